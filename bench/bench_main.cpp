@@ -0,0 +1,247 @@
+/**
+ * Decode and Render Benchmark (host)
+ *
+ * Runs the firmware's JSON decoder and screen renderer on the development machine, on a
+ * recorded One Call response, so changes to either can be timed and checked without a
+ * device:  pio run -e native && .pio/build/native/program [options]
+ *
+ *   --fixture FILE   One Call 3.0 response to decode (bench/fixtures/onecall_sample.json)
+ *   --iterations N   Runs of each stage (50)
+ *   --units M|I      Units and clock format to render with (M)
+ *   --out DIR        Also write the rendered frame as DIR/weather_<units>.pgm
+ *   --golden DIR     Compare the frame with DIR/weather_<units>.pgm; exits 1 if any pixel
+ *                    differs, records it when the file does not exist yet
+ *
+ * Each stage reports its first run separately: on the device every wake starts with an
+ * empty glyph cache, like the first run here. Host times are for comparing changes with
+ * each other, not a prediction of device times.
+ */
+
+#include <Arduino.h>
+#include <vector>
+#include "forecast_record.h"
+#include "memory_arena.h"
+#include "renderer.h"
+#include "settings.h"
+#include "weather_decoder.h"
+#include "weather_view.h"
+
+#define FRAMEBUFFER_SIZE (EPD_WIDTH * EPD_HEIGHT / 2)
+
+// Globals the firmware defines in main.ino and settings.cpp
+Settings settings;
+Forecast_record_type WxConditions[1];
+Forecast_record_type WxHourlyForecast[max_hourly_readings];
+Forecast_record_type WxDailyForecast[max_daily_readings];
+GFXfont  currentFont;
+uint8_t *framebuffer;
+
+static String dateStr, timeStr;
+
+// Decoder hooks; the host clock is left alone
+void SetRTCTimeFromAPI(time_t apiTime, int timezoneOffset) {}
+void fetchProgress(uint32_t bits) {}
+
+/**
+ * Stream over a response held in memory.
+ */
+class MemoryStream : public Stream {
+public:
+  MemoryStream(const std::vector<char> &data) : data(data), position(0) {}
+  int available() override { return data.size() - position; }
+  int read() override { return position < data.size() ? (uint8_t)data[position++] : -1; }
+  int peek() override { return position < data.size() ? (uint8_t)data[position] : -1; }
+
+private:
+  const std::vector<char> &data;
+  size_t position;
+};
+
+typedef struct {
+  const char *name;
+  void (*run)();
+} Stage;
+
+static std::vector<char> response;
+
+static void decodeStage() {
+  MemoryStream stream(response);
+  if (!DecodeWeather(stream)) {
+    fprintf(stderr, "DecodeWeather() failed\n");
+    exit(2);
+  }
+}
+
+static void drawLocation() { drawLocationDate(settings.City, dateStr); }
+static void drawCurrent()  { drawCurrentConditions(WxConditions, weatherView); }
+static void drawForecastRow() { drawForecast(weatherView); }
+static void drawGraph()    { drawOutlookGraph(weatherView); }
+static void drawStatus()   { drawStatusBar("", timeStr, -60, 3900, -1); }
+
+/**
+ * The whole screen, as DisplayWeather() composes it: cleared, then every section.
+ */
+static void drawFrame() {
+  memset(framebuffer, 0xFF, FRAMEBUFFER_SIZE);
+  drawLocation();
+  drawCurrent();
+  drawForecastRow();
+  drawGraph();
+  drawStatus();
+}
+
+static const Stage stages[] = {
+  {"decode",   decodeStage},
+  {"location", drawLocation},
+  {"current",  drawCurrent},
+  {"forecast", drawForecastRow},
+  {"graph",    drawGraph},
+  {"status",   drawStatus},
+  {"frame",    drawFrame},
+};
+#define STAGE_COUNT (sizeof(stages) / sizeof(stages[0]))
+
+static bool readFile(const char *path, std::vector<char> &out) {
+  FILE *file = fopen(path, "rb");
+  if (!file) return false;
+  char buffer[4096];
+  size_t length;
+  out.clear();
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    out.insert(out.end(), buffer, buffer + length);
+  }
+  fclose(file);
+  return true;
+}
+
+static bool writeFile(const char *path, const std::vector<char> &data) {
+  FILE *file = fopen(path, "wb");
+  if (!file) return false;
+  bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+  return fclose(file) == 0 && ok;
+}
+
+/**
+ * The framebuffer as a binary PGM, 16 grey levels scaled to 0-255.
+ * Even x is the low nibble of each byte, as the EPD driver lays it out.
+ */
+static std::vector<char> framebufferImage() {
+  char header[32];
+  int headerLength = snprintf(header, sizeof(header), "P5\n%d %d\n255\n", EPD_WIDTH, EPD_HEIGHT);
+  std::vector<char> image(header, header + headerLength);
+  image.reserve(headerLength + EPD_WIDTH * EPD_HEIGHT);
+  for (int i = 0; i < FRAMEBUFFER_SIZE; i++) {
+    image.push_back((framebuffer[i] & 0x0F) * 17);
+    image.push_back((framebuffer[i] >> 4) * 17);
+  }
+  return image;
+}
+
+/**
+ * Local date and update time as UpdateLocalTime() formats them, from the decoded API time.
+ */
+static void formatClockStrings() {
+  time_t local = WxConditions[0].Dt + WxConditions[0].FTimezone;
+  struct tm t;
+  gmtime_r(&local, &t);
+  char weekday[20], month[20], date[48], clock[16];
+  strftime(weekday, sizeof(weekday), "%A", &t);
+  strftime(month, sizeof(month), "%B", &t);
+  snprintf(date, sizeof(date), "%s, %s %d", weekday, month, t.tm_mday);
+  strftime(clock, sizeof(clock), strcmp(settings.Units, "M") == 0 ? "%H:%M:%S" : "%r", &t);
+  dateStr = date;
+  timeStr = clock;
+}
+
+static int usage(const char *program) {
+  fprintf(stderr, "usage: %s [--fixture FILE] [--iterations N] [--units M|I] [--out DIR] [--golden DIR]\n", program);
+  return 2;
+}
+
+int main(int argc, char **argv) {
+  const char *fixture = "bench/fixtures/onecall_sample.json";
+  const char *outDir = NULL;
+  const char *goldenDir = NULL;
+  const char *units = "M";
+  int iterations = 50;
+
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--fixture") == 0 && hasValue) fixture = argv[++i];
+    else if (strcmp(argv[i], "--iterations") == 0 && hasValue) iterations = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--units") == 0 && hasValue) units = argv[++i];
+    else if (strcmp(argv[i], "--out") == 0 && hasValue) outDir = argv[++i];
+    else if (strcmp(argv[i], "--golden") == 0 && hasValue) goldenDir = argv[++i];
+    else return usage(argv[0]);
+  }
+  if (iterations < 1 || (strcmp(units, "M") != 0 && strcmp(units, "I") != 0)) return usage(argv[0]);
+
+  if (!readFile(fixture, response)) {
+    fprintf(stderr, "cannot read %s\n", fixture);
+    return 2;
+  }
+  memset(&settings, 0, sizeof(settings));
+  snprintf(settings.City, sizeof(settings.City), "%s", "Chicago,IL,US");
+  snprintf(settings.Language, sizeof(settings.Language), "%s", "en");
+  snprintf(settings.Units, sizeof(settings.Units), "%s", units);
+  settings.MaxDataAge = 0;
+  settings.magic = SETTINGS_MAGIC;
+
+  framebuffer = (uint8_t *)arenaAlloc(ARENA_FRAMEBUFFER, FRAMEBUFFER_SIZE);
+  if (!framebuffer) return 2;
+
+  printf("%-10s %10s %10s %10s   (%d runs, %zu byte response)\n", "stage", "first us", "mean us", "min us",
+         iterations, response.size());
+  for (size_t s = 0; s < STAGE_COUNT; s++) {
+    unsigned long first = 0, total = 0, fastest = ~0UL;
+    for (int i = 0; i < iterations; i++) {
+      memset(framebuffer, 0xFF, FRAMEBUFFER_SIZE);
+      unsigned long start = micros();
+      stages[s].run();
+      unsigned long elapsed = micros() - start;
+      if (i == 0) first = elapsed;
+      total += elapsed;
+      if (elapsed < fastest) fastest = elapsed;
+    }
+    printf("%-10s %10lu %10lu %10lu\n", stages[s].name, first, total / iterations, fastest);
+    if (s == 0) formatClockStrings();  // Decoded: the screen strings can be formatted
+  }
+
+  drawFrame();
+  std::vector<char> image = framebufferImage();
+
+  char path[512];
+  if (outDir) {
+    snprintf(path, sizeof(path), "%s/weather_%s.pgm", outDir, units);
+    if (!writeFile(path, image)) {
+      fprintf(stderr, "cannot write %s\n", path);
+      return 2;
+    }
+    printf("frame written to %s\n", path);
+  }
+  if (goldenDir) {
+    std::vector<char> golden;
+    snprintf(path, sizeof(path), "%s/weather_%s.pgm", goldenDir, units);
+    if (!readFile(path, golden)) {
+      if (!writeFile(path, image)) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 2;
+      }
+      printf("golden frame recorded as %s\n", path);
+    } else if (golden.size() != image.size()) {
+      printf("golden frame %s has a different size\n", path);
+      return 1;
+    } else {
+      int differing = 0;
+      for (size_t i = 0; i < image.size(); i++) {
+        if (image[i] != golden[i]) differing++;
+      }
+      if (differing) {
+        printf("%d pixels differ from %s\n", differing, path);
+        return 1;
+      }
+      printf("frame matches %s\n", path);
+    }
+  }
+  return 0;
+}
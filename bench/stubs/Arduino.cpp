@@ -0,0 +1,75 @@
+/**
+ * Host implementations behind bench/stubs/Arduino.h.
+ */
+
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+#include "Arduino.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+size_t Print::printf(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int written = vprintf(format, args);
+  va_end(args);
+  return written < 0 ? 0 : written;
+}
+
+/**
+ * Read until target is found (true) or terminator is found or the data ends (false).
+ */
+bool Stream::findUntil(const char *target, const char *terminator) {
+  const size_t targetLength = strlen(target);
+  const size_t terminatorLength = terminator ? strlen(terminator) : 0;
+  size_t targetIndex = 0, terminatorIndex = 0;
+  int c;
+  while ((c = read()) >= 0) {
+    if (c == target[targetIndex]) {
+      if (++targetIndex == targetLength) return true;
+    } else {
+      targetIndex = (c == target[0]) ? 1 : 0;
+    }
+    if (terminatorLength) {
+      if (c == terminator[terminatorIndex]) {
+        if (++terminatorIndex == terminatorLength) return false;
+      } else {
+        terminatorIndex = (c == terminator[0]) ? 1 : 0;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * Skip to the first digit or minus sign and read an integer (0 if the data ends first).
+ */
+long Stream::parseInt() {
+  int c;
+  while ((c = peek()) >= 0 && c != '-' && (c < '0' || c > '9')) read();
+  if (c < 0) return 0;
+  bool negative = (c == '-');
+  if (negative) read();
+  long value = 0;
+  while ((c = peek()) >= '0' && c <= '9') {
+    value = value * 10 + (c - '0');
+    read();
+  }
+  return negative ? -value : value;
+}
@@ -0,0 +1,147 @@
+/**
+ * Host stand-in for the parts of the Arduino core the decoder and renderer use
+ * (native benchmark only, see bench/bench_main.cpp). Not a general Arduino emulation.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include <algorithm>
+
+#define PROGMEM
+#define RTC_DATA_ATTR
+#define F(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::min;
+using std::max;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+static inline void *ps_malloc(size_t size) { return malloc(size); }
+static inline void *ps_calloc(size_t n, size_t size) { return calloc(n, size); }
+static inline bool psramFound() { return true; }
+
+class String {
+public:
+  String(const char *s = "") : str(s ? s : "") {}
+  String(const std::string &s) : str(s) {}
+  explicit String(char c) : str(1, c) {}
+  String(int value) : str(std::to_string(value)) {}
+  String(unsigned int value) : str(std::to_string(value)) {}
+  String(long value) : str(std::to_string(value)) {}
+  String(unsigned long value) : str(std::to_string(value)) {}
+  String(float value, unsigned int decimals = 2) : str(format(value, decimals)) {}
+  String(double value, unsigned int decimals = 2) : str(format(value, decimals)) {}
+
+  const char *c_str() const { return str.c_str(); }
+  unsigned int length() const { return str.length(); }
+  void reserve(unsigned int size) { str.reserve(size); }
+  char charAt(unsigned int i) const { return i < str.length() ? str[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  int indexOf(char c, unsigned int from = 0) const { return find(str.find(c, from)); }
+  int indexOf(const char *s, unsigned int from = 0) const { return find(str.find(s, from)); }
+  int indexOf(const String &s, unsigned int from = 0) const { return find(str.find(s.str, from)); }
+  int lastIndexOf(char c) const { return find(str.rfind(c)); }
+  String substring(unsigned int from) const { return from < str.length() ? String(str.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    return from < str.length() ? String(str.substr(from, to - from)) : String();
+  }
+  bool startsWith(const String &s) const { return str.compare(0, s.str.length(), s.str) == 0; }
+  void trim() {
+    size_t first = str.find_first_not_of(" \t\r\n");
+    size_t last = str.find_last_not_of(" \t\r\n");
+    str = (first == std::string::npos) ? "" : str.substr(first, last - first + 1);
+  }
+  long toInt() const { return atol(str.c_str()); }
+  float toFloat() const { return atof(str.c_str()); }
+
+  String &operator+=(const String &s) { str += s.str; return *this; }
+  String &operator+=(const char *s) { str += s; return *this; }
+  String &operator+=(char c) { str += c; return *this; }
+  bool operator==(const String &s) const { return str == s.str; }
+  bool operator==(const char *s) const { return str == s; }
+  bool operator!=(const String &s) const { return str != s.str; }
+  bool operator!=(const char *s) const { return str != s; }
+
+  friend String operator+(const String &a, const String &b) { return String(a.str + b.str); }
+  friend String operator+(const String &a, const char *b) { return String(a.str + b); }
+  friend String operator+(const char *a, const String &b) { return String(a + b.str); }
+
+private:
+  static std::string format(double value, unsigned int decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+    return buf;
+  }
+  static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+
+  std::string str;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  size_t print(const char *s) { return fputs(s, stdout) >= 0 ? strlen(s) : 0; }
+  size_t print(const String &s) { return print(s.c_str()); }
+  size_t print(long value) { return printf("%ld", value); }
+  size_t print(double value, int decimals = 2) { return printf("%.*f", decimals, value); }
+  size_t println(const char *s = "") { return print(s) + print("\n"); }
+  size_t println(const String &s) { return println(s.c_str()); }
+  size_t println(long value) { return print(value) + print("\n"); }
+  size_t println(double value, int decimals = 2) { return print(value, decimals) + print("\n"); }
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+/**
+ * Arduino Stream with the timed search and number parsing the decoder relies on.
+ * A read() of -1 means no more data (there is no waiting on the host).
+ */
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t write(uint8_t) override { return 0; }
+
+  size_t readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = read();
+      if (c < 0) break;
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  bool find(const char *target) { return findUntil(target, NULL); }
+  bool findUntil(const char *target, const char *terminator);
+  long parseInt();
+};
+
+class HardwareSerial : public Print {
+public:
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  explicit operator bool() const { return true; }
+  void flush() { fflush(stdout); }
+};
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+  uint32_t getFreeHeap() { return 0; }
+  uint32_t getMinFreeHeap() { return 0; }
+  uint32_t getMaxAllocHeap() { return 0; }
+};
+extern EspClass ESP;
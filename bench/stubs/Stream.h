@@ -0,0 +1,3 @@
+// ArduinoJson includes <Stream.h> for its Arduino stream reader; the host Stream is in Arduino.h
+#pragma once
+#include "Arduino.h"
@@ -0,0 +1,219 @@
+/**
+ * Host implementation of the LilyGo EPD47 framebuffer drawing functions, following the
+ * driver's own code pixel for pixel (4bpp, two pixels per byte, even x in the low nibble,
+ * the high nibble of the color used) so benchmark images match what the device draws.
+ */
+
+#include <stdlib.h>
+#include "epd_driver.h"
+
+static inline void swapInt(int &a, int &b) {
+  int t = a;
+  a = b;
+  b = t;
+}
+
+void epd_draw_pixel(int x, int y, uint8_t color, uint8_t *framebuffer) {
+  if (x < 0 || x >= EPD_WIDTH) return;
+  if (y < 0 || y >= EPD_HEIGHT) return;
+  uint8_t *buf_ptr = &framebuffer[y * EPD_WIDTH / 2 + x / 2];
+  if (x % 2) {
+    *buf_ptr = (*buf_ptr & 0x0F) | (color & 0xF0);
+  } else {
+    *buf_ptr = (*buf_ptr & 0xF0) | (color >> 4);
+  }
+}
+
+void epd_draw_hline(int x, int y, int length, uint8_t color, uint8_t *framebuffer) {
+  for (int i = 0; i < length; i++) {
+    epd_draw_pixel(x + i, y, color, framebuffer);
+  }
+}
+
+void epd_draw_vline(int x, int y, int length, uint8_t color, uint8_t *framebuffer) {
+  for (int i = 0; i < length; i++) {
+    epd_draw_pixel(x, y + i, color, framebuffer);
+  }
+}
+
+void epd_draw_circle(int x0, int y0, int r, uint8_t color, uint8_t *framebuffer) {
+  int f = 1 - r;
+  int ddF_x = 1;
+  int ddF_y = -2 * r;
+  int x = 0;
+  int y = r;
+
+  epd_draw_pixel(x0, y0 + r, color, framebuffer);
+  epd_draw_pixel(x0, y0 - r, color, framebuffer);
+  epd_draw_pixel(x0 + r, y0, color, framebuffer);
+  epd_draw_pixel(x0 - r, y0, color, framebuffer);
+
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+
+    epd_draw_pixel(x0 + x, y0 + y, color, framebuffer);
+    epd_draw_pixel(x0 - x, y0 + y, color, framebuffer);
+    epd_draw_pixel(x0 + x, y0 - y, color, framebuffer);
+    epd_draw_pixel(x0 - x, y0 - y, color, framebuffer);
+    epd_draw_pixel(x0 + y, y0 + x, color, framebuffer);
+    epd_draw_pixel(x0 - y, y0 + x, color, framebuffer);
+    epd_draw_pixel(x0 + y, y0 - x, color, framebuffer);
+    epd_draw_pixel(x0 - y, y0 - x, color, framebuffer);
+  }
+}
+
+static void epd_fill_circle_helper(int x0, int y0, int r, int corners, int delta, uint8_t color,
+                                   uint8_t *framebuffer) {
+  int f = 1 - r;
+  int ddF_x = 1;
+  int ddF_y = -2 * r;
+  int x = 0;
+  int y = r;
+  int px = x;
+  int py = y;
+
+  delta++; // Avoid some +1's in the loop
+
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    // These checks avoid double-drawing certain lines
+    if (x < (y + 1)) {
+      if (corners & 1) epd_draw_vline(x0 + x, y0 - y, 2 * y + delta, color, framebuffer);
+      if (corners & 2) epd_draw_vline(x0 - x, y0 - y, 2 * y + delta, color, framebuffer);
+    }
+    if (y != py) {
+      if (corners & 1) epd_draw_vline(x0 + py, y0 - px, 2 * px + delta, color, framebuffer);
+      if (corners & 2) epd_draw_vline(x0 - py, y0 - px, 2 * px + delta, color, framebuffer);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void epd_fill_circle(int x0, int y0, int r, uint8_t color, uint8_t *framebuffer) {
+  epd_draw_vline(x0, y0 - r, 2 * r + 1, color, framebuffer);
+  epd_fill_circle_helper(x0, y0, r, 3, 0, color, framebuffer);
+}
+
+void epd_draw_rect(int x, int y, int w, int h, uint8_t color, uint8_t *framebuffer) {
+  epd_draw_hline(x, y, w, color, framebuffer);
+  epd_draw_hline(x, y + h - 1, w, color, framebuffer);
+  epd_draw_vline(x, y, h, color, framebuffer);
+  epd_draw_vline(x + w - 1, y, h, color, framebuffer);
+}
+
+void epd_fill_rect(int x, int y, int w, int h, uint8_t color, uint8_t *framebuffer) {
+  for (int i = y; i < y + h; i++) {
+    epd_draw_hline(x, i, w, color, framebuffer);
+  }
+}
+
+void epd_write_line(int x0, int y0, int x1, int y1, uint8_t color, uint8_t *framebuffer) {
+  int steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    swapInt(x0, y0);
+    swapInt(x1, y1);
+  }
+  if (x0 > x1) {
+    swapInt(x0, x1);
+    swapInt(y0, y1);
+  }
+
+  int dx = x1 - x0;
+  int dy = abs(y1 - y0);
+  int err = dx / 2;
+  int ystep = (y0 < y1) ? 1 : -1;
+
+  for (; x0 <= x1; x0++) {
+    if (steep) {
+      epd_draw_pixel(y0, x0, color, framebuffer);
+    } else {
+      epd_draw_pixel(x0, y0, color, framebuffer);
+    }
+    err -= dy;
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void epd_draw_line(int x0, int y0, int x1, int y1, uint8_t color, uint8_t *framebuffer) {
+  if (x0 == x1) {
+    if (y0 > y1) swapInt(y0, y1);
+    epd_draw_vline(x0, y0, y1 - y0 + 1, color, framebuffer);
+  } else if (y0 == y1) {
+    if (x0 > x1) swapInt(x0, x1);
+    epd_draw_hline(x0, y0, x1 - x0 + 1, color, framebuffer);
+  } else {
+    epd_write_line(x0, y0, x1, y1, color, framebuffer);
+  }
+}
+
+void epd_fill_triangle(int x0, int y0, int x1, int y1, int x2, int y2, uint8_t color, uint8_t *framebuffer) {
+  int a, b, y, last;
+
+  // Sort coordinates by Y order (y2 >= y1 >= y0)
+  if (y0 > y1) {
+    swapInt(y0, y1);
+    swapInt(x0, x1);
+  }
+  if (y1 > y2) {
+    swapInt(y2, y1);
+    swapInt(x2, x1);
+  }
+  if (y0 > y1) {
+    swapInt(y0, y1);
+    swapInt(x0, x1);
+  }
+
+  if (y0 == y2) { // All on the same line
+    a = b = x0;
+    if (x1 < a) a = x1;
+    else if (x1 > b) b = x1;
+    if (x2 < a) a = x2;
+    else if (x2 > b) b = x2;
+    epd_draw_hline(a, y0, b - a + 1, color, framebuffer);
+    return;
+  }
+
+  int dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+  int sa = 0, sb = 0;
+
+  // Upper part: include scanline y1 only for a flat-bottomed triangle
+  last = (y1 == y2) ? y1 : y1 - 1;
+  for (y = y0; y <= last; y++) {
+    a = x0 + sa / dy01;
+    b = x0 + sb / dy02;
+    sa += dx01;
+    sb += dx02;
+    if (a > b) swapInt(a, b);
+    epd_draw_hline(a, y, b - a + 1, color, framebuffer);
+  }
+
+  // Lower part
+  sa = dx12 * (y - y1);
+  sb = dx02 * (y - y0);
+  for (; y <= y2; y++) {
+    a = x1 + sa / dy12;
+    b = x0 + sb / dy02;
+    sa += dx12;
+    sb += dx02;
+    if (a > b) swapInt(a, b);
+    epd_draw_hline(a, y, b - a + 1, color, framebuffer);
+  }
+}
@@ -0,0 +1,57 @@
+/**
+ * Host version of the LilyGo EPD47 driver interface: the same types and the framebuffer
+ * drawing functions the renderer uses (epd_driver.cpp). There is no panel; the benchmark
+ * writes the framebuffer to an image instead. Native benchmark only.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define EPD_WIDTH  960
+#define EPD_HEIGHT 540
+
+typedef struct {
+  uint8_t  width;
+  uint8_t  height;
+  uint8_t  advance_x;
+  int16_t  left;
+  int16_t  top;
+  uint16_t compressed_size;
+  uint32_t data_offset;
+} GFXglyph;
+
+typedef struct {
+  uint32_t first;
+  uint32_t last;
+  uint32_t offset;
+} UnicodeInterval;
+
+typedef struct {
+  uint8_t         *bitmap;
+  GFXglyph        *glyph;
+  UnicodeInterval *intervals;
+  uint32_t         interval_count;
+  bool             compressed;
+  uint8_t          advance_y;
+  int              ascender;
+  int              descender;
+} GFXfont;
+
+typedef struct {
+  int x;
+  int y;
+  int width;
+  int height;
+} Rect_t;
+
+void epd_draw_pixel(int x, int y, uint8_t color, uint8_t *framebuffer);
+void epd_draw_hline(int x, int y, int length, uint8_t color, uint8_t *framebuffer);
+void epd_draw_vline(int x, int y, int length, uint8_t color, uint8_t *framebuffer);
+void epd_draw_circle(int x, int y, int r, uint8_t color, uint8_t *framebuffer);
+void epd_fill_circle(int x, int y, int r, uint8_t color, uint8_t *framebuffer);
+void epd_draw_rect(int x, int y, int w, int h, uint8_t color, uint8_t *framebuffer);
+void epd_fill_rect(int x, int y, int w, int h, uint8_t color, uint8_t *framebuffer);
+void epd_write_line(int x0, int y0, int x1, int y1, uint8_t color, uint8_t *framebuffer);
+void epd_draw_line(int x0, int y0, int x1, int y1, uint8_t color, uint8_t *framebuffer);
+void epd_fill_triangle(int x0, int y0, int x1, int y1, int x2, int y2, uint8_t color, uint8_t *framebuffer);
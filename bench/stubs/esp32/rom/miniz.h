@@ -0,0 +1,52 @@
+/**
+ * Host stand-in for the ESP32 ROM tinfl (miniz inflater), for single-shot inflation into
+ * a non-wrapping buffer as text_renderer.cpp does. Built on zlib. Native benchmark only.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zlib.h>
+
+#define TINFL_FLAG_PARSE_ZLIB_HEADER            1
+#define TINFL_FLAG_HAS_MORE_INPUT               2
+#define TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF 4
+
+typedef enum {
+  TINFL_STATUS_BAD_PARAM        = -3,
+  TINFL_STATUS_ADLER32_MISMATCH = -2,
+  TINFL_STATUS_FAILED           = -1,
+  TINFL_STATUS_DONE             = 0,
+  TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+  TINFL_STATUS_HAS_MORE_OUTPUT  = 2
+} tinfl_status;
+
+typedef struct {
+  int unused;
+} tinfl_decompressor;
+
+#define tinfl_init(r) ((void)(r))
+
+static inline tinfl_status tinfl_decompress(tinfl_decompressor *r, const uint8_t *pIn_buf_next, size_t *pIn_buf_size,
+                                            uint8_t *pOut_buf_start, uint8_t *pOut_buf_next, size_t *pOut_buf_size,
+                                            uint32_t decomp_flags) {
+  (void)r;
+  (void)pOut_buf_start;
+  z_stream stream = {};
+  if (inflateInit2(&stream, (decomp_flags & TINFL_FLAG_PARSE_ZLIB_HEADER) ? MAX_WBITS : -MAX_WBITS) != Z_OK) {
+    return TINFL_STATUS_BAD_PARAM;
+  }
+  stream.next_in   = (Bytef *)pIn_buf_next;
+  stream.avail_in  = (uInt)*pIn_buf_size;
+  stream.next_out  = pOut_buf_next;
+  stream.avail_out = (uInt)*pOut_buf_size;
+  int result = inflate(&stream, Z_FINISH);
+  *pIn_buf_size  = stream.total_in;
+  *pOut_buf_size = stream.total_out;
+  inflateEnd(&stream);
+  switch (result) {
+    case Z_STREAM_END: return TINFL_STATUS_DONE;
+    case Z_BUF_ERROR:  return stream.avail_in ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+    default:           return TINFL_STATUS_FAILED;
+  }
+}
@@ -0,0 +1,3 @@
+#pragma once
+// Same host inflater for ESP32-S3 builds of text_renderer.cpp
+#include "../../esp32/rom/miniz.h"
@@ -0,0 +1,296 @@
+/**
+ * API Client
+ *
+ * One connection to api.openweathermap.org per wake, shared by the geocoding and
+ * weather requests (HTTP keep-alive). With API_USE_HTTPS the connection is TLS with
+ * the CA pinned to owm_ca.h, and the session is kept in RTC memory so the next wake
+ * resumes it instead of repeating the full handshake. The server address is cached in
+ * RTC memory as well, so most wakes skip the DNS lookup.
+ *
+ * apiRequest() writes the request and parses the response headers itself, for the
+ * weather request: that way it can ask for gzip and send the cached validators.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <time.h>
+#include "api_client.h"
+#include "settings.h"
+#include "http_body.h"
+#include "rtc_budget.h"
+#if API_USE_HTTPS
+#include "tls_client.h"
+#include "owm_ca.h"
+#endif
+
+typedef struct {
+  uint32_t magic;
+  uint32_t address;     // IPv4 address of API_HOST
+  int32_t  resolvedAt;  // UTC, 0 = resolved before the RTC was set (used until it is)
+} ApiDnsCache;
+
+// Persist across deep sleep
+RTC_DATA_ATTR static ApiDnsCache dnsCache;
+#if API_USE_HTTPS
+typedef struct {
+  uint16_t length;  // 0 = no session saved
+  uint8_t  data[API_TLS_SESSION_SIZE];
+} ApiTlsSession;
+
+RTC_DATA_ATTR static ApiTlsSession tlsSession;
+static_assert(sizeof(dnsCache) + sizeof(tlsSession) <= RTC_BUDGET_API_CLIENT, "API cache over its RTC allotment");
+static TlsClient apiClient;
+#else
+static WiFiClient apiClient;
+#endif
+
+// Longest response header line kept; the rest of a longer line is dropped
+#define API_HEADER_LINE_LEN 128
+
+// Response to the last apiRequest()
+static HttpBodyStream responseBody;
+static char responseETag[API_VALIDATOR_LEN];
+static char responseLastModified[API_VALIDATOR_LEN];
+static bool responseKeepAlive;
+
+/**
+ * Address of API_HOST, from the cache while it is fresh.
+ *
+ * @param cached Set to whether the address came from the cache
+ */
+static bool resolveHost(IPAddress &address, bool &cached) {
+  time_t now = time(NULL);
+  bool rtcSet = (now >= 946684800); // Unix timestamp for 2000-01-01
+  cached = dnsCache.magic == API_CACHE_MAGIC &&
+           (rtcSet ? (dnsCache.resolvedAt != 0 && now >= dnsCache.resolvedAt &&
+                      now - dnsCache.resolvedAt < API_DNS_CACHE_SECONDS)
+                   : dnsCache.resolvedAt == 0);
+  if (cached) {
+    address = IPAddress(dnsCache.address);
+    return true;
+  }
+
+  if (!WiFi.hostByName(API_HOST, address) || (uint32_t)address == 0) {
+    return false;
+  }
+  dnsCache.address = (uint32_t)address;
+  dnsCache.resolvedAt = rtcSet ? now : 0;
+  dnsCache.magic = API_CACHE_MAGIC;
+  return true;
+}
+
+bool apiConnect() {
+  if (apiClient.connected()) {
+    return true;
+  }
+#if API_USE_HTTPS
+  apiClient.setCACert(owm_ca_pem);
+  apiClient.setHostname(API_HOST);
+  apiClient.setSessionCache(tlsSession.data, sizeof(tlsSession.data), &tlsSession.length);
+#endif
+
+  // A cached address may have gone stale: forget it and look it up again once
+  for (int attempt = 0; attempt < 2; attempt++) {
+    IPAddress address;
+    bool cached;
+    if (!resolveHost(address, cached)) {
+      break;
+    }
+    if (apiClient.connect(address, API_PORT)) {
+#if DEBUG_LEVEL
+      if (Serial) {
+        Serial.printf("Connected to %s (%s, %s address)\n", API_HOST, address.toString().c_str(),
+                      cached ? "cached" : "resolved");
+      }
+#endif
+      return true;
+    }
+    dnsCache.magic = 0;
+    if (!cached) {
+      break;
+    }
+  }
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.println("Connection to " API_HOST " failed");
+  }
+#endif
+  return false;
+}
+
+int apiGet(HTTPClient &http, const String &uri) {
+  if (!apiConnect()) {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  http.setReuse(true); // Ask for keep-alive; HTTPClient reuses the open connection
+  http.begin(apiClient, API_HOST, API_PORT, uri, API_USE_HTTPS);
+  return http.GET();
+}
+
+/**
+ * Read one response header line without its CRLF, truncating lines longer than the buffer.
+ *
+ * @return false on timeout or if the connection closed
+ */
+static bool readHeaderLine(char *line, size_t size) {
+  size_t length = 0;
+  unsigned long start = millis();
+  while (true) {
+    if (apiClient.available() <= 0) {
+      if (!apiClient.connected() || millis() - start > API_RESPONSE_TIMEOUT_MS) {
+        return false;
+      }
+      delay(1);
+      continue;
+    }
+    int c = apiClient.read();
+    if (c == '\n') {
+      line[length] = '\0';
+      return true;
+    }
+    if (c >= 0 && c != '\r' && length + 1 < size) {
+      line[length++] = c;
+    }
+  }
+}
+
+/**
+ * Keep a validator header value if it fits; a truncated one could never match.
+ */
+static void keepValidator(char *dest, const char *value) {
+  if (strlen(value) < API_VALIDATOR_LEN) {
+    strcpy(dest, value);
+  }
+}
+
+int apiRequest(const String &uri, const char *etag, const char *lastModified) {
+  responseETag[0] = '\0';
+  responseLastModified[0] = '\0';
+  responseKeepAlive = false;
+
+  String request = "GET " + uri + " HTTP/1.1\r\n"
+                   "Host: " API_HOST "\r\n"
+                   "User-Agent: ESP32HTTPClient\r\n"
+                   "Accept-Encoding: gzip\r\n"
+                   "Connection: keep-alive\r\n";
+  if (etag && etag[0]) {
+    request += "If-None-Match: " + String(etag) + "\r\n";
+  }
+  if (lastModified && lastModified[0]) {
+    request += "If-Modified-Since: " + String(lastModified) + "\r\n";
+  }
+  request += "\r\n";
+
+  // The server may have dropped a kept-alive connection while idle: retry once on a new one
+  char line[API_HEADER_LINE_LEN];
+  int result = HTTPC_ERROR_CONNECTION_REFUSED;
+  for (int attempt = 0; attempt < 2; attempt++) {
+    bool reused = apiClient.connected();
+    if (!apiConnect()) {
+      return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    if (apiClient.write((const uint8_t *)request.c_str(), request.length()) != request.length()) {
+      result = HTTPC_ERROR_SEND_HEADER_FAILED;
+    } else if (!readHeaderLine(line, sizeof(line))) {
+      result = HTTPC_ERROR_READ_TIMEOUT;
+    } else {
+      result = 0;
+      break;
+    }
+    apiClose();
+    if (!reused) {
+      return result;
+    }
+  }
+  if (result != 0) {
+    return result;
+  }
+
+  // Status line, e.g. "HTTP/1.1 200 OK"; HTTP/1.1 keeps the connection open by default
+  if (strncmp(line, "HTTP/1.", 7) != 0 || strlen(line) < 12) {
+    apiClose();
+    return HTTPC_ERROR_NO_HTTP_SERVER;
+  }
+  int code = atoi(line + 9);
+  responseKeepAlive = (line[7] == '1');
+
+  long contentLength = -1;
+  bool chunked = false;
+  bool gzip = false;
+  while (true) {
+    if (!readHeaderLine(line, sizeof(line))) {
+      apiClose();
+      return HTTPC_ERROR_READ_TIMEOUT;
+    }
+    if (line[0] == '\0') {
+      break; // End of headers
+    }
+    char *value = strchr(line, ':');
+    if (!value) {
+      continue;
+    }
+    *value++ = '\0';
+    while (*value == ' ') value++;
+
+    if (strcasecmp(line, "Content-Length") == 0) {
+      contentLength = atol(value);
+    } else if (strcasecmp(line, "Transfer-Encoding") == 0) {
+      chunked = (strcasecmp(value, "chunked") == 0);
+    } else if (strcasecmp(line, "Content-Encoding") == 0) {
+      gzip = (strcasecmp(value, "gzip") == 0);
+    } else if (strcasecmp(line, "ETag") == 0) {
+      keepValidator(responseETag, value);
+    } else if (strcasecmp(line, "Last-Modified") == 0) {
+      keepValidator(responseLastModified, value);
+    } else if (strcasecmp(line, "Connection") == 0) {
+      if (strcasecmp(value, "close") == 0) responseKeepAlive = false;
+      if (strcasecmp(value, "keep-alive") == 0) responseKeepAlive = true;
+    }
+  }
+  if (code == HTTP_CODE_NOT_MODIFIED || code == HTTP_CODE_NO_CONTENT || code < 200) {
+    contentLength = 0; // No body, whatever the headers say
+    chunked = false;
+  }
+
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("HTTP %d (%s%s, Content-Length %ld)\n", code, gzip ? "gzip" : "identity",
+                  chunked ? ", chunked" : "", contentLength);
+  }
+#endif
+  if (!responseBody.begin(apiClient, contentLength, chunked, gzip, API_RESPONSE_TIMEOUT_MS)) {
+    apiClose();
+    return HTTPC_ERROR_TOO_LESS_RAM;
+  }
+  return code;
+}
+
+Stream &apiBody() {
+  return responseBody;
+}
+
+const char *apiResponseETag() {
+  return responseETag;
+}
+
+const char *apiResponseLastModified() {
+  return responseLastModified;
+}
+
+void apiEndRequest() {
+  bool reusable = responseKeepAlive && responseBody.complete();
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("%u response bytes received, connection %s\n", (unsigned)responseBody.receivedBytes(),
+                  reusable ? "kept open" : "closed");
+  }
+#endif
+  responseBody.end();
+  if (!reusable) {
+    apiClose();
+  }
+}
+
+void apiClose() {
+  apiClient.stop();
+}
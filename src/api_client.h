@@ -0,0 +1,94 @@
+#ifndef __API_CLIENT_H__
+#define __API_CLIENT_H__
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+
+#define API_HOST "api.openweathermap.org"
+
+// 1 = HTTPS with the pinned CA (owm_ca.h), 0 = plain HTTP on port 80
+#ifndef API_USE_HTTPS
+#define API_USE_HTTPS 1
+#endif
+
+#if API_USE_HTTPS
+#define API_PORT 443
+#else
+#define API_PORT 80
+#endif
+
+// Keep the resolved address of API_HOST in RTC memory for this long (seconds)
+#ifndef API_DNS_CACHE_SECONDS
+#define API_DNS_CACHE_SECONDS (6 * 3600)
+#endif
+
+// RTC memory reserved for the saved TLS session (bytes), with the server certificate left
+// out: about 120 bytes plus the session ticket. A session is only cached if it fits.
+#ifndef API_TLS_SESSION_SIZE
+#define API_TLS_SESSION_SIZE 512
+#endif
+
+#define API_CACHE_MAGIC 0x41504943  // "APIC" in hex
+
+// Give up on a response when no data arrives for this long
+#ifndef API_RESPONSE_TIMEOUT_MS
+#define API_RESPONSE_TIMEOUT_MS 10000
+#endif
+
+// Longest ETag / Last-Modified value kept from a response, including the terminator
+#define API_VALIDATOR_LEN 48
+
+/**
+ * Open the connection to API_HOST, unless the one from an earlier request of this wake is still open.
+ * The address comes from the RTC DNS cache and the TLS session is resumed when possible.
+ *
+ * @return true if connected
+ */
+bool apiConnect();
+
+/**
+ * Send a GET request on the shared keep-alive connection, connecting first if needed.
+ * Read the body from http.getStream(), then call http.end(); the connection stays
+ * open for the next request of this wake.
+ *
+ * @param http HTTPClient for this request
+ * @param uri Path and query, e.g. "/data/3.0/onecall?..."
+ * @return HTTP status code, or a negative HTTPC_ERROR_* code
+ */
+int apiGet(HTTPClient &http, const String &uri);
+
+/**
+ * Send a GET request on the shared connection without HTTPClient, so the response can
+ * be gzip-compressed and conditional. HTTPClient always asks for an identity encoding.
+ * On success read the body from apiBody(), then call apiEndRequest().
+ *
+ * @param uri Path and query
+ * @param etag Sent as If-None-Match (NULL or "" = none)
+ * @param lastModified Sent as If-Modified-Since (NULL or "" = none)
+ * @return HTTP status code (304 when the validators still match), or a negative HTTPC_ERROR_* code
+ */
+int apiRequest(const String &uri, const char *etag, const char *lastModified);
+
+/**
+ * Body of the response to apiRequest(), de-chunked and inflated.
+ */
+Stream &apiBody();
+
+/**
+ * ETag / Last-Modified of the response to apiRequest(), "" if the server sent none.
+ */
+const char *apiResponseETag();
+const char *apiResponseLastModified();
+
+/**
+ * Finish the apiRequest() response. The connection stays open if the whole body was read
+ * and the server allows keep-alive; a partly read body closes it instead of draining it.
+ */
+void apiEndRequest();
+
+/**
+ * Close the shared connection (e.g. after an incomplete read, or before WiFi is switched off).
+ */
+void apiClose();
+
+#endif // __API_CLIENT_H__
@@ -0,0 +1,243 @@
+/**
+ * Battery Monitor
+ *
+ * One reading per wake, taken before the radio is started: the median half of
+ * BATTERY_SAMPLES ADC conversions, converted with the Vref from an ADC characterization
+ * that is done once after power-on and kept in RTC memory. Everything else on the wake
+ * (low battery check, scheduler, status bar) uses that reading.
+ *
+ * Readings are also kept in a small discharge history in RTC memory, one entry per
+ * BATTERY_HISTORY_INTERVAL_SECS, from which the remaining runtime is predicted. A
+ * recharge starts a new history; a power-on (battery swapped) clears it.
+ */
+
+#include <Arduino.h>
+#include "esp_adc_cal.h"
+#include "battery.h"
+#include "rtc_budget.h"
+
+typedef struct {
+  uint16_t minutes;     // Since BatteryHistory.start
+  uint16_t millivolts;
+} BatteryHistoryEntry;
+
+typedef struct {
+  uint32_t magic;
+  uint16_t vref;        // ADC reference from the characterization (mV), 0 = not characterized
+  uint8_t  head;        // Index of the oldest entry
+  uint8_t  count;
+  uint32_t start;       // UTC the entry offsets count from
+  BatteryHistoryEntry entries[BATTERY_HISTORY_SIZE];
+} BatteryHistory;
+
+// Persists across deep sleep
+RTC_DATA_ATTR static BatteryHistory history;
+static_assert(sizeof(history) <= RTC_BUDGET_BATTERY, "battery history over its RTC allotment");
+
+static uint32_t wakeMillivolts = 0;
+static int      wakeRuntimeHours = -1;
+
+/**
+ * Start from an empty history after power-on or reset.
+ */
+static void ensureState() {
+  if (history.magic != BATTERY_MAGIC) {
+    memset(&history, 0, sizeof(history));
+    history.magic = BATTERY_MAGIC;
+  }
+}
+
+/**
+ * Characterize the ADC once; the eFuse Vref is used when the chip has one.
+ */
+static uint16_t adcVref() {
+  if (history.vref == 0) {
+    esp_adc_cal_characteristics_t adc_chars;
+#ifdef ESP32_S3_PLATFORM
+    // ESP32-S3 supports up to ADC_ATTEN_DB_11 (not ADC_ATTEN_DB_12 like ESP32)
+    esp_adc_cal_value_t val_type =
+      esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &adc_chars);
+#else
+    esp_adc_cal_value_t val_type =
+      esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_12, ADC_WIDTH_BIT_12, 1100, &adc_chars);
+#endif
+    history.vref = (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF) ? adc_chars.vref : 1100;
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("ADC Vref:%u mV (%s)\n", history.vref, (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF) ? "eFuse" : "default");
+    }
+#endif
+  }
+  return history.vref;
+}
+
+/**
+ * Raw ADC value of the battery pin: the mean of the middle half of BATTERY_SAMPLES
+ * sorted conversions, which drops the outliers on either side.
+ */
+static float readRaw(int pin) {
+  uint16_t samples[BATTERY_SAMPLES];
+  for (int i = 0; i < BATTERY_SAMPLES; i++) {
+    uint16_t value = analogRead(pin);
+    int j = i;
+    for (; j > 0 && samples[j - 1] > value; j--) { // Insertion sort as they come in
+      samples[j] = samples[j - 1];
+    }
+    samples[j] = value;
+  }
+  uint32_t sum = 0;
+  const int first = BATTERY_SAMPLES / 4, last = BATTERY_SAMPLES - BATTERY_SAMPLES / 4;
+  for (int i = first; i < last; i++) {
+    sum += samples[i];
+  }
+  return (float)sum / (last - first);
+}
+
+/**
+ * Convert the battery pin to a voltage.
+ *
+ * ESP32 (5 Button dev kit): GPIO36 (ADC1_CH0) with voltage divider (6.566x scaling)
+ * ESP32-S3 (3 Button dev kit): GPIO14 with voltage divider (0.5x scaling, then 2x multiplier)
+ */
+static uint32_t readMillivolts() {
+  const float vref = adcVref();
+#ifdef ESP32_S3_PLATFORM
+  const int batteryPin = 14;  // GPIO14 = Battery ADC on ESP32-S3
+
+  // Calibration multiplier - adjust based on actual vs measured voltage
+  // Calculated from: actual_voltage / measured_voltage
+  // Example: if actual is 3.952V and measured is 3.4V, multiplier = 1.162
+  const float CALIBRATION_MULTIPLIER = 1.162f;
+
+  // For ATTEN_DB_11 on ESP32-S3, full scale is approximately 3.0V
+  // Formula: adcVoltage = (rawValue / 4095.0) * 3.0V * (vref / 1100.0)
+  // Then: batteryVoltage = adcVoltage * 2.0 (to account for 0.5x divider)
+  float adcVoltage = (readRaw(batteryPin) / 4095.0) * 3.0 * (vref / 1100.0);
+  float voltage = adcVoltage * 2.0 * CALIBRATION_MULTIPLIER;
+#else
+  const int batteryPin = 36;  // GPIO36 = ADC1_CH0 on ESP32
+
+  // Formula: voltage = (rawValue / 4096.0) * 6.566 * (vref / 1000.0)
+  float voltage = readRaw(batteryPin) / 4096.0 * 6.566 * (vref / 1000.0);
+#endif
+
+  if (voltage <= 1.0) {
+    // Voltage too low indicates battery monitoring hardware not available
+    return 0;
+  }
+  return (uint32_t)(voltage * 1000);
+}
+
+/**
+ * Add a reading to the discharge history, or start a new one after a recharge.
+ */
+static void recordHistory(time_t now, uint32_t millivolts) {
+  if (millivolts == 0 || now < 946684800) return; // No battery, or RTC not set
+  if (millivolts >= BATTERY_CHARGING_MV) {
+    history.count = 0;
+    return;
+  }
+
+  if (history.count > 0) {
+    const BatteryHistoryEntry &last = history.entries[(history.head + history.count - 1) % BATTERY_HISTORY_SIZE];
+    uint32_t lastTime = history.start + last.minutes * 60UL;
+    if (now < (time_t)lastTime) { // Clock went back: the offsets no longer hold
+      history.count = 0;
+    } else if (millivolts >= last.millivolts + (uint32_t)BATTERY_RECHARGE_MV) {
+      history.count = 0;
+    } else if (now - lastTime < BATTERY_HISTORY_INTERVAL_SECS - 60) { // A wake a little early still counts
+      return;
+    }
+  }
+
+  if (history.count == 0) {
+    history.head = 0;
+    history.start = now;
+  } else if (history.count == BATTERY_HISTORY_SIZE) {
+    history.head = (history.head + 1) % BATTERY_HISTORY_SIZE;
+    history.count--;
+  }
+
+  // Keep the offsets counting from the oldest entry so they fit 16 bits
+  uint32_t oldest = history.entries[history.head].minutes;
+  if (history.count > 0 && oldest > 0) {
+    for (int i = 0; i < history.count; i++) {
+      history.entries[(history.head + i) % BATTERY_HISTORY_SIZE].minutes -= oldest;
+    }
+    history.start += oldest * 60UL;
+  }
+  uint32_t minutes = (now - history.start) / 60;
+  if (minutes > 0xFFFF) { // Weeks since the oldest entry: start over
+    history.count = 0;
+    history.head = 0;
+    history.start = now;
+    minutes = 0;
+  }
+
+  BatteryHistoryEntry &entry = history.entries[(history.head + history.count) % BATTERY_HISTORY_SIZE];
+  entry.minutes = minutes;
+  entry.millivolts = millivolts;
+  history.count++;
+}
+
+/**
+ * Hours to empty from the charge's least squares slope over the history, -1 if unknown.
+ */
+static int predictRuntimeHours() {
+  if (wakeMillivolts == 0 || wakeMillivolts >= BATTERY_CHARGING_MV || history.count < 3) {
+    return -1;
+  }
+  const BatteryHistoryEntry &last = history.entries[(history.head + history.count - 1) % BATTERY_HISTORY_SIZE];
+  if (last.minutes < BATTERY_HISTORY_MIN_HOURS * 60) {
+    return -1;
+  }
+
+  // Least squares fit of charge (percent) over time (hours), about the means so the
+  // sums stay small in float
+  float meanT = 0, meanC = 0;
+  for (int i = 0; i < history.count; i++) {
+    const BatteryHistoryEntry &entry = history.entries[(history.head + i) % BATTERY_HISTORY_SIZE];
+    meanT += entry.minutes / 60.0f;
+    meanC += batteryCharge(entry.millivolts);
+  }
+  meanT /= history.count;
+  meanC /= history.count;
+  float sumTT = 0, sumTC = 0;
+  for (int i = 0; i < history.count; i++) {
+    const BatteryHistoryEntry &entry = history.entries[(history.head + i) % BATTERY_HISTORY_SIZE];
+    float t = entry.minutes / 60.0f - meanT;
+    sumTT += t * t;
+    sumTC += t * (batteryCharge(entry.millivolts) - meanC);
+  }
+  if (sumTT <= 0) {
+    return -1;
+  }
+  float slope = sumTC / sumTT; // Percent per hour
+  if (slope >= -0.01f) { // Not discharging measurably (over 10000 h to go)
+    return -1;
+  }
+  float hours = batteryCharge(wakeMillivolts) / -slope;
+  return (hours > 9999) ? 9999 : (int)hours;
+}
+
+uint32_t batterySample(time_t now) {
+  ensureState();
+  wakeMillivolts = readMillivolts();
+  recordHistory(now, wakeMillivolts);
+  wakeRuntimeHours = predictRuntimeHours();
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Battery %lu mV, history %u entries, runtime %d h\n", (unsigned long)wakeMillivolts,
+                  history.count, wakeRuntimeHours);
+  }
+#endif
+  return wakeMillivolts;
+}
+
+uint32_t batteryMillivolts() {
+  return wakeMillivolts;
+}
+
+int batteryRuntimeHours() {
+  return wakeRuntimeHours;
+}
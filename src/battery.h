@@ -0,0 +1,75 @@
+#ifndef __BATTERY_H__
+#define __BATTERY_H__
+
+#include <Arduino.h>
+#include <time.h>
+
+// ADC conversions per reading; the middle half of them (sorted) is averaged
+#ifndef BATTERY_SAMPLES
+#define BATTERY_SAMPLES 16
+#endif
+
+// Discharge history: at most one entry per interval, kept in RTC memory
+#ifndef BATTERY_HISTORY_INTERVAL_SECS
+#define BATTERY_HISTORY_INTERVAL_SECS 3600
+#endif
+#define BATTERY_HISTORY_SIZE 48          // Entries (2 days at the default interval)
+#define BATTERY_HISTORY_MIN_HOURS 6      // Span of the history before a runtime is predicted
+#define BATTERY_RECHARGE_MV 100          // A rise this large over the last entry starts a new discharge
+
+#define BATTERY_CUTOFF_MV   3200         // Low battery screen at or below this
+#define BATTERY_FULL_MV     4200         // 100% at or above this
+#define BATTERY_CHARGING_MV 4350         // Above this the charger is connected
+
+#define BATTERY_MAGIC 0x42415454  // "BATT" in hex
+
+/**
+ * Take this wake's battery reading: BATTERY_SAMPLES ADC conversions, sorted, with the
+ * middle half averaged, so a single noisy conversion does not move the result. The ADC
+ * characterization is done on the first reading after power-on and kept in RTC memory.
+ * Call once per wake before WiFi is started (the radio draws current, and on the S3 the
+ * battery pin is on ADC2, which is unavailable while WiFi is on).
+ *
+ * The reading is added to the discharge history if BATTERY_HISTORY_INTERVAL_SECS have
+ * passed since the last entry (and the RTC is set); a rise of BATTERY_RECHARGE_MV or a
+ * charging voltage clears the history, since a new discharge starts.
+ *
+ * @param now Current UTC time (RTC)
+ * @return Battery voltage in millivolts, or 0 if no battery monitoring hardware
+ */
+uint32_t batterySample(time_t now);
+
+/**
+ * Reading taken by batterySample() on this wake.
+ *
+ * @return Battery voltage in millivolts, or 0 if unavailable or not sampled yet
+ */
+uint32_t batteryMillivolts();
+
+/**
+ * Remaining runtime predicted by batterySample() from the discharge history: the least
+ * squares slope of charge over time, extrapolated from the current charge to empty.
+ *
+ * @return Hours until the cutoff, or -1 if the history is too short, the charge is not
+ *         falling, or the battery is charging
+ */
+int batteryRuntimeHours();
+
+/**
+ * State of charge for a voltage: a polynomial fit of a typical Li-ion discharge curve
+ * between BATTERY_CUTOFF_MV (0%) and BATTERY_FULL_MV (100%).
+ *
+ * @param millivolts Battery voltage (0 = unknown, reported as 100%)
+ * @return Charge in percent, 0-100
+ */
+inline float batteryCharge(uint32_t millivolts) {
+  if (millivolts == 0 || millivolts >= BATTERY_FULL_MV) return 100;
+  if (millivolts <= BATTERY_CUTOFF_MV) return 0;
+  // In double: the terms are around 10^6 and cancel down to 0-100
+  double v = millivolts / 1000.0;
+  double charge = 2836.9625 * pow(v, 4) - 43987.4889 * pow(v, 3) + 255233.8134 * pow(v, 2) -
+                  656689.7123 * v + 632041.7303;
+  return (charge > 100) ? 100 : ((charge < 0) ? 0 : (float)charge);
+}
+
+#endif // __BATTERY_H__
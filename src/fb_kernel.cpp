@@ -0,0 +1,401 @@
+/**
+ * Framebuffer Kernel
+ *
+ * The EPD driver draws everything through epd_draw_pixel(), which works out the byte
+ * and nibble of each pixel and clips it on its own. Here shapes are clipped once and
+ * broken into horizontal spans: the odd pixel at either end of a span is written as a
+ * nibble and the bytes in between are stored 32 bits at a time. The framebuffer is in
+ * PSRAM on both boards, so fewer, wider stores are what matters; the S3's 128-bit PIE
+ * stores gain nothing over that for spans this short.
+ *
+ * The anti-aliased line and curve compute, per pixel, how much of it the shape covers in
+ * Q16 fixed point and blend the color in by that fraction.
+ */
+
+#include <Arduino.h>
+#include <epd_driver.h>
+#include "fb_kernel.h"
+
+#define FB_ROW_BYTES (EPD_WIDTH / 2)
+
+static inline void swapInt(int &a, int &b) {
+  int t = a;
+  a = b;
+  b = t;
+}
+
+/**
+ * Set count bytes, whole words where the destination is word aligned.
+ */
+static inline void fillBytes(uint8_t *p, int count, uint8_t value) {
+  while (count > 0 && ((uintptr_t)p & 3)) {
+    *p++ = value;
+    count--;
+  }
+  uint32_t word = value * 0x01010101UL;
+  uint32_t *w = (uint32_t *)p;
+  for (; count >= 4; count -= 4) {
+    *w++ = word;
+  }
+  p = (uint8_t *)w;
+  while (count-- > 0) {
+    *p++ = value;
+  }
+}
+
+/**
+ * Fill pixels x .. x1 - 1 of a row (already clipped, x < x1) with a 4-bit gray.
+ */
+static inline void fillSpan(uint8_t *row, int x, int x1, uint8_t nibble) {
+  if (x & 1) {
+    row[x / 2] = (row[x / 2] & 0x0F) | (nibble << 4);
+    x++;
+  }
+  if (x1 & 1) {
+    row[x1 / 2] = (row[x1 / 2] & 0xF0) | nibble;
+    x1--;
+  }
+  if (x < x1) {
+    fillBytes(row + x / 2, (x1 - x) / 2, nibble | (nibble << 4));
+  }
+}
+
+void fbHLine(uint8_t *fb, int x, int y, int length, uint8_t color) {
+  if (y < 0 || y >= EPD_HEIGHT || length <= 0) return;
+  int x1 = x + length;
+  if (x < 0) x = 0;
+  if (x1 > EPD_WIDTH) x1 = EPD_WIDTH;
+  if (x >= x1) return;
+  fillSpan(fb + y * FB_ROW_BYTES, x, x1, color >> 4);
+}
+
+void fbVLine(uint8_t *fb, int x, int y, int length, uint8_t color) {
+  if (x < 0 || x >= EPD_WIDTH || length <= 0) return;
+  int y1 = y + length;
+  if (y < 0) y = 0;
+  if (y1 > EPD_HEIGHT) y1 = EPD_HEIGHT;
+  uint8_t keep = (x & 1) ? 0x0F : 0xF0;
+  uint8_t set  = (x & 1) ? (color & 0xF0) : (color >> 4);
+  uint8_t *p = fb + y * FB_ROW_BYTES + x / 2;
+  for (; y < y1; y++, p += FB_ROW_BYTES) {
+    *p = (*p & keep) | set;
+  }
+}
+
+void fbFillRect(uint8_t *fb, int x, int y, int w, int h, uint8_t color) {
+  int x1 = x + w, y1 = y + h;
+  if (x < 0) x = 0;
+  if (y < 0) y = 0;
+  if (x1 > EPD_WIDTH) x1 = EPD_WIDTH;
+  if (y1 > EPD_HEIGHT) y1 = EPD_HEIGHT;
+  if (x >= x1) return;
+  uint8_t *row = fb + y * FB_ROW_BYTES;
+  for (; y < y1; y++, row += FB_ROW_BYTES) {
+    fillSpan(row, x, x1, color >> 4);
+  }
+}
+
+void fbDrawRect(uint8_t *fb, int x, int y, int w, int h, uint8_t color) {
+  fbHLine(fb, x, y, w, color);
+  fbHLine(fb, x, y + h - 1, w, color);
+  fbVLine(fb, x, y, h, color);
+  fbVLine(fb, x + w - 1, y, h, color);
+}
+
+void fbFillCircle(uint8_t *fb, int x0, int y0, int r, uint8_t color) {
+  // epd_fill_circle() fills columns; the midpoint circle is symmetric about its
+  // diagonals, so the same pixels come out as rows, which are spans
+  fbHLine(fb, x0 - r, y0, 2 * r + 1, color);
+  int f = 1 - r;
+  int ddF_x = 1;
+  int ddF_y = -2 * r;
+  int x = 0;
+  int y = r;
+  int px = x;
+  int py = y;
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (x < (y + 1)) {
+      fbHLine(fb, x0 - y, y0 + x, 2 * y + 1, color);
+      fbHLine(fb, x0 - y, y0 - x, 2 * y + 1, color);
+    }
+    if (y != py) {
+      fbHLine(fb, x0 - px, y0 + py, 2 * px + 1, color);
+      fbHLine(fb, x0 - px, y0 - py, 2 * px + 1, color);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void fbFillTriangle(uint8_t *fb, int x0, int y0, int x1, int y1, int x2, int y2, uint8_t color) {
+  int a, b, y, last;
+
+  // Sort coordinates by Y order (y2 >= y1 >= y0)
+  if (y0 > y1) {
+    swapInt(y0, y1);
+    swapInt(x0, x1);
+  }
+  if (y1 > y2) {
+    swapInt(y2, y1);
+    swapInt(x2, x1);
+  }
+  if (y0 > y1) {
+    swapInt(y0, y1);
+    swapInt(x0, x1);
+  }
+
+  if (y0 == y2) { // All on the same line
+    a = b = x0;
+    if (x1 < a) a = x1;
+    else if (x1 > b) b = x1;
+    if (x2 < a) a = x2;
+    else if (x2 > b) b = x2;
+    fbHLine(fb, a, y0, b - a + 1, color);
+    return;
+  }
+
+  int dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+  int sa = 0, sb = 0;
+
+  // Upper part: include scanline y1 only for a flat-bottomed triangle
+  last = (y1 == y2) ? y1 : y1 - 1;
+  for (y = y0; y <= last; y++) {
+    a = x0 + sa / dy01;
+    b = x0 + sb / dy02;
+    sa += dx01;
+    sb += dx02;
+    if (a > b) swapInt(a, b);
+    fbHLine(fb, a, y, b - a + 1, color);
+  }
+
+  // Lower part
+  sa = dx12 * (y - y1);
+  sb = dx02 * (y - y0);
+  for (; y <= y2; y++) {
+    a = x1 + sa / dy12;
+    b = x0 + sb / dy02;
+    sa += dx12;
+    sb += dx02;
+    if (a > b) swapInt(a, b);
+    fbHLine(fb, a, y, b - a + 1, color);
+  }
+}
+
+/**
+ * Per-lane minimum of four 4-bit values, one in the low nibble of each byte.
+ * Lane a | 0x10 minus lane b cannot borrow into the next lane; bit 4 is left set where a >= b.
+ */
+static inline uint32_t minLanes(uint32_t a, uint32_t b) {
+  uint32_t takeB = ((((a | 0x10101010UL) - b) & 0x10101010UL) >> 4) * 0x0F;
+  return a ^ ((a ^ b) & takeB);
+}
+
+static inline uint32_t darkenWord(uint32_t d, uint32_t s) {
+  return minLanes(d & 0x0F0F0F0FUL, s & 0x0F0F0F0FUL) | (minLanes((d >> 4) & 0x0F0F0F0FUL, (s >> 4) & 0x0F0F0F0FUL) << 4);
+}
+
+static inline uint8_t darkenByte(uint8_t d, uint8_t s) {
+  uint8_t lo = ((s & 0x0F) < (d & 0x0F)) ? (s & 0x0F) : (d & 0x0F);
+  uint8_t hi = ((s & 0xF0) < (d & 0xF0)) ? (s & 0xF0) : (d & 0xF0);
+  return hi | lo;
+}
+
+/**
+ * Darken count framebuffer bytes with image bytes, a word at a time once the
+ * framebuffer is aligned; all-white image words are skipped.
+ */
+static void darkenBytes(uint8_t *dst, const uint8_t *src, int count) {
+  while (count > 0 && ((uintptr_t)dst & 3)) {
+    *dst = darkenByte(*dst, *src);
+    dst++;
+    src++;
+    count--;
+  }
+  for (; count >= 4; count -= 4, dst += 4, src += 4) {
+    uint32_t s;
+    memcpy(&s, src, sizeof(s)); // The image need not be aligned
+    if (s == 0xFFFFFFFFUL) continue;
+    *(uint32_t *)dst = darkenWord(*(uint32_t *)dst, s);
+  }
+  while (count-- > 0) {
+    *dst = darkenByte(*dst, *src);
+    dst++;
+    src++;
+  }
+}
+
+void fbBlitDarken(uint8_t *fb, int x, int y, const uint8_t *image, int width, int height) {
+  const int rowBytes = width / 2;
+  const bool inside = x >= 0 && x + width <= EPD_WIDTH;
+  uint8_t shifted[FB_ROW_BYTES + 1];
+
+  for (int row = 0; row < height; row++) {
+    int yy = y + row;
+    if (yy < 0 || yy >= EPD_HEIGHT) continue;
+    const uint8_t *src = image + row * rowBytes;
+
+    if (inside && (x & 1) == 0) {
+      darkenBytes(fb + yy * FB_ROW_BYTES + x / 2, src, rowBytes);
+    } else if (inside) {
+      // Move the row a pixel right so its nibbles line up with the framebuffer's, white on both ends
+      shifted[0] = (src[0] << 4) | 0x0F;
+      for (int i = 1; i < rowBytes; i++) {
+        shifted[i] = (src[i - 1] >> 4) | (src[i] << 4);
+      }
+      shifted[rowBytes] = (src[rowBytes - 1] >> 4) | 0xF0;
+      darkenBytes(fb + yy * FB_ROW_BYTES + x / 2, shifted, rowBytes + 1);
+    } else {
+      // Partly off screen: pixel by pixel
+      for (int px = 0; px < width; px++) {
+        int xx = x + px;
+        if (xx < 0 || xx >= EPD_WIDTH) continue;
+        uint8_t s = (px & 1) ? (src[px / 2] >> 4) : (src[px / 2] & 0x0F);
+        if (s == 0x0F) continue;
+        uint8_t *p = &fb[yy * FB_ROW_BYTES + xx / 2];
+        if (xx & 1) {
+          if (s < (*p >> 4)) *p = (*p & 0x0F) | (s << 4);
+        } else {
+          if (s < (*p & 0x0F)) *p = (*p & 0xF0) | s;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Blend color (a 4-bit gray) into pixel (x, y) by coverage (Q16, 65536 = the whole pixel).
+ */
+static inline void blendPixel(uint8_t *fb, int x, int y, uint8_t level, int32_t coverage) {
+  if (x < 0 || x >= EPD_WIDTH || y < 0 || y >= EPD_HEIGHT || coverage <= 0) return;
+  uint8_t *p = &fb[y * FB_ROW_BYTES + x / 2];
+  int shift = (x & 1) ? 4 : 0;
+  int gray = (*p >> shift) & 0x0F;
+  if (coverage >= 65536) {
+    gray = level;
+  } else if (level < gray) {
+    gray -= ((gray - level) * coverage + 32768) >> 16;
+  } else {
+    gray += ((level - gray) * coverage + 32768) >> 16;
+  }
+  *p = (*p & ~(0x0F << shift)) | (gray << shift);
+}
+
+static inline int32_t clampCoverage(int64_t value) {
+  return value < 0 ? 0 : (value > 65536 ? 65536 : (int32_t)value);
+}
+
+/**
+ * Integer square root (rounded down).
+ */
+static uint32_t isqrt64(uint64_t n) {
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > n) bit >>= 2;
+  while (bit) {
+    if (n >= root + bit) {
+      n -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+void fbThickLineAA(uint8_t *fb, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t width, uint8_t color) {
+  int64_t dx = x1 - x0, dy = y1 - y0;
+  int32_t length = isqrt64(dx * dx + dy * dy);
+  if (length == 0) return;
+  // Unit vector along the line; each pixel's distance along it and across it then
+  // changes by a constant per column
+  int32_t ux = (dx * 65536) / length;
+  int32_t uy = (dy * 65536) / length;
+  int32_t half = width / 2;
+  int32_t reach = half + 65536;
+
+  int left   = ((x0 < x1 ? x0 : x1) - reach) >> 16;
+  int right  = ((x0 > x1 ? x0 : x1) + reach) >> 16;
+  int top    = ((y0 < y1 ? y0 : y1) - reach) >> 16;
+  int bottom = ((y0 > y1 ? y0 : y1) + reach) >> 16;
+  if (left < 0) left = 0;
+  if (top < 0) top = 0;
+  if (right >= EPD_WIDTH) right = EPD_WIDTH - 1;
+  if (bottom >= EPD_HEIGHT) bottom = EPD_HEIGHT - 1;
+  const uint8_t level = color >> 4;
+
+  for (int py = top; py <= bottom; py++) {
+    int64_t rx = (int64_t)left * 65536 + 32768 - x0;
+    int64_t ry = (int64_t)py * 65536 + 32768 - y0;
+    int32_t along  = (rx * ux + ry * uy) >> 16;
+    int32_t across = (rx * uy - ry * ux) >> 16;
+    for (int px = left; px <= right; px++, along += ux, across += uy) {
+      int32_t side = half + 32768 - (across < 0 ? -across : across);
+      if (side <= 0) continue;
+      int32_t end = (along < length - along ? along : length - along) + 32768;
+      if (end <= 0) continue;
+      blendPixel(fb, px, py, level, ((int64_t)clampCoverage(side) * clampCoverage(end)) >> 16);
+    }
+  }
+}
+
+/**
+ * Catmull-Rom slope (Q16) at point k: from its neighbours, one-sided at the ends.
+ */
+static int64_t curveSlope(const FbPoint *points, int count, int k) {
+  int previous = k > 0 ? k - 1 : k;
+  int next = k < count - 1 ? k + 1 : k;
+  int64_t run = points[next].x - points[previous].x;
+  if (run <= 0) return 0;
+  return ((int64_t)(points[next].y - points[previous].y) * 65536) / run;
+}
+
+void fbCurveAA(uint8_t *fb, const FbPoint *points, int count, int32_t width, uint8_t color) {
+  const int32_t half = width / 2;
+  const uint8_t level = color >> 4;
+
+  for (int i = 0; i < count - 1; i++) {
+    const FbPoint &p0 = points[i];
+    const FbPoint &p1 = points[i + 1];
+    int64_t h = p1.x - p0.x;
+    if (h <= 0) continue;
+
+    // Cubic Hermite segment y(u) = ((a u + b) u + c) u + d for u = 0 .. 1 (Q16)
+    int64_t hm0 = (h * curveSlope(points, count, i)) >> 16;
+    int64_t hm1 = (h * curveSlope(points, count, i + 1)) >> 16;
+    int64_t dy = p1.y - p0.y;
+    int64_t a = -2 * dy + hm0 + hm1;
+    int64_t b = 3 * dy - 2 * hm0 - hm1;
+    int64_t c = hm0;
+    int64_t d = p0.y;
+
+    // Columns whose centers lie in [p0.x, p1.x), so consecutive segments tile exactly
+    int first = (p0.x - 32768 + 65535) >> 16;
+    int last = (p1.x - 32768 + 65535) >> 16;
+    if (first < 0) first = 0;
+    if (last > EPD_WIDTH) last = EPD_WIDTH;
+    for (int col = first; col < last; col++) {
+      int64_t u = (((int64_t)col * 65536 + 32768 - p0.x) * 65536) / h;
+      int64_t y = ((((((a * u) >> 16) + b) * u) >> 16) + c) * u;
+      y = (y >> 16) + d;
+      int64_t slope = (((((3 * a * u) >> 16) + 2 * b) * u >> 16) + c) * 65536 / h;
+
+      // The column cuts the line over its width / cos(angle) = width * sqrt(1 + slope^2)
+      int64_t reach = ((int64_t)half * isqrt64((1ULL << 32) + (uint64_t)(slope * slope))) >> 16;
+      int64_t top = y - reach, bottom = y + reach;
+      for (int row = (int)(top >> 16); row <= (int)((bottom - 1) >> 16); row++) {
+        int64_t rowTop = (int64_t)row * 65536;
+        int64_t covered = (bottom < rowTop + 65536 ? bottom : rowTop + 65536) - (top > rowTop ? top : rowTop);
+        blendPixel(fb, col, row, level, clampCoverage(covered));
+      }
+    }
+  }
+}
@@ -0,0 +1,84 @@
+#ifndef __FB_KERNEL_H__
+#define __FB_KERNEL_H__
+
+#include <Arduino.h>
+
+// 1 = the renderer's fills, lines and blits use these routines, 0 = the EPD driver's
+// per-pixel functions (for comparing the two in the native benchmark)
+#ifndef FB_KERNEL
+#define FB_KERNEL 1
+#endif
+
+/**
+ * Framebuffer kernel: span-based drawing into the 4bpp framebuffer (EPD_WIDTH x EPD_HEIGHT,
+ * two pixels per byte, even x in the low nibble). Pixels come out exactly as the EPD
+ * driver's functions draw them: the color's high nibble is written, and pixels outside
+ * the screen are skipped. Rows are filled a 32-bit word at a time; only the half-byte at
+ * either end of a span is handled on its own.
+ */
+
+/**
+ * Horizontal line from (x, y), length pixels to the right.
+ */
+void fbHLine(uint8_t *fb, int x, int y, int length, uint8_t color);
+
+/**
+ * Vertical line from (x, y), length pixels down.
+ */
+void fbVLine(uint8_t *fb, int x, int y, int length, uint8_t color);
+
+/**
+ * Filled rectangle.
+ */
+void fbFillRect(uint8_t *fb, int x, int y, int w, int h, uint8_t color);
+
+/**
+ * Rectangle outline, 1 pixel wide.
+ */
+void fbDrawRect(uint8_t *fb, int x, int y, int w, int h, uint8_t color);
+
+/**
+ * Filled circle, the same pixels as epd_fill_circle().
+ */
+void fbFillCircle(uint8_t *fb, int x0, int y0, int r, uint8_t color);
+
+/**
+ * Filled triangle, the same pixels as epd_fill_triangle().
+ */
+void fbFillTriangle(uint8_t *fb, int x0, int y0, int x1, int y1, int x2, int y2, uint8_t color);
+
+/**
+ * Combine a 4bpp image (same layout as the framebuffer, width even) into the framebuffer,
+ * keeping the darker of each pair of pixels, so white is transparent. Eight pixels are
+ * compared at once; an image at an odd column is shifted by a nibble per row first.
+ */
+void fbBlitDarken(uint8_t *fb, int x, int y, const uint8_t *image, int width, int height);
+
+/**
+ * Anti-aliased lines and curves. Coordinates are Q16 fixed point (pixels * 65536, pixel
+ * centers at +0.5), and the color is blended over what is already there in proportion to
+ * how much of each pixel the shape covers, so edges use the panel's intermediate grays.
+ * Everything is integer arithmetic.
+ */
+#define FB_Q16(v) ((int32_t)(v) * 65536)
+
+typedef struct {
+  int32_t x;  // Q16
+  int32_t y;  // Q16
+} FbPoint;
+
+/**
+ * Straight line of the given width (Q16) from (x0, y0) to (x1, y1), with square ends
+ * at the two points.
+ */
+void fbThickLineAA(uint8_t *fb, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t width, uint8_t color);
+
+/**
+ * Smooth curve of the given width (Q16) through count points with increasing x: a
+ * Catmull-Rom spline (each point's slope taken from its two neighbours), drawn from the
+ * first point's x to the last's. Every column is filled once, so the curve is blended
+ * in a single pass without darker joints between segments.
+ */
+void fbCurveAA(uint8_t *fb, const FbPoint *points, int count, int32_t width, uint8_t color);
+
+#endif // __FB_KERNEL_H__
@@ -0,0 +1,78 @@
+/**
+ * Fetch Backoff
+ *
+ * Error budget for network failures. A failed fetch is retried on a short sleep that
+ * grows exponentially (with jitter) rather than straight away on the same wake, and after
+ * BACKOFF_MAX_FAILURES failures in a row a circuit breaker stops radio attempts until the
+ * next scheduled interval, so a dead access point costs one attempt per interval.
+ * The state is kept in RTC memory; a power-on starts with a closed breaker.
+ */
+
+#include <Arduino.h>
+#include "fetch_backoff.h"
+#include "settings.h"
+#include "rtc_budget.h"
+
+// Persist across deep sleep; cleared on power-on reset
+RTC_DATA_ATTR static uint16_t failures = 0;
+RTC_DATA_ATTR static int32_t  openUntil = 0;  // UTC before which the open breaker keeps the radio off
+static_assert(sizeof(failures) + sizeof(openUntil) <= RTC_BUDGET_FETCH_BACKOFF, "backoff state over its RTC allotment");
+
+static bool failedThisWake = false;
+
+void backoffSuccess() {
+#if DEBUG_LEVEL
+  if (Serial && failures) {
+    Serial.printf("Fetch succeeded after %u failures\n", failures);
+  }
+#endif
+  failures = 0;
+  openUntil = 0;
+  failedThisWake = false;
+}
+
+void backoffFailure() {
+  if (failures < 0xFFFF) failures++;
+  failedThisWake = true;
+}
+
+int backoffFailures() {
+  return failures;
+}
+
+bool backoffAllowAttempt(time_t now) {
+  if (failures < BACKOFF_MAX_FAILURES || now < 946684800) { // RTC not set: nothing to compare with
+    return true;
+  }
+  // A wake that lands a little early on the interval still counts as reaching it
+  return now >= openUntil - 120;
+}
+
+long backoffSleepSeconds(long scheduledSecs, time_t now) {
+  if (!failedThisWake) {
+    return scheduledSecs;
+  }
+
+  if (failures >= BACKOFF_MAX_FAILURES) {
+    openUntil = now + scheduledSecs;
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("Circuit breaker open after %u failures, next attempt in %ld s\n", failures, scheduledSecs);
+    }
+#endif
+    return scheduledSecs;
+  }
+
+  // Exponential delay with "equal jitter": half fixed, half random
+  long delaySecs = (long)BACKOFF_BASE_SECS << (failures - 1);
+  if (delaySecs > BACKOFF_MAX_SECS) delaySecs = BACKOFF_MAX_SECS;
+  delaySecs = delaySecs / 2 + (long)(esp_random() % (uint32_t)(delaySecs / 2 + 1));
+  if (delaySecs > scheduledSecs) delaySecs = scheduledSecs;
+
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Fetch failure %u, retrying in %ld s\n", failures, delaySecs);
+  }
+#endif
+  return delaySecs;
+}
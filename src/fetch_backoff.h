@@ -0,0 +1,59 @@
+#ifndef __FETCH_BACKOFF_H__
+#define __FETCH_BACKOFF_H__
+
+#include <Arduino.h>
+#include <time.h>
+
+// Sleep before the first retry after a failed fetch; doubled on each further failure
+#ifndef BACKOFF_BASE_SECS
+#define BACKOFF_BASE_SECS 60
+#endif
+
+// Longest retry sleep (retries never sleep longer than the scheduled interval either)
+#ifndef BACKOFF_MAX_SECS
+#define BACKOFF_MAX_SECS 900
+#endif
+
+// Consecutive failures that open the circuit breaker: no more retries, and no radio at
+// all until the next scheduled interval has passed
+#ifndef BACKOFF_MAX_FAILURES
+#define BACKOFF_MAX_FAILURES 4
+#endif
+
+/**
+ * Record a successful fetch: the failure count is cleared and the breaker closed.
+ */
+void backoffSuccess();
+
+/**
+ * Record a failed fetch (WiFi, connection or response), to be retried by backoffSleepSeconds().
+ */
+void backoffFailure();
+
+/**
+ * Consecutive failed fetches up to now (0 after a success).
+ */
+int backoffFailures();
+
+/**
+ * Whether the radio may be used on this wake: always, unless the circuit breaker is open
+ * and the interval it was opened for has not passed yet (e.g. a button wake).
+ *
+ * @param now Current UTC time (0 or unset RTC: allowed)
+ */
+bool backoffAllowAttempt(time_t now);
+
+/**
+ * Sleep before the next wake. After a failure on this wake that is a retry: an
+ * exponential backoff from BACKOFF_BASE_SECS with random jitter, so displays that failed
+ * together do not retry together, capped at the scheduled sleep. After
+ * BACKOFF_MAX_FAILURES failures in a row the breaker opens and the scheduled sleep is
+ * kept; the next wake tries once more, and a failure then reopens it.
+ *
+ * @param scheduledSecs Sleep chosen by the scheduler
+ * @param now Current UTC time
+ * @return Seconds to sleep
+ */
+long backoffSleepSeconds(long scheduledSecs, time_t now);
+
+#endif // __FETCH_BACKOFF_H__
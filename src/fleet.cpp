@@ -0,0 +1,297 @@
+/**
+ * Fleet
+ *
+ * Lets several displays at one site share a single forecast fetch. A mains-powered
+ * gateway fetches and decodes as usual, then keeps its radio listening for ESP-NOW
+ * requests instead of sleeping. A battery display wakes, broadcasts one request on the
+ * access point's channel and receives the packed forecast records unicast from the
+ * gateway (a few ESP-NOW frames, acknowledged and retried by the MAC), without
+ * associating or running DHCP, TLS or the decoder. A display that hears nothing within
+ * FLEET_LISTEN_MS fetches over HTTP as a stand-alone unit would.
+ *
+ * ESP-NOW frames are not authenticated: anything on the channel could answer a request.
+ * The forecast is checked for integrity (CRC) and for the display's own settings only.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <esp_rom_crc.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "fleet.h"
+#include "forecast_cache.h"
+
+#define FLEET_PACKET_REQUEST  1  // Display -> broadcast: header only
+#define FLEET_PACKET_FORECAST 2  // Gateway -> display: header and one fragment
+
+// Requests waiting for an answer on the gateway
+#define FLEET_REQUEST_QUEUE 4
+
+// How long the gateway waits for each frame to be acknowledged
+#define FLEET_SEND_TIMEOUT_MS 50
+
+typedef struct __attribute__((packed)) {
+  uint32_t magic;
+  uint8_t  type;         // FLEET_PACKET_*
+  uint8_t  index;        // Fragment number
+  uint8_t  count;        // Fragments making up the forecast
+  uint8_t  reserved;
+  uint32_t settingsKey;  // forecastSettingsKey() of the sender
+  uint32_t id;           // CRC32 of the whole forecast, identifies it across fragments
+  int32_t  clock;        // Sender's UTC clock
+} FleetHeader;
+
+typedef struct {
+  int32_t fetchTime;       // UTC
+  int32_t timezoneOffset;  // Seconds east of UTC
+  Forecast_record_type current;
+  Forecast_record_type hourly[max_hourly_readings];
+  Forecast_record_type daily[max_daily_readings];
+} FleetForecast;
+
+#define FLEET_FRAGMENT_SIZE   (ESP_NOW_MAX_DATA_LEN - sizeof(FleetHeader))
+#define FLEET_FRAGMENT_COUNT  ((sizeof(FleetForecast) + FLEET_FRAGMENT_SIZE - 1) / FLEET_FRAGMENT_SIZE)
+
+static_assert(FLEET_FRAGMENT_COUNT <= 32, "Fragments are tracked in a 32-bit mask");
+
+static const uint8_t broadcastAddress[ESP_NOW_ETH_ALEN] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+// Forecast being served (gateway) or reassembled (display)
+static FleetForecast forecast;
+static uint32_t forecastId;
+
+// Gateway: addresses of displays waiting for the forecast
+static QueueHandle_t requestQueue = NULL;
+static SemaphoreHandle_t sendDone = NULL;
+static volatile bool sendOk = false;
+
+// Display: fragments received so far of forecastId
+static SemaphoreHandle_t receiveDone = NULL;
+static volatile uint32_t receivedMask = 0;
+static volatile bool receiveComplete = false;
+static volatile int32_t gatewayClock = 0;
+
+static void fillHeader(FleetHeader *header, uint8_t type) {
+  memset(header, 0, sizeof(FleetHeader));
+  header->magic       = FLEET_MAGIC;
+  header->type        = type;
+  header->count       = FLEET_FRAGMENT_COUNT;
+  header->settingsKey = forecastSettingsKey();
+  header->id          = forecastId;
+  header->clock       = time(NULL);
+}
+
+/**
+ * Radio on in station mode on the fleet channel, without joining a network.
+ */
+static bool startRadio(uint8_t channel) {
+  WiFi.mode(WIFI_STA);
+  WiFi.disconnect();
+  esp_wifi_set_ps(WIFI_PS_NONE); // Listen all the time, not only at beacons
+  esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+  if (esp_now_init() != ESP_OK) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println("ESP-NOW init failed");
+    }
+#endif
+    WiFi.mode(WIFI_OFF);
+    return false;
+  }
+  return true;
+}
+
+static void stopRadio() {
+  esp_now_unregister_recv_cb();
+  esp_now_unregister_send_cb();
+  esp_now_deinit();
+  WiFi.mode(WIFI_OFF);
+}
+
+static bool addPeer(const uint8_t *address) {
+  if (esp_now_is_peer_exist(address)) {
+    return true;
+  }
+  esp_now_peer_info_t peer;
+  memset(&peer, 0, sizeof(peer));
+  memcpy(peer.peer_addr, address, ESP_NOW_ETH_ALEN);
+  peer.channel = 0; // The current channel
+  peer.ifidx   = WIFI_IF_STA;
+  peer.encrypt = false;
+  return esp_now_add_peer(&peer) == ESP_OK;
+}
+
+/**
+ * Gateway: queue requests for our settings (runs in the WiFi task).
+ */
+static void onRequest(const uint8_t *mac, const uint8_t *data, int length) {
+  const FleetHeader *header = (const FleetHeader *)data;
+  if (length != sizeof(FleetHeader) || header->magic != FLEET_MAGIC || header->type != FLEET_PACKET_REQUEST ||
+      header->settingsKey != forecastSettingsKey()) {
+    return;
+  }
+  xQueueSend(requestQueue, mac, 0); // Dropped if full; the display asks again
+}
+
+static void onSent(const uint8_t * /* mac */, esp_now_send_status_t status) {
+  sendOk = (status == ESP_NOW_SEND_SUCCESS);
+  xSemaphoreGive(sendDone);
+}
+
+/**
+ * Gateway: send every fragment of the forecast to one display.
+ * @return true if every frame was acknowledged
+ */
+static bool sendForecast(const uint8_t *address) {
+  if (!addPeer(address)) {
+    return false;
+  }
+  uint8_t packet[ESP_NOW_MAX_DATA_LEN];
+  FleetHeader *header = (FleetHeader *)packet;
+  const uint8_t *source = (const uint8_t *)&forecast;
+  bool ok = true;
+  for (uint8_t i = 0; i < FLEET_FRAGMENT_COUNT && ok; i++) {
+    size_t offset = i * FLEET_FRAGMENT_SIZE;
+    size_t size = min(FLEET_FRAGMENT_SIZE, sizeof(FleetForecast) - offset);
+    fillHeader(header, FLEET_PACKET_FORECAST);
+    header->index = i;
+    memcpy(packet + sizeof(FleetHeader), source + offset, size);
+    xSemaphoreTake(sendDone, 0);
+    ok = esp_now_send(address, packet, sizeof(FleetHeader) + size) == ESP_OK &&
+         xSemaphoreTake(sendDone, pdMS_TO_TICKS(FLEET_SEND_TIMEOUT_MS)) == pdTRUE && sendOk;
+  }
+  esp_now_del_peer(address);
+  return ok;
+}
+
+void fleetServe(uint8_t channel, uint32_t durationMs, const Forecast_record_type *current,
+                const Forecast_record_type *hourly, const Forecast_record_type *daily, time_t fetchTime,
+                int timezoneOffset) {
+  memset(&forecast, 0, sizeof(forecast));
+  forecast.fetchTime      = fetchTime;
+  forecast.timezoneOffset = timezoneOffset;
+  memcpy(&forecast.current, current, sizeof(forecast.current));
+  memcpy(forecast.hourly, hourly, sizeof(forecast.hourly));
+  memcpy(forecast.daily, daily, sizeof(forecast.daily));
+  forecastId = esp_rom_crc32_le(0, (const uint8_t *)&forecast, sizeof(forecast));
+
+  if (!requestQueue) requestQueue = xQueueCreate(FLEET_REQUEST_QUEUE, ESP_NOW_ETH_ALEN);
+  if (!sendDone) sendDone = xSemaphoreCreateBinary();
+  if (!requestQueue || !sendDone || !startRadio(channel)) {
+    return;
+  }
+  xQueueReset(requestQueue);
+  esp_now_register_send_cb(onSent);
+  esp_now_register_recv_cb(onRequest);
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Fleet gateway serving on channel %u for %lu s (%u fragments)\n", channel,
+                  (unsigned long)(durationMs / 1000), (unsigned)FLEET_FRAGMENT_COUNT);
+  }
+#endif
+
+  unsigned long start = millis();
+  uint8_t address[ESP_NOW_ETH_ALEN];
+  while (millis() - start < durationMs) {
+    uint32_t remaining = durationMs - (millis() - start);
+    if (xQueueReceive(requestQueue, address, pdMS_TO_TICKS(remaining)) != pdTRUE) {
+      continue;
+    }
+    bool sent = sendForecast(address);
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("Fleet forecast %s %02X:%02X:%02X:%02X:%02X:%02X\n", sent ? "sent to" : "not acknowledged by",
+                    address[0], address[1], address[2], address[3], address[4], address[5]);
+    }
+#else
+    (void)sent;
+#endif
+  }
+  stopRadio();
+}
+
+/**
+ * Display: store fragments of the forecast (runs in the WiFi task).
+ * A fragment of a different forecast starts the reassembly over.
+ */
+static void onForecast(const uint8_t * /* mac */, const uint8_t *data, int length) {
+  const FleetHeader *header = (const FleetHeader *)data;
+  if (receiveComplete || length <= (int)sizeof(FleetHeader) || header->magic != FLEET_MAGIC ||
+      header->type != FLEET_PACKET_FORECAST || header->count != FLEET_FRAGMENT_COUNT ||
+      header->index >= FLEET_FRAGMENT_COUNT || header->settingsKey != forecastSettingsKey()) {
+    return;
+  }
+  size_t offset = header->index * FLEET_FRAGMENT_SIZE;
+  size_t size = length - sizeof(FleetHeader);
+  if (size != min(FLEET_FRAGMENT_SIZE, sizeof(FleetForecast) - offset)) {
+    return;
+  }
+  if (header->id != forecastId) {
+    forecastId = header->id;
+    receivedMask = 0;
+  }
+  memcpy((uint8_t *)&forecast + offset, data + sizeof(FleetHeader), size);
+  receivedMask |= 1UL << header->index;
+  gatewayClock = header->clock;
+  if (receivedMask == (uint32_t)((1ULL << FLEET_FRAGMENT_COUNT) - 1)) {
+    if (esp_rom_crc32_le(0, (const uint8_t *)&forecast, sizeof(forecast)) == forecastId) {
+      receiveComplete = true;
+      xSemaphoreGive(receiveDone);
+    } else {
+      receivedMask = 0; // Mixed up fragments; wait for the next answer
+    }
+  }
+}
+
+bool fleetReceive(uint8_t channel, uint32_t timeoutMs, long maxAgeSecs, Forecast_record_type *current,
+                  Forecast_record_type *hourly, Forecast_record_type *daily, time_t *fetchTime,
+                  int *timezoneOffset, time_t *gatewayTime) {
+  if (!receiveDone) receiveDone = xSemaphoreCreateBinary();
+  if (!receiveDone || !startRadio(channel)) {
+    return false;
+  }
+  forecastId = 0;
+  receivedMask = 0;
+  receiveComplete = false;
+  xSemaphoreTake(receiveDone, 0);
+  esp_now_register_recv_cb(onForecast);
+
+  bool complete = false;
+  if (addPeer(broadcastAddress)) {
+    FleetHeader request;
+    unsigned long start = millis();
+    while (!complete && millis() - start < timeoutMs) {
+      fillHeader(&request, FLEET_PACKET_REQUEST);
+      esp_now_send(broadcastAddress, (const uint8_t *)&request, sizeof(request));
+      uint32_t wait = min((uint32_t)FLEET_REQUEST_RETRY_MS, (uint32_t)(timeoutMs - (millis() - start)));
+      complete = xSemaphoreTake(receiveDone, pdMS_TO_TICKS(wait)) == pdTRUE;
+    }
+  }
+  stopRadio(); // No more callbacks: the forecast buffer is ours
+
+#if DEBUG_LEVEL
+  if (Serial) {
+    if (complete) {
+      Serial.printf("Fleet forecast received (fetched %ld s ago)\n", (long)(gatewayClock - forecast.fetchTime));
+    } else {
+      Serial.printf("No fleet forecast within %lu ms\n", (unsigned long)timeoutMs);
+    }
+  }
+#endif
+  // A gateway that has not managed to update is no better than fetching
+  long age = (long)(gatewayClock - forecast.fetchTime);
+  if (!complete || age < 0 || age > maxAgeSecs) {
+    return false;
+  }
+
+  memcpy(current, &forecast.current, sizeof(forecast.current));
+  memcpy(hourly, forecast.hourly, sizeof(forecast.hourly));
+  memcpy(daily, forecast.daily, sizeof(forecast.daily));
+  *fetchTime      = forecast.fetchTime;
+  *timezoneOffset = forecast.timezoneOffset;
+  *gatewayTime    = gatewayClock;
+  return true;
+}
@@ -0,0 +1,64 @@
+#ifndef __FLEET_H__
+#define __FLEET_H__
+
+#include <Arduino.h>
+#include <time.h>
+#include "forecast_record.h"
+
+// settings.FleetRole
+#define FLEET_ROLE_STANDALONE 0  // Fetches its own forecast
+#define FLEET_ROLE_GATEWAY    1  // Fetches, then stays awake answering displays (mains powered)
+#define FLEET_ROLE_DISPLAY    2  // Asks the gateway first, fetches only if no answer arrives
+
+// How long a display waits for the gateway's forecast before fetching it itself
+#ifndef FLEET_LISTEN_MS
+#define FLEET_LISTEN_MS 400
+#endif
+
+// A display repeats its request this often until the forecast is complete
+#define FLEET_REQUEST_RETRY_MS 100
+
+// Channel used when no access point has been joined yet (displays and gateway must agree)
+#define FLEET_DEFAULT_CHANNEL 1
+
+#define FLEET_MAGIC 0x464C5431  // "FLT1" in hex
+
+/**
+ * Answer forecast requests from fleet displays over ESP-NOW until durationMs has passed.
+ * Takes the radio in station mode on the given channel without joining a network, and
+ * turns it off again before returning. Requests for other settings (location, units or
+ * language) are ignored.
+ *
+ * @param channel WiFi channel to listen on (the access point's, where the displays look)
+ * @param durationMs How long to serve
+ * @param current Current conditions record
+ * @param hourly Hourly forecast records (max_hourly_readings entries)
+ * @param daily Daily forecast records (max_daily_readings entries)
+ * @param fetchTime UTC time the forecast was fetched
+ * @param timezoneOffset Timezone offset in seconds reported by the API
+ */
+void fleetServe(uint8_t channel, uint32_t durationMs, const Forecast_record_type *current,
+                const Forecast_record_type *hourly, const Forecast_record_type *daily, time_t fetchTime,
+                int timezoneOffset);
+
+/**
+ * Request the forecast from the fleet gateway over ESP-NOW. The radio is on only for the
+ * request and is turned off before returning. The output arrays are only written when
+ * true is returned.
+ *
+ * @param channel WiFi channel the gateway listens on
+ * @param timeoutMs How long to wait for a complete forecast
+ * @param maxAgeSecs Oldest forecast accepted, by the gateway's clock
+ * @param current Current conditions record (output)
+ * @param hourly Hourly forecast records (output, max_hourly_readings entries)
+ * @param daily Daily forecast records (output, max_daily_readings entries)
+ * @param fetchTime UTC time the gateway fetched the forecast (output)
+ * @param timezoneOffset Timezone offset in seconds reported by the API (output)
+ * @param gatewayTime Gateway's UTC clock when it sent the forecast (output)
+ * @return true if a complete forecast for the current settings arrived in time and is fresh enough
+ */
+bool fleetReceive(uint8_t channel, uint32_t timeoutMs, long maxAgeSecs, Forecast_record_type *current,
+                  Forecast_record_type *hourly, Forecast_record_type *daily, time_t *fetchTime,
+                  int *timezoneOffset, time_t *gatewayTime);
+
+#endif // __FLEET_H__
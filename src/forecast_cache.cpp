@@ -0,0 +1,203 @@
+/**
+ * Forecast Cache
+ *
+ * Keeps the last decoded forecast in RTC slow memory so that wakes shorter than the
+ * configured maximum data age can redraw the display without powering the radio.
+ * The snapshot is a plain copy of the packed forecast records (~3.6 KB) plus the
+ * fetch time and response validators, protected by a CRC and keyed to the settings
+ * that shaped the request.
+ *
+ * With several locations (locations.h) each one's snapshot is also kept in flash, in
+ * the "forecasts" NVS partition, and copied into RTC memory when it is shown or fetched.
+ */
+
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+#include <Preferences.h>
+#include "forecast_cache.h"
+#include "settings.h"
+#include "rtc_budget.h"
+
+typedef struct {
+  uint32_t magic;
+  uint32_t crc;            // CRC32 of everything after this field
+  uint32_t settingsKey;    // CRC32 of the location/units/language the data was fetched for
+  int32_t  fetchTime;      // UTC
+  int32_t  timezoneOffset; // Seconds east of UTC
+  int32_t  wifiSignal;     // RSSI at fetch time
+  char     etag[API_VALIDATOR_LEN];         // Response validators, "" = not sent
+  char     lastModified[API_VALIDATOR_LEN];
+  Forecast_record_type current;
+  Forecast_record_type hourly[max_hourly_readings];
+  Forecast_record_type daily[max_daily_readings];
+} ForecastSnapshot;
+
+// Persists across deep sleep; cleared on power-on reset
+RTC_DATA_ATTR static ForecastSnapshot snapshot;
+static_assert(sizeof(snapshot) <= RTC_BUDGET_FORECAST_CACHE, "forecast snapshot over its RTC allotment");
+
+// NVS partition (partitions.csv) and namespace of the per-location snapshots
+#define FORECAST_SLOT_PARTITION "forecasts"
+#define FORECAST_SLOT_NAMESPACE "forecasts"
+
+/**
+ * NVS key of a location's snapshot: "loc0", "loc1"...
+ */
+static void slotKey(char *key, int slot) {
+  snprintf(key, 8, "loc%d", slot);
+}
+
+/**
+ * Compute the CRC of the snapshot contents following the crc field.
+ */
+static uint32_t snapshotCRC() {
+  const uint8_t *start = (const uint8_t *)&snapshot.settingsKey;
+  size_t len = sizeof(ForecastSnapshot) - offsetof(ForecastSnapshot, settingsKey);
+  return esp_rom_crc32_le(0, start, len);
+}
+
+uint32_t forecastSettingsKey() {
+  uint32_t key = 0;
+  key = esp_rom_crc32_le(key, (const uint8_t *)settings.Latitude, strlen(settings.Latitude));
+  key = esp_rom_crc32_le(key, (const uint8_t *)settings.Longitude, strlen(settings.Longitude));
+  key = esp_rom_crc32_le(key, (const uint8_t *)settings.Units, strlen(settings.Units));
+  key = esp_rom_crc32_le(key, (const uint8_t *)settings.Language, strlen(settings.Language));
+  return key;
+}
+
+void storeForecastSnapshot(const Forecast_record_type *current, const Forecast_record_type *hourly,
+                           const Forecast_record_type *daily, time_t fetchTime, int timezoneOffset, int wifiSignal,
+                           const char *etag, const char *lastModified) {
+  snapshot.settingsKey    = forecastSettingsKey();
+  snapshot.fetchTime      = fetchTime;
+  snapshot.timezoneOffset = timezoneOffset;
+  snapshot.wifiSignal     = wifiSignal;
+  strlcpy(snapshot.etag, etag, sizeof(snapshot.etag));
+  strlcpy(snapshot.lastModified, lastModified, sizeof(snapshot.lastModified));
+  memcpy(&snapshot.current, current, sizeof(snapshot.current));
+  memcpy(snapshot.hourly, hourly, sizeof(snapshot.hourly));
+  memcpy(snapshot.daily, daily, sizeof(snapshot.daily));
+  snapshot.crc   = snapshotCRC();
+  snapshot.magic = FORECAST_CACHE_MAGIC;
+
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Forecast snapshot stored in RTC memory (%u bytes)\n", (unsigned)sizeof(ForecastSnapshot));
+  }
+#endif
+}
+
+/**
+ * Whether the snapshot is intact and for the current settings; discards it if not.
+ */
+static bool snapshotUsable() {
+  if (snapshot.magic != FORECAST_CACHE_MAGIC) {
+    return false;
+  }
+
+  if (snapshot.crc != snapshotCRC()) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println("Forecast snapshot CRC mismatch, discarding");
+    }
+#endif
+    invalidateForecastSnapshot();
+    return false;
+  }
+
+  if (snapshot.settingsKey != forecastSettingsKey()) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println("Forecast snapshot is for different settings, discarding");
+    }
+#endif
+    invalidateForecastSnapshot();
+    return false;
+  }
+  return true;
+}
+
+bool restoreForecastSnapshot(time_t now, long maxAgeSecs, Forecast_record_type *current, Forecast_record_type *hourly,
+                             Forecast_record_type *daily, int *timezoneOffset, int *wifiSignal) {
+  if (maxAgeSecs <= 0 || !snapshotUsable()) {
+    return false;
+  }
+
+  // A clock that went backwards (or was never set) cannot prove the data is fresh
+  long age = (long)(now - snapshot.fetchTime);
+  if (age < 0 || age >= maxAgeSecs - FORECAST_CACHE_GUARD_SECS) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("Forecast snapshot is stale (age %ld s, max %ld s)\n", age, maxAgeSecs);
+    }
+#endif
+    return false;
+  }
+
+  memcpy(current, &snapshot.current, sizeof(snapshot.current));
+  memcpy(hourly, snapshot.hourly, sizeof(snapshot.hourly));
+  memcpy(daily, snapshot.daily, sizeof(snapshot.daily));
+  *timezoneOffset = snapshot.timezoneOffset;
+  *wifiSignal     = snapshot.wifiSignal;
+
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Forecast restored from RTC memory (age %ld s)\n", age);
+  }
+#endif
+  return true;
+}
+
+const char *forecastSnapshotETag() {
+  return snapshotUsable() ? snapshot.etag : "";
+}
+
+const char *forecastSnapshotLastModified() {
+  return snapshotUsable() ? snapshot.lastModified : "";
+}
+
+time_t forecastSnapshotFetchTime() {
+  return snapshotUsable() ? snapshot.fetchTime : 0;
+}
+
+bool saveForecastSnapshotSlot(int slot) {
+  if (snapshot.magic != FORECAST_CACHE_MAGIC || snapshot.crc != snapshotCRC()) {
+    return false;
+  }
+  char key[8];
+  slotKey(key, slot);
+  Preferences prefs;
+  if (!prefs.begin(FORECAST_SLOT_NAMESPACE, false, FORECAST_SLOT_PARTITION)) {
+    return false;
+  }
+  bool saved = prefs.putBytes(key, &snapshot, sizeof(snapshot)) == sizeof(snapshot);
+  prefs.end();
+
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Forecast snapshot %s saved to flash: %s\n", key, saved ? "ok" : "failed");
+  }
+#endif
+  return saved;
+}
+
+bool loadForecastSnapshotSlot(int slot) {
+  char key[8];
+  slotKey(key, slot);
+  Preferences prefs;
+  size_t length = 0;
+  if (prefs.begin(FORECAST_SLOT_NAMESPACE, true, FORECAST_SLOT_PARTITION)) {
+    length = prefs.getBytes(key, &snapshot, sizeof(snapshot));
+    prefs.end();
+  }
+  // Checked here, so a bad slot's settings key is not compared and reported later
+  if (length != sizeof(snapshot) || snapshot.magic != FORECAST_CACHE_MAGIC || snapshot.crc != snapshotCRC()) {
+    invalidateForecastSnapshot();
+    return false;
+  }
+  return true;
+}
+
+void invalidateForecastSnapshot() {
+  snapshot.magic = 0;
+}
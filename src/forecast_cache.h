@@ -0,0 +1,96 @@
+#ifndef __FORECAST_CACHE_H__
+#define __FORECAST_CACHE_H__
+
+#include <Arduino.h>
+#include <time.h>
+#include "forecast_record.h"
+#include "api_client.h"
+
+// Magic number to identify a valid snapshot in RTC memory
+#define FORECAST_CACHE_MAGIC 0x46435354  // "FCST" in hex
+
+// A snapshot this close to MaxDataAge is treated as stale, so a wake that lands on
+// the boundary (sleep timing is only accurate to a few seconds) fetches instead
+#define FORECAST_CACHE_GUARD_SECS 120
+
+/**
+ * Store the decoded forecast in RTC slow memory.
+ * The snapshot survives deep sleep (but not a power cycle or reset) and is tied to
+ * the location/units/language it was fetched for.
+ *
+ * @param current Current conditions record
+ * @param hourly Hourly forecast records (max_hourly_readings entries)
+ * @param daily Daily forecast records (max_daily_readings entries)
+ * @param fetchTime UTC time the data was fetched
+ * @param timezoneOffset Timezone offset in seconds reported by the API
+ * @param wifiSignal RSSI at fetch time (shown in the status bar on cached redraws)
+ * @param etag ETag of the response the data came from ("" = none)
+ * @param lastModified Last-Modified of the response the data came from ("" = none)
+ */
+void storeForecastSnapshot(const Forecast_record_type *current, const Forecast_record_type *hourly,
+                           const Forecast_record_type *daily, time_t fetchTime, int timezoneOffset, int wifiSignal,
+                           const char *etag, const char *lastModified);
+
+/**
+ * Restore the forecast from RTC slow memory if the snapshot is valid and still fresh.
+ * The output arrays are only written when true is returned.
+ *
+ * @param now Current UTC time from the RTC
+ * @param maxAgeSecs Maximum snapshot age in seconds (0 disables the cache)
+ * @param current Current conditions record (output)
+ * @param hourly Hourly forecast records (output, max_hourly_readings entries)
+ * @param daily Daily forecast records (output, max_daily_readings entries)
+ * @param timezoneOffset Timezone offset stored with the snapshot (output)
+ * @param wifiSignal RSSI stored with the snapshot (output)
+ * @return true if the snapshot was restored, false if it is missing, corrupt, stale or for other settings
+ */
+bool restoreForecastSnapshot(time_t now, long maxAgeSecs, Forecast_record_type *current, Forecast_record_type *hourly,
+                             Forecast_record_type *daily, int *timezoneOffset, int *wifiSignal);
+
+/**
+ * Validators of the response the snapshot was decoded from, for a conditional request.
+ * Whatever its age, a snapshot for the current settings can be restored if the server
+ * answers 304 Not Modified.
+ *
+ * @return ETag / Last-Modified, "" if there is no valid snapshot or the server sent none
+ */
+const char *forecastSnapshotETag();
+const char *forecastSnapshotLastModified();
+
+/**
+ * UTC time the snapshot's forecast was fetched, 0 if there is no valid snapshot.
+ */
+time_t forecastSnapshotFetchTime();
+
+/**
+ * Key identifying the request a forecast belongs to: a CRC of the location, units and
+ * language. Changing any of them in setup mode invalidates the snapshot.
+ */
+uint32_t forecastSettingsKey();
+
+/**
+ * Copy the RTC snapshot to flash as the forecast of a location (see locations.h).
+ * The flash copies live in their own NVS partition ("forecasts"), as RTC memory only
+ * has room for one; the stand-alone single-location setup never touches them.
+ *
+ * @param slot Location index (0 to MAX_LOCATIONS - 1)
+ * @return true if there was a valid snapshot and it was written
+ */
+bool saveForecastSnapshotSlot(int slot);
+
+/**
+ * Replace the RTC snapshot with the forecast stored for a location, so the restore,
+ * staleness and conditional request logic above works on that location. The RTC
+ * snapshot is discarded if the slot is empty or corrupt.
+ *
+ * @param slot Location index (0 to MAX_LOCATIONS - 1)
+ * @return true if the slot held a valid snapshot
+ */
+bool loadForecastSnapshotSlot(int slot);
+
+/**
+ * Discard the RTC snapshot so the next wake fetches fresh data.
+ */
+void invalidateForecastSnapshot();
+
+#endif // __FORECAST_CACHE_H__
@@ -3,28 +3,99 @@
 
 #include <Arduino.h>
 
+// Forecast data array sizes
+#define max_hourly_readings 48  // One Call API 3.0 provides 48 hours of hourly forecasts
+#define max_daily_readings 8    // One Call API 3.0 provides 8 days of daily forecasts
+#define max_nowcast_readings 60 // One Call API 3.0 "minutely": precipitation for the next hour
+
+// Entries the display draws (drawOutlookGraph / drawForecast); DecodeWeather() stops reading there
+#define graph_hours_shown   24
+#define forecast_days_shown 5
+
+// Bounded buffer for the weather description, including the terminator
+#define FORECAST_DESCRIPTION_LEN 20
+
+// Pressure trend between today and tomorrow (stored in Forecast_record_type::Trend)
+typedef enum : uint8_t {
+  TREND_STEADY = 0,
+  TREND_RISING,
+  TREND_FALLING
+} pressure_trend_t;
+
+/**
+ * Packed, trivially-copyable forecast record.
+ * Values are stored as fixed-point integers in the unit system requested from the API
+ * (Metric or Imperial), so a full forecast set is a few KB and can be copied with memcpy.
+ */
 typedef struct { // For current Day and Day 1, 2, 3, etc
-  int    Dt;
-  String Icon;
-  String Trend;
-  String Forecast0;
-  String Description;
-  float  Temperature;
-  float  FeelsLike;
-  float  Humidity;
-  float  High;
-  float  Low;
-  float  Winddir;
-  float  Windspeed;
-  float  Rainfall;
-  float  Snowfall;
-  float  Pressure;
-  int    Cloudcover;
-  float  Pop;  // Probability of precipitation (0.0 to 1.0)
-  int    Visibility;
-  int    Sunrise;
-  int    Sunset;
-  int    FTimezone;  
+  int32_t  Dt;
+  int32_t  Sunrise;
+  int32_t  Sunset;
+  int32_t  FTimezone;
+  int16_t  Temperature;  // Tenths of a degree
+  int16_t  FeelsLike;    // Tenths of a degree
+  int16_t  High;         // Tenths of a degree
+  int16_t  Low;          // Tenths of a degree
+  int16_t  Pressure;     // hPa
+  int16_t  Windspeed;    // Tenths of m/s or mph
+  uint16_t Winddir;      // Degrees
+  uint16_t Visibility;   // Metres
+  uint16_t Rainfall;     // Hundredths of mm or in
+  uint16_t Snowfall;     // Hundredths of mm or in
+  uint8_t  Humidity;     // Percent
+  uint8_t  Cloudcover;   // Percent
+  uint8_t  Pop;          // Probability of precipitation, percent (0-100)
+  uint8_t  Trend;        // pressure_trend_t
+  char     Icon[4];      // OpenWeatherMap icon code, e.g. "10d"
+  char     Description[FORECAST_DESCRIPTION_LEN];
 } Forecast_record_type;
 
+static_assert(sizeof(Forecast_record_type) == 64, "Forecast_record_type should stay packed");
+
+/**
+ * Minutely precipitation for the next hour (the nowcast, nowcast.h), plain data like the
+ * forecast records so it can be kept in RTC memory.
+ */
+typedef struct {
+  int32_t  Start;     // UTC of the first minute, 0 = none
+  int8_t   Location;  // Location it was fetched for (locations.h)
+  uint8_t  Count;     // Minutes received
+  uint16_t Precipitation[max_nowcast_readings];  // Hundredths of mm/h (the API reports mm/h in either unit system)
+} Nowcast_record_type;
+
+// Fixed-point conversion helpers
+static inline int16_t toTenths(float value) {
+  float scaled = value * 10.0f;
+  scaled = (scaled > 32767.0f) ? 32767.0f : ((scaled < -32768.0f) ? -32768.0f : scaled);
+  return (int16_t)lroundf(scaled);
+}
+
+static inline float fromTenths(int16_t value) {
+  return value / 10.0f;
+}
+
+// Round a tenths value to the nearest whole unit (half away from zero, like round())
+static inline int roundTenths(int16_t value) {
+  return (value >= 0) ? (value + 5) / 10 : (value - 5) / 10;
+}
+
+static inline uint16_t toHundredths(float value) {
+  float scaled = value * 100.0f;
+  scaled = (scaled > 65535.0f) ? 65535.0f : ((scaled < 0.0f) ? 0.0f : scaled);
+  return (uint16_t)lroundf(scaled);
+}
+
+static inline uint8_t toPercent(float fraction) {
+  float scaled = fraction * 100.0f;
+  scaled = (scaled > 100.0f) ? 100.0f : ((scaled < 0.0f) ? 0.0f : scaled);
+  return (uint8_t)lroundf(scaled);
+}
+
+// Copy a (possibly null) string into a fixed record field, always terminated
+static inline void setRecordText(char *dst, size_t len, const char *src) {
+  if (src == NULL) src = "";
+  strncpy(dst, src, len - 1);
+  dst[len - 1] = '\0';
+}
+
 #endif /* ifndef FORECAST_RECORD_H_ */
@@ -0,0 +1,126 @@
+/**
+ * Frame Diff
+ *
+ * Finds the parts of the 4bpp framebuffer that need pushing to the panel. The previous
+ * frame does not survive deep sleep, so what changed between wakes is tracked with small
+ * per-tile hashes. Within an area that was just cleared, the panel is known to be white,
+ * so only the rows and columns holding ink are drawn. Rows are compared a 32-bit word
+ * (8 pixels) at a time; the framebuffer and every layout region are word aligned.
+ */
+
+#include <Arduino.h>
+#include "frame_diff.h"
+
+#define WHITE_WORD 0xFFFFFFFFUL  // 8 white pixels
+
+static inline const uint32_t *rowWords(const uint8_t *frame, int x, int y) {
+  return (const uint32_t *)(frame + (y * EPD_WIDTH + x) / 2);
+}
+
+static inline bool wordAligned(const Rect_t &area) {
+  return (area.x % 8) == 0 && (area.width % 8) == 0;
+}
+
+int frameTileCount(const Rect_t &area) {
+  int columns = (area.width + FRAME_TILE_WIDTH - 1) / FRAME_TILE_WIDTH;
+  int rows    = (area.height + FRAME_TILE_HEIGHT - 1) / FRAME_TILE_HEIGHT;
+  return columns * rows;
+}
+
+void frameTileHashes(const uint8_t *frame, const Rect_t &area, uint16_t *hashes) {
+  const int columns = (area.width + FRAME_TILE_WIDTH - 1) / FRAME_TILE_WIDTH;
+  for (int top = 0; top < area.height; top += FRAME_TILE_HEIGHT) {
+    const int bottom = min(top + FRAME_TILE_HEIGHT, area.height);
+    for (int column = 0; column < columns; column++) {
+      const int left  = column * FRAME_TILE_WIDTH;
+      const int words = (min(left + FRAME_TILE_WIDTH, area.width) - left) / 8;
+      // FNV-1a over whole words, folded to 16 bits
+      uint32_t hash = 2166136261UL;
+      for (int y = top; y < bottom; y++) {
+        const uint32_t *row = rowWords(frame, area.x + left, area.y + y);
+        for (int i = 0; i < words; i++) {
+          hash = (hash ^ row[i]) * 16777619UL;
+        }
+      }
+      *hashes++ = (uint16_t)(hash ^ (hash >> 16));
+    }
+  }
+}
+
+/**
+ * Add a span of rows [top, bottom) x [left, right) to the rectangle list, growing the
+ * last rectangle when the span continues it.
+ *
+ * @param gapRows Blank rows allowed between the last rectangle and the span for them to merge
+ * @param overlapOnly Only merge spans that share columns with the last rectangle
+ */
+static int addSpan(Rect_t *rects, int count, int maxRects, int left, int right, int top, int bottom,
+                   int gapRows, bool overlapOnly) {
+  if (count > 0) {
+    Rect_t &last = rects[count - 1];
+    bool touches = top - (last.y + last.height) <= gapRows &&
+                   (!overlapOnly || (left < last.x + last.width && right > last.x));
+    if (touches || count == maxRects) {
+      int x0 = min(last.x, left);
+      int x1 = max(last.x + last.width, right);
+      int y0 = min(last.y, top);
+      int y1 = max(last.y + last.height, bottom);
+      last.x = x0;
+      last.y = y0;
+      last.width  = x1 - x0;
+      last.height = y1 - y0;
+      return count;
+    }
+  }
+  Rect_t &rect = rects[count];
+  rect.x = left;
+  rect.y = top;
+  rect.width  = right - left;
+  rect.height = bottom - top;
+  return count + 1;
+}
+
+int frameChangedRects(const Rect_t &area, const uint16_t *oldHashes, const uint16_t *newHashes,
+                      Rect_t *rects, int maxRects) {
+  const int columns = (area.width + FRAME_TILE_WIDTH - 1) / FRAME_TILE_WIDTH;
+  int count = 0;
+  int tile = 0;
+  for (int top = 0; top < area.height; top += FRAME_TILE_HEIGHT) {
+    const int bottom = min(top + FRAME_TILE_HEIGHT, area.height);
+    int first = -1, last = -1;
+    for (int column = 0; column < columns; column++, tile++) {
+      if (oldHashes[tile] != newHashes[tile]) {
+        if (first < 0) first = column;
+        last = column;
+      }
+    }
+    if (first < 0) continue;
+    // One span per row of tiles; rows are merged only where the spans overlap, so
+    // changes far apart do not flash the panel in between
+    int left  = first * FRAME_TILE_WIDTH;
+    int right = min((last + 1) * FRAME_TILE_WIDTH, area.width);
+    count = addSpan(rects, count, maxRects, area.x + left, area.x + right, area.y + top, area.y + bottom, 0, true);
+  }
+  return count;
+}
+
+int frameInkRects(const uint8_t *frame, const Rect_t &area, Rect_t *rects, int maxRects) {
+  if (!wordAligned(area)) {
+    rects[0] = area;
+    return 1;
+  }
+  const int words = area.width / 8;
+  int count = 0;
+  for (int y = area.y; y < area.y + area.height; y++) {
+    const uint32_t *row = rowWords(frame, area.x, y);
+    int first = 0;
+    while (first < words && row[first] == WHITE_WORD) first++;
+    if (first == words) continue;
+    int last = words - 1;
+    while (row[last] == WHITE_WORD) last--;
+    // Drawing white pixels leaves them white, so ink rows are merged whatever their columns
+    count = addSpan(rects, count, maxRects, area.x + first * 8, area.x + (last + 1) * 8, y, y + 1,
+                    FRAME_DIFF_MERGE_ROWS, false);
+  }
+  return count;
+}
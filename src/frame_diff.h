@@ -0,0 +1,59 @@
+#ifndef __FRAME_DIFF_H__
+#define __FRAME_DIFF_H__
+
+#include <Arduino.h>
+#include "epd_driver.h"
+
+// Tile size for change tracking between wakes (pixels; the width a multiple of 8)
+#define FRAME_TILE_WIDTH  64
+#define FRAME_TILE_HEIGHT 32
+
+// Blank rows allowed inside one pushed rectangle before a new one is started.
+// Each push costs a full set of waveform frames, so short gaps are cheaper to draw through.
+#ifndef FRAME_DIFF_MERGE_ROWS
+#define FRAME_DIFF_MERGE_ROWS 24
+#endif
+
+/**
+ * Number of tiles covering an area (tiles are laid out from its top left corner).
+ */
+int frameTileCount(const Rect_t &area);
+
+/**
+ * Hash every tile of a framebuffer area, row of tiles by row of tiles.
+ *
+ * @param frame 4bpp framebuffer (EPD_WIDTH x EPD_HEIGHT)
+ * @param area Area to hash; x and width must be multiples of 8
+ * @param hashes Output, frameTileCount(area) entries
+ */
+void frameTileHashes(const uint8_t *frame, const Rect_t &area, uint16_t *hashes);
+
+/**
+ * Rectangles covering the tiles whose hashes differ. The changed tiles of a row of tiles
+ * form a span, and spans of consecutive rows that overlap are merged.
+ *
+ * @param area Area the hashes were computed for
+ * @param oldHashes Hashes of what the panel shows
+ * @param newHashes Hashes of the framebuffer
+ * @param rects Output rectangles (clipped to the area)
+ * @param maxRects Capacity of rects; when exceeded, the last one is grown to cover the rest
+ * @return Number of rectangles, 0 if no tile changed
+ */
+int frameChangedRects(const Rect_t &area, const uint16_t *oldHashes, const uint16_t *newHashes,
+                      Rect_t *rects, int maxRects);
+
+/**
+ * Rectangles covering the non-white pixels of a framebuffer area: the difference between
+ * the framebuffer and a panel area that was just cleared to white. Rows are scanned a
+ * 32-bit word (8 pixels) at a time; rows with ink are merged into rectangles across gaps
+ * of up to FRAME_DIFF_MERGE_ROWS blank rows.
+ *
+ * @param frame 4bpp framebuffer (EPD_WIDTH x EPD_HEIGHT)
+ * @param area Area to scan; if x or width is not a multiple of 8 the whole area is returned
+ * @param rects Output rectangles, x and width multiples of 8
+ * @param maxRects Capacity of rects; when exceeded, the last one is grown to cover the rest
+ * @return Number of rectangles, 0 if the area is blank
+ */
+int frameInkRects(const uint8_t *frame, const Rect_t &area, Rect_t *rects, int maxRects);
+
+#endif // __FRAME_DIFF_H__
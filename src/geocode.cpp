@@ -0,0 +1,209 @@
+/**
+ * Geocoding
+ *
+ * Turns the location string from setup mode into coordinates. Lookups only run in
+ * setup mode, where the page shows the candidates as the user types; the place that
+ * is saved is remembered in NVS under its normalized query, so going back to an
+ * earlier location is resolved without a network round trip. Normal wakes only read
+ * the coordinates from settings.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include "geocode.h"
+#include "settings.h"
+#include "api_client.h"
+#include "memory_arena.h"
+
+#define GEOCODE_DOC_SIZE 1536  // Filtered response with GEOCODE_MAX_RESULTS places
+
+typedef struct {
+  uint32_t magic;
+  char query[GEOCODE_QUERY_LEN];  // Normalized
+  GeocodeResult result;
+} GeocodeCacheEntry;
+
+void geocodeNormalize(const char *query, char *out, size_t size) {
+  size_t length = 0;
+  bool space = false;
+  for (const char *p = query; *p && length + 1 < size; p++) {
+    char c = *p;
+    if (c == ' ' || c == '\t') {
+      space = length > 0; // Collapse runs, drop leading spaces
+      continue;
+    }
+    if (c != ',' && space && out[length - 1] != ',') { // No spaces around commas
+      out[length++] = ' ';
+      if (length + 1 >= size) break;
+    }
+    space = false;
+    out[length++] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+  }
+  out[length] = '\0';
+}
+
+bool geocodeHasCoordinates() {
+  float lat = String(settings.Latitude).toFloat();
+  float lon = String(settings.Longitude).toFloat();
+  return lat > -180.0 && lat < 180.0 && lon > -180.0 && lon < 180.0;
+}
+
+/**
+ * Percent-encode a query parameter value (UTF-8 bytes are encoded one by one).
+ */
+static String urlEncode(const char *value) {
+  static const char hex[] = "0123456789ABCDEF";
+  String encoded;
+  encoded.reserve(strlen(value) * 3);
+  for (const uint8_t *p = (const uint8_t *)value; *p; p++) {
+    if (isalnum(*p) || *p == '-' || *p == '_' || *p == '.' || *p == '~') {
+      encoded += (char)*p;
+    } else {
+      encoded += '%';
+      encoded += hex[*p >> 4];
+      encoded += hex[*p & 0x0F];
+    }
+  }
+  return encoded;
+}
+
+int geocodeLookup(const char *query, const char *apiKey, GeocodeResult *results, int *count) {
+  *count = 0;
+  // API endpoint: https://api.openweathermap.org/geo/1.0/direct?q={city name}&limit=5&appid={API key}
+  String uri = "/geo/1.0/direct?q=" + urlEncode(query) + "&limit=" + String(GEOCODE_MAX_RESULTS) +
+               "&appid=" + urlEncode(apiKey);
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.print("Geocoding API request: ");
+    Serial.println(query);
+  }
+#endif
+
+  int httpCode = apiRequest(uri, NULL, NULL);
+  if (httpCode != HTTP_CODE_OK) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.print("Geocoding API error. HTTP code: ");
+      Serial.println(httpCode);
+    }
+#endif
+    if (httpCode > 0) {
+      apiEndRequest();
+    }
+    return (httpCode == HTTP_CODE_UNAUTHORIZED) ? 1 : 2;
+  }
+
+  // Each place also carries its name in dozens of languages: keep only what is shown
+  // Expected format: [{"name":"...","lat":51.5085,"lon":-0.1257,"country":"GB","state":"..."},...]
+  StaticJsonDocument<128> filter;
+  filter[0]["name"]    = true;
+  filter[0]["state"]   = true;
+  filter[0]["country"] = true;
+  filter[0]["lat"]     = true;
+  filter[0]["lon"]     = true;
+  BasicJsonDocument<ArenaJsonAllocator> doc(GEOCODE_DOC_SIZE);
+  DeserializationError error = deserializeJson(doc, apiBody(), DeserializationOption::Filter(filter));
+  apiEndRequest();
+  if (error || !doc.is<JsonArray>()) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.print("Failed to parse geocoding JSON: ");
+      Serial.println(error.c_str());
+    }
+#endif
+    return 2;
+  }
+
+  for (JsonObject place : doc.as<JsonArray>()) {
+    if (*count >= GEOCODE_MAX_RESULTS) break;
+    float lat = place["lat"] | -181.0f;
+    float lon = place["lon"] | -181.0f;
+    if (lat < -90.0 || lat > 90.0 || lon < -180.0 || lon > 180.0) {
+      continue;
+    }
+    GeocodeResult &result = results[(*count)++];
+    strlcpy(result.name, place["name"] | "", sizeof(result.name));
+    strlcpy(result.state, place["state"] | "", sizeof(result.state));
+    strlcpy(result.country, place["country"] | "", sizeof(result.country));
+    result.lat = lat;
+    result.lon = lon;
+  }
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Geocoding returned %d places\n", *count);
+  }
+#endif
+  return 0;
+}
+
+/**
+ * NVS key of a cache slot.
+ */
+static void slotKey(char *key, int slot) {
+  snprintf(key, 4, "e%d", slot);
+}
+
+bool geocodeCacheGet(const char *query, GeocodeResult *result) {
+  char normalized[GEOCODE_QUERY_LEN];
+  geocodeNormalize(query, normalized, sizeof(normalized));
+  if (!normalized[0]) return false;
+
+  Preferences prefs;
+  prefs.begin("geocode", true);
+  bool found = false;
+  for (int slot = 0; slot < GEOCODE_CACHE_ENTRIES && !found; slot++) {
+    char key[4];
+    slotKey(key, slot);
+    GeocodeCacheEntry entry;
+    if (prefs.getBytes(key, &entry, sizeof(entry)) == sizeof(entry) && entry.magic == GEOCODE_CACHE_MAGIC &&
+        strncmp(entry.query, normalized, sizeof(entry.query)) == 0) {
+      memcpy(result, &entry.result, sizeof(*result));
+      found = true;
+    }
+  }
+  prefs.end();
+  return found;
+}
+
+void geocodeCachePut(const char *query, const GeocodeResult *result) {
+  GeocodeCacheEntry entry;
+  memset(&entry, 0, sizeof(entry));
+  geocodeNormalize(query, entry.query, sizeof(entry.query));
+  if (!entry.query[0]) return;
+  entry.magic = GEOCODE_CACHE_MAGIC;
+  memcpy(&entry.result, result, sizeof(entry.result));
+
+  Preferences prefs;
+  prefs.begin("geocode", false);
+  // Reuse the slot of the same query, otherwise the oldest one
+  int slot = -1;
+  for (int i = 0; i < GEOCODE_CACHE_ENTRIES && slot < 0; i++) {
+    char key[4];
+    slotKey(key, i);
+    GeocodeCacheEntry existing;
+    if (prefs.getBytes(key, &existing, sizeof(existing)) == sizeof(existing) &&
+        existing.magic == GEOCODE_CACHE_MAGIC && strcmp(existing.query, entry.query) == 0) {
+      slot = i;
+    }
+  }
+  if (slot < 0) {
+    slot = prefs.getUChar("next", 0) % GEOCODE_CACHE_ENTRIES;
+    prefs.putUChar("next", (slot + 1) % GEOCODE_CACHE_ENTRIES);
+  }
+  char key[4];
+  slotKey(key, slot);
+  prefs.putBytes(key, &entry, sizeof(entry));
+  prefs.end();
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Geocode cache: '%s' stored in slot %d\n", entry.query, slot);
+  }
+#endif
+}
+
+void geocodeApply(const GeocodeResult *result) {
+  // 6 decimal places for precision
+  strlcpy(settings.Latitude, String(result->lat, 6).c_str(), sizeof(settings.Latitude));
+  strlcpy(settings.Longitude, String(result->lon, 6).c_str(), sizeof(settings.Longitude));
+}
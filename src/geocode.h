@@ -0,0 +1,71 @@
+#ifndef __GEOCODE_H__
+#define __GEOCODE_H__
+
+#include <Arduino.h>
+
+// Candidates returned by one lookup (OpenWeatherMap allows up to 5)
+#define GEOCODE_MAX_RESULTS 5
+
+// Resolved locations kept in NVS (oldest replaced first)
+#ifndef GEOCODE_CACHE_ENTRIES
+#define GEOCODE_CACHE_ENTRIES 8
+#endif
+
+// Longest normalized query, including the terminator
+#define GEOCODE_QUERY_LEN 64
+
+#define GEOCODE_CACHE_MAGIC 0x47454f43  // "GEOC" in hex
+
+/**
+ * One place returned by the geocoding API.
+ */
+typedef struct {
+  char  name[48];
+  char  state[32];   // "" if the API has none for this place
+  char  country[4];  // ISO 3166 code
+  float lat;
+  float lon;
+} GeocodeResult;
+
+/**
+ * Lowercase the query and tidy its spacing ("Chicago ,IL  US" -> "chicago,il us"),
+ * so the spellings a user types for one place share a cache entry.
+ */
+void geocodeNormalize(const char *query, char *out, size_t size);
+
+/**
+ * Whether settings hold coordinates rather than the -181 "not resolved" sentinel.
+ */
+bool geocodeHasCoordinates();
+
+/**
+ * Look a place up with the OpenWeatherMap Geocoding API (blocking, needs a station connection).
+ *
+ * @param query Location as typed, e.g. "Chicago, IL, US"
+ * @param apiKey API key to use (the one typed in setup mode may not be saved yet)
+ * @param results Candidates (output, GEOCODE_MAX_RESULTS entries)
+ * @param count Number of candidates found (output)
+ * @return 0 on success (count may be 0), 1 if the API key is invalid (401), 2 on other errors
+ */
+int geocodeLookup(const char *query, const char *apiKey, GeocodeResult *results, int *count);
+
+/**
+ * Find a resolved location in the NVS cache.
+ *
+ * @param query Location as typed (normalized here)
+ * @param result Cached place (output)
+ * @return true if found
+ */
+bool geocodeCacheGet(const char *query, GeocodeResult *result);
+
+/**
+ * Remember the place a location string resolved to, replacing the oldest entry when full.
+ */
+void geocodeCachePut(const char *query, const GeocodeResult *result);
+
+/**
+ * Store a place's coordinates in settings (not saved to NVS here).
+ */
+void geocodeApply(const GeocodeResult *result);
+
+#endif // __GEOCODE_H__
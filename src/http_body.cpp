@@ -0,0 +1,314 @@
+/**
+ * HTTP Body Stream
+ *
+ * Two layers between the connection and the decoder: the message framing
+ * (Content-Length, chunked, or until the connection closes) and, for gzip responses,
+ * the gzip header plus a streaming inflate with the ROM miniz inflater into a wrapping
+ * 32 KB window. read() hands out the window contents before inflating more, so memory
+ * stays fixed whatever the size of the response.
+ */
+
+#include <Arduino.h>
+#include "http_body.h"
+#include "memory_arena.h"
+
+// gzip member header flags (RFC 1952)
+#define GZIP_FHCRC    0x02
+#define GZIP_FEXTRA   0x04
+#define GZIP_FNAME    0x08
+#define GZIP_FCOMMENT 0x10
+
+// Reads allowed to consume the gzip trailer and the end of the framing after inflating
+#define HTTP_BODY_DRAIN_READS 4
+
+HttpBodyStream::HttpBodyStream()
+  : source(NULL), timeoutMs(0), chunked(false), framingDone(true), failed(false), firstChunk(true),
+    remaining(0), received(0), gzip(false), headerDone(false), inflateDone(false), inflator(NULL),
+    window(NULL), windowPos(0), inputPos(0), inputLen(0), out(NULL), outPos(0), outLen(0) {
+}
+
+HttpBodyStream::~HttpBodyStream() {
+  end();
+}
+
+bool HttpBodyStream::begin(Client &client, long contentLength, bool isChunked, bool isGzip, unsigned long timeout) {
+  source      = &client;
+  timeoutMs   = timeout;
+  chunked     = isChunked;
+  remaining   = chunked ? 0 : contentLength;
+  framingDone = !chunked && contentLength == 0;
+  failed      = false;
+  firstChunk  = true;
+  received    = 0;
+  gzip        = isGzip;
+  headerDone  = false;
+  inflateDone = false;
+  windowPos   = 0;
+  inputPos    = inputLen = 0;
+  out         = NULL;
+  outPos      = outLen = 0;
+
+  if (gzip && !inflator) {
+    inflator = (tinfl_decompressor *)arenaAlloc(ARENA_INFLATE, sizeof(tinfl_decompressor));
+    window   = (uint8_t *)arenaAlloc(ARENA_INFLATE, TINFL_LZ_DICT_SIZE);
+    if (!inflator || !window) {
+      end();
+      return false;
+    }
+  }
+  return true;
+}
+
+void HttpBodyStream::end() {
+  arenaReset(ARENA_INFLATE);
+  inflator = NULL;
+  window   = NULL;
+  out      = NULL;
+  outPos   = outLen = 0;
+}
+
+/**
+ * Read whatever the connection has, waiting up to the timeout for the first byte.
+ *
+ * @return Bytes read, 0 if the connection closed, -1 on timeout
+ */
+int HttpBodyStream::readSource(uint8_t *buf, size_t size) {
+  unsigned long start = millis();
+  while (true) {
+    int avail = source->available();
+    if (avail > 0) {
+      int n = source->read(buf, ((size_t)avail < size) ? (size_t)avail : size);
+      if (n > 0) {
+        received += n;
+        return n;
+      }
+    } else if (!source->connected()) {
+      return 0;
+    }
+    if (millis() - start > timeoutMs) {
+      return -1;
+    }
+    delay(1);
+  }
+}
+
+/**
+ * Read the size line of the next chunk, after the CRLF ending the previous one.
+ * The last (empty) chunk's trailer is consumed so the connection is left at the next response.
+ */
+bool HttpBodyStream::readChunkSize() {
+  long size = 0;
+  int digits = 0;
+  bool extension = false;
+  uint8_t c;
+  while (true) {
+    if (readSource(&c, 1) != 1) return false;
+    if (c == '\n') {
+      if (digits > 0) break;
+      if (!firstChunk) continue; // CRLF after the previous chunk's data
+      return false;
+    }
+    if (c == '\r' || extension) continue;
+    int value = (c >= '0' && c <= '9') ? c - '0' :
+                (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+                (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+    if (value < 0) {
+      if (digits == 0) return false;
+      extension = true; // ";name=value" chunk extension, ignored
+      continue;
+    }
+    if (++digits > 7) return false; // Far larger than any response we expect
+    size = size * 16 + value;
+  }
+  firstChunk = false;
+  remaining = size;
+
+  if (size == 0) {
+    // Trailer fields end with an empty line
+    int lineLength = 0;
+    while (readSource(&c, 1) == 1) {
+      if (c == '\n') {
+        if (lineLength == 0) {
+          framingDone = true;
+          return true;
+        }
+        lineLength = 0;
+      } else if (c != '\r') {
+        lineLength++;
+      }
+    }
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Read body bytes with the framing removed.
+ *
+ * @return Bytes read, 0 at the end of the body, -1 on error
+ */
+int HttpBodyStream::readFramed(uint8_t *buf, size_t size) {
+  if (framingDone) return 0;
+  if (failed) return -1;
+  if (chunked && remaining == 0) {
+    if (!readChunkSize()) {
+      failed = true;
+      return -1;
+    }
+    if (framingDone) return 0;
+  }
+  if (!chunked && remaining == 0) {
+    framingDone = true;
+    return 0;
+  }
+
+  if (remaining > 0 && (long)size > remaining) {
+    size = remaining;
+  }
+  int n = readSource(buf, size);
+  if (n == 0 && remaining < 0) {
+    framingDone = true; // Body ends when the server closes the connection
+    return 0;
+  }
+  if (n <= 0) {
+    failed = true; // Timed out, or closed before the end of the body
+    return -1;
+  }
+  if (remaining > 0) {
+    remaining -= n;
+  }
+  return n;
+}
+
+/**
+ * Next compressed byte, refilling the input buffer from the connection as needed.
+ *
+ * @return Byte value, or -1 at the end of the body or on error
+ */
+int HttpBodyStream::nextInputByte() {
+  if (inputPos == inputLen) {
+    int n = readFramed(input, sizeof(input));
+    if (n <= 0) return -1;
+    inputPos = 0;
+    inputLen = n;
+  }
+  return input[inputPos++];
+}
+
+/**
+ * Check and skip the gzip member header, leaving the input at the deflate data.
+ */
+bool HttpBodyStream::skipGzipHeader() {
+  uint8_t header[10];
+  for (size_t i = 0; i < sizeof(header); i++) {
+    int c = nextInputByte();
+    if (c < 0) return false;
+    header[i] = c;
+  }
+  if (header[0] != 0x1f || header[1] != 0x8b || header[2] != 8) { // Magic, deflate method
+    return false;
+  }
+  uint8_t flags = header[3];
+  if (flags & GZIP_FEXTRA) {
+    int low = nextInputByte();
+    int high = nextInputByte();
+    if (low < 0 || high < 0) return false;
+    for (int n = low | (high << 8); n > 0; n--) {
+      if (nextInputByte() < 0) return false;
+    }
+  }
+  if (flags & GZIP_FNAME) {
+    int c;
+    while ((c = nextInputByte()) > 0) {}
+    if (c < 0) return false;
+  }
+  if (flags & GZIP_FCOMMENT) {
+    int c;
+    while ((c = nextInputByte()) > 0) {}
+    if (c < 0) return false;
+  }
+  if (flags & GZIP_FHCRC) {
+    if (nextInputByte() < 0 || nextInputByte() < 0) return false;
+  }
+  return true;
+}
+
+/**
+ * Make more decoded bytes available to read().
+ *
+ * @return false at the end of the body or on error
+ */
+bool HttpBodyStream::fill() {
+  if (!gzip) {
+    int n = readFramed(input, sizeof(input));
+    if (n <= 0) return false;
+    out    = input;
+    outPos = 0;
+    outLen = n;
+    return true;
+  }
+
+  if (inflateDone || failed || !inflator) return false;
+  if (!headerDone) {
+    if (!skipGzipHeader()) {
+      failed = true;
+      return false;
+    }
+    headerDone = true;
+    tinfl_init(inflator);
+  }
+
+  while (true) {
+    if (inputPos == inputLen && !framingDone) {
+      int n = readFramed(input, sizeof(input));
+      if (n < 0) return false;
+      inputPos = 0;
+      inputLen = n;
+    }
+    size_t inBytes  = inputLen - inputPos;
+    size_t outBytes = TINFL_LZ_DICT_SIZE - windowPos;
+    // Raw deflate; the window wraps, so earlier output must be read before inflating more
+    tinfl_status status = tinfl_decompress(inflator, input + inputPos, &inBytes, window, window + windowPos,
+                                           &outBytes, framingDone ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+    inputPos += inBytes;
+
+    if (status == TINFL_STATUS_DONE) {
+      inflateDone = true;
+      // Consume the CRC/size trailer and the end of the framing so the connection can be reused
+      for (int reads = 0; !framingDone && reads < HTTP_BODY_DRAIN_READS; reads++) {
+        inputPos = inputLen = 0;
+        if (readFramed(input, sizeof(input)) < 0) break;
+      }
+    }
+    if (outBytes > 0) {
+      out       = window + windowPos;
+      outPos    = 0;
+      outLen    = outBytes;
+      windowPos = (windowPos + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+      return true;
+    }
+    if (status == TINFL_STATUS_DONE) {
+      return false;
+    }
+    if (status < 0 || (status == TINFL_STATUS_NEEDS_MORE_INPUT && framingDone && inputPos == inputLen)) {
+      failed = true; // Corrupt or truncated deflate data
+      return false;
+    }
+  }
+}
+
+int HttpBodyStream::available() {
+  if (outPos < outLen) return outLen - outPos;
+  if (failed || (gzip ? inflateDone : framingDone)) return 0;
+  return (inputPos < inputLen || source->available() > 0) ? 1 : 0;
+}
+
+int HttpBodyStream::read() {
+  if (outPos >= outLen && !fill()) return -1;
+  return out[outPos++];
+}
+
+int HttpBodyStream::peek() {
+  if (outPos >= outLen && !fill()) return -1;
+  return out[outPos];
+}
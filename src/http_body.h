@@ -0,0 +1,95 @@
+#ifndef __HTTP_BODY_H__
+#define __HTTP_BODY_H__
+
+#include <Arduino.h>
+#include <Client.h>
+#ifdef ESP32_S3_PLATFORM
+#include "esp32s3/rom/miniz.h"
+#else
+#include "esp32/rom/miniz.h"
+#endif
+
+// Compressed bytes read from the connection at a time
+#ifndef HTTP_BODY_INPUT_SIZE
+#define HTTP_BODY_INPUT_SIZE 512
+#endif
+
+/**
+ * Response body of an HTTP/1.1 request, read straight from the connection.
+ *
+ * Removes the Content-Length or chunked framing and, for "Content-Encoding: gzip",
+ * inflates the body as it is read, so the JSON decoder sees plain text without the
+ * response ever being held in memory. Inflating needs a 32 KB window, taken from the
+ * ARENA_INFLATE region (memory_arena.h) in begin() and given back in end().
+ */
+class HttpBodyStream : public Stream {
+public:
+  HttpBodyStream();
+  ~HttpBodyStream();
+
+  /**
+   * Start reading a body from the connection, positioned just after the headers.
+   *
+   * @param source Connection to read from
+   * @param contentLength Body length from Content-Length, -1 = unknown (read until closed)
+   * @param chunked Transfer-Encoding is chunked (contentLength is ignored)
+   * @param gzip Content-Encoding is gzip
+   * @param timeoutMs Give up when no data arrives for this long
+   * @return false if the inflate buffers could not be allocated
+   */
+  bool begin(Client &source, long contentLength, bool chunked, bool gzip, unsigned long timeoutMs);
+
+  /**
+   * Free the inflate buffers. The unread rest of the body is left on the connection.
+   */
+  void end();
+
+  /**
+   * Whether the whole body has been read from the connection, so the next response can follow.
+   */
+  bool complete() const { return framingDone; }
+
+  /**
+   * Bytes received from the connection for this body (before inflating).
+   */
+  uint32_t receivedBytes() const { return received; }
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override { return 0; }
+  void flush() override {}
+
+private:
+  int readFramed(uint8_t *buf, size_t size);
+  int readSource(uint8_t *buf, size_t size);
+  bool readChunkSize();
+  int nextInputByte();
+  bool skipGzipHeader();
+  bool fill();
+
+  Client *source;
+  unsigned long timeoutMs;
+  bool chunked;
+  bool framingDone;   // No more body bytes on the connection
+  bool failed;        // Timeout, connection lost or corrupt data
+  bool firstChunk;
+  long remaining;     // Bytes left in the body (or chunk), -1 = until the connection closes
+  uint32_t received;
+
+  bool gzip;
+  bool headerDone;
+  bool inflateDone;
+  tinfl_decompressor *inflator;
+  uint8_t *window;    // TINFL_LZ_DICT_SIZE, wraps around
+  size_t windowPos;
+  uint8_t input[HTTP_BODY_INPUT_SIZE];
+  size_t inputPos;
+  size_t inputLen;
+
+  const uint8_t *out; // Decoded bytes not yet returned by read()
+  size_t outPos;
+  size_t outLen;
+};
+
+#endif // __HTTP_BODY_H__
@@ -0,0 +1,192 @@
+#ifndef __LAYOUT_H__
+#define __LAYOUT_H__
+
+#include <Arduino.h>
+#include <epd_driver.h>
+#include "forecast_record.h"
+
+// Panel the screens are laid out for. The positions below were designed on the 960 x 540
+// LilyGo T5 4.7 and are scaled to this size at compile time (fonts are not scaled).
+#ifndef LAYOUT_WIDTH
+#define LAYOUT_WIDTH  EPD_WIDTH
+#endif
+#ifndef LAYOUT_HEIGHT
+#define LAYOUT_HEIGHT EPD_HEIGHT
+#endif
+
+// Intervals on each Y axis of the graph (labels are drawn at both ends of every interval)
+#define GRAPH_AXIS_TICKS 5
+
+/**
+ * Screen regions of the weather layout, used to refresh only the parts of the panel
+ * whose pixels changed. Together the rectangles cover the whole screen; x and width
+ * are even so every region starts and ends on a framebuffer byte (2 pixels per byte).
+ */
+typedef enum display_region {
+  REGION_CURRENT = 0,  // Large icon, temperature, feels-like and sunrise
+  REGION_LOCATION,     // City and date
+  REGION_FORECAST,     // 5-day forecast row
+  REGION_DETAILS,      // Sunset, humidity, pressure and wind column
+  REGION_GRAPH,        // 24-hour temperature/precipitation graph
+  REGION_STATUS,       // WiFi, refresh time and battery status bar
+  REGION_COUNT
+} display_region_t;
+
+typedef struct {
+  int16_t x;
+  int16_t y;
+} LayoutPoint;
+
+typedef struct {
+  int16_t x;
+  int16_t y;
+  int16_t width;
+  int16_t height;
+} LayoutRect;
+
+/**
+ * Fixed-size table of positions computed at compile time.
+ */
+template <int N>
+struct LayoutTable {
+  int16_t values[N];
+  constexpr int16_t operator[](int i) const { return values[i]; }
+};
+
+namespace layout_detail {
+
+constexpr int16_t scale(int value, int size, int designSize) {
+  return (int16_t)(value * size / designSize);
+}
+
+/**
+ * Boundaries of n equal parts of [start, start + length]: n + 1 positions, the last one
+ * exactly at the end, so parts of unequal (integer) size fill the length without gaps.
+ */
+template <int N>
+constexpr LayoutTable<N + 1> divisions(int start, int length) {
+  LayoutTable<N + 1> table = {};
+  for (int i = 0; i <= N; i++) {
+    table.values[i] = (int16_t)(start + i * length / N);
+  }
+  return table;
+}
+
+/**
+ * Centers of n columns of the given width placed side by side from start.
+ */
+template <int N>
+constexpr LayoutTable<N> columnCenters(int start, int width) {
+  LayoutTable<N> table = {};
+  for (int i = 0; i < N; i++) {
+    table.values[i] = (int16_t)(start + i * width + width / 2);
+  }
+  return table;
+}
+
+constexpr bool within(const LayoutRect &inner, const LayoutRect &outer) {
+  return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.width <= outer.x + outer.width &&
+         inner.y + inner.height <= outer.y + outer.height;
+}
+
+} // namespace layout_detail
+
+/**
+ * Scaling from the 960 x 540 design panel to Width x Height.
+ */
+template <int Width, int Height>
+struct LayoutScale {
+  static constexpr int16_t sx(int x) { return layout_detail::scale(x, Width, 960); }
+  static constexpr int16_t sy(int y) { return layout_detail::scale(y, Height, 540); }
+  static constexpr int16_t even(int x) { return (int16_t)(x & ~1); }  // Byte boundary in the framebuffer
+};
+
+/**
+ * Geometry of every screen for a Width x Height panel, all of it constant expressions:
+ * anchors, column and tick positions, and the refresh regions of the weather screen.
+ * Positions on the 960 x 540 design panel are given once and scaled from there.
+ */
+template <int Width, int Height>
+struct ScreenLayout : LayoutScale<Width, Height> {
+  using Scale = LayoutScale<Width, Height>;
+  static constexpr int width  = Width;
+  static constexpr int height = Height;
+
+  // Weather screen (DisplayWeather): current conditions on the left
+  static constexpr LayoutPoint currentIcon    = {Scale::sx(122), Scale::sy(117)};  // Large icon center
+  static constexpr LayoutPoint temperature    = {Scale::sx(240), Scale::sy(50)};   // Temperature and feels-like column
+  static constexpr LayoutPoint details        = {Scale::sx(5), Scale::sy(180)};    // Sunrise .. wind column
+  static constexpr int16_t     detailsRowStep = Scale::sy(65);
+
+  // Location and date, right aligned
+  static constexpr int16_t locationRight = Width - Scale::sx(7);
+  static constexpr int16_t locationY     = 0;
+  static constexpr int16_t dateY         = Scale::sy(42);
+
+  // Forecast row: one column per day, below the location
+  static constexpr int16_t forecastX           = Scale::sx(385);
+  static constexpr int16_t forecastColumnWidth = Scale::sx(115);
+  static constexpr int16_t forecastY           = Scale::sy(200);  // Reference line; names above, temperatures below
+  static constexpr LayoutTable<forecast_days_shown> forecastCenterX =
+      layout_detail::columnCenters<forecast_days_shown>(forecastX, forecastColumnWidth);
+
+  // 24-hour graph; the series are scaled to the plot area
+  static constexpr LayoutRect graph = {Scale::sx(240), Scale::sy(255), Scale::sx(665), Scale::sy(230)};
+  static constexpr int16_t graphBottom = graph.y + graph.height;
+  // Grid lines and axis labels, bottom (index 0) to top
+  static constexpr LayoutTable<GRAPH_AXIS_TICKS + 1> graphTickY =
+      layout_detail::divisions<GRAPH_AXIS_TICKS>(graphBottom, -graph.height);
+  // Bar edges for a full window of graph_hours_shown hours
+  static constexpr LayoutTable<graph_hours_shown + 1> graphColumnX =
+      layout_detail::divisions<graph_hours_shown>(graph.x, graph.width);
+
+  // Status bar along the bottom edge
+  static constexpr LayoutRect statusBar = {0, (int16_t)(Height - Scale::sy(25)), Width, Scale::sy(25)};
+  // Nowcast sparkline in the status bar, between the refresh time and the battery;
+  // column edges inside its frame for the max_nowcast_readings minutes of the next hour
+  static constexpr LayoutRect nowcast = {Scale::even(Scale::sx(552)), (int16_t)(statusBar.y + Scale::sy(4)),
+                                         Scale::even(Scale::sx(122)), Scale::sy(18)};
+  static constexpr LayoutTable<max_nowcast_readings + 1> nowcastColumnX =
+      layout_detail::divisions<max_nowcast_readings>(nowcast.x + 1, nowcast.width - 2);
+
+  // Refresh regions (display_region_t); each draw* section stays within its own rectangle(s),
+  // and anything that straddles a boundary is covered by both regions
+  static constexpr int16_t rightColumnX = Scale::even(Scale::sx(384));  // Location and forecast from here
+  static constexpr int16_t graphRegionX = Scale::even(Scale::sx(184));  // Left of the graph's axis labels
+  static constexpr int16_t locationEnd  = Scale::sy(80);
+  static constexpr int16_t topEnd       = Scale::sy(245);
+  static constexpr LayoutRect regions[REGION_COUNT] = {
+    {0,            0,           rightColumnX,                   topEnd},                         // REGION_CURRENT
+    {rightColumnX, 0,           (int16_t)(Width - rightColumnX), locationEnd},                   // REGION_LOCATION
+    {rightColumnX, locationEnd, (int16_t)(Width - rightColumnX), (int16_t)(topEnd - locationEnd)}, // REGION_FORECAST
+    {0,            topEnd,      graphRegionX,                   (int16_t)(statusBar.y - topEnd)}, // REGION_DETAILS
+    {graphRegionX, topEnd,      (int16_t)(Width - graphRegionX), (int16_t)(statusBar.y - topEnd)}, // REGION_GRAPH
+    {0,            statusBar.y, Width,                          statusBar.height}                // REGION_STATUS
+  };
+
+  /**
+   * Bytes of the largest region packed 2 pixels per byte (the partial refresh staging copy).
+   */
+  static constexpr size_t largestRegionBytes() {
+    size_t largest = 0;
+    for (int r = 0; r < REGION_COUNT; r++) {
+      size_t bytes = (size_t)regions[r].width * regions[r].height / 2;
+      if (bytes > largest) largest = bytes;
+    }
+    return largest;
+  }
+
+  // Message screens (setup mode, low battery and the error screens)
+  static constexpr LayoutPoint center     = {Width / 2, Height / 2};
+  static constexpr int16_t     messageTop = Height / 4;  // Title of the error screens with instructions
+
+  static_assert(layout_detail::within(graph, regions[REGION_GRAPH]), "graph outside its refresh region");
+  static_assert(layout_detail::within(nowcast, regions[REGION_STATUS]), "nowcast outside the status bar");
+  static_assert(forecastX + forecast_days_shown * forecastColumnWidth <= Width, "forecast row wider than the panel");
+};
+
+static_assert(LAYOUT_WIDTH <= EPD_WIDTH && LAYOUT_HEIGHT <= EPD_HEIGHT, "layout larger than the framebuffer");
+
+typedef ScreenLayout<LAYOUT_WIDTH, LAYOUT_HEIGHT> Layout;
+
+#endif // __LAYOUT_H__
@@ -0,0 +1,129 @@
+/**
+ * Location Rotation
+ *
+ * Shows settings.City and up to MAX_LOCATIONS - 1 additional locations in turn, one per
+ * wake. The location shown is selected by copying it into settings, so everything
+ * downstream (request, cache key, location line) is unchanged. Each location's forecast
+ * is kept in flash (forecast_cache.h); when the RTC snapshot is about to be used it is
+ * replaced with the shown location's.
+ *
+ * Staleness is tracked in RTC memory: the fetch time and settings key of every
+ * location's last forecast, enough to decide which ones to refresh on a WiFi session
+ * without reading their snapshots from flash. The additional locations themselves are
+ * read from flash the first time one is selected.
+ */
+
+#include <Arduino.h>
+#include "locations.h"
+#include "forecast_cache.h"
+#include "rtc_budget.h"
+
+// Persist across deep sleep; cleared on power-on reset
+RTC_DATA_ATTR static int shownLocation = -1;
+RTC_DATA_ATTR static int32_t fetchTimes[MAX_LOCATIONS];   // UTC, 0 = not fetched
+RTC_DATA_ATTR static uint32_t fetchKeys[MAX_LOCATIONS];   // forecastSettingsKey() of that fetch
+static_assert(sizeof(shownLocation) + sizeof(fetchTimes) + sizeof(fetchKeys) <= RTC_BUDGET_LOCATIONS,
+              "rotation state over its RTC allotment");
+
+// settings.City and its coordinates, taken before the first other location is selected
+static SettingsLocation primaryLocation;
+static bool primarySaved = false;
+static int selectedLocation = 0;
+
+// The additional locations, loaded from EEPROM by locationExtra()
+static SettingsLocation extraLocations[MAX_LOCATIONS - 1];
+static bool extraLoaded = false;
+
+int locationAdvance() {
+  shownLocation = (shownLocation + 1) % locationCount();
+  if (locationCount() > 1) {
+    locationSelect(shownLocation);
+    loadForecastSnapshotSlot(shownLocation);
+  }
+
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Showing location %d of %d: %s\n", shownLocation + 1, locationCount(), settings.City);
+  }
+#endif
+  return shownLocation;
+}
+
+int locationShown() {
+  return shownLocation < 0 ? 0 : shownLocation;
+}
+
+void locationSelect(int index) {
+  if (!primarySaved) {
+    strlcpy(primaryLocation.City, settings.City, sizeof(primaryLocation.City));
+    strlcpy(primaryLocation.Latitude, settings.Latitude, sizeof(primaryLocation.Latitude));
+    strlcpy(primaryLocation.Longitude, settings.Longitude, sizeof(primaryLocation.Longitude));
+    primarySaved = true;
+  }
+  const SettingsLocation *location = locationExtra(index);
+  if (!location) {
+    location = &primaryLocation;
+  }
+  strlcpy(settings.City, location->City, sizeof(settings.City));
+  strlcpy(settings.Latitude, location->Latitude, sizeof(settings.Latitude));
+  strlcpy(settings.Longitude, location->Longitude, sizeof(settings.Longitude));
+  selectedLocation = (index > 0 && index < locationCount()) ? index : 0;
+}
+
+void locationFetched(time_t fetchTime) {
+  if (locationCount() == 1) {
+    return;
+  }
+  fetchTimes[selectedLocation] = fetchTime;
+  fetchKeys[selectedLocation]  = forecastSettingsKey();
+  saveForecastSnapshotSlot(selectedLocation);
+}
+
+bool locationNeedsFetch(int index, time_t now) {
+  int count = locationCount();
+  long maxAgeSecs = locationMaxDataAge() * 60L;
+  if (index < 0 || index >= count || maxAgeSecs <= 0) {
+    return false; // Without a cache each location is fetched as it is shown
+  }
+
+  int selected = selectedLocation;
+  locationSelect(index);
+  bool coordinates = index == 0 || locationHasCoordinates(locationExtra(index));
+  uint32_t key = forecastSettingsKey();
+  locationSelect(selected);
+  if (!coordinates) {
+    return false;
+  }
+  if (fetchTimes[index] == 0 || fetchKeys[index] != key) {
+    return true;
+  }
+
+  // Age the forecast will have when the location comes round, at the configured interval
+  int wakesUntilShown = (index - locationShown() + count) % count;
+  long age = (long)(now - fetchTimes[index]) + wakesUntilShown * settings.SleepDuration * 60L;
+  return age < 0 || age >= maxAgeSecs - FORECAST_CACHE_GUARD_SECS;
+}
+
+bool locationHasCoordinates(const SettingsLocation *location) {
+  float lat = String(location->Latitude).toFloat();
+  float lon = String(location->Longitude).toFloat();
+  return location->City[0] && lat > -180.0 && lat < 180.0 && lon > -180.0 && lon < 180.0;
+}
+
+const SettingsLocation *locationExtra(int index) {
+  if (index <= 0 || index >= locationCount()) {
+    return NULL;
+  }
+  if (!extraLoaded) {
+    loadExtraLocations(extraLocations);
+    extraLoaded = true;
+  }
+  return &extraLocations[index - 1];
+}
+
+void locationSetExtras(const SettingsLocation *locations, int count) {
+  saveExtraLocations(locations, count);
+  memset(extraLocations, 0, sizeof(extraLocations));
+  memcpy(extraLocations, locations, settings.ExtraLocationCount * sizeof(SettingsLocation));
+  extraLoaded = true;
+}
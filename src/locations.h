@@ -0,0 +1,95 @@
+#ifndef __LOCATIONS_H__
+#define __LOCATIONS_H__
+
+#include <Arduino.h>
+#include <time.h>
+#include "settings.h"
+
+/**
+ * Locations the display rotates through: settings.City (index 0) and the additional
+ * ones configured in setup mode.
+ */
+static inline int locationCount() {
+  int extra = settings.ExtraLocationCount;
+  if (extra < 0) extra = 0;
+  if (extra > MAX_LOCATIONS - 1) extra = MAX_LOCATIONS - 1;
+  return 1 + extra;
+}
+
+/**
+ * Minutes a location's forecast may be redrawn without fetching.
+ * With several locations each is shown only every locationCount() wakes, so the age is
+ * stretched to a full rotation: all locations are then refreshed on one WiFi session per
+ * rotation instead of one per wake. 0 (always fetch) is kept as it is.
+ */
+static inline int locationMaxDataAge() {
+  int rotation = (int)settings.SleepDuration * locationCount();
+  if (settings.MaxDataAge <= 0 || locationCount() == 1 || rotation <= settings.MaxDataAge) {
+    return settings.MaxDataAge;
+  }
+  return rotation;
+}
+
+/**
+ * Move on to the location shown on this wake (the first one after a power-on) and
+ * select it. Its stored forecast becomes the RTC snapshot.
+ *
+ * @return Index of the location shown
+ */
+int locationAdvance();
+
+/**
+ * Index of the location shown on this wake.
+ */
+int locationShown();
+
+/**
+ * Make a location the current one: its name and coordinates are copied into settings
+ * (in RAM only, settings are not saved), so the fetch, cache and drawing code works on
+ * it unchanged.
+ *
+ * @param index 0 to locationCount() - 1
+ */
+void locationSelect(int index);
+
+/**
+ * Record that the selected location's forecast was fetched and store it in flash
+ * (the RTC snapshot must hold it). Does nothing with a single location.
+ *
+ * @param fetchTime UTC time of the fetch
+ */
+void locationFetched(time_t fetchTime);
+
+/**
+ * Whether a location's forecast would be too old by the wake that shows it, so it is
+ * worth fetching on the WiFi session of this wake. Unknown forecasts (after a power-on
+ * or for changed settings) always are.
+ *
+ * @param index 0 to locationCount() - 1
+ * @param now Current UTC time
+ */
+bool locationNeedsFetch(int index, time_t now);
+
+/**
+ * Whether an additional location has coordinates (resolved in setup mode).
+ */
+bool locationHasCoordinates(const SettingsLocation *location);
+
+/**
+ * An additional location, read from EEPROM on first use in a wake.
+ *
+ * @param index 1 to locationCount() - 1
+ * @return The location, or NULL for index 0 or out of range
+ */
+const SettingsLocation *locationExtra(int index);
+
+/**
+ * Replace the additional locations (setup mode) and set settings.ExtraLocationCount;
+ * call saveSettings() afterwards to store the count.
+ *
+ * @param locations count entries
+ * @param count 0 to MAX_LOCATIONS - 1
+ */
+void locationSetExtras(const SettingsLocation *locations, int count);
+
+#endif // __LOCATIONS_H__
@@ -19,19 +19,37 @@
 #include <esp_task_wdt.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
 #include "epd_driver.h"
-#include "esp_adc_cal.h"
-#include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <WiFi.h>
 #include <SPI.h>
 #include <time.h>
 #include <sys/time.h>
+#include <limits.h>
 #include "lang.h"
 #include "forecast_record.h"
 #include "renderer.h"
+#include "weather_view.h"
 #include "setup_mode.h"
 #include "settings.h"
+#include "forecast_cache.h"
+#include "partial_refresh.h"
+#include "perf_log.h"
+#include "scheduler.h"
+#include "rtc_drift.h"
+#include "api_client.h"
+#include "geocode.h"
+#include "weather_decoder.h"
+#include "fleet.h"
+#include "locations.h"
+#include "fetch_backoff.h"
+#include "memory_arena.h"
+#include "battery.h"
+#include "ota_update.h"
+#include "nowcast.h"
+#include "rtc_budget.h"
+#include "driver/rtc_io.h"
 
 // Platform detection
 #ifdef ESP32_S3_PLATFORM
@@ -64,33 +82,45 @@
 #define Black         0x00
 
 // Program variables
-#define max_hourly_readings 48  // One Call API 3.0 provides 48 hours of hourly forecasts
-#define max_daily_readings 8    // One Call API 3.0 provides 8 days of daily forecasts
+// 1 = fetch and decode on core 0 while the screen is drawn and pushed on core 1, 0 = one after the other
+#ifndef PIPELINED_FETCH
+#define PIPELINED_FETCH 1
+#endif
+#define FETCH_TASK_CORE  0     // The WiFi stack runs on core 0, setup() on core 1
+#define FETCH_TASK_STACK 8192  // Same as the Arduino loop task
 
-// Forecast arrays - use static allocation for ESP32, heap allocation for ESP32-S3
+// Button that wakes the display to show the next location (only armed with several locations).
+// On the S3 it is also the setup-mode button, which is only read after a reset.
 #if IS_ESP32_S3
-// ESP32-S3: Allocate on heap to avoid static initialization crash
-Forecast_record_type  *WxConditions = nullptr;
-Forecast_record_type  *WxHourlyForecast = nullptr;  
-Forecast_record_type  *WxDailyForecast = nullptr;
+#define LOCATION_BUTTON_PIN GPIO_NUM_21
 #else
-// ESP32: Use static allocation
+#define LOCATION_BUTTON_PIN GPIO_NUM_34  // Button 3
+#endif
+
+// Screen sections drawn by drawWeatherSections()
+#define SECTION_LOCATION 0x01
+#define SECTION_CURRENT  0x02
+#define SECTION_FORECAST 0x04
+#define SECTION_GRAPH    0x08
+#define SECTION_STATUS   0x10
+#define SECTION_ALL      0x1F
+
+// Fetch progress (fetchEvents bits): FETCH_*_READY (weather_decoder.h) as DecodeWeather()
+// stores each section, then
+#define FETCH_DONE          (1 << 3)  // fetchResult is valid
+
+// Forecast arrays (filled by DecodeWeather()) - statically allocated on both platforms.
+// Forecast_record_type is plain data (no String members), so there are no static
+// constructors to run and the arrays live in zero-initialised .bss.
 Forecast_record_type  WxConditions[1];
 Forecast_record_type  WxHourlyForecast[max_hourly_readings];  // Hourly forecasts for 24-hour graph
 Forecast_record_type  WxDailyForecast[max_daily_readings];    // Daily forecasts for 5-day display
-#endif
 
 // Runtime variables (not configuration - these change during execution)
 long StartTime       = 0;  // Timestamp when device woke up
 long SleepTimer      = 0;  // Calculated sleep duration in seconds
-long Delta           = 30; // RTC speed compensation offset (seconds)
 
-// Fonts
-#include "OpenSans8B.h"
-#include "OpenSans10B.h"
-#include "OpenSans12B.h"
-#include "OpenSans18B.h"
-#include "OpenSans24B.h"
+// Bitmaps
 #include "moon.h"
 #include "sunrise.h"
 #include "sunset.h"
@@ -101,48 +131,135 @@ uint8_t *framebuffer;
 
 String  Time_str = "--:--:--";
 String  Date_str = "-- --- ----";
-int     wifi_signal, CurrentHour = 0, CurrentMin = 0, CurrentSec = 0, EventCnt = 0, vref = 1100;
-int     globalTimezoneOffset = 0;  // Timezone offset in seconds (positive = east of UTC)
+int     wifi_signal, CurrentHour = 0, CurrentMin = 0, CurrentSec = 0, EventCnt = 0;
+RTC_DATA_ATTR int globalTimezoneOffset = 0;  // Timezone offset in seconds (positive = east of UTC), kept for the wake-hours check
+EventGroupHandle_t fetchEvents = NULL; // Pipelined fetch progress, NULL when fetching in line
+volatile int fetchResult = 2;          // obtainWeatherData() result of the pipelined fetch
+bool    forecastValid = false;     // WxHourlyForecast holds fetched or restored data (used by the scheduler)
+bool    fetchOtherLocations = false; // Other locations are due, keep WiFi on after the shown one's fetch
+bool    otaThisWake = false;       // Firmware update check or download due, keep WiFi on for it too
+String  statusBadge = "";          // Status bar message (stale-data badge), "" = none
+RTC_DATA_ATTR int failureScreenLocation = -1; // Location whose failed update is on the panel, -1 = none
+char    forecastETag[API_VALIDATOR_LEN] = "";         // Validators of the response the Wx arrays came from,
+char    forecastLastModified[API_VALIDATOR_LEN] = ""; // sent with the next request to make it conditional
 
 // RTC memory variable to track if low battery screen has been shown
 // This persists across deep sleep
 RTC_DATA_ATTR bool lowBatteryScreenShown = false;
 
+// WiFi fast reconnect cache: access point and DHCP lease from the last full connection
+#define WIFI_CACHE_MAGIC             0x57494649  // "WIFI" in hex
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 3000        // Give up on the cached AP after this long
+#define WIFI_FAST_CONNECT_MAX_USES   24          // Renew the DHCP lease with a full connect after this many wakes
+
+typedef struct {
+  uint32_t magic;
+  char     ssid[64];   // SSID the cache belongs to
+  uint8_t  bssid[6];
+  int32_t  channel;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  uint16_t uses;       // Fast connects since the lease was obtained
+} WiFiFastConnect_type;
+
+RTC_DATA_ATTR WiFiFastConnect_type wifiCache;
+static_assert(sizeof(globalTimezoneOffset) + sizeof(failureScreenLocation) + sizeof(lowBatteryScreenShown) +
+              sizeof(wifiCache) <= RTC_BUDGET_MAIN, "main.ino RTC variables over their allotment");
+
+// Connection phase timestamps (millis), set from WiFi events
+volatile unsigned long wifiAssociatedAt = 0;
+volatile unsigned long wifiGotIPAt = 0;
+
 // Function prototypes
 void BeginSleep();
 uint8_t StartWiFi();
 void StopWiFi();
 void InitialiseSystem();
-bool DecodeWeather(WiFiClient& json);
-int obtainWeatherData(WiFiClient & client); // Returns: 0 = success, 1 = API key invalid (401), 2 = other error
+void InitialiseHardware();
+int obtainWeatherData(); // Returns: 0 = success, 1 = API key invalid (401), 2 = other error
+int obtainNowcastData();
+void updateNowcast(time_t wakeTime);
 boolean UpdateLocalTime();
-void SetRTCTimeFromAPI(time_t apiTime, int timezoneOffset);
+void SetRTCTime(time_t utcTime, int timezoneOffset);
 void DisplayWeather();  // Main display function - adapted to use GUI layout
-String ConvertUnixTime(int unix_time);
-uint32_t readBatteryVoltage();
+void drawWeatherSections(uint8_t sections);
+int fetchAndDisplayWeather(bool rtcSet);
+bool isWithinWakeHours();
+uint8_t fleetChannel();
+bool receiveFleetForecast();
+bool otherLocationsNeedFetch(time_t now);
+void refreshOtherLocations();
+void showFetchFailure();
+void showFullScreen(void (*drawScreen)());
 
 /**
  * Prepare device for deep sleep and enter sleep mode.
- * Calculates sleep duration to align with minute boundaries based on SleepDuration.
- * The Delta offset compensates for ESP32 RTC drift.
+ * The sleep duration comes from the scheduler (scheduler.h): an interval adapted to the
+ * hourly forecast and battery voltage, aligned to local time, or the next WakeupHour
+ * when the wake would fall outside the wake hours.
+ * The timer period is corrected for the measured RTC drift (rtc_drift.h).
+ * A fleet gateway with a forecast spends that time awake answering the displays (fleet.h)
+ * and then sleeps only briefly, so the next update starts from a normal wake.
+ * After a failed fetch the sleep is shortened to a retry backoff (fetch_backoff.h).
+ * With several locations, LOCATION_BUTTON_PIN also wakes the display to show the next one.
  */
 void BeginSleep() {
+  perfBegin(PERF_POWEROFF);
   epd_poweroff_all();
-  UpdateLocalTime();
+  perfEnd(PERF_POWEROFF);
+  
+  if (otaReadyToBoot()) {
+    // Restart rather than deep sleep: the new firmware starts with its own RTC memory layout
+    perfCommit(1);
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println("Restarting into the new firmware...");
+      Serial.flush();
+    }
+#endif
+    esp_restart();
+  }
   
-  // Calculate sleep duration: align to next SleepDuration minute boundary
-  // Example: if SleepDuration=60 and current time is 14:23:45, sleep until 15:00:00
-  int minutesUntilNext = settings.SleepDuration - (CurrentMin % settings.SleepDuration);
-  int secondsUntilNext = (minutesUntilNext * 60) - CurrentSec;
-  SleepTimer = secondsUntilNext + Delta; // Add compensation offset
+  SleepTimer = scheduleSleepSeconds(time(NULL), forecastValid ? WxHourlyForecast : NULL, max_hourly_readings,
+                                    batteryMillivolts(), batteryRuntimeHours());
+  long scheduledSleep = SleepTimer;
+  SleepTimer = backoffSleepSeconds(SleepTimer, time(NULL)); // A failed fetch is retried sooner
+  if (SleepTimer < scheduledSleep) {
+    perfSetFlag(PERF_FLAG_BACKOFF);
+  }
+  // While rain is near, wake in between for the next hour's precipitation (nowcast.h)
+  bool nowcast = settings.FleetRole == FLEET_ROLE_STANDALONE && forecastValid && backoffFailures() == 0 &&
+                 nowcastWanted(time(NULL), WxHourlyForecast, max_hourly_readings, batteryMillivolts(),
+                               batteryRuntimeHours());
+  SleepTimer = nowcastSleepSeconds(time(NULL), SleepTimer, nowcast);
   
-  esp_sleep_enable_timer_wakeup(SleepTimer * 1000000LL); // Convert to microseconds
+  if (settings.FleetRole == FLEET_ROLE_GATEWAY && forecastValid) {
+    perfBegin(PERF_FLEET);
+    fleetServe(fleetChannel(), SleepTimer * 1000UL, WxConditions, WxHourlyForecast, WxDailyForecast,
+               forecastSnapshotFetchTime(), globalTimezoneOffset);
+    perfEnd(PERF_FLEET);
+    SleepTimer = 1;
+  }
+  
+  esp_sleep_enable_timer_wakeup(rtcDriftSleepMicros(SleepTimer));
+  if (locationCount() > 1) {
+#if IS_ESP32_S3
+    rtc_gpio_pullup_en(LOCATION_BUTTON_PIN); // GPIO 34 on the ESP32 kit has an external pull-up
+    rtc_gpio_pulldown_dis(LOCATION_BUTTON_PIN);
+#endif
+    esp_sleep_enable_ext0_wakeup(LOCATION_BUTTON_PIN, 0); // Pressed = LOW
+  }
+  perfCommit(SleepTimer);
   
   // Serial output (non-blocking, only if available)
 #if DEBUG_LEVEL
   if (Serial) {
     Serial.println("Awake for : " + String((millis() - StartTime) / 1000.0, 3) + "-secs");
-    Serial.println("Entering " + String(SleepTimer) + " (secs) of sleep time");
+    Serial.println("Entering " + String(SleepTimer) + " (secs) of sleep time, RTC drift " + String(rtcDriftPpm()) + " ppm");
+    perfPrintReport(Serial, 1);
+    arenaPrintReport(Serial);
     Serial.println("Starting deep-sleep period...");
     Serial.flush();
   }
@@ -162,9 +279,22 @@ void BeginSleep() {
  * @param timezoneOffset Timezone offset in seconds from UTC (positive = east of UTC, negative = west of UTC)
  */
 void SetRTCTimeFromAPI(time_t apiTime, int timezoneOffset) {
+  // Measure how far the clock drifted since the last sync before overwriting it
+  rtcDriftOnSync(apiTime);
+  SetRTCTime(apiTime, timezoneOffset);
+}
+
+/**
+ * Set the ESP32 RTC (UTC) and the timezone offset, without measuring drift against the
+ * new time (SetRTCTimeFromAPI() does that for the API's).
+ *
+ * @param utcTime Unix timestamp (UTC)
+ * @param timezoneOffset Timezone offset in seconds from UTC (positive = east of UTC)
+ */
+void SetRTCTime(time_t utcTime, int timezoneOffset) {
   // Store UTC time in RTC
   struct timeval tv;
-  tv.tv_sec = apiTime;
+  tv.tv_sec = utcTime;
   tv.tv_usec = 0;
   settimeofday(&tv, NULL);
   
@@ -173,7 +303,7 @@ void SetRTCTimeFromAPI(time_t apiTime, int timezoneOffset) {
   
 #if DEBUG_LEVEL
   if (Serial) {
-    Serial.println("RTC set from API time (UTC)");
+    Serial.println("RTC set (UTC)");
     Serial.print("Timezone offset: ");
     Serial.print(timezoneOffset / 3600.0);
     Serial.println(" hours");
@@ -191,9 +321,66 @@ void SetRTCTimeFromAPI(time_t apiTime, int timezoneOffset) {
 #endif
 }
 
+/**
+ * WiFi channel the fleet talks on: that of the access point last joined, so a gateway and
+ * its displays on the same network agree without configuration.
+ */
+uint8_t fleetChannel() {
+  if (wifiCache.magic == WIFI_CACHE_MAGIC && wifiCache.channel > 0) {
+    return wifiCache.channel;
+  }
+  return FLEET_DEFAULT_CHANNEL;
+}
+
+/**
+ * Record association and DHCP completion times for the current connection attempt.
+ */
+void WiFiTimingEvent(WiFiEvent_t event, WiFiEventInfo_t /* info */) {
+  if (event == ARDUINO_EVENT_WIFI_STA_CONNECTED) {
+    wifiAssociatedAt = millis();
+  } else if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    wifiGotIPAt = millis();
+  }
+}
+
+/**
+ * Check whether the RTC connection cache can be used for a fast reconnect.
+ * The cache is tied to the configured SSID and is re-validated with a full
+ * scan and DHCP lease every WIFI_FAST_CONNECT_MAX_USES wakes.
+ */
+bool WiFiFastConnectAvailable() {
+  return wifiCache.magic == WIFI_CACHE_MAGIC &&
+         wifiCache.uses < WIFI_FAST_CONNECT_MAX_USES &&
+         strncmp(wifiCache.ssid, settings.ssid, sizeof(wifiCache.ssid)) == 0;
+}
+
+/**
+ * Save the access point and DHCP lease of the current connection to RTC memory.
+ */
+void StoreWiFiFastConnect() {
+  uint8_t *bssid = WiFi.BSSID();
+  if (bssid == NULL) {
+    return;
+  }
+  memcpy(wifiCache.bssid, bssid, sizeof(wifiCache.bssid));
+  strncpy(wifiCache.ssid, settings.ssid, sizeof(wifiCache.ssid) - 1);
+  wifiCache.ssid[sizeof(wifiCache.ssid) - 1] = '\0';
+  wifiCache.channel = WiFi.channel();
+  wifiCache.ip      = (uint32_t)WiFi.localIP();
+  wifiCache.gateway = (uint32_t)WiFi.gatewayIP();
+  wifiCache.subnet  = (uint32_t)WiFi.subnetMask();
+  wifiCache.dns     = (uint32_t)WiFi.dnsIP(0);
+  wifiCache.uses    = 0;
+  wifiCache.magic   = WIFI_CACHE_MAGIC;
+}
+
 /**
  * Connect to WiFi network and retrieve signal strength.
- * Attempts connection twice if first attempt fails.
+ * 
+ * If a previous wake stored the access point (BSSID/channel) and DHCP lease in RTC
+ * memory, the station joins that AP directly with a static configuration, skipping
+ * the channel scan and DHCP handshake. If that fails, the cache is discarded and a
+ * normal scan + DHCP connection is made, retried once on failure.
  * 
  * @return WiFi status (WL_CONNECTED on success)
  */
@@ -202,33 +389,76 @@ uint8_t StartWiFi() {
   if (Serial) {
     Serial.println("\r\nWiFi Connecting to: " + String(settings.ssid));
   }
+  unsigned long wifiStart = millis();
 #endif
-  IPAddress dns(8, 8, 8, 8); // Google DNS
+  wifiAssociatedAt = 0;
+  wifiGotIPAt = 0;
+  static bool timingEventRegistered = false; // Retries and other-location fetches connect again
+  if (!timingEventRegistered) {
+    WiFi.onEvent(WiFiTimingEvent);
+    timingEventRegistered = true;
+  }
+  
   WiFi.disconnect();
   WiFi.mode(WIFI_STA); // Station mode (client)
-  WiFi.begin(settings.ssid, settings.password);
   
-  if (WiFi.waitForConnectResult() != WL_CONNECTED) {
+  bool fastConnect = WiFiFastConnectAvailable();
+  if (fastConnect) {
+    // Fast path: static lease, known channel and BSSID - no scan, no DHCP
+    wifiCache.uses++;
+    WiFi.config(IPAddress(wifiCache.ip), IPAddress(wifiCache.gateway), IPAddress(wifiCache.subnet), IPAddress(wifiCache.dns));
+    WiFi.begin(settings.ssid, settings.password, wifiCache.channel, wifiCache.bssid);
+    
+    if (WiFi.waitForConnectResult(WIFI_FAST_CONNECT_TIMEOUT_MS) != WL_CONNECTED) {
 #if DEBUG_LEVEL
-    if (Serial) {
-      Serial.printf("WiFi connection failed, retrying...!\n");
-    }
+      if (Serial) {
+        Serial.printf("WiFi fast connect failed after %lu ms, falling back to full scan\n", millis() - wifiStart);
+      }
 #endif
-    WiFi.disconnect(true); // Clear stored credentials
-    delay(500);
+      fastConnect = false;
+      wifiCache.magic = 0;
+      WiFi.disconnect();
+      WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE); // Back to DHCP
+      wifiAssociatedAt = 0;
+      wifiGotIPAt = 0;
+    }
+  }
+  
+  if (!fastConnect) {
     WiFi.begin(settings.ssid, settings.password);
+    
+    if (WiFi.waitForConnectResult() != WL_CONNECTED) {
+#if DEBUG_LEVEL
+      if (Serial) {
+        Serial.printf("WiFi connection failed, retrying...!\n");
+      }
+#endif
+      WiFi.disconnect(true); // Clear stored credentials
+      delay(500);
+      WiFi.begin(settings.ssid, settings.password);
+    }
   }
   
   if (WiFi.waitForConnectResult() == WL_CONNECTED) {
     wifi_signal = WiFi.RSSI(); // Store signal strength before WiFi is turned off
+    if (fastConnect) {
+      perfSetFlag(PERF_FLAG_WIFI_FAST);
+    } else {
+      StoreWiFiFastConnect();
+    }
 #if DEBUG_LEVEL
     if (Serial) {
       Serial.println("WiFi connected at: " + WiFi.localIP().toString());
+      unsigned long associateMs = wifiAssociatedAt ? wifiAssociatedAt - wifiStart : 0;
+      unsigned long dhcpMs = (wifiGotIPAt && wifiAssociatedAt) ? wifiGotIPAt - wifiAssociatedAt : 0;
+      Serial.printf("WiFi %s connect: associate %lu ms, DHCP %lu ms, total %lu ms\n",
+                    fastConnect ? "fast" : "full", associateMs, dhcpMs, millis() - wifiStart);
     }
 #endif
   }
   else {
     wifi_signal = 0;
+    wifiCache.magic = 0;
 #if DEBUG_LEVEL
     if (Serial) {
       Serial.println("WiFi connection *** FAILED ***");
@@ -242,6 +472,7 @@ uint8_t StartWiFi() {
  * Disconnect from WiFi and power down WiFi module to save power.
  */
 void StopWiFi() {
+  apiClose();
   WiFi.disconnect();
   WiFi.mode(WIFI_OFF);
 #if DEBUG_LEVEL
@@ -253,7 +484,6 @@ void StopWiFi() {
 
 /**
  * Initialize system components: serial, display, and framebuffer.
- * Framebuffer uses 4-bit grayscale (2 pixels per byte), hence size is width*height/2.
  */
 void InitialiseSystem() {
   StartTime = millis();
@@ -271,56 +501,35 @@ void InitialiseSystem() {
   }
 #endif
   
-#if IS_ESP32_S3
-  // ESP32-S3: Check PSRAM
-  if (ESP.getPsramSize() == 0) {
-    // PSRAM required - enter infinite loop (will retry on next boot)
-    // Don't use Serial here as it may not be available
-    while(1) { delay(1000); }
-  }
-  
-  // Allocate framebuffer
-  size_t fb_size = EPD_WIDTH * EPD_HEIGHT / 2;
-  framebuffer = (uint8_t *)ps_calloc(1, fb_size);
-  if (!framebuffer) {
-    // Framebuffer allocation failed - enter infinite loop (will retry on next boot)
-    while(1) { delay(1000); }
-  }
-  memset(framebuffer, 0xFF, fb_size);
-  
-  // Initialize settings
-  initSettings();
-  
-  // Initialize display
-  epd_init();
-  
-  // Allocate forecast arrays on heap (avoid static initialization crash)
-  WxConditions = new Forecast_record_type[1];
-  WxHourlyForecast = new Forecast_record_type[max_hourly_readings];
-  WxDailyForecast = new Forecast_record_type[max_daily_readings];
-  
-  if (!WxConditions || !WxHourlyForecast || !WxDailyForecast) {
-    // Forecast array allocation failed - enter infinite loop (will retry on next boot)
-    while(1) { delay(1000); }
-  }
-#else
-  // ESP32: Initialize settings first
+  InitialiseHardware();
+}
+
+/**
+ * Settings, display and framebuffer, the same way on both boards (also for setup mode).
+ * The framebuffer is the first allocation from the memory arena (memory_arena.h), which
+ * reserves all of its PSRAM regions at once. Without PSRAM nothing can be drawn, so the
+ * board stops here until the next reset.
+ */
+void InitialiseHardware() {
+  perfBegin(PERF_SETTINGS);
   initSettings();
+  perfEnd(PERF_SETTINGS);
   
-  // Initialize display
+  perfBegin(PERF_DISPLAY_INIT);
   epd_init();
   
-  // Allocate framebuffer: 4-bit grayscale = 2 pixels per byte
-  framebuffer = (uint8_t *)ps_calloc(sizeof(uint8_t), EPD_WIDTH * EPD_HEIGHT / 2);
+  // Framebuffer: 4-bit grayscale = 2 pixels per byte
+  framebuffer = (uint8_t *)arenaAlloc(ARENA_FRAMEBUFFER, ARENA_FRAMEBUFFER_SIZE);
   if (!framebuffer) {
 #if DEBUG_LEVEL
     if (Serial) {
       Serial.println("Memory alloc failed!");
     }
 #endif
+    while(1) { delay(1000); }
   }
-  memset(framebuffer, 0xFF, EPD_WIDTH * EPD_HEIGHT / 2); // Fill with white
-#endif
+  memset(framebuffer, 0xFF, ARENA_FRAMEBUFFER_SIZE); // Fill with white
+  perfEnd(PERF_DISPLAY_INIT);
 }
 
 void loop() {
@@ -377,6 +586,52 @@ bool checkSetupModeEntry() {
 #endif
 }
 
+/**
+ * Check whether the current local time falls within the configured wake hours.
+ * Updates CurrentHour/Time_str/Date_str from the RTC; the RTC must already be set.
+ * 
+ * @return true if the display should be updated now
+ */
+bool isWithinWakeHours() {
+  UpdateLocalTime();
+  
+  bool WakeUp = scheduleHourIsAwake(CurrentHour);
+  
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.print("Current hour: ");
+    Serial.println(CurrentHour);
+    Serial.print("Wake hours: ");
+    Serial.print(settings.WakeupHour);
+    Serial.print(" - ");
+    Serial.println(settings.SleepHour);
+    Serial.print("WakeUp status: ");
+    Serial.println(WakeUp ? "true" : "false");
+  }
+#endif
+  return WakeUp;
+}
+
+/**
+ * Clear the panel and show a full-screen message (setup mode, low battery, errors).
+ * The next weather screen is then redrawn in full.
+ * 
+ * @param drawScreen Function drawing the message into the framebuffer
+ */
+void showFullScreen(void (*drawScreen)()) {
+  invalidateDisplayRegions();
+  failureScreenLocation = -1;
+  drawScreen();
+  perfBegin(PERF_PANEL);
+  epd_poweron();
+  epd_clear();
+  epd_draw_grayscale_image(epd_full_screen(), framebuffer);
+  perfEnd(PERF_PANEL);
+  perfBegin(PERF_POWEROFF);
+  epd_poweroff_all();
+  perfEnd(PERF_POWEROFF);
+}
+
 /**
  * Main setup function - runs once on wake from deep sleep.
  * 
@@ -385,13 +640,27 @@ bool checkSetupModeEntry() {
  * 2. Check for setup mode entry button combo
  * 3. Initialize system (display, framebuffer)
  * 4. Check battery voltage - if low, show warning and sleep
- * 5. Connect to WiFi
- * 6. Check RTC and wake hours - fetch weather if within wake hours or RTC not set
- * 7. Parse weather data and set RTC time from API
- * 8. Draw weather display to framebuffer and update e-paper screen
- * 9. Enter deep sleep until next wake time
+ * 5. If the RTC is set and the time is outside wake hours, sleep until WakeupHour (no WiFi).
+ *    On a nowcast wake between two regular updates (nowcast.h) only the next hour's
+ *    precipitation is fetched and only the status bar is pushed with it
+ * 6. Move on to the next location (locations.h) and, if its forecast snapshot is younger than
+ *    the maximum data age, redraw from it and sleep (no WiFi)
+ * 7. Connect to WiFi and fetch weather, unless the circuit breaker is open (fetch_backoff.h)
+ * 8. Parse weather data, set RTC time from API and store the forecast snapshot; then fetch
+ *    the other locations that are due on the same WiFi session
+ * 9. Draw weather display to framebuffer and update the changed regions of the e-paper screen
+ *    (with PIPELINED_FETCH, steps 8 and 9 overlap: core 0 fetches while core 1 draws each section)
+ *    On a failure the last good screen is kept, with a stale-data badge, and the fetch is
+ *    retried after a short backoff instead
+ * 10. Enter deep sleep until the next wake time chosen by the scheduler, or the next nowcast
+ *    wake before it while rain is near
+ * 
+ * Each phase is timed into the wake log (perf_log.h), which is printed before sleep
+ * when DEBUG_LEVEL is set and served at /perf in setup mode.
  */
 void setup() {
+  perfInit();
+  
   // Initialize Serial (non-blocking - works without serial connection)
   // Don't call Serial.end() - just begin it once, it will work if USB is connected
 #if DEBUG_LEVEL
@@ -403,8 +672,11 @@ void setup() {
   // Don't wait for serial connection - proceed immediately
 #endif
   
-  // Check for setup mode entry early - before heavy initialization
-  if (checkSetupModeEntry()) {
+  rtcDriftOnWake(); // Correct the clock for drift over the last sleep
+  
+  // Check for setup mode entry early - before heavy initialization. Not on a location
+  // button wake: on the S3 that button is the setup button, held while tapping reset.
+  if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_EXT0 && checkSetupModeEntry()) {
     // Enter setup mode
 #if DEBUG_LEVEL
     if (Serial) {
@@ -412,44 +684,11 @@ void setup() {
     }
 #endif
     
-#if IS_ESP32_S3
-    // ESP32-S3: Initialize minimal system for setup mode
     StartTime = millis();
-    
-    // Check PSRAM
-    if (ESP.getPsramSize() == 0) {
-      while(1) { delay(1000); }
-    }
-    
-    // Allocate framebuffer
-    size_t fb_size = EPD_WIDTH * EPD_HEIGHT / 2;
-    framebuffer = (uint8_t *)ps_calloc(1, fb_size);
-    if (!framebuffer) {
-      while(1) { delay(1000); }
-    }
-    memset(framebuffer, 0xFF, fb_size);
-    
-    // Initialize settings (needed for setup mode)
-    initSettings();
-    
-    // Initialize display
-    epd_init();
-    
-    // Allocate forecast arrays (needed for rendering)
-    WxConditions = new Forecast_record_type[1];
-    WxHourlyForecast = new Forecast_record_type[max_hourly_readings];
-    WxDailyForecast = new Forecast_record_type[max_daily_readings];
-#else
-    // ESP32: Initialize system normally
-    InitialiseSystem();
-#endif
+    InitialiseHardware(); // Serial is already running
     
     // Show setup mode screen
-    epd_poweron();
-    epd_clear();
-    drawSetupModeScreen();
-    epd_draw_grayscale_image(epd_full_screen(), framebuffer);
-    epd_poweroff_all();
+    showFullScreen([]() { drawSetupModeScreen(setupUpdatePin()); });
     
 #if DEBUG_LEVEL
     if (Serial) {
@@ -464,27 +703,29 @@ void setup() {
   
   // Normal boot - initialize system
   InitialiseSystem();
+#if ICON_BENCHMARK && DEBUG_LEVEL
+  benchmarkIconRendering();
+#endif
   
-  // Check battery voltage first - if low, show message once and sleep
-  uint32_t batVoltage = readBatteryVoltage();
-  float voltage = (batVoltage > 0) ? (batVoltage / 1000.0) : 0.0;
+  // Check battery voltage first - if low, show message once and sleep. This is the
+  // wake's only reading, taken before the radio draws current (battery.h)
+  perfBegin(PERF_BATTERY);
+  uint32_t batVoltage = batterySample(time(NULL));
+  perfEnd(PERF_BATTERY);
   
-  if (voltage > 0 && voltage <= 3.2) {
+  if (batVoltage > 0 && batVoltage <= BATTERY_CUTOFF_MV) {
     // Battery is low (<= 3.2V)
+    perfSetFlag(PERF_FLAG_LOW_BATTERY);
     if (!lowBatteryScreenShown) {
       // Show low battery screen once
 #if DEBUG_LEVEL
       if (Serial) {
-        Serial.println("Low battery detected: " + String(voltage, 2) + "V");
+        Serial.println("Low battery detected: " + String(batVoltage / 1000.0, 2) + "V");
         Serial.println("Displaying low battery screen...");
       }
 #endif
       
-      epd_poweron();
-      epd_clear();
-      drawLowBatteryScreen();
-      epd_draw_grayscale_image(epd_full_screen(), framebuffer);
-      epd_poweroff_all();
+      showFullScreen(drawLowBatteryScreen);
       
       // Mark that we've shown the screen
       lowBatteryScreenShown = true;
@@ -508,477 +749,684 @@ void setup() {
   }
   
   // Battery is OK (> 3.2V), reset the flag and proceed normally
-  if (voltage > 3.2) {
+  if (batVoltage > BATTERY_CUTOFF_MV) {
     lowBatteryScreenShown = false; // Reset flag when battery is good
   }
   
-  if (StartWiFi() == WL_CONNECTED) {
-    // Validate and geocode location if needed (after setup mode has finished)
-    // Returns: 0 = success, 1 = API key invalid (401), 2 = other error (invalid location, etc.)
-    int locationResult = validateAndGeocodeLocation();
-    
-    if (locationResult == 1) {
-      // API key is invalid - show error screen
+  // Check if RTC is initialized (timestamp >= year 2000)
+  time_t wakeTime = time(NULL);
+  bool rtcSet = (wakeTime >= 946684800); // Unix timestamp for 2000-01-01
+  
+  // Outside wake hours nothing is fetched or drawn and the radio stays off. The scheduler
+  // sleeps straight through to WakeupHour, so this only happens after RTC drift.
+  if (rtcSet && !isWithinWakeHours()) {
 #if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("OpenWeatherMap API key is invalid");
-      }
+    if (Serial) {
+      Serial.println("Outside wake hours, skipping weather fetch and display update");
+    }
 #endif
-      StopWiFi();
-      epd_poweron();
-      epd_clear();
-      drawInvalidAPIKeyScreen();
-      epd_draw_grayscale_image(epd_full_screen(), framebuffer);
-      epd_poweroff_all();
-      
-      // Go to sleep - user needs to enter setup mode to fix API key
+    BeginSleep();
+    return; // Exit setup() early
+  }
+  
+  // A nowcast wake between two regular updates only redraws the status bar (nowcast.h)
+  if (rtcSet && esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER && backoffFailures() == 0 &&
+      nowcastBeginWake(wakeTime)) {
+    updateNowcast(wakeTime);
+    BeginSleep();
+    return; // Exit setup() early
+  }
+  
+  // Each wake (timer or button) shows the next location; its stored forecast becomes the RTC snapshot
+  locationAdvance();
+  
+  // Redraw from the RTC snapshot while it is fresh - the radio stays off
+  if (rtcSet && restoreForecastSnapshot(wakeTime, locationMaxDataAge() * 60L, WxConditions, WxHourlyForecast,
+                                        WxDailyForecast, &globalTimezoneOffset, &wifi_signal)) {
 #if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("Entering deep sleep due to invalid API key...");
-      }
+    if (Serial) {
+      Serial.println("Drawing weather display from cached forecast...");
+    }
 #endif
-      BeginSleep();
-      return; // Exit setup() early
-    } else if (locationResult == 2) {
-      // Location is invalid and geocoding failed - show error screen
+    forecastValid = true;
+    perfSetFlag(PERF_FLAG_CACHED);
+    buildWeatherView(WxConditions[0], WxHourlyForecast, max_hourly_readings, WxDailyForecast, max_daily_readings,
+                     wakeTime, globalTimezoneOffset);
+    DisplayWeather();
+    perfBegin(PERF_PANEL);
+    refreshWeatherDisplay(); // Only the regions that changed since the last wake are redrawn
+    perfEnd(PERF_PANEL);
+    BeginSleep();
+    return; // Exit setup() early
+  }
+  
+  // A fleet display asks the gateway before powering up WiFi; without an answer it fetches
+  if (settings.FleetRole == FLEET_ROLE_DISPLAY && receiveFleetForecast()) {
 #if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("Location validation failed. Displaying error screen...");
-      }
+    if (Serial) {
+      Serial.println("Drawing weather display from fleet forecast...");
+    }
 #endif
-      StopWiFi();
-      epd_poweron();
-      epd_clear();
-      drawInvalidLocationScreen();
-      epd_draw_grayscale_image(epd_full_screen(), framebuffer);
-      epd_poweroff_all();
-      
-      // Go to sleep - user needs to enter setup mode to fix location
+    DisplayWeather();
+    perfBegin(PERF_PANEL);
+    refreshWeatherDisplay();
+    perfEnd(PERF_PANEL);
+    BeginSleep();
+    return; // Exit setup() early
+  }
+  
+  // Coordinates are resolved in setup mode (geocode.h); without them there is nothing to fetch
+  if (!geocodeHasCoordinates()) {
 #if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("Entering deep sleep due to invalid location...");
-      }
-#endif
-      BeginSleep();
-      return; // Exit setup() early
+    if (Serial) {
+      Serial.println("Location has no coordinates. Displaying error screen...");
     }
-    // locationResult == 0 means success, continue normally
-    
-    // Check if RTC is initialized (timestamp >= year 2000)
-    time_t now = time(NULL);
-    bool rtcSet = (now >= 946684800); // Unix timestamp for 2000-01-01
+#endif
+    perfSetFlag(PERF_FLAG_FETCH_ERROR);
+    showFullScreen(drawInvalidLocationScreen);
     
-    bool WakeUp = false;
-    if (rtcSet) {
-      // RTC is set - check if current time is within wake hours
-      UpdateLocalTime();
-      
-      // SleepHour == 24 means "never sleep" (always wake)
-      if (settings.SleepHour == 24) {
-        WakeUp = true; // Always wake regardless of hour
-      } else {
-        // Handle wake hours that span midnight (e.g., 22:00 to 06:00)
-        if (settings.WakeupHour > settings.SleepHour) {
-          // Spanning midnight: wake if hour >= WakeupHour OR hour <= SleepHour
-          WakeUp = (CurrentHour >= settings.WakeupHour || CurrentHour <= settings.SleepHour);
-        } else {
-          // Normal range: wake if hour is between WakeupHour and SleepHour
-          WakeUp = (CurrentHour >= settings.WakeupHour && CurrentHour <= settings.SleepHour);
-        }
-      }
-      
+    // Go to sleep - user needs to enter setup mode to fix location
 #if DEBUG_LEVEL
-      if (Serial) {
-        Serial.print("Current hour: ");
-        Serial.println(CurrentHour);
-        Serial.print("Wake hours: ");
-        Serial.print(settings.WakeupHour);
-        Serial.print(" - ");
-        Serial.println(settings.SleepHour);
-        Serial.print("WakeUp status: ");
-        Serial.println(WakeUp ? "true" : "false");
-      }
+    if (Serial) {
+      Serial.println("Entering deep sleep due to invalid location...");
+    }
 #endif
-    } else {
-      // RTC not initialized - always fetch weather to set time from API
+    BeginSleep();
+    return; // Exit setup() early
+  }
+  
+  // The circuit breaker keeps the radio off until the interval it was opened for has passed
+  if (!backoffAllowAttempt(wakeTime)) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println("Circuit breaker open, not fetching");
+    }
+#endif
+    perfSetFlag(PERF_FLAG_BACKOFF);
+    showFetchFailure();
+    BeginSleep();
+    return; // Exit setup() early
+  }
+  
+  // Decided before the fetch: the pipelined fetch task must not switch locations under the drawing code
+  fetchOtherLocations = otherLocationsNeedFetch(wakeTime);
+  otaThisWake = otaDue(wakeTime);
+  // A retry only touches the panel once there is something new to show
+  bool pipelined = PIPELINED_FETCH && backoffFailures() == 0;
+  
+  perfBegin(PERF_WIFI);
+  uint8_t wifiStatus = StartWiFi();
+  perfEnd(PERF_WIFI);
+  int weatherResult = 2; // 0 = success, 1 = API key invalid, 2 = other error
+  if (wifiStatus == WL_CONNECTED) {
+    if (!rtcSet) {
+      // RTC not initialized - the weather fetch sets the time from the API
 #if DEBUG_LEVEL
       if (Serial) {
         Serial.println("RTC not set, fetching weather to set time from API...");
       }
 #endif
-      WakeUp = true;
     }
     
-    if (WakeUp) {
 #if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("Within wake hours, fetching weather...");
-      }
+    if (Serial) {
+      Serial.println("Within wake hours, fetching weather...");
+    }
 #endif
-      byte Attempts = 1;
-      int weatherResult = 2; // 0 = success, 1 = API key invalid, 2 = other error
-      WiFiClient client;
-      while (weatherResult != 0 && Attempts <= 2) {
-        if (weatherResult != 0) {
-          weatherResult = obtainWeatherData(client);
-        }
-        Attempts++;
-      }
+    // One attempt: a failure is retried on a later wake (fetch_backoff.h), not back to back
+    if (pipelined) {
+      weatherResult = fetchAndDisplayWeather(rtcSet); // Draws and pushes the screen as the data arrives
+    } else {
+      weatherResult = obtainWeatherData();
+    }
 #if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("Received weather data...");
-      }
+    if (Serial) {
+      Serial.println("Received weather data...");
+    }
 #endif
-      if (weatherResult == 0) {
-        // Update time strings after RTC was set from API
-        UpdateLocalTime();
-        
-        StopWiFi();
-        epd_poweron();
-        epd_clear();
-        
+  }
+  else {
 #if DEBUG_LEVEL
-        if (Serial) {
-          Serial.println("Drawing weather display...");
-        }
+    if (Serial) {
+      Serial.println("WiFi or time setup failed");
+    }
 #endif
-        DisplayWeather();
-        
-        // Update display - render framebuffer to screen
+  }
+  
+  if (weatherResult == 0) {
+    forecastValid = true;
+    perfSetFlag(PERF_FLAG_FETCHED);
+    backoffSuccess();
+    failureScreenLocation = -1;
+    // Update time strings after RTC was set from API
+    UpdateLocalTime();
+    storeForecastSnapshot(WxConditions, WxHourlyForecast, WxDailyForecast, time(NULL),
+                          globalTimezoneOffset, wifi_signal, forecastETag, forecastLastModified);
+    locationFetched(time(NULL));
+    otaMarkValid(); // This firmware fetches the weather: keep it
+    if (fetchOtherLocations) {
+      refreshOtherLocations(); // The pipelined fetch task left WiFi on for them
+    }
+    if (otaThisWake) {
+      perfBegin(PERF_OTA);
+      otaRun(time(NULL)); // Last on the session: a new firmware is booted from BeginSleep()
+      perfEnd(PERF_OTA);
+    }
+    
+    if (pipelined) {
+      if (fetchOtherLocations || otaThisWake) {
+        StopWiFi();
+      }
+    } else {
+      StopWiFi();
+      
 #if DEBUG_LEVEL
-        if (Serial) {
-          Serial.println("Updating display...");
-        }
+      if (Serial) {
+        Serial.println("Drawing weather display...");
+      }
 #endif
-        epd_draw_grayscale_image(epd_full_screen(), framebuffer);
-        epd_poweroff_all();
+      DisplayWeather();
+      
+      // Update display - push changed regions of the framebuffer to screen
 #if DEBUG_LEVEL
-        if (Serial) {
-          Serial.println("Display updated successfully");
-        }
+      if (Serial) {
+        Serial.println("Updating display...");
+      }
 #endif
-      } else if (weatherResult == 1) {
-        // API key is invalid - show error screen
+      perfBegin(PERF_PANEL);
+      refreshWeatherDisplay();
+      perfEnd(PERF_PANEL);
+    }
 #if DEBUG_LEVEL
-        if (Serial) {
-          Serial.println("OpenWeatherMap API key is invalid");
-        }
+    if (Serial) {
+      Serial.println("Display updated successfully");
+    }
 #endif
-        StopWiFi();
-        epd_poweron();
-        epd_clear();
-        drawInvalidAPIKeyScreen();
-        epd_draw_grayscale_image(epd_full_screen(), framebuffer);
-        epd_poweroff_all();
-      } else {
-        // Other error - show generic error message
+  } else if (weatherResult == 1) {
+    // API key is invalid - show error screen (not a network failure, so no retries)
+    perfSetFlag(PERF_FLAG_FETCH_ERROR);
 #if DEBUG_LEVEL
-        if (Serial) {
-          Serial.println("Failed to receive weather data");
-        }
+    if (Serial) {
+      Serial.println("OpenWeatherMap API key is invalid");
+    }
 #endif
-        epd_poweron();
-        epd_clear();
-        drawWiFiErrorScreen(); // Reuse WiFi error screen for generic errors
-        epd_draw_grayscale_image(epd_full_screen(), framebuffer);
-        epd_poweroff_all();
-      }
-    } else {
-      // Outside wake hours - skip weather fetch and display update to save power
-      // Leave current display image in place and go back to sleep
+    StopWiFi();
+    showFullScreen(drawInvalidAPIKeyScreen);
+  } else {
+    // WiFi, connection or response failure - keep the last good screen and retry soon
+    perfSetFlag(PERF_FLAG_FETCH_ERROR);
 #if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("Outside wake hours, skipping weather fetch and display update");
-      }
+    if (Serial) {
+      Serial.println("Failed to receive weather data");
+    }
 #endif
-      StopWiFi();
-      // No EPD operations - current image remains on screen
+    StopWiFi();
+    backoffFailure();
+    showFetchFailure();
+  }
+  BeginSleep();
+}
+
+/**
+ * Show that the forecast could not be updated, touching the panel only the first time
+ * for the location shown. With a forecast to fall back on (however old) its screen is
+ * redrawn with a stale-data badge in the status bar; the partial refresh then only
+ * redraws the tiles that changed from the last good screen. Without one the WiFi error
+ * screen is shown.
+ */
+void showFetchFailure() {
+  if (failureScreenLocation == locationShown()) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println("Failure already on screen, panel left alone");
     }
+#endif
+    return;
   }
-  else {
+  
+  time_t now = time(NULL);
+  time_t fetchTime = forecastSnapshotFetchTime();
+  if (fetchTime && restoreForecastSnapshot(now, LONG_MAX, WxConditions, WxHourlyForecast, WxDailyForecast,
+                                           &globalTimezoneOffset, &wifi_signal)) {
+    forecastValid = true;
+    UpdateLocalTime();
+    buildWeatherView(WxConditions[0], WxHourlyForecast, max_hourly_readings, WxDailyForecast, max_daily_readings,
+                     now, globalTimezoneOffset);
+    char fetched[32];
+    time_t local = fetchTime + globalTimezoneOffset;
+    strftime(fetched, sizeof(fetched), strcmp(settings.Units, "M") == 0 ? "%H:%M" : "%I:%M%p", gmtime(&local));
+    statusBadge = String("Offline, data from ") + fetched;
+    wifi_signal = 0; // Drawn as no signal
+    DisplayWeather();
+    perfBegin(PERF_PANEL);
+    refreshWeatherDisplay();
+    perfEnd(PERF_PANEL);
+    statusBadge = "";
+  } else {
 #if DEBUG_LEVEL
     if (Serial) {
-      Serial.println("WiFi or time setup failed");
       Serial.println("Displaying WiFi connection error...");
     }
 #endif
-    
-    epd_poweron();
-    epd_clear();
-    drawWiFiErrorScreen();
-    epd_draw_grayscale_image(epd_full_screen(), framebuffer);
-    epd_poweroff_all();
+    showFullScreen(drawWiFiErrorScreen); // Reuse WiFi error screen for generic errors
   }
-  BeginSleep();
+  failureScreenLocation = locationShown();
 }
 
 /**
- * Main display function - renders complete weather information to framebuffer.
- * Layout includes: location/date, current conditions, 5-day forecast, 24-hour graph, and status bar.
+ * Nowcast wake (nowcast.h): fetch the next hour's precipitation for the location on the
+ * panel and push only the status bar, with the new sparkline, refresh time and battery.
+ * The forecast sections are neither drawn nor pushed. When the panel is due a full clear
+ * the whole screen is redrawn from the RTC snapshot instead. A failed fetch leaves the
+ * panel alone; the regular update after it is not affected.
  */
-void DisplayWeather() {
-#if IS_ESP32_S3
-  // ESP32-S3: Check that arrays are allocated
-  if (!WxConditions || !WxHourlyForecast || !WxDailyForecast) {
+void updateNowcast(time_t wakeTime) {
+  perfSetFlag(PERF_FLAG_NOWCAST);
+  locationSelect(locationShown()); // Not the next location: this is not a rotation wake
+  
+  perfBegin(PERF_WIFI);
+  uint8_t wifiStatus = StartWiFi();
+  perfEnd(PERF_WIFI);
+  int result = (wifiStatus == WL_CONNECTED) ? obtainNowcastData() : 2;
+  StopWiFi();
+  if (result != 0) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println("Nowcast not received, panel left alone");
+    }
+#endif
     return;
   }
-#endif
+  UpdateLocalTime();
   
-  // Clear framebuffer to white
   memset(framebuffer, 0xFF, EPD_WIDTH * EPD_HEIGHT / 2);
-  
-  // Get current time from RTC for forecast day labels
-  time_t now = time(NULL);
-  struct tm *timeInfo = localtime(&now);
-  if (timeInfo == NULL) {
-    // Fallback if RTC not set
-    struct tm defaultTime = {0};
-    timeInfo = &defaultTime;
-  }
-  
-  // Render display sections in order (back to front)
-  drawLocationDate(settings.City, Date_str);                                    // Top right: city and date
-  drawCurrentConditions(WxConditions, wifi_signal);                    // Center: current weather
-  drawForecast(WxDailyForecast, max_daily_readings, timeInfo);         // Top row: 5-day forecast
-  drawOutlookGraph(WxHourlyForecast, max_hourly_readings, timeInfo);   // Bottom: 24-hour graph
-  drawStatusBar("", Time_str, wifi_signal, readBatteryVoltage());       // Bottom: status indicators
+  drawWeatherSections(SECTION_STATUS);
+  perfBegin(PERF_PANEL);
+  bool pushed = refreshRegionsOnly(1 << REGION_STATUS);
+  perfEnd(PERF_PANEL);
+  int snapshotSignal; // The status bar keeps this wake's signal
+  if (!pushed && restoreForecastSnapshot(wakeTime, LONG_MAX, WxConditions, WxHourlyForecast, WxDailyForecast,
+                                         &globalTimezoneOffset, &snapshotSignal)) {
+    buildWeatherView(WxConditions[0], WxHourlyForecast, max_hourly_readings, WxDailyForecast, max_daily_readings,
+                     wakeTime, globalTimezoneOffset);
+    DisplayWeather();
+    perfBegin(PERF_PANEL);
+    refreshWeatherDisplay();
+    perfEnd(PERF_PANEL);
+  }
 }
 
 /**
- * Convert Unix timestamp to formatted time string.
- * Format depends on unit system (Metric = 24-hour, Imperial = 12-hour with AM/PM).
+ * Fleet display: receive the forecast from the gateway, set the clock from the gateway's
+ * and keep the forecast in the RTC snapshot like a fetched one.
+ * A forecast older than two update intervals means the gateway is not updating; it is
+ * refused so the display fetches instead.
  * 
- * @param unix_time Unix timestamp
- * @return Formatted time string (e.g., "14:30" or "2:30PM")
+ * @return true if the Wx arrays and weatherView hold the gateway's forecast
  */
-String ConvertUnixTime(int unix_time) {
-  time_t tm = unix_time;
-  struct tm *now_tm = localtime(&tm);
-  char output[40];
-  if (String(settings.Units) == "M") {
-    strftime(output, sizeof(output), "%H:%M %d/%m/%y", now_tm); // 24-hour format
-  }
-  else {
-    strftime(output, sizeof(output), "%I:%M%P %m/%d/%y", now_tm); // 12-hour with AM/PM
+bool receiveFleetForecast() {
+  time_t fetchTime, gatewayTime;
+  int timezoneOffset;
+  perfBegin(PERF_FLEET);
+  bool received = fleetReceive(fleetChannel(), FLEET_LISTEN_MS, settings.SleepDuration * 2 * 60L, WxConditions,
+                               WxHourlyForecast, WxDailyForecast, &fetchTime, &timezoneOffset, &gatewayTime);
+  perfEnd(PERF_FLEET);
+  if (!received) {
+    return false;
   }
-  return output;
+  
+  // The gateway's clock drifts as well, so it is no reference for this RTC's drift
+  rtcDriftOnClockSet();
+  SetRTCTime(gatewayTime, timezoneOffset);
+  UpdateLocalTime();
+  forecastValid = true;
+  perfSetFlag(PERF_FLAG_FLEET);
+  wifi_signal = 0; // No access point was joined
+  storeForecastSnapshot(WxConditions, WxHourlyForecast, WxDailyForecast, fetchTime, timezoneOffset, wifi_signal,
+                        "", "");
+  locationFetched(fetchTime);
+  buildWeatherView(WxConditions[0], WxHourlyForecast, max_hourly_readings, WxDailyForecast, max_daily_readings,
+                   gatewayTime, timezoneOffset);
+  return true;
 }
 
 /**
- * Parse OpenWeatherMap One Call API 3.0 JSON response.
- * Extracts current weather, hourly forecasts (48h), and daily forecasts (8 days).
- * Sets RTC time from API response timestamp.
+ * Whether any location other than the one shown on this wake is due for a fetch.
  * 
- * @param json WiFiClient stream containing JSON response
- * @return true if parsing successful, false on error
+ * @param now UTC time at wake (meaningless if the RTC is not set, when nothing is known yet)
  */
-bool DecodeWeather(WiFiClient& json) {
-#if DEBUG_LEVEL
-  if (Serial) {
-    Serial.print(F("\nDeserializing One Call API 3.0 json... "));
+bool otherLocationsNeedFetch(time_t now) {
+  for (int i = 0; i < locationCount(); i++) {
+    if (i != locationShown() && locationNeedsFetch(i, now)) {
+      return true;
+    }
   }
-#endif
-  auto doc = DynamicJsonDocument(64 * 1024);
-  DeserializationError error = deserializeJson(doc, json);
-  if (error) {
+  return false;
+}
+
+/**
+ * Fetch the other locations that would be stale by the wake that shows them, on the WiFi
+ * session and keep-alive connection of the shown one's fetch, and store each in flash.
+ * Each location's snapshot is loaded first, so its request is conditional too.
+ * The shown location is then selected again and its forecast put back in the Wx arrays,
+ * the RTC snapshot and weatherView, for the scheduler and the fleet gateway.
+ */
+void refreshOtherLocations() {
+  int shown = locationShown();
+  time_t now = time(NULL);
+  for (int i = 0; i < locationCount(); i++) {
+    if (i == shown || !locationNeedsFetch(i, now)) {
+      continue;
+    }
+    locationSelect(i);
+    loadForecastSnapshotSlot(i);
+    int result = obtainWeatherData();
 #if DEBUG_LEVEL
     if (Serial) {
-      Serial.print(F("deserializeJson() failed: "));
-      Serial.println(error.c_str());
+      Serial.printf("Location %d (%s): %s\n", i + 1, settings.City, result == 0 ? "fetched" : "fetch failed");
     }
 #endif
-    return false;
-  }
-  JsonObject root = doc.as<JsonObject>();
-#if DEBUG_LEVEL
-  if (Serial) {
-    Serial.println(" Decoding One Call API 3.0 data");
-  }
-#endif
-  
-  // Parse current weather conditions
-  JsonObject current = root["current"];
-  if (!current.isNull()) {
-    int timezoneOffset = doc["timezone_offset"] | 0;
-    time_t apiTime = current["dt"].as<int>(); // Unix timestamp (UTC)
-    
-    // Store current weather data
-    WxConditions[0].FTimezone   = timezoneOffset;
-    WxConditions[0].Dt         = apiTime;
-    WxConditions[0].Sunrise     = current["sunrise"].as<int>();
-    WxConditions[0].Sunset      = current["sunset"].as<int>();
-    WxConditions[0].Temperature = current["temp"].as<float>();
-    WxConditions[0].FeelsLike   = current["feels_like"].as<float>();
-    WxConditions[0].Pressure    = current["pressure"].as<int>();
-    WxConditions[0].Humidity     = current["humidity"].as<int>();
-    WxConditions[0].Cloudcover   = current["clouds"].as<int>();
-    WxConditions[0].Visibility   = current["visibility"].as<int>();
-    WxConditions[0].Windspeed    = current["wind_speed"].as<float>();
-    WxConditions[0].Winddir      = current["wind_deg"].as<float>();
-    WxConditions[0].Forecast0    = current["weather"][0]["description"].as<const char*>();
-    WxConditions[0].Icon         = current["weather"][0]["icon"].as<const char*>();
-    
-    // Synchronize RTC with API time
-    SetRTCTimeFromAPI(apiTime, timezoneOffset);
-    
-    // Get today's high/low from first daily forecast entry
-    JsonArray daily = root["daily"];
-    if (daily.size() > 0) {
-      JsonObject firstDay = daily[0];
-      JsonObject temp = firstDay["temp"];
-      WxConditions[0].High = temp["max"].as<float>();
-      WxConditions[0].Low  = temp["min"].as<float>();
+    if (result == 0) {
+      perfSetFlag(PERF_FLAG_LOCATIONS);
+      storeForecastSnapshot(WxConditions, WxHourlyForecast, WxDailyForecast, time(NULL), globalTimezoneOffset,
+                            wifi_signal, forecastETag, forecastLastModified);
+      locationFetched(time(NULL));
+    } else if (result == 1) {
+      break; // Same key for every location
     }
   }
   
-  // Parse hourly forecasts (48 hours) - used for 24-hour graph
-  JsonArray hourly = root["hourly"];
-#if DEBUG_LEVEL
-  if (Serial) {
-    Serial.print(F("\nReceiving Hourly Forecast - "));
+  locationSelect(shown);
+  if (loadForecastSnapshotSlot(shown)) {
+    restoreForecastSnapshot(time(NULL), LONG_MAX, WxConditions, WxHourlyForecast, WxDailyForecast,
+                            &globalTimezoneOffset, &wifi_signal);
+    buildWeatherView(WxConditions[0], WxHourlyForecast, max_hourly_readings, WxDailyForecast, max_daily_readings,
+                     time(NULL), globalTimezoneOffset);
   }
-#endif
-  for (byte r = 0; r < max_hourly_readings && r < hourly.size(); r++) {
-    WxHourlyForecast[r].Dt          = hourly[r]["dt"].as<int>();
-    WxHourlyForecast[r].Temperature = hourly[r]["temp"].as<float>();
-    WxHourlyForecast[r].Low         = hourly[r]["temp"].as<float>(); // Hourly has single temperature value
-    WxHourlyForecast[r].High        = hourly[r]["temp"].as<float>();
-    WxHourlyForecast[r].Pressure    = hourly[r]["pressure"].as<float>();
-    WxHourlyForecast[r].Humidity    = hourly[r]["humidity"].as<float>();
-    WxHourlyForecast[r].Icon        = hourly[r]["weather"][0]["icon"].as<const char*>();
-    WxHourlyForecast[r].Cloudcover  = hourly[r]["clouds"].as<int>();
-    WxHourlyForecast[r].Pop         = hourly[r]["pop"].as<float>(); // Probability of precipitation (0.0-1.0)
-    WxHourlyForecast[r].Windspeed   = hourly[r]["wind_speed"].as<float>();
-    WxHourlyForecast[r].Winddir     = hourly[r]["wind_deg"].as<float>();
-    
-    // Parse optional precipitation fields (hourly API uses "1h" key)
-    if (hourly[r]["rain"].isNull() || hourly[r]["rain"]["1h"].isNull()) {
-      WxHourlyForecast[r].Rainfall = 0.0;
-    } else {
-      WxHourlyForecast[r].Rainfall = hourly[r]["rain"]["1h"].as<float>();
-    }
-    if (hourly[r]["snow"].isNull() || hourly[r]["snow"]["1h"].isNull()) {
-      WxHourlyForecast[r].Snowfall = 0.0;
-    } else {
-      WxHourlyForecast[r].Snowfall = hourly[r]["snow"]["1h"].as<float>();
-    }
+}
+
+/**
+ * Main display function - renders complete weather information to framebuffer.
+ * Layout includes: location/date, current conditions, 5-day forecast, 24-hour graph, and status bar.
+ */
+void DisplayWeather() {
+  // Clear framebuffer to white
+  memset(framebuffer, 0xFF, EPD_WIDTH * EPD_HEIGHT / 2);
+  drawWeatherSections(SECTION_ALL);
+}
+
+/**
+ * Render some sections of the weather screen to the framebuffer.
+ * Each section only touches its own display regions, so sections can be drawn in any order.
+ * The sections drawn from the forecast use weatherView, built when their records were stored.
+ * 
+ * @param sections SECTION_* bits
+ */
+void drawWeatherSections(uint8_t sections) {
+  if (sections & SECTION_LOCATION) {
+    perfBegin(PERF_DRAW_LOCATION);
+    drawLocationDate(settings.City, Date_str);                                  // Top right: city and date
+    perfEnd(PERF_DRAW_LOCATION);
   }
-#if DEBUG_LEVEL
-  if (Serial) {
-    Serial.println(String(hourly.size()) + " periods received");
+  if (sections & SECTION_CURRENT) {
+    perfBegin(PERF_DRAW_CURRENT);
+    drawCurrentConditions(WxConditions, weatherView);                  // Center: current weather
+    perfEnd(PERF_DRAW_CURRENT);
+  }
+  if (sections & SECTION_FORECAST) {
+    perfBegin(PERF_DRAW_FORECAST);
+    drawForecast(weatherView);                                         // Top row: 5-day forecast
+    perfEnd(PERF_DRAW_FORECAST);
+  }
+  if (sections & SECTION_GRAPH) {
+    perfBegin(PERF_DRAW_GRAPH);
+    drawOutlookGraph(weatherView);                                     // Bottom: 24-hour graph
+    perfEnd(PERF_DRAW_GRAPH);
+  }
+  if (sections & SECTION_STATUS) {
+    // Voltage read at wake: the S3 battery pin is on ADC2, which is unusable while WiFi is on
+    perfBegin(PERF_DRAW_STATUS);
+    drawStatusBar(statusBadge, Time_str, wifi_signal, batteryMillivolts(), batteryRuntimeHours());        // Bottom: status indicators
+    buildNowcastView(nowcastRecord(time(NULL)), time(NULL));
+    drawNowcast(weatherView);                                          // In the status bar, while rain is near
+    perfEnd(PERF_DRAW_STATUS);
+  }
+}
+
+/**
+ * Fetch and decode the weather on core 0 (one attempt, see fetch_backoff.h).
+ * Stops WiFi on success (unless other locations or a firmware update come next) and sets
+ * FETCH_DONE with the result in fetchResult.
+ */
+void fetchWeatherTask(void *param) {
+  int result = obtainWeatherData();
+  if (result == 0 && !fetchOtherLocations && !otaThisWake) {
+    StopWiFi();
+  }
+  fetchResult = result;
+  xEventGroupSetBits(fetchEvents, FETCH_DONE);
+  vTaskDelete(NULL);
+}
+
+/**
+ * Wait for a fetch progress bit.
+ * 
+ * @return false if the fetch finished without reaching it
+ */
+static bool waitForFetch(EventBits_t bit) {
+  EventBits_t bits = xEventGroupWaitBits(fetchEvents, bit | FETCH_DONE, pdFALSE, pdFALSE, portMAX_DELAY);
+  return (bits & bit) != 0;
+}
+
+/**
+ * Fetch the weather on core 0 while this core powers up the panel and draws and pushes
+ * each section as soon as its data has been decoded: location, date and status bar
+ * straight away (once the time is known), current conditions when "current" is parsed,
+ * then the graph and the forecast when "hourly" and "daily" arrive.
+ * Wake-to-image time becomes roughly the longer of the fetch and the refresh rather
+ * than their sum. On failure the refresh is abandoned and the caller shows an error screen.
+ * 
+ * @param rtcSet The RTC was already set at wake, so the date and refresh time can be drawn before the fetch
+ * @return 0 = success, 1 = API key invalid (401), 2 = other error
+ */
+int fetchAndDisplayWeather(bool rtcSet) {
+  fetchEvents = xEventGroupCreate();
+  fetchResult = 2;
+  if (!fetchEvents ||
+      xTaskCreatePinnedToCore(fetchWeatherTask, "fetch", FETCH_TASK_STACK, NULL, 1, NULL, FETCH_TASK_CORE) != pdPASS) {
+    if (fetchEvents) vEventGroupDelete(fetchEvents);
+    fetchEvents = NULL;
+    return 2;
   }
-#endif
   
-  // Parse daily forecasts (8 days) - used for 5-day forecast display
-  JsonArray daily = root["daily"];
-#if DEBUG_LEVEL
-  if (Serial) {
-    Serial.print(F("\nReceiving Daily Forecast - "));
+  memset(framebuffer, 0xFF, EPD_WIDTH * EPD_HEIGHT / 2);
+  perfBegin(PERF_PANEL);
+  refreshBegin(); // A full refresh clears the panel while the request is in flight
+  perfEnd(PERF_PANEL);
+  
+  uint8_t pending = SECTION_LOCATION | SECTION_STATUS;
+  if (rtcSet) {
+    drawWeatherSections(pending);
+    perfBegin(PERF_PANEL);
+    refreshRegion(REGION_LOCATION);
+    refreshRegion(REGION_STATUS);
+    perfEnd(PERF_PANEL);
+    pending = 0;
   }
-#endif
-  for (byte r = 0; r < max_daily_readings && r < daily.size(); r++) {
-    JsonObject day = daily[r];
-    JsonObject temp = day["temp"]; // Daily forecast has temp object with min/max/day/night
-    
-    WxDailyForecast[r].Dt          = day["dt"].as<int>();
-    WxDailyForecast[r].Temperature = temp["day"].as<float>(); // Daytime average temperature
-    WxDailyForecast[r].Low         = temp["min"].as<float>();
-    WxDailyForecast[r].High        = temp["max"].as<float>();
-    WxDailyForecast[r].Pressure    = day["pressure"].as<float>();
-    WxDailyForecast[r].Humidity    = day["humidity"].as<float>();
-    WxDailyForecast[r].Icon        = day["weather"][0]["icon"].as<const char*>();
-    WxDailyForecast[r].Cloudcover  = day["clouds"].as<int>();
-    WxDailyForecast[r].Pop         = day["pop"].as<float>(); // Probability of precipitation
-    WxDailyForecast[r].Windspeed   = day["wind_speed"].as<float>();
-    WxDailyForecast[r].Winddir     = day["wind_deg"].as<float>();
-    WxDailyForecast[r].Sunrise     = day["sunrise"].as<int>();
-    WxDailyForecast[r].Sunset      = day["sunset"].as<int>();
-    
-    // Parse optional precipitation (daily API provides total for the day, not per-hour)
-    if (day["rain"].isNull()) {
-      WxDailyForecast[r].Rainfall = 0.0;
-    } else {
-      WxDailyForecast[r].Rainfall = day["rain"].as<float>();
-    }
-    if (day["snow"].isNull()) {
-      WxDailyForecast[r].Snowfall = 0.0;
-    } else {
-      WxDailyForecast[r].Snowfall = day["snow"].as<float>();
+  
+  bool ok = waitForFetch(FETCH_CURRENT_READY);
+  if (ok) {
+    if (pending) {
+      UpdateLocalTime(); // RTC was just set from the API
     }
+    drawWeatherSections(SECTION_CURRENT | pending);
+    perfBegin(PERF_PANEL);
+    refreshRegion(REGION_CURRENT);
+    refreshRegion(REGION_DETAILS);
+    refreshRegion(REGION_LOCATION);
+    refreshRegion(REGION_STATUS);
+    perfEnd(PERF_PANEL);
+    ok = waitForFetch(FETCH_HOURLY_READY);
   }
-#if DEBUG_LEVEL
-  if (Serial) {
-    Serial.println(String(daily.size()) + " days received");
+  if (ok) {
+    drawWeatherSections(SECTION_GRAPH);
+    perfBegin(PERF_PANEL);
+    refreshRegion(REGION_GRAPH);
+    perfEnd(PERF_PANEL);
+    ok = waitForFetch(FETCH_DAILY_READY);
+  }
+  if (ok) {
+    drawWeatherSections(SECTION_FORECAST);
   }
-#endif
   
-  // Calculate pressure trend: compare today's pressure with tomorrow's
-  // "+" = rising, "-" = falling, "=" = stable
-  if (daily.size() >= 2) {
-    float pressure_trend = WxDailyForecast[0].Pressure - WxDailyForecast[1].Pressure;
-    pressure_trend = ((int)(pressure_trend * 10)) / 10.0; // Round to 0.1 hPa
-    WxConditions[0].Trend = "=";
-    if (pressure_trend > 0)  WxConditions[0].Trend = "+";
-    if (pressure_trend < 0)  WxConditions[0].Trend = "-";
+  waitForFetch(FETCH_DONE);
+  vEventGroupDelete(fetchEvents);
+  fetchEvents = NULL;
+  if (!ok || fetchResult != 0) {
+    refreshCancel();
+    return fetchResult != 0 ? fetchResult : 2;
   }
   
-  return true;
+  perfBegin(PERF_PANEL);
+  refreshEnd();
+  perfEnd(PERF_PANEL);
+  return 0;
+}
+
+/**
+ * Tell the drawing core that a section of the response has been stored (pipelined fetch only).
+ */
+void fetchProgress(uint32_t bits) {
+  if (fetchEvents) {
+    xEventGroupSetBits(fetchEvents, bits);
+  }
 }
 
 /**
  * Fetch weather data from OpenWeatherMap One Call API 3.0.
  * Requests current weather, hourly forecast (48h), and daily forecast (8 days).
- * Excludes minutely forecast and alerts to reduce response size.
+ * Excludes minutely forecast and alerts to reduce response size, asks for gzip, and
+ * stops reading once the entries drawn have been decoded (see DecodeWeather()).
+ * The request is conditional on the validators of the RTC snapshot, if the server sent
+ * any: a 304 answer restores the snapshot instead of downloading the forecast again.
+ * Uses the keep-alive connection shared with geocoding (api_client.h).
  * 
- * @param client WiFiClient for HTTP connection
  * @return 0 if data received and parsed successfully, 1 if API key invalid (401), 2 for other errors
  */
-int obtainWeatherData(WiFiClient & client) {
-  const String units = (String(settings.Units) == "M" ? "metric" : "imperial");
-  client.stop(); // Close any existing connection
+int obtainWeatherData() {
+  const String units = (strcmp(settings.Units, "M") == 0 ? "metric" : "imperial");
   
-  HTTPClient http;
   // Build API request URI
   String uri = "/data/3.0/onecall?lat=" + String(settings.Latitude) + "&lon=" + String(settings.Longitude) + 
                "&exclude=minutely,alerts&appid=" + String(settings.apikey) + 
                "&units=" + units + "&lang=" + String(settings.Language);
   
-  const char* server = "api.openweathermap.org";
 #if DEBUG_LEVEL
   if (Serial) {
     Serial.print("Connecting: ");
-    Serial.print(String(server) + uri);
+    Serial.print(String(API_HOST) + uri);
     Serial.println();
   }
 #endif
   
-  http.begin(client, server, 80, uri); // HTTP port 80 (use 443 + WiFiClientSecure for HTTPS)
-  int httpCode = http.GET();
+  // Connect up front so the TCP/TLS handshake is timed separately; apiRequest() reuses the connection
+  perfBegin(PERF_HTTP_CONNECT);
+  apiConnect();
+  perfEnd(PERF_HTTP_CONNECT);
+  
+  perfBegin(PERF_FIRST_BYTE);
+  int httpCode = apiRequest(uri, forecastSnapshotETag(), forecastSnapshotLastModified());
+  perfEnd(PERF_FIRST_BYTE);
   
   if (httpCode == HTTP_CODE_OK) {
-    if (!DecodeWeather(http.getStream())) {
-      http.end();
-      return 2; // Parsing error
-    }
-    client.stop();
-    http.end();
-    return 0; // Success
+    perfBegin(PERF_DECODE);
+    bool decoded = DecodeWeather(apiBody());
+    perfEnd(PERF_DECODE);
+    strlcpy(forecastETag, apiResponseETag(), sizeof(forecastETag));
+    strlcpy(forecastLastModified, apiResponseLastModified(), sizeof(forecastLastModified));
+    apiEndRequest(); // Closes the connection on the part of the response left unread
+    return decoded ? 0 : 2; // 2 = parsing error
   }
-  else {
+  
+  if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+    apiEndRequest();
+    strlcpy(forecastETag, forecastSnapshotETag(), sizeof(forecastETag));
+    strlcpy(forecastLastModified, forecastSnapshotLastModified(), sizeof(forecastLastModified));
+    if (restoreForecastSnapshot(time(NULL), LONG_MAX, WxConditions, WxHourlyForecast, WxDailyForecast,
+                                &globalTimezoneOffset, &wifi_signal)) {
 #if DEBUG_LEVEL
-    if (Serial) {
-      Serial.printf("connection failed, http error code %i %s\n", httpCode, http.errorToString(httpCode));
+      if (Serial) {
+        Serial.println("Forecast not modified, using RTC snapshot");
+      }
+#endif
+      buildWeatherView(WxConditions[0], WxHourlyForecast, max_hourly_readings, WxDailyForecast, max_daily_readings,
+                       time(NULL), globalTimezoneOffset);
+      fetchProgress(FETCH_CURRENT_READY | FETCH_HOURLY_READY | FETCH_DAILY_READY);
+      return 0;
     }
+    invalidateForecastSnapshot(); // The retry asks unconditionally
+    return 2;
+  }
+  
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("connection failed, http error code %i %s\n", httpCode, HTTPClient::errorToString(httpCode).c_str());
+  }
 #endif
-    client.stop();
-    http.end();
-    
-    // Check if error is due to invalid API key (HTTP 401 Unauthorized)
-    if (httpCode == 401) {
-      return 1; // API key invalid
+  if (httpCode > 0) {
+    apiEndRequest();
+  }
+  
+  // Check if error is due to invalid API key (HTTP 401 Unauthorized)
+  if (httpCode == 401) {
+    return 1; // API key invalid
+  }
+  return 2; // Other error
+}
+
+/**
+ * Fetch the precipitation nowcast: the One Call API 3.0 with every section but "minutely"
+ * excluded, about 60 small entries instead of the whole forecast. Uses the same
+ * keep-alive connection as the forecast (api_client.h); the result is stored with
+ * nowcastStore() for the location shown.
+ * 
+ * @return 0 if data received and parsed successfully, 1 if API key invalid (401), 2 for other errors
+ */
+int obtainNowcastData() {
+  String uri = "/data/3.0/onecall?lat=" + String(settings.Latitude) + "&lon=" + String(settings.Longitude) +
+               "&exclude=current,hourly,daily,alerts&appid=" + String(settings.apikey);
+  
+  perfBegin(PERF_HTTP_CONNECT);
+  apiConnect();
+  perfEnd(PERF_HTTP_CONNECT);
+  
+  perfBegin(PERF_FIRST_BYTE);
+  int httpCode = apiRequest(uri, NULL, NULL);
+  perfEnd(PERF_FIRST_BYTE);
+  
+  if (httpCode == HTTP_CODE_OK) {
+    Nowcast_record_type nowcast;
+    perfBegin(PERF_DECODE);
+    bool decoded = DecodeNowcast(apiBody(), nowcast);
+    perfEnd(PERF_DECODE);
+    apiEndRequest();
+    if (!decoded) {
+      return 2; // Parsing error
     }
-    return 2; // Other error
+    nowcast.Location = locationShown();
+    nowcastStore(nowcast);
+    return 0;
+  }
+  
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("nowcast request failed, http error code %i %s\n", httpCode, HTTPClient::errorToString(httpCode).c_str());
+  }
+#endif
+  if (httpCode > 0) {
+    apiEndRequest();
   }
+  return (httpCode == 401) ? 1 : 2;
 }
 
 /**
@@ -1028,7 +1476,7 @@ boolean UpdateLocalTime() {
   sprintf(day_output, "%s, %s %d", weekday_full, month_full, timeinfo->tm_mday);
   
   // Format time string based on unit system
-  if (String(settings.Units) == "M") {
+  if (strcmp(settings.Units, "M") == 0) {
     strftime(update_time, sizeof(update_time), "%H:%M:%S", timeinfo); // 24-hour format
   }
   else {
@@ -1040,89 +1488,3 @@ boolean UpdateLocalTime() {
   Time_str = time_output;
   return true;
 }
-
-/**
- * Read battery voltage from ADC pin using ESP32 ADC calibration.
- * 
- * ESP32 (5 Button dev kit): GPIO36 (ADC1_CH0) with voltage divider (6.566x scaling)
- * ESP32-S3 (3 Button dev kit): GPIO14 with voltage divider (0.5x scaling, then 2x multiplier)
- * 
- * Uses eFuse Vref calibration for accurate voltage readings.
- * 
- * @return Battery voltage in millivolts, or 0 if reading unavailable
- */
-uint32_t readBatteryVoltage() {
-#if IS_ESP32_S3
-  // ESP32-S3: GPIO14 with 0.5x voltage divider, then 2x multiplier, plus calibration
-  const int batteryPin = 14;  // GPIO14 = Battery ADC on ESP32-S3
-  
-  // Calibration multiplier - adjust based on actual vs measured voltage
-  // Calculated from: actual_voltage / measured_voltage
-  // Example: if actual is 3.952V and measured is 3.4V, multiplier = 1.162
-  const float CALIBRATION_MULTIPLIER = 1.162f;
-  
-  // Characterize ADC with calibration values
-  // ESP32-S3 supports up to ADC_ATTEN_DB_11 (not ADC_ATTEN_DB_12 like ESP32)
-  esp_adc_cal_characteristics_t adc_chars;
-  esp_adc_cal_value_t val_type = esp_adc_cal_characterize(
-    ADC_UNIT_1, 
-    ADC_ATTEN_DB_11,  // ESP32-S3 maximum attenuation (3.0V full scale)
-    ADC_WIDTH_BIT_12, 
-    1100,  // Default Vref in mV
-    &adc_chars
-  );
-  
-  // Use eFuse Vref if available (more accurate than default)
-  if (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF) {
-    vref = adc_chars.vref;
-  }
-  
-  // Read ADC value and convert to voltage using calibrated reference
-  // Voltage divider scales by 0.5x, so battery voltage = ADC voltage * 2
-  // For ATTEN_DB_11 on ESP32-S3, full scale is approximately 3.0V
-  // Formula: adcVoltage = (rawValue / 4095.0) * 3.0V * (vref / 1100.0)
-  // Then: batteryVoltage = adcVoltage * 2.0 (to account for 0.5x divider)
-  int rawValue = analogRead(batteryPin);
-  float adcVoltage = (rawValue / 4095.0) * 3.0 * (vref / 1100.0);
-  float voltage = adcVoltage * 2.0;  // Account for 0.5x voltage divider
-  
-  // Apply calibration multiplier to correct for hardware variations
-  voltage = voltage * CALIBRATION_MULTIPLIER;
-#else
-  // ESP32: GPIO36 with 6.566x scaling
-  const int batteryPin = 36;  // GPIO36 = ADC1_CH0 on ESP32
-  
-  // Characterize ADC with calibration values
-  esp_adc_cal_characteristics_t adc_chars;
-  esp_adc_cal_value_t val_type = esp_adc_cal_characterize(
-    ADC_UNIT_1, 
-    ADC_ATTEN_DB_12, 
-    ADC_WIDTH_BIT_12, 
-    1100,  // Default Vref in mV
-    &adc_chars
-  );
-  
-  // Use eFuse Vref if available (more accurate than default)
-  if (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF) {
-#if DEBUG_LEVEL
-    if (Serial) {
-      Serial.printf("eFuse Vref:%u mV\n", adc_chars.vref);
-    }
-#endif
-    vref = adc_chars.vref;
-  }
-  
-  // Read ADC value and convert to voltage using calibrated reference
-  // Formula: voltage = (rawValue / 4096.0) * 6.566 * (vref / 1000.0)
-  float voltage = analogRead(batteryPin) / 4096.0 * 6.566 * (vref / 1000.0);
-#endif
-  
-  if (voltage <= 1.0) {
-    // Voltage too low indicates battery monitoring hardware not available
-    return 0;
-  }
-  
-  // Return in millivolts for easier comparison
-  return (uint32_t)(voltage * 1000);
-}
-
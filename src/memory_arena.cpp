@@ -0,0 +1,103 @@
+/**
+ * Memory Arena
+ *
+ * All of the large buffers of a wake are carved from fixed regions instead of being
+ * allocated and freed on the heap as each step needs them, so the heap does not
+ * fragment over a wake and both boards use their memory the same way. The PSRAM regions
+ * share one block reserved on first use; the internal RAM region is a static array.
+ * Each region is a bump allocator that is reset as a whole.
+ */
+
+#include <Arduino.h>
+#include "memory_arena.h"
+
+#define ARENA_ALIGN 16
+
+#define ARENA_ROUND(size) (((size) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+typedef struct {
+  const char *name;
+  size_t      size;
+  bool        psram;
+} ArenaLayout;
+
+static const ArenaLayout layout[ARENA_REGION_COUNT] = {
+  {"framebuffer", ARENA_ROUND(ARENA_FRAMEBUFFER_SIZE), true},
+  {"refresh",     ARENA_ROUND(ARENA_REFRESH_SIZE),     true},
+  {"inflate",     ARENA_ROUND(ARENA_INFLATE_SIZE),     true},
+  {"glyphs",      ARENA_ROUND(ARENA_GLYPHS_SIZE),      true},
+  {"ota",         ARENA_ROUND(ARENA_OTA_SIZE),         true},
+  {"decode",      ARENA_ROUND(ARENA_DECODE_SIZE),      false},
+};
+
+typedef struct {
+  uint8_t *base;
+  size_t   used;
+  size_t   peak;
+} ArenaRegion;
+
+static ArenaRegion regions[ARENA_REGION_COUNT];
+static uint8_t decodeScratch[ARENA_ROUND(ARENA_DECODE_SIZE)] __attribute__((aligned(ARENA_ALIGN)));
+static bool carved = false;
+
+/**
+ * Reserve the PSRAM block and lay out the regions in it.
+ */
+static void arenaCarve() {
+  carved = true;
+  size_t psramBytes = 0;
+  for (int r = 0; r < ARENA_REGION_COUNT; r++) {
+    if (layout[r].psram) psramBytes += layout[r].size;
+  }
+  uint8_t *block = (uint8_t *)ps_malloc(psramBytes + ARENA_ALIGN);
+#if DEBUG_LEVEL
+  if (Serial && !block) {
+    Serial.printf("Memory arena: %u bytes of PSRAM not available\n", (unsigned)psramBytes);
+  }
+#endif
+  uint8_t *next = block ? (uint8_t *)ARENA_ROUND((uintptr_t)block) : NULL;
+  for (int r = 0; r < ARENA_REGION_COUNT; r++) {
+    if (!layout[r].psram) {
+      regions[r].base = decodeScratch;
+    } else if (next) {
+      regions[r].base = next;
+      next += layout[r].size;
+    }
+  }
+}
+
+void *arenaAlloc(arena_region_t region, size_t size) {
+  if (!carved) arenaCarve();
+  ArenaRegion &r = regions[region];
+  size = ARENA_ROUND(size);
+  if (!r.base || r.used + size > layout[region].size) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("Memory arena: %u bytes do not fit in %s (%u of %u used)\n", (unsigned)size,
+                    layout[region].name, (unsigned)r.used, (unsigned)layout[region].size);
+    }
+#endif
+    return NULL;
+  }
+  void *pointer = r.base + r.used;
+  r.used += size;
+  if (r.used > r.peak) r.peak = r.used;
+  return pointer;
+}
+
+void arenaReset(arena_region_t region) {
+  regions[region].used = 0;
+}
+
+size_t arenaPeak(arena_region_t region) {
+  return regions[region].peak;
+}
+
+void arenaPrintReport(Print &out) {
+  out.println("Memory arena   capacity       peak");
+  for (int r = 0; r < ARENA_REGION_COUNT; r++) {
+    out.printf("%-12s %10u %10u%s\n", layout[r].name, (unsigned)layout[r].size, (unsigned)regions[r].peak,
+               regions[r].base ? (layout[r].psram ? "" : "  (internal)") : "  (not available)");
+  }
+  out.printf("Heap: %u bytes free, largest block %u\n", (unsigned)ESP.getFreeHeap(), (unsigned)ESP.getMaxAllocHeap());
+}
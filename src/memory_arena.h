@@ -0,0 +1,79 @@
+#ifndef __MEMORY_ARENA_H__
+#define __MEMORY_ARENA_H__
+
+#include <Arduino.h>
+#include <epd_driver.h>
+#include "text_renderer.h"
+#include "layout.h"
+
+// Region capacities in bytes. The PSRAM regions are carved from one block, so their sum
+// is reserved as a whole on the first allocation.
+#define ARENA_FRAMEBUFFER_SIZE (EPD_WIDTH * EPD_HEIGHT / 2)
+#define ARENA_REFRESH_SIZE     Layout::largestRegionBytes()  // Largest display region (REGION_GRAPH)
+#define ARENA_INFLATE_SIZE     (48 * 1024)  // tinfl_decompressor (about 11 KB) and the 32 KB window
+#define ARENA_GLYPHS_SIZE      (TEXT_GLYPH_CACHE_SIZE + TEXT_GLYPH_CACHE_ENTRIES * 2 * sizeof(void *))
+#define ARENA_OTA_SIZE         (48 * 1024)  // tinfl_decompressor and one 32 KB firmware block
+#define ARENA_DECODE_SIZE      2048         // One JSON document (JSON_ELEMENT_DOC_SIZE, GEOCODE_DOC_SIZE)
+
+/**
+ * Memory regions, each with a fixed capacity and a single user. Buffers that are
+ * streamed through (framebuffer, refresh copy, inflate window, glyph bitmaps, firmware
+ * block) are in PSRAM; the JSON scratch document, which the parser accesses at random,
+ * is in internal RAM. Both boards get the same layout.
+ */
+typedef enum {
+  ARENA_FRAMEBUFFER,  // The 4bpp screen (main.ino)
+  ARENA_REFRESH,      // Packed copy of the region being pushed (partial_refresh.h)
+  ARENA_INFLATE,      // gzip decompressor state and window (http_body.h)
+  ARENA_GLYPHS,       // Glyph cache table and bitmaps (text_renderer.h)
+  ARENA_OTA,          // Firmware block decoder (ota_update.h)
+  ARENA_DECODE,       // JSON scratch document (weather_decoder.h, geocode.h)
+  ARENA_REGION_COUNT
+} arena_region_t;
+
+/**
+ * Take size bytes from a region (16-byte aligned, not cleared). The PSRAM block is
+ * allocated on the first call, which main.ino makes for the framebuffer before the
+ * fetch task starts; after that each region is only used by its own module.
+ *
+ * @return NULL when the region is full or there is no PSRAM
+ */
+void *arenaAlloc(arena_region_t region, size_t size);
+
+/**
+ * Give back everything taken from a region, for the next use.
+ */
+void arenaReset(arena_region_t region);
+
+/**
+ * Highest number of bytes in use in a region since boot.
+ */
+size_t arenaPeak(arena_region_t region);
+
+/**
+ * Print each region's capacity and high-water mark, and the heap left over.
+ */
+void arenaPrintReport(Print &out);
+
+/**
+ * ArduinoJson allocator over ARENA_DECODE, for one document at a time:
+ * BasicJsonDocument<ArenaJsonAllocator> doc(JSON_ELEMENT_DOC_SIZE);
+ * The region is reset when the document is destroyed. A block cannot grow in place, so
+ * reallocate() only succeeds for a size it already has (shrinkToFit()).
+ */
+struct ArenaJsonAllocator {
+  size_t allocated = 0;  // Size of the block handed out
+
+  void *allocate(size_t size) {
+    void *block = arenaAlloc(ARENA_DECODE, size);
+    allocated = block ? size : 0;
+    return block;
+  }
+  void deallocate(void *) {
+    arenaReset(ARENA_DECODE);
+    allocated = 0;
+  }
+  void *reallocate(void *pointer, size_t size) { return size <= allocated ? pointer : NULL; }
+};
+
+#endif // __MEMORY_ARENA_H__
@@ -0,0 +1,129 @@
+/**
+ * Precipitation Nowcast
+ *
+ * While rain is near, the sleep between two regular updates is broken up by short
+ * nowcast wakes every NOWCAST_INTERVAL_MINUTES. Such a wake asks the API for the
+ * "minutely" section only (the next hour's precipitation, a few KB against the full
+ * forecast) and pushes just the status bar with the sparkline drawn from it; the
+ * forecast on the panel is left alone and the regular updates keep their own schedule.
+ *
+ * The time of the next regular update, whether the last one wanted nowcast wakes, and
+ * the last nowcast are kept in RTC memory; a power-on starts without them.
+ */
+
+#include <Arduino.h>
+#include "nowcast.h"
+#include "scheduler.h"
+#include "locations.h"
+#include "rtc_budget.h"
+
+extern int globalTimezoneOffset;  // Timezone offset in seconds (positive = east of UTC)
+
+typedef struct {
+  uint32_t magic;
+  bool     active;         // The last regular update wanted nowcast wakes
+  int32_t  regularWakeAt;  // UTC of the next regular update, 0 = unknown
+  Nowcast_record_type nowcast;
+} NowcastState;
+
+// Persists across deep sleep
+RTC_DATA_ATTR static NowcastState state;
+static_assert(sizeof(state) <= RTC_BUDGET_NOWCAST, "nowcast state over its RTC allotment");
+
+static bool wakeIsNowcast = false;
+
+/**
+ * Start without a nowcast after power-on or reset.
+ */
+static void ensureState() {
+  if (state.magic != NOWCAST_MAGIC) {
+    memset(&state, 0, sizeof(state));
+    state.magic = NOWCAST_MAGIC;
+  }
+}
+
+/**
+ * Seconds from now to the next multiple of NOWCAST_INTERVAL_MINUTES since local midnight
+ * (a wake just short of one counts as on it, as in the scheduler).
+ */
+static long secondsToNextInterval(time_t now) {
+  long secOfDay = (now + globalTimezoneOffset) % 86400;
+  long nextMin = ((secOfDay + SCHEDULER_BOUNDARY_SLACK_SECONDS) / 60 / NOWCAST_INTERVAL_MINUTES + 1) *
+                 NOWCAST_INTERVAL_MINUTES;
+  return nextMin * 60 - secOfDay;
+}
+
+bool nowcastWanted(time_t now, const Forecast_record_type *hourly, int hourlyCount, uint32_t batteryMv,
+                   int batteryHours) {
+#if NOWCAST_MODE
+  // The extra wakes are the first thing to go when the scheduler saves the battery
+  if (batteryMv > 0 && batteryMv < SCHEDULER_BATTERY_FULL_MV) return false;
+  if (batteryHours >= 0 && batteryHours < SCHEDULER_BATTERY_RUNTIME_HOURS) return false;
+
+  const Nowcast_record_type *nowcast = nowcastRecord(now);
+  if (nowcast) {
+    for (int i = (now - nowcast->Start) / 60; i < nowcast->Count; i++) {
+      if (nowcast->Precipitation[i] > 0) return true;
+    }
+  }
+  if (hourly) {
+    // From the hour in progress to NOWCAST_LOOKAHEAD_HOURS ahead
+    for (int i = 0; i < hourlyCount; i++) {
+      if (hourly[i].Dt == 0 || hourly[i].Dt <= now - 3600 || hourly[i].Dt > now + NOWCAST_LOOKAHEAD_HOURS * 3600L) {
+        continue;
+      }
+      if (hourly[i].Pop >= NOWCAST_POP || hourly[i].Rainfall > 0 || hourly[i].Snowfall > 0) return true;
+    }
+  }
+#endif
+  return false;
+}
+
+long nowcastSleepSeconds(time_t now, long sleepSecs, bool wanted) {
+  ensureState();
+  if (now < 946684800) { // RTC not set: no regular wake to fit in before
+    state.active = false;
+    return sleepSecs;
+  }
+  if (!wakeIsNowcast) {
+    state.active = wanted;
+    state.regularWakeAt = now + sleepSecs;
+  }
+  long untilRegular = max((long)(state.regularWakeAt - now), 1L);
+  if (!state.active) {
+    return untilRegular;
+  }
+
+  long seconds = secondsToNextInterval(now);
+  time_t target = now + globalTimezoneOffset + seconds;
+  if (seconds + SCHEDULER_BOUNDARY_SLACK_SECONDS >= untilRegular || !scheduleHourIsAwake((target / 3600) % 24)) {
+    seconds = untilRegular; // The regular update comes first anyway
+  }
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Nowcast: rain near, next wake in %ld s, regular update in %ld s\n", seconds, untilRegular);
+  }
+#endif
+  return seconds;
+}
+
+bool nowcastBeginWake(time_t now) {
+  ensureState();
+  wakeIsNowcast = NOWCAST_MODE && state.active && now + SCHEDULER_BOUNDARY_SLACK_SECONDS < state.regularWakeAt;
+  return wakeIsNowcast;
+}
+
+void nowcastStore(const Nowcast_record_type &nowcast) {
+  ensureState();
+  state.nowcast = nowcast;
+}
+
+const Nowcast_record_type *nowcastRecord(time_t now) {
+  ensureState();
+  const Nowcast_record_type &nowcast = state.nowcast;
+  if (nowcast.Start == 0 || nowcast.Location != locationShown() || now < nowcast.Start ||
+      now >= nowcast.Start + nowcast.Count * 60L) {
+    return NULL;
+  }
+  return &nowcast;
+}
@@ -0,0 +1,78 @@
+#ifndef __NOWCAST_H__
+#define __NOWCAST_H__
+
+#include <Arduino.h>
+#include <time.h>
+#include "forecast_record.h"
+
+// 1 = wake between the regular updates while rain is near to fetch the next hour's
+// precipitation, 0 = regular updates only
+#ifndef NOWCAST_MODE
+#define NOWCAST_MODE 1
+#endif
+
+// Minutes between nowcast wakes, aligned to local time like the regular updates
+#ifndef NOWCAST_INTERVAL_MINUTES
+#define NOWCAST_INTERVAL_MINUTES 10
+#endif
+
+// Rain is near when an hourly entry within NOWCAST_LOOKAHEAD_HOURS has at least this
+// probability of precipitation (percent) or any rain or snow, or the last nowcast has some
+#ifndef NOWCAST_POP
+#define NOWCAST_POP 50
+#endif
+#define NOWCAST_LOOKAHEAD_HOURS 2
+
+#define NOWCAST_MAGIC 0x4E4F5743  // "NOWC" in hex
+
+/**
+ * Whether the next sleep should be broken up by nowcast wakes: rain is near for the
+ * location shown, and the battery is not low enough for the scheduler to stretch the
+ * intervals (scheduler.h).
+ *
+ * @param now Current UTC time (RTC)
+ * @param hourly Hourly forecast of the location shown, or NULL if none is loaded
+ * @param hourlyCount Number of hourly entries
+ * @param batteryMv Battery voltage in millivolts, or 0 if unknown
+ * @param batteryHours Predicted battery runtime in hours (battery.h), or -1 if unknown
+ */
+bool nowcastWanted(time_t now, const Forecast_record_type *hourly, int hourlyCount, uint32_t batteryMv,
+                   int batteryHours);
+
+/**
+ * Sleep before the next wake. A regular update passes the scheduler's sleep, which is
+ * remembered as the next regular wake, and whether nowcast wakes are wanted; then the
+ * sleep is cut short at the next NOWCAST_INTERVAL_MINUTES boundary before it. A nowcast
+ * wake keeps the regular wake and the choice of the update before it (the arguments
+ * are ignored).
+ *
+ * @param now Current UTC time (RTC)
+ * @param sleepSecs Sleep chosen for the regular update
+ * @param wanted nowcastWanted() on a regular update
+ * @return Seconds to sleep
+ */
+long nowcastSleepSeconds(time_t now, long sleepSecs, bool wanted);
+
+/**
+ * Decide whether this timer wake is a nowcast wake: one put in before the next regular
+ * update by nowcastSleepSeconds(). Call once, early in the wake.
+ *
+ * @param now Current UTC time (RTC)
+ * @return true if only the nowcast is to be fetched and drawn
+ */
+bool nowcastBeginWake(time_t now);
+
+/**
+ * Keep a decoded nowcast (DecodeNowcast()) in RTC memory for the location shown.
+ */
+void nowcastStore(const Nowcast_record_type &nowcast);
+
+/**
+ * The stored nowcast, if it is for the location shown and has minutes from now on.
+ *
+ * @param now Current UTC time (RTC)
+ * @return The record, or NULL if there is none to draw
+ */
+const Nowcast_record_type *nowcastRecord(time_t now);
+
+#endif // __NOWCAST_H__
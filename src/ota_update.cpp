@@ -0,0 +1,592 @@
+/**
+ * Firmware Update
+ *
+ * Writes a new firmware into the OTA slot that is not running (app0/app1 in
+ * partitions.csv) and makes it the boot partition once it is complete and checked.
+ * Images come from an upload in setup mode, or from a download on normal wakes when
+ * OTA_MANIFEST_URL names a manifest with a newer version.
+ *
+ * Downloads use the packed format of tools/pack_ota_image.py: the firmware in 32 KB
+ * blocks, each deflated on its own, which roughly halves the transfer. A block inflates
+ * without the ones before it, so a download can stop after any block; the next wake
+ * resumes there with an HTTP Range request. The file offset and the bytes written so far
+ * are kept in RTC memory, and each wake downloads for at most OTA_WAKE_BUDGET_MS.
+ */
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#include <ArduinoJson.h>
+#include <MD5Builder.h>
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "ota_update.h"
+#include "http_body.h"
+#include "api_client.h"
+#include "memory_arena.h"
+#include "rtc_budget.h"
+
+#define OTA_SECTOR_SIZE 4096
+#define OTA_ESP_IMAGE_MAGIC 0xE9  // First byte of an ESP32 application image
+
+typedef enum {
+  OTA_PARSE_HEADER,  // Packed image header
+  OTA_PARSE_LENGTH,  // Length word of the next block
+  OTA_PARSE_BLOCK,   // Block bytes
+  OTA_PARSE_RAW,     // Plain firmware.bin (uploads only)
+  OTA_PARSE_DONE,    // Every block written
+  OTA_PARSE_FAILED
+} ota_parse_t;
+
+/**
+ * Image being written: parses the packed format as it arrives, in pieces of any size,
+ * and writes each decoded block to the partition.
+ */
+typedef struct {
+  const esp_partition_t *partition;
+  ota_parse_t state;
+  bool     allowRaw;        // Accept a plain firmware.bin
+  uint8_t  word[16];        // Header or length word being collected
+  size_t   wordLen;
+  uint32_t imageSize;       // Firmware bytes, from the header (raw: counted)
+  uint32_t written;         // Firmware bytes written to the partition
+  uint32_t blockRemaining;  // Packed bytes left of the current block
+  bool     stored;          // The current block is not deflated
+  tinfl_decompressor *inflator;
+  uint8_t *block;           // OTA_BLOCK_SIZE decoded bytes
+  size_t   blockLen;
+  char     error[64];
+} OtaWriter;
+
+static OtaWriter writer;
+
+typedef struct {
+  uint32_t magic;
+  int32_t  lastCheck;        // UTC of the last manifest check, 0 = none since power-on
+  uint32_t version;          // Version being downloaded, 0 = none
+  uint32_t rejectedVersion;  // Version given up on, not downloaded again until the manifest changes
+  uint32_t imageSize;        // From the packed header, 0 = not read yet
+  uint32_t written;          // Firmware bytes in the partition (whole blocks)
+  uint32_t fileOffset;       // Offset of the next block in the packed file
+  uint32_t partitionAddress; // Partition the blocks were written to
+  uint8_t  failures;         // Failed attempts for this version
+  char     md5[33];          // From the manifest, "" = none
+  char     url[OTA_URL_LEN];
+} OtaState;
+
+// Persists across deep sleep
+RTC_DATA_ATTR static OtaState ota;
+static_assert(sizeof(ota) <= RTC_BUDGET_OTA_UPDATE, "OTA state over its RTC allotment");
+
+static bool readyToBoot = false;
+static bool uploadActive = false;
+
+/**
+ * Start from no download after power-on or reset.
+ */
+static void ensureState() {
+  if (ota.magic != OTA_MAGIC) {
+    memset(&ota, 0, sizeof(ota));
+    ota.magic = OTA_MAGIC;
+  }
+}
+
+static uint32_t readLE32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool writerFail(const char *error) {
+  strlcpy(writer.error, error, sizeof(writer.error));
+  writer.state = OTA_PARSE_FAILED;
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("OTA: %s\n", error);
+  }
+#endif
+  return false;
+}
+
+/**
+ * Prepare to write into partition, from the start or (resuming) after written bytes
+ * of an image whose header was read on an earlier wake.
+ */
+static bool writerBegin(const esp_partition_t *partition, bool allowRaw, uint32_t imageSize, uint32_t written) {
+  memset(&writer, 0, sizeof(writer));
+  writer.partition = partition;
+  writer.allowRaw = allowRaw;
+  writer.imageSize = imageSize;
+  writer.written = written;
+  writer.state = (written > 0) ? OTA_PARSE_LENGTH : OTA_PARSE_HEADER;
+
+  arenaReset(ARENA_OTA);
+  writer.inflator = (tinfl_decompressor *)arenaAlloc(ARENA_OTA, sizeof(tinfl_decompressor));
+  writer.block = (uint8_t *)arenaAlloc(ARENA_OTA, OTA_BLOCK_SIZE);
+  if (!writer.inflator || !writer.block) {
+    return writerFail("No memory for the firmware block");
+  }
+  return true;
+}
+
+static void writerEnd() {
+  arenaReset(ARENA_OTA);
+  writer.inflator = NULL;
+  writer.block = NULL;
+}
+
+/**
+ * Erase the sectors under the decoded block and write it.
+ */
+static bool flushBlock() {
+  if (writer.blockLen == 0) {
+    return true;
+  }
+  if (writer.written == 0 && writer.block[0] != OTA_ESP_IMAGE_MAGIC) {
+    return writerFail("Not an ESP32 firmware image");
+  }
+  if (writer.written + writer.blockLen > writer.partition->size) {
+    return writerFail("Image larger than the OTA partition");
+  }
+  size_t eraseLen = (writer.blockLen + OTA_SECTOR_SIZE - 1) & ~(size_t)(OTA_SECTOR_SIZE - 1);
+  if (esp_partition_erase_range(writer.partition, writer.written, eraseLen) != ESP_OK ||
+      esp_partition_write(writer.partition, writer.written, writer.block, writer.blockLen) != ESP_OK) {
+    return writerFail("Flash write failed");
+  }
+  writer.written += writer.blockLen;
+  writer.blockLen = 0;
+  return true;
+}
+
+/**
+ * Take the bytes of a header or length word, collected across pieces.
+ *
+ * @return true once all size bytes are in writer.word
+ */
+static bool collectWord(const uint8_t *data, size_t len, size_t size, size_t *used) {
+  size_t n = min(size - writer.wordLen, len);
+  memcpy(writer.word + writer.wordLen, data, n);
+  writer.wordLen += n;
+  *used = n;
+  if (writer.wordLen < size) return false;
+  writer.wordLen = 0;
+  return true;
+}
+
+/**
+ * Check and write a block whose bytes have all arrived.
+ */
+static void finishBlock() {
+  uint32_t expected = min((uint32_t)OTA_BLOCK_SIZE, writer.imageSize - writer.written);
+  if (writer.blockLen != expected) {
+    writerFail("Block has the wrong size");
+    return;
+  }
+  if (flushBlock()) {
+    writer.state = (writer.written == writer.imageSize) ? OTA_PARSE_DONE : OTA_PARSE_LENGTH;
+  }
+}
+
+/**
+ * Parse the next bytes of the image. Stops early after a block has been written, so
+ * the caller can note the position.
+ *
+ * @return Bytes used from data
+ */
+static size_t writerFeed(const uint8_t *data, size_t len) {
+  size_t pos = 0;
+  while (pos < len) {
+    size_t used = 0;
+    switch (writer.state) {
+      case OTA_PARSE_HEADER:
+        if (writer.wordLen == 0 && writer.allowRaw && data[pos] == OTA_ESP_IMAGE_MAGIC) {
+          writer.state = OTA_PARSE_RAW;
+          break;
+        }
+        if (collectWord(data + pos, len - pos, 16, &used)) {
+          writer.imageSize = readLE32(writer.word + 4);
+          if (readLE32(writer.word) != OTA_PACK_MAGIC || readLE32(writer.word + 8) != OTA_BLOCK_SIZE) {
+            writerFail("Not a packed firmware image");
+          } else if (writer.imageSize == 0 || writer.imageSize > writer.partition->size) {
+            writerFail("Image larger than the OTA partition");
+          } else {
+            writer.state = OTA_PARSE_LENGTH;
+          }
+        }
+        break;
+
+      case OTA_PARSE_LENGTH:
+        if (collectWord(data + pos, len - pos, 4, &used)) {
+          uint32_t length = readLE32(writer.word);
+          writer.stored = (length & OTA_BLOCK_STORED) != 0;
+          writer.blockRemaining = length & ~OTA_BLOCK_STORED;
+          writer.blockLen = 0;
+          if (writer.blockRemaining == 0 || writer.blockRemaining > OTA_BLOCK_SIZE) {
+            writerFail("Corrupt block length");
+          } else {
+            tinfl_init(writer.inflator);
+            writer.state = OTA_PARSE_BLOCK;
+          }
+        }
+        break;
+
+      case OTA_PARSE_BLOCK: {
+        size_t in = min((size_t)writer.blockRemaining, len - pos);
+        if (writer.stored) {
+          if (writer.blockLen + in > OTA_BLOCK_SIZE) {
+            writerFail("Block has the wrong size");
+            break;
+          }
+          memcpy(writer.block + writer.blockLen, data + pos, in);
+          writer.blockLen += in;
+          used = in;
+          writer.blockRemaining -= in;
+          if (writer.blockRemaining == 0) {
+            finishBlock();
+            return pos + used;
+          }
+          break;
+        }
+        size_t out = OTA_BLOCK_SIZE - writer.blockLen;
+        mz_uint32 flags = TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF;
+        if (writer.blockRemaining > in) flags |= TINFL_FLAG_HAS_MORE_INPUT;
+        // The output buffer holds the whole block, so it is its own dictionary
+        tinfl_status status = tinfl_decompress(writer.inflator, data + pos, &in, writer.block,
+                                               writer.block + writer.blockLen, &out, flags);
+        used = in;
+        writer.blockRemaining -= in;
+        writer.blockLen += out;
+        if (status == TINFL_STATUS_DONE) {
+          if (writer.blockRemaining != 0) {
+            writerFail("Corrupt block");
+          } else {
+            finishBlock();
+          }
+          return pos + used;
+        }
+        if (status < 0 || status == TINFL_STATUS_HAS_MORE_OUTPUT ||
+            (writer.blockRemaining == 0 && status == TINFL_STATUS_NEEDS_MORE_INPUT)) {
+          writerFail("Corrupt block");
+        }
+        break;
+      }
+
+      case OTA_PARSE_RAW:
+        used = min(OTA_BLOCK_SIZE - writer.blockLen, len - pos);
+        memcpy(writer.block + writer.blockLen, data + pos, used);
+        writer.blockLen += used;
+        if (writer.blockLen == OTA_BLOCK_SIZE) {
+          flushBlock();
+          return pos + used;
+        }
+        break;
+
+      case OTA_PARSE_DONE:
+        return len; // Anything after the last block is ignored
+
+      case OTA_PARSE_FAILED:
+        return pos;
+    }
+    pos += used;
+    if (writer.state == OTA_PARSE_FAILED) {
+      return pos;
+    }
+  }
+  return pos;
+}
+
+/**
+ * Check the written image and set it to boot.
+ *
+ * @param md5 Expected MD5 of the firmware (hex), "" = no check beyond the image's own
+ */
+static bool writerFinish(const char *md5) {
+  if (writer.state == OTA_PARSE_RAW) {
+    if (!flushBlock()) return false;
+    writer.imageSize = writer.written;
+    writer.state = OTA_PARSE_DONE;
+  }
+  if (writer.state == OTA_PARSE_FAILED) {
+    return false; // Keeps the first error
+  }
+  if (writer.state != OTA_PARSE_DONE) {
+    return writerFail("Incomplete image");
+  }
+
+  if (md5[0]) {
+    MD5Builder digest;
+    digest.begin();
+    for (uint32_t offset = 0; offset < writer.imageSize; offset += OTA_BLOCK_SIZE) {
+      size_t n = min((uint32_t)OTA_BLOCK_SIZE, writer.imageSize - offset);
+      if (esp_partition_read(writer.partition, offset, writer.block, n) != ESP_OK) {
+        return writerFail("Flash read failed");
+      }
+      digest.add(writer.block, n);
+    }
+    digest.calculate();
+    if (strcasecmp(digest.toString().c_str(), md5) != 0) {
+      return writerFail("MD5 does not match the manifest");
+    }
+  }
+
+  // Verifies the image checksum and hash before switching
+  if (esp_ota_set_boot_partition(writer.partition) != ESP_OK) {
+    return writerFail("Image did not verify");
+  }
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("OTA: %u bytes written to %s, boots on restart\n", writer.imageSize, writer.partition->label);
+  }
+#endif
+  return true;
+}
+
+/**
+ * GET a URL with the client its scheme needs.
+ *
+ * @return HTTP status code, or a negative HTTPC_ERROR_* code
+ */
+static int otaGet(HTTPClient &http, WiFiClient &plain, WiFiClientSecure &secure, const char *url, uint32_t offset) {
+  bool https = strncmp(url, "https://", 8) == 0;
+  if (https) {
+    if (!OTA_CA_CERT) return HTTPC_ERROR_CONNECTION_REFUSED; // No trust anchor for the server
+    secure.setCACert(OTA_CA_CERT);
+  }
+  if (!(https ? http.begin(secure, url) : http.begin(plain, url))) {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  http.useHTTP10(true); // No chunked framing: the body is read straight off the connection
+  http.setTimeout(API_RESPONSE_TIMEOUT_MS);
+  if (offset > 0) {
+    http.addHeader("Range", "bytes=" + String(offset) + "-");
+  }
+  return http.GET();
+}
+
+/**
+ * Look for a newer firmware in the manifest and start downloading it.
+ */
+static void checkManifest(time_t now) {
+  ota.lastCheck = now;
+  WiFiClient plain;
+  WiFiClientSecure secure;
+  HTTPClient http;
+  int code = otaGet(http, plain, secure, OTA_MANIFEST_URL, 0);
+  if (code != HTTP_CODE_OK) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("OTA: manifest request failed (%d)\n", code);
+    }
+#endif
+    http.end();
+    return;
+  }
+
+  StaticJsonDocument<384> doc;
+  DeserializationError error = deserializeJson(doc, http.getStream());
+  http.end();
+  uint32_t version = doc["version"] | 0;
+  const char *url = doc["url"] | "";
+  const char *md5 = doc["md5"] | "";
+  if (error || version <= OTA_FIRMWARE_VERSION || version == ota.rejectedVersion) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("OTA: no update (running %u, manifest %u)\n", OTA_FIRMWARE_VERSION, version);
+    }
+#endif
+    return;
+  }
+  if (strlen(url) == 0 || strlen(url) >= sizeof(ota.url) || strlen(md5) >= sizeof(ota.md5)) {
+    return;
+  }
+
+  ota.version = version;
+  strlcpy(ota.url, url, sizeof(ota.url));
+  strlcpy(ota.md5, md5, sizeof(ota.md5));
+  ota.imageSize = 0;
+  ota.written = 0;
+  ota.fileOffset = 0;
+  ota.partitionAddress = 0;
+  ota.failures = 0;
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("OTA: version %u available, downloading %s\n", version, url);
+  }
+#endif
+}
+
+/**
+ * Count a failed attempt; after OTA_MAX_FAILURES the version is dropped.
+ *
+ * @param restart The data written so far cannot be trusted, start over
+ */
+static void downloadFailed(bool restart) {
+  if (restart) {
+    ota.imageSize = 0;
+    ota.written = 0;
+    ota.fileOffset = 0;
+  }
+  if (++ota.failures >= OTA_MAX_FAILURES) {
+    ota.rejectedVersion = ota.version;
+    ota.version = 0;
+  }
+}
+
+/**
+ * Continue the download from the RTC position for up to OTA_WAKE_BUDGET_MS.
+ */
+static void download(unsigned long startMs) {
+  const esp_partition_t *partition = esp_ota_get_next_update_partition(NULL);
+  if (!partition) {
+    ota.version = 0;
+    return;
+  }
+  if (partition->address != ota.partitionAddress) {
+    ota.imageSize = 0;
+    ota.written = 0;
+    ota.fileOffset = 0;
+    ota.partitionAddress = partition->address;
+  }
+
+  WiFiClient plain;
+  WiFiClientSecure secure;
+  HTTPClient http;
+  int code = otaGet(http, plain, secure, ota.url, ota.fileOffset);
+  if (code == HTTP_CODE_OK && ota.fileOffset > 0) { // Range ignored: the whole file follows
+    ota.imageSize = 0;
+    ota.written = 0;
+    ota.fileOffset = 0;
+  } else if (code != HTTP_CODE_OK && code != HTTP_CODE_PARTIAL_CONTENT) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("OTA: image request failed (%d)\n", code);
+    }
+#endif
+    http.end();
+    if (code > 0) downloadFailed(code == 416); // Beyond the end: the file changed
+    return;
+  }
+
+  if (!writerBegin(partition, false, ota.imageSize, ota.written)) {
+    http.end();
+    writerEnd();
+    return;
+  }
+  Stream *stream = http.getStreamPtr();
+  long remaining = http.getSize();     // -1 = until the server closes
+  const uint32_t fileBase = ota.fileOffset;
+  uint32_t parsed = 0;                 // File bytes parsed on this wake
+  bool budgetUsed = false;
+  uint8_t buf[HTTP_BODY_INPUT_SIZE];
+  while (!budgetUsed && writer.state != OTA_PARSE_DONE && writer.state != OTA_PARSE_FAILED && remaining != 0) {
+    size_t want = (remaining > 0) ? min((long)sizeof(buf), remaining) : sizeof(buf);
+    size_t n = stream->readBytes(buf, want);
+    if (n == 0) break; // Timed out or closed: resume from the last block next time
+    if (remaining > 0) remaining -= n;
+
+    size_t pos = 0;
+    while (pos < n && writer.state != OTA_PARSE_FAILED) {
+      uint32_t writtenBefore = writer.written;
+      pos += writerFeed(buf + pos, n - pos);
+      if (writer.written != writtenBefore) { // A block boundary: the position to resume from
+        ota.fileOffset = fileBase + parsed + pos;
+        ota.written = writer.written;
+        ota.imageSize = writer.imageSize;
+        if (millis() - startMs >= OTA_WAKE_BUDGET_MS) {
+          budgetUsed = true;
+          break;
+        }
+      }
+    }
+    parsed += n;
+  }
+  http.end();
+
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("OTA: version %u, %u of %u bytes written\n", ota.version, ota.written, ota.imageSize);
+  }
+#endif
+  if (writer.state == OTA_PARSE_FAILED) {
+    downloadFailed(true);
+  } else if (writer.state == OTA_PARSE_DONE) {
+    if (writerFinish(ota.md5)) {
+      readyToBoot = true;
+      ota.version = 0;
+    } else {
+      ota.rejectedVersion = ota.version;
+      ota.version = 0;
+    }
+  }
+  writerEnd();
+}
+
+bool otaDue(time_t now) {
+  ensureState();
+  if (strlen(OTA_MANIFEST_URL) == 0 || now < 946684800) { // Disabled, or RTC not set
+    return false;
+  }
+  return ota.version != 0 || ota.lastCheck == 0 || now - ota.lastCheck >= OTA_CHECK_HOURS * 3600L;
+}
+
+bool otaRun(time_t now) {
+  if (!otaDue(now)) {
+    return false;
+  }
+  unsigned long startMs = millis();
+  apiClose(); // The weather connection is finished with; one TLS session at a time
+  if (ota.version == 0) {
+    checkManifest(now);
+  }
+  if (ota.version != 0) {
+    download(startMs);
+  }
+  return readyToBoot;
+}
+
+bool otaReadyToBoot() {
+  return readyToBoot;
+}
+
+void otaMarkValid() {
+  esp_ota_mark_app_valid_cancel_rollback();
+}
+
+bool otaUploadBegin() {
+  const esp_partition_t *partition = esp_ota_get_next_update_partition(NULL);
+  uploadActive = false;
+  if (!partition) {
+    strlcpy(writer.error, "No OTA partition", sizeof(writer.error));
+    return false;
+  }
+  uploadActive = writerBegin(partition, true, 0, 0);
+  return uploadActive;
+}
+
+bool otaUploadWrite(const uint8_t *data, size_t len) {
+  if (!uploadActive) {
+    return false;
+  }
+  size_t pos = 0;
+  while (pos < len && writer.state != OTA_PARSE_FAILED) {
+    pos += writerFeed(data + pos, len - pos);
+  }
+  if (writer.state == OTA_PARSE_FAILED) {
+    uploadActive = false;
+    writerEnd();
+    return false;
+  }
+  return true;
+}
+
+bool otaUploadEnd() {
+  if (!uploadActive) {
+    return false;
+  }
+  uploadActive = false;
+  bool ok = writerFinish("");
+  writerEnd();
+  return ok;
+}
+
+const char *otaUploadError() {
+  return writer.error;
+}
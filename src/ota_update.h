@@ -0,0 +1,109 @@
+#ifndef __OTA_UPDATE_H__
+#define __OTA_UPDATE_H__
+
+#include <Arduino.h>
+#include <time.h>
+
+// Manifest checked for a newer firmware on wakes that use WiFi (http:// or https://),
+// "" = no network updates (uploads in setup mode still work). The manifest is JSON:
+// {"version": 12, "url": "http://host/firmware.ota", "md5": "<md5 of firmware.bin>"}
+// as written by tools/pack_ota_image.py
+#ifndef OTA_MANIFEST_URL
+#define OTA_MANIFEST_URL ""
+#endif
+
+// Version of this build; a manifest with a higher one is downloaded
+#ifndef OTA_FIRMWARE_VERSION
+#define OTA_FIRMWARE_VERSION 1
+#endif
+
+// PEM CA certificate(s) for https:// manifest and image URLs, NULL = http:// only
+#ifndef OTA_CA_CERT
+#define OTA_CA_CERT NULL
+#endif
+
+// Hours between manifest checks
+#ifndef OTA_CHECK_HOURS
+#define OTA_CHECK_HOURS 24
+#endif
+
+// Download time per wake (ms); the download stops after the block in progress and resumes on the next wake
+#ifndef OTA_WAKE_BUDGET_MS
+#define OTA_WAKE_BUDGET_MS 8000
+#endif
+
+// Failed attempts (bad response or corrupt data) before a version is given up until the next check
+#define OTA_MAX_FAILURES 3
+
+// Longest image URL kept in RTC memory, including the terminator
+#define OTA_URL_LEN 160
+
+// Packed image format (tools/pack_ota_image.py), little endian:
+//   header: "OTA1", firmware size, block size (OTA_BLOCK_SIZE), 0
+//   then per block: length (bit 31 set = stored, not deflated) and that many bytes,
+//   each block an independent raw deflate stream of OTA_BLOCK_SIZE firmware bytes (the last one shorter)
+#define OTA_PACK_MAGIC   0x3141544F  // "OTA1" in file order
+#define OTA_BLOCK_SIZE   32768       // TINFL_LZ_DICT_SIZE: a block inflates within its own output
+#define OTA_BLOCK_STORED 0x80000000
+
+#define OTA_MAGIC 0x4F544155  // "OTAU" in hex
+
+/**
+ * Whether this wake has updater work for the WiFi session: a download in progress, or
+ * a manifest check due. Decided before WiFi is started, so the fetch leaves it on.
+ *
+ * @param now Current UTC time (RTC)
+ */
+bool otaDue(time_t now);
+
+/**
+ * Run the updater on the wake's WiFi session, after the weather fetches: check the
+ * manifest if due, then continue the download for up to OTA_WAKE_BUDGET_MS. A complete
+ * image is checked against the manifest's MD5 and the ESP image checksum and made the
+ * boot partition.
+ *
+ * @param now Current UTC time (RTC)
+ * @return true if a new firmware is ready (see otaReadyToBoot())
+ */
+bool otaRun(time_t now);
+
+/**
+ * A new firmware was written and set to boot. Restart with esp_restart() instead of deep
+ * sleep, so it starts with RTC memory initialized for its own layout.
+ */
+bool otaReadyToBoot();
+
+/**
+ * The running firmware works (it fetched the weather): cancel a pending rollback when the
+ * bootloader has rollback enabled.
+ */
+void otaMarkValid();
+
+/**
+ * Start writing an upload (setup mode, POST /update): firmware.bin as built, or a packed
+ * image. Abandons an upload that was left unfinished.
+ *
+ * @return false if there is no OTA partition or no memory for the inflater
+ */
+bool otaUploadBegin();
+
+/**
+ * Write the next part of the upload.
+ *
+ * @return false once the upload has failed (otaUploadError())
+ */
+bool otaUploadWrite(const uint8_t *data, size_t len);
+
+/**
+ * Finish the upload: check the image and make it the boot partition.
+ *
+ * @return true if the new firmware boots on the next restart
+ */
+bool otaUploadEnd();
+
+/**
+ * Why the last upload failed.
+ */
+const char *otaUploadError();
+
+#endif // __OTA_UPDATE_H__
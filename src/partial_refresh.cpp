@@ -0,0 +1,245 @@
+/**
+ * Partial Refresh
+ *
+ * Tracks which layout regions of the weather screen changed between wakes so the panel
+ * only flashes and redraws those areas. The previous frame itself does not survive deep
+ * sleep (PSRAM is powered down), so a 32-bit hash per region and a 16-bit hash per tile
+ * are kept in RTC memory instead. Within a changed region only the changed tiles are
+ * cleared, and of those only the rectangles holding ink are drawn.
+ */
+
+#include <Arduino.h>
+#include "partial_refresh.h"
+#include "frame_diff.h"
+#include "memory_arena.h"
+#include "perf_log.h"
+#include "settings.h"
+#include "rtc_budget.h"
+
+// Hashes of the regions and their tiles currently shown on the panel
+RTC_DATA_ATTR static uint32_t regionHashes[REGION_COUNT];
+RTC_DATA_ATTR static uint16_t tileHashes[PARTIAL_REFRESH_MAX_TILES];
+RTC_DATA_ATTR static bool     regionHashesValid = false;
+RTC_DATA_ATTR static uint16_t refreshesSinceFullClear = 0;
+static_assert(sizeof(regionHashes) + sizeof(tileHashes) + sizeof(regionHashesValid) + sizeof(refreshesSinceFullClear) <=
+              RTC_BUDGET_PARTIAL_REFRESH, "refresh hashes over their RTC allotment");
+
+/**
+ * FNV-1a hash of a framebuffer rectangle (x and width must be even).
+ */
+static uint32_t hashRegion(const Rect_t &area) {
+  uint32_t hash = 2166136261UL;
+  const int rowBytes = area.width / 2;
+  for (int y = area.y; y < area.y + area.height; y++) {
+    const uint8_t *row = framebuffer + (y * EPD_WIDTH + area.x) / 2;
+    for (int i = 0; i < rowBytes; i++) {
+      hash = (hash ^ row[i]) * 16777619UL;
+    }
+  }
+  return hash;
+}
+
+/**
+ * First tile hash of each region, and the total at REGION_COUNT, worked out from the
+ * layout at compile time.
+ */
+static constexpr LayoutTable<REGION_COUNT + 1> layoutTileOffsets() {
+  LayoutTable<REGION_COUNT + 1> offsets = {};
+  for (int r = 0; r < REGION_COUNT; r++) {
+    const LayoutRect &area = Layout::regions[r];
+    int tiles = ((area.width + FRAME_TILE_WIDTH - 1) / FRAME_TILE_WIDTH) * ((area.height + FRAME_TILE_HEIGHT - 1) / FRAME_TILE_HEIGHT);
+    offsets.values[r + 1] = offsets.values[r] + tiles;
+  }
+  return offsets;
+}
+static constexpr LayoutTable<REGION_COUNT + 1> tileOffsets = layoutTileOffsets();
+
+/**
+ * Index of a region's first tile hash, or -1 if the regions before it used up PARTIAL_REFRESH_MAX_TILES.
+ */
+static int regionTileOffset(int region) {
+  return (tileOffsets[region + 1] <= PARTIAL_REFRESH_MAX_TILES) ? tileOffsets[region] : -1;
+}
+
+/**
+ * Copy a framebuffer rectangle into a packed buffer sized to the rectangle.
+ */
+static void copyRegion(const Rect_t &area, uint8_t *dest) {
+  const int rowBytes = area.width / 2;
+  for (int y = 0; y < area.height; y++) {
+    memcpy(dest + y * rowBytes, framebuffer + ((area.y + y) * EPD_WIDTH + area.x) / 2, rowBytes);
+  }
+}
+
+// Refresh in progress (refreshBegin() .. refreshEnd())
+static bool     refreshFull;          // Panel was cleared, every region is drawn
+static uint8_t *regionBuffer = NULL;  // Packed copy of the region being drawn
+static uint32_t refreshHashes[REGION_COUNT];
+static uint16_t refreshTileHashes[PARTIAL_REFRESH_MAX_TILES];
+static uint8_t  regionsDone;          // Bit per region already hashed and pushed
+static int      regionsChanged;
+static uint32_t pixelsDrawn;          // Area of the rectangles pushed
+
+/**
+ * Draw the ink in a panel area that is white (just cleared).
+ */
+static void drawInk(const Rect_t &area) {
+  Rect_t rects[PARTIAL_REFRESH_MAX_RECTS];
+  int count = frameInkRects(framebuffer, area, rects, PARTIAL_REFRESH_MAX_RECTS);
+  for (int i = 0; i < count; i++) {
+    copyRegion(rects[i], regionBuffer);
+    epd_draw_grayscale_image(rects[i], regionBuffer);
+    pixelsDrawn += rects[i].width * rects[i].height;
+  }
+}
+
+void refreshBegin() {
+  refreshFull = !regionHashesValid || refreshesSinceFullClear >= PARTIAL_REFRESH_FULL_INTERVAL;
+  regionBuffer = (uint8_t *)arenaAlloc(ARENA_REFRESH, Layout::largestRegionBytes());
+  if (!regionBuffer) {
+    refreshFull = true; // The whole framebuffer is pushed in refreshEnd() instead
+  }
+  regionsDone = 0;
+  regionsChanged = 0;
+  pixelsDrawn = 0;
+
+  epd_poweron();
+  if (refreshFull) {
+    epd_clear();
+  }
+}
+
+void refreshRegion(int region) {
+  if (regionsDone & (1 << region)) return;
+  regionsDone |= 1 << region;
+
+  const Rect_t &area = displayRegions[region];
+  refreshHashes[region] = hashRegion(area);
+  int tiles = regionTileOffset(region);
+  if (tiles >= 0) {
+    frameTileHashes(framebuffer, area, refreshTileHashes + tiles);
+  }
+  if (!regionBuffer) return;
+  if (!refreshFull && refreshHashes[region] == regionHashes[region]) return;
+  regionsChanged++;
+
+  if (refreshFull) {
+    drawInk(area); // The whole panel was cleared
+    return;
+  }
+  Rect_t changed[PARTIAL_REFRESH_MAX_RECTS];
+  int count = 0;
+  if (tiles >= 0) {
+    count = frameChangedRects(area, tileHashes + tiles, refreshTileHashes + tiles, changed, PARTIAL_REFRESH_MAX_RECTS);
+  }
+  if (count == 0) {
+    changed[0] = area; // Untracked region, or the change fell within a tile hash collision
+    count = 1;
+  }
+  for (int i = 0; i < count; i++) {
+    epd_clear_area(changed[i]);
+    drawInk(changed[i]);
+  }
+}
+
+void refreshEnd() {
+  for (int r = 0; r < REGION_COUNT; r++) {
+    refreshRegion(r);
+  }
+  if (!regionBuffer) {
+    epd_draw_grayscale_image(epd_full_screen(), framebuffer);
+    pixelsDrawn = EPD_WIDTH * EPD_HEIGHT;
+  }
+  arenaReset(ARENA_REFRESH);
+  regionBuffer = NULL;
+  epd_poweroff_all();
+
+  if (refreshFull) {
+    refreshesSinceFullClear = 0;
+  } else {
+    refreshesSinceFullClear++;
+  }
+#if DEBUG_LEVEL
+  if (Serial) {
+    if (refreshFull) {
+      Serial.printf("Full display refresh: %lu pixels drawn\n", (unsigned long)pixelsDrawn);
+    } else {
+      Serial.printf("Partial display refresh: %d of %d regions changed, %lu pixels drawn\n", regionsChanged,
+                    REGION_COUNT, (unsigned long)pixelsDrawn);
+    }
+  }
+#endif
+  perfSetPanelPixels(pixelsDrawn);
+
+  memcpy(regionHashes, refreshHashes, sizeof(regionHashes));
+  memcpy(tileHashes, refreshTileHashes, sizeof(tileHashes));
+  regionHashesValid = true;
+}
+
+/**
+ * Remember the regions pushed by this refresh as shown; the others keep their hashes.
+ */
+static void keepPushedRegions() {
+  for (int r = 0; r < REGION_COUNT; r++) {
+    if (!(regionsDone & (1 << r))) continue;
+    regionHashes[r] = refreshHashes[r];
+    int tiles = regionTileOffset(r);
+    if (tiles >= 0) {
+      memcpy(tileHashes + tiles, refreshTileHashes + tiles, frameTileCount(displayRegions[r]) * sizeof(uint16_t));
+    }
+  }
+}
+
+void refreshCancel() {
+  arenaReset(ARENA_REFRESH);
+  regionBuffer = NULL;
+  if (refreshFull) {
+    invalidateDisplayRegions(); // Regions not pushed yet are blank on the panel
+    return;
+  }
+  // The panel shows the regions already pushed as drawn, the others as they were, so a
+  // screen drawn next (e.g. the last good forecast) is still refreshed partially
+  keepPushedRegions();
+}
+
+bool refreshRegionsOnly(uint8_t regions) {
+  if (!regionHashesValid || refreshesSinceFullClear >= PARTIAL_REFRESH_FULL_INTERVAL) {
+    return false;
+  }
+  regionBuffer = (uint8_t *)arenaAlloc(ARENA_REFRESH, Layout::largestRegionBytes());
+  if (!regionBuffer) {
+    return false;
+  }
+  refreshFull = false;
+  regionsDone = 0;
+  regionsChanged = 0;
+  pixelsDrawn = 0;
+
+  epd_poweron();
+  for (int r = 0; r < REGION_COUNT; r++) {
+    if (regions & (1 << r)) {
+      refreshRegion(r);
+    }
+  }
+  arenaReset(ARENA_REFRESH);
+  regionBuffer = NULL;
+  epd_poweroff_all();
+  refreshesSinceFullClear++;
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Region refresh: %d regions changed, %lu pixels drawn\n", regionsChanged, (unsigned long)pixelsDrawn);
+  }
+#endif
+  perfSetPanelPixels(pixelsDrawn);
+  keepPushedRegions();
+  return true;
+}
+
+void refreshWeatherDisplay() {
+  refreshBegin();
+  refreshEnd();
+}
+
+void invalidateDisplayRegions() {
+  regionHashesValid = false;
+}
@@ -0,0 +1,72 @@
+#ifndef __PARTIAL_REFRESH_H__
+#define __PARTIAL_REFRESH_H__
+
+#include <Arduino.h>
+#include "renderer.h"
+
+// Do a full flashing clear and redraw every this many weather refreshes to control ghosting
+#define PARTIAL_REFRESH_FULL_INTERVAL 24
+
+// Tile hashes kept in RTC memory for all regions (the layout needs 288 of FRAME_TILE_WIDTH x FRAME_TILE_HEIGHT)
+#ifndef PARTIAL_REFRESH_MAX_TILES
+#define PARTIAL_REFRESH_MAX_TILES 288
+#endif
+
+// Rectangles cleared, and drawn, per region
+#define PARTIAL_REFRESH_MAX_RECTS 8
+
+/**
+ * Push the weather screen in the framebuffer to the panel.
+ * Each layout region is hashed and compared with the hashes of the previous weather
+ * screen (kept in RTC memory); only the changed tiles of changed regions are cleared,
+ * and only the parts of them holding ink are drawn. A full
+ * clear and redraw is done on the first screen after boot, after any other screen
+ * was shown, and every PARTIAL_REFRESH_FULL_INTERVAL refreshes.
+ * Powers the panel on and off.
+ */
+void refreshWeatherDisplay();
+
+/**
+ * Start a region-by-region refresh: decide between a full and a partial refresh, power
+ * the panel on and, for a full refresh, clear it.
+ * Lets regions be pushed while the rest of the screen is still being drawn.
+ */
+void refreshBegin();
+
+/**
+ * Push one region of the framebuffer (a display_region_t) if it changed, or always after
+ * a full clear. The region must be completely drawn. Regions already pushed are skipped.
+ */
+void refreshRegion(int region);
+
+/**
+ * Push any regions not pushed yet, power the panel off and remember the screen shown.
+ */
+void refreshEnd();
+
+/**
+ * Abandon a refresh started with refreshBegin() (e.g. the fetch failed part way through).
+ * After a partial start the regions already pushed are remembered as shown; after a full
+ * clear the next weather screen is redrawn in full.
+ */
+void refreshCancel();
+
+/**
+ * Push only some regions of the framebuffer over the weather screen on the panel (a
+ * nowcast wake draws just the status bar). The other regions stay on the panel as they
+ * are and their part of the framebuffer is not looked at. Powers the panel on and off.
+ *
+ * @param regions Bit per display_region_t
+ * @return false, with nothing pushed, if the panel does not show a weather screen pushed
+ *         by this module or a full clear is due: draw the whole screen and use
+ *         refreshWeatherDisplay() instead
+ */
+bool refreshRegionsOnly(uint8_t regions);
+
+/**
+ * Forget the previous weather screen so the next refreshWeatherDisplay() redraws fully.
+ * Call whenever something other than the weather screen is drawn.
+ */
+void invalidateDisplayRegions();
+
+#endif // __PARTIAL_REFRESH_H__
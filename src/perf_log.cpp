@@ -0,0 +1,181 @@
+/**
+ * Performance Log
+ *
+ * Times each phase of a wake and keeps the last PERF_LOG_WAKES wakes in RTC slow
+ * memory, with an estimate of the charge each wake/sleep cycle used. The ring is
+ * copied to NVS now and then, so the setup-mode web server (entered through a
+ * reset, which clears RTC memory) can still show it.
+ */
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <time.h>
+#include "perf_log.h"
+#include "settings.h"
+#include "rtc_budget.h"
+
+typedef struct {
+  uint32_t magic;
+  uint16_t head;        // Slot the next record is written to
+  uint16_t count;       // Valid records
+  uint16_t sinceFlush;  // Records added since the last NVS copy
+  PerfRecord records[PERF_LOG_WAKES];
+} PerfLog;
+
+// Persists across deep sleep; restored from NVS after a reset
+RTC_DATA_ATTR static PerfLog perfLog;
+static_assert(sizeof(perfLog) <= RTC_BUDGET_PERF_LOG, "wake log over its RTC allotment");
+
+// This wake (RAM only, committed before sleep)
+static PerfRecord currentRecord;
+static uint32_t phaseStartUs[PERF_PHASE_COUNT];
+static uint32_t phaseTotalUs[PERF_PHASE_COUNT];
+
+static const char *const phaseNames[PERF_PHASE_COUNT] = {
+  "settings", "display", "battery", "wifi", "geocode", "connect", "ttfb", "decode",
+  "location", "current", "forecast", "graph", "status", "panel", "poweroff", "fleet",
+  "ota"
+};
+
+typedef enum { RAIL_ACTIVE, RAIL_WIFI, RAIL_PANEL } power_rail_t;
+
+// Power state the board is in during each phase
+static const uint8_t phaseRail[PERF_PHASE_COUNT] = {
+  RAIL_ACTIVE, RAIL_ACTIVE, RAIL_ACTIVE, RAIL_WIFI, RAIL_WIFI, RAIL_WIFI, RAIL_WIFI, RAIL_WIFI,
+  RAIL_ACTIVE, RAIL_ACTIVE, RAIL_ACTIVE, RAIL_ACTIVE, RAIL_ACTIVE, RAIL_PANEL, RAIL_ACTIVE, RAIL_WIFI,
+  RAIL_WIFI
+};
+
+/**
+ * Copy the ring buffer to NVS.
+ */
+static void flushToNVS() {
+  Preferences prefs;
+  prefs.begin("perf", false);
+  prefs.putBytes("log", &perfLog, sizeof(perfLog));
+  prefs.end();
+  perfLog.sinceFlush = 0;
+}
+
+/**
+ * Restore the ring buffer from NVS, or start an empty one.
+ */
+static void restoreFromNVS() {
+  Preferences prefs;
+  prefs.begin("perf", true);
+  size_t len = prefs.getBytes("log", &perfLog, sizeof(perfLog));
+  prefs.end();
+
+  if (len != sizeof(perfLog) || perfLog.magic != PERF_LOG_MAGIC ||
+      perfLog.head >= PERF_LOG_WAKES || perfLog.count > PERF_LOG_WAKES) {
+    memset(&perfLog, 0, sizeof(perfLog));
+    perfLog.magic = PERF_LOG_MAGIC;
+  }
+  perfLog.sinceFlush = 0;
+}
+
+void perfInit() {
+  if (perfLog.magic != PERF_LOG_MAGIC) {
+    restoreFromNVS();
+  }
+
+  memset(&currentRecord, 0, sizeof(currentRecord));
+  memset(phaseTotalUs, 0, sizeof(phaseTotalUs));
+  time_t now = time(NULL);
+  currentRecord.wakeTime = (now >= 946684800) ? now : 0; // RTC set (Unix timestamp for 2000-01-01)
+}
+
+void perfBegin(perf_phase_t phase) {
+  phaseStartUs[phase] = micros();
+}
+
+void perfEnd(perf_phase_t phase) {
+  phaseTotalUs[phase] += micros() - phaseStartUs[phase];
+}
+
+void perfSetFlag(uint16_t flag) {
+  currentRecord.flags |= flag;
+}
+
+void perfSetPanelPixels(uint32_t pixels) {
+  currentRecord.panelPixels = pixels;
+}
+
+void perfCommit(uint32_t sleepSecs) {
+  for (int i = 0; i < PERF_PHASE_COUNT; i++) {
+    uint32_t ms = (phaseTotalUs[i] + 500) / 1000;
+    currentRecord.phaseMs[i] = (ms > 0xFFFF) ? 0xFFFF : ms;
+  }
+  currentRecord.awakeMs = millis();
+  currentRecord.sleepSecs = sleepSecs;
+
+  perfLog.records[perfLog.head] = currentRecord;
+  perfLog.head = (perfLog.head + 1) % PERF_LOG_WAKES;
+  if (perfLog.count < PERF_LOG_WAKES) perfLog.count++;
+  if (++perfLog.sinceFlush >= PERF_LOG_FLUSH_INTERVAL) {
+    flushToNVS();
+  }
+}
+
+uint32_t perfEstimateMicroAmpHours(const PerfRecord &record) {
+  static const uint32_t railCurrentMA[] = {PERF_CURRENT_ACTIVE_MA, PERF_CURRENT_WIFI_MA, PERF_CURRENT_PANEL_MA};
+
+  // Charge in mA*ms; time not covered by a phase counts as plain CPU time
+  uint64_t charge = 0;
+  uint32_t phasedMs = 0;
+  for (int i = 0; i < PERF_PHASE_COUNT; i++) {
+    charge += (uint64_t)record.phaseMs[i] * railCurrentMA[phaseRail[i]];
+    phasedMs += record.phaseMs[i];
+  }
+  if (record.awakeMs > phasedMs) {
+    charge += (uint64_t)(record.awakeMs - phasedMs) * PERF_CURRENT_ACTIVE_MA;
+  }
+
+  // mA*ms -> uAh is /3600; sleep uA*s -> uAh is /3600 as well
+  return (uint32_t)((charge + (uint64_t)record.sleepSecs * PERF_CURRENT_SLEEP_UA) / 3600);
+}
+
+void perfPrintReport(Print &out, int maxRecords) {
+  int count = perfLog.count;
+  if (maxRecords > 0 && maxRecords < count) count = maxRecords;
+
+  out.printf("Wake log: %d of %d wakes, newest first\n", count, (int)perfLog.count);
+  out.printf("Currents: active %d mA, wifi %d mA, panel %d mA, sleep %d uA\n",
+             PERF_CURRENT_ACTIVE_MA, PERF_CURRENT_WIFI_MA, PERF_CURRENT_PANEL_MA, PERF_CURRENT_SLEEP_UA);
+
+  uint32_t totalUAh = 0;
+  for (int n = 0; n < count; n++) {
+    const PerfRecord &record = perfLog.records[(perfLog.head + PERF_LOG_WAKES - 1 - n) % PERF_LOG_WAKES];
+    uint32_t uAh = perfEstimateMicroAmpHours(record);
+    totalUAh += uAh;
+
+    char when[24] = "RTC not set";
+    if (record.wakeTime) {
+      time_t t = record.wakeTime;
+      strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", gmtime(&t));
+    }
+    out.printf("\n[%d] %s UTC  awake %lu ms  sleep %lu s  ~%lu.%03lu mAh ", n, when,
+               (unsigned long)record.awakeMs, (unsigned long)record.sleepSecs,
+               (unsigned long)(uAh / 1000), (unsigned long)(uAh % 1000));
+    if (record.flags & PERF_FLAG_CACHED)      out.print(" cached");
+    if (record.flags & PERF_FLAG_FETCHED)     out.print(" fetched");
+    if (record.flags & PERF_FLAG_FETCH_ERROR) out.print(" error");
+    if (record.flags & PERF_FLAG_WIFI_FAST)   out.print(" wifi-fast");
+    if (record.flags & PERF_FLAG_LOW_BATTERY) out.print(" low-battery");
+    if (record.flags & PERF_FLAG_FLEET)       out.print(" fleet");
+    if (record.flags & PERF_FLAG_LOCATIONS)   out.print(" locations");
+    if (record.flags & PERF_FLAG_BACKOFF)     out.print(" backoff");
+    if (record.flags & PERF_FLAG_NOWCAST)     out.print(" nowcast");
+    out.print("\n   ");
+    for (int i = 0; i < PERF_PHASE_COUNT; i++) {
+      if (record.phaseMs[i]) out.printf(" %s %u", phaseNames[i], record.phaseMs[i]);
+    }
+    if (record.panelPixels) out.printf("  pixels drawn %lu", (unsigned long)record.panelPixels);
+    out.print("\n");
+  }
+
+  if (count > 0) {
+    uint32_t avg = totalUAh / count;
+    out.printf("\nAverage ~%lu.%03lu mAh per cycle\n", (unsigned long)(avg / 1000), (unsigned long)(avg % 1000));
+  }
+}
@@ -0,0 +1,128 @@
+#ifndef __PERF_LOG_H__
+#define __PERF_LOG_H__
+
+#include <Arduino.h>
+
+// Number of wakes kept in the RTC ring buffer
+#ifndef PERF_LOG_WAKES
+#define PERF_LOG_WAKES 16
+#endif
+
+// Copy the ring to NVS every this many wakes, so it survives a reset (e.g. entering setup mode)
+// A reset loses at most this many wakes minus one
+#ifndef PERF_LOG_FLUSH_INTERVAL
+#define PERF_LOG_FLUSH_INTERVAL 4
+#endif
+
+// Board current draw used for the energy estimate, per power state
+#ifndef PERF_CURRENT_ACTIVE_MA
+#define PERF_CURRENT_ACTIVE_MA 45    // CPU running, radio and panel off
+#endif
+#ifndef PERF_CURRENT_WIFI_MA
+#define PERF_CURRENT_WIFI_MA   120   // Radio on: connecting, HTTP and streaming decode
+#endif
+#ifndef PERF_CURRENT_PANEL_MA
+#define PERF_CURRENT_PANEL_MA  95    // Panel high voltage on while refreshing
+#endif
+#ifndef PERF_CURRENT_SLEEP_UA
+#define PERF_CURRENT_SLEEP_UA  170   // Deep sleep, whole board
+#endif
+
+#define PERF_LOG_MAGIC 0x50455246  // "PERF" in hex
+
+// Timed phases of a wake, in the order setup() runs them
+typedef enum {
+  PERF_SETTINGS,       // initSettings()
+  PERF_DISPLAY_INIT,   // epd_init() and framebuffer allocation
+  PERF_BATTERY,        // batterySample()
+  PERF_WIFI,           // StartWiFi()
+  PERF_GEOCODE,        // Unused since geocoding moved to setup mode; kept so logged wakes keep their layout
+  PERF_HTTP_CONNECT,   // TCP connect to the weather API
+  PERF_FIRST_BYTE,     // Request sent until response headers received
+  PERF_DECODE,         // DecodeWeather() (streams the body)
+  PERF_DRAW_LOCATION,  // drawLocationDate()
+  PERF_DRAW_CURRENT,   // drawCurrentConditions()
+  PERF_DRAW_FORECAST,  // drawForecast()
+  PERF_DRAW_GRAPH,     // drawOutlookGraph()
+  PERF_DRAW_STATUS,    // drawStatusBar()
+  PERF_PANEL,          // Pushing the framebuffer to the panel (epd_draw_grayscale_image)
+  PERF_POWEROFF,       // epd_poweroff_all()
+  PERF_FLEET,          // Fleet forecast over ESP-NOW: requesting (display) or serving (gateway)
+  PERF_OTA,            // otaRun(): firmware manifest check and image download
+  PERF_PHASE_COUNT
+} perf_phase_t;
+
+// What happened during a wake (PerfRecord::flags)
+#define PERF_FLAG_CACHED      0x01  // Redrawn from the RTC forecast snapshot
+#define PERF_FLAG_FETCHED     0x02  // Weather fetched and decoded
+#define PERF_FLAG_FETCH_ERROR 0x04  // WiFi, geocoding or weather request failed
+#define PERF_FLAG_WIFI_FAST   0x08  // WiFi reconnected from the cached AP/lease
+#define PERF_FLAG_LOW_BATTERY 0x10  // Low battery, nothing fetched
+#define PERF_FLAG_FLEET       0x20  // Forecast received from the fleet gateway
+#define PERF_FLAG_LOCATIONS   0x40  // Other locations' forecasts fetched on the same WiFi session
+#define PERF_FLAG_BACKOFF     0x80  // Retry sleep after a failure, or radio kept off by the circuit breaker
+#define PERF_FLAG_NOWCAST     0x100 // Nowcast wake: only the minutely precipitation fetched and the status bar pushed
+
+/**
+ * Timings of one wake.
+ */
+typedef struct {
+  uint32_t wakeTime;                  // UTC at wake, 0 if the RTC was not set
+  uint32_t awakeMs;                   // Boot until deep sleep
+  uint32_t sleepSecs;                 // Sleep that followed
+  uint32_t panelPixels;               // Pixels drawn on the panel by the weather screen refresh
+  uint16_t phaseMs[PERF_PHASE_COUNT];
+  uint16_t flags;
+} PerfRecord;
+
+/**
+ * Start the record for this wake.
+ * Restores the ring buffer from NVS if RTC memory was lost (power-on or reset).
+ * Call first thing in setup().
+ */
+void perfInit();
+
+/**
+ * Mark the start of a phase.
+ */
+void perfBegin(perf_phase_t phase);
+
+/**
+ * Mark the end of a phase. A phase run more than once in a wake accumulates.
+ */
+void perfEnd(perf_phase_t phase);
+
+/**
+ * Set PERF_FLAG_* bits on this wake's record.
+ */
+void perfSetFlag(uint16_t flag);
+
+/**
+ * Record how many pixels the display refresh drew (the changed pixel area of the update).
+ */
+void perfSetPanelPixels(uint32_t pixels);
+
+/**
+ * Store this wake's record in the RTC ring buffer (and NVS every PERF_LOG_FLUSH_INTERVAL wakes).
+ * Call just before entering deep sleep.
+ *
+ * @param sleepSecs Seconds the device is about to sleep
+ */
+void perfCommit(uint32_t sleepSecs);
+
+/**
+ * Estimated charge used by one wake/sleep cycle, from the phase times and PERF_CURRENT_*.
+ *
+ * @return Charge in microamp-hours
+ */
+uint32_t perfEstimateMicroAmpHours(const PerfRecord &record);
+
+/**
+ * Print the most recent wakes, newest first, as a plain text table with the energy estimate.
+ *
+ * @param out Serial or a web client
+ * @param maxRecords Number of wakes to print (0 = all in the ring)
+ */
+void perfPrintReport(Print &out, int maxRecords);
+
+#endif // __PERF_LOG_H__
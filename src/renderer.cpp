@@ -12,14 +12,23 @@
 #include "renderer.h"
 #include "lang.h"
 #include "settings.h"
+#if FONT_SUBSET
+#include "font_subsets.h"
+#else
 #include "OpenSans8B.h"
 #include "OpenSans10B.h"
 #include "OpenSans12B.h"
 #include "OpenSans18B.h"
 #include "OpenSans24B.h"
+#endif
 #include "sunrise.h"
 #include "sunset.h"
+#include "fb_kernel.h"
+#include "battery.h"
 #include <math.h>
+#if ICON_SPRITES || ICON_BENCHMARK
+#include "icon_sprites.h"
+#endif
 
 // Color definitions
 #define White         0xFF
@@ -34,22 +43,52 @@
 #define LargeIcon   true
 #define SmallIcon   false
 
+// Width of the graph's temperature curve (Q16 pixels)
+#define GRAPH_LINE_WIDTH  (FB_Q16(5) / 2)
+
 // External variables from main.ino
 extern uint8_t *framebuffer;
 extern GFXfont currentFont;
-extern int globalTimezoneOffset;  // Timezone offset in seconds (positive = east of UTC)
+static const GFXfont *currentFallback = NULL;  // Language supplement for currentFont (FONT_SUBSET)
+
+static constexpr Rect_t toRect(const LayoutRect &r) {
+  return Rect_t{r.x, r.y, r.width, r.height};
+}
+
+// Layout regions (see display_region_t), from the compile-time layout
+const Rect_t displayRegions[REGION_COUNT] = {
+  toRect(Layout::regions[REGION_CURRENT]),   // drawCurrentConditions icon/temperatures, sunrise row
+  toRect(Layout::regions[REGION_LOCATION]),  // drawLocationDate
+  toRect(Layout::regions[REGION_FORECAST]),  // drawForecast
+  toRect(Layout::regions[REGION_DETAILS]),   // drawCurrentConditions detail rows
+  toRect(Layout::regions[REGION_GRAPH]),     // drawOutlookGraph including axis labels
+  toRect(Layout::regions[REGION_STATUS])     // drawStatusBar
+};
 
-// Helper drawing functions - wrappers around EPD driver functions
+// Helper drawing functions - wrappers around EPD driver functions; fills and straight
+// lines go through the span routines in fb_kernel.h (same pixels, fewer stores)
 void fillCircle(int x, int y, int r, uint8_t color) {
+#if FB_KERNEL
+  fbFillCircle(framebuffer, x, y, r, color);
+#else
   epd_fill_circle(x, y, r, color, framebuffer);
+#endif
 }
 
 void drawFastHLine(int16_t x0, int16_t y0, int length, uint16_t color) {
+#if FB_KERNEL
+  fbHLine(framebuffer, x0, y0, length, color);
+#else
   epd_draw_hline(x0, y0, length, color, framebuffer);
+#endif
 }
 
 void drawFastVLine(int16_t x0, int16_t y0, int length, uint16_t color) {
+#if FB_KERNEL
+  fbVLine(framebuffer, x0, y0, length, color);
+#else
   epd_draw_vline(x0, y0, length, color, framebuffer);
+#endif
 }
 
 void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
@@ -61,16 +100,28 @@ void drawCircle(int x0, int y0, int r, uint8_t color) {
 }
 
 void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+#if FB_KERNEL
+  fbDrawRect(framebuffer, x, y, w, h, color);
+#else
   epd_draw_rect(x, y, w, h, color, framebuffer);
+#endif
 }
 
 void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+#if FB_KERNEL
+  fbFillRect(framebuffer, x, y, w, h, color);
+#else
   epd_fill_rect(x, y, w, h, color, framebuffer);
+#endif
 }
 
 void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
                   int16_t x2, int16_t y2, uint16_t color) {
+#if FB_KERNEL
+  fbFillTriangle(framebuffer, x0, y0, x1, y1, x2, y2, color);
+#else
   epd_fill_triangle(x0, y0, x1, y1, x2, y2, color, framebuffer);
+#endif
 }
 
 void drawPixel(int x, int y, uint8_t color) {
@@ -78,12 +129,7 @@ void drawPixel(int x, int y, uint8_t color) {
 }
 
 void DrawAngledLine(int x, int y, int x1, int y1, int size, int color) {
-  float dist = sqrt((float)((x - x1) * (x - x1) + (y - y1) * (y - y1)));
-  if (dist == 0) return;
-  int dx = (size / 2.0) * (x - x1) / dist;
-  int dy = (size / 2.0) * (y - y1) / dist;
-  fillTriangle(x + dx, y - dy, x - dx,  y + dy,  x1 + dx, y1 - dy, color);
-  fillTriangle(x - dx, y + dy, x1 - dx, y1 + dy, x1 + dx, y1 - dy, color);
+  fbThickLineAA(framebuffer, FB_Q16(x), FB_Q16(y), FB_Q16(x1), FB_Q16(y1), FB_Q16(size), color);
 }
 
 // Icon building blocks (from source repo)
@@ -166,54 +212,65 @@ void addmoon(int x, int y, bool IconSize) {
   fillCircle(x - 16 + xOffset, y - 37 + yOffset, uint16_t(Small * 1.6), White);
 }
 
+// True for night variants of an OpenWeatherMap icon code (e.g. "01n")
+static bool isNightIcon(const char *IconName) {
+  size_t len = strlen(IconName);
+  return len > 0 && IconName[len - 1] == 'n';
+}
+
+// True if IconName is the day or night variant of the two-digit condition code
+static bool iconIs(const char *IconName, const char *code) {
+  return strncmp(IconName, code, 2) == 0 && (IconName[2] == 'd' || IconName[2] == 'n') && IconName[3] == '\0';
+}
+
 // Main icon functions (from source repo)
-void ClearSky(int x, int y, bool IconSize, String IconName) {
+void ClearSky(int x, int y, bool IconSize, const char *IconName) {
   int scale = Small;
-  if (IconName.endsWith("n")) addmoon(x, y, IconSize);
+  if (isNightIcon(IconName)) addmoon(x, y, IconSize);
   if (IconSize == LargeIcon) scale = Large;
   y += (IconSize ? 0 : 10);
   addsun(x, y, scale * (IconSize ? 1.7 : 1.2), IconSize);
 }
 
-void BrokenClouds(int x, int y, bool IconSize, String IconName) {
+void BrokenClouds(int x, int y, bool IconSize, const char *IconName) {
   int scale = Small, linesize = 5;
-  if (IconName.endsWith("n")) addmoon(x, y, IconSize);
+  if (isNightIcon(IconName)) addmoon(x, y, IconSize);
   y += 15;
   if (IconSize == LargeIcon) scale = Large;
   addsun(x - scale * 1.8, y - scale * 1.8, scale, IconSize);
   addcloud(x, y, scale * (IconSize ? 1 : 0.75), linesize);
 }
 
-void FewClouds(int x, int y, bool IconSize, String IconName) {
+void FewClouds(int x, int y, bool IconSize, const char *IconName) {
   int scale = Small, linesize = 5;
-  if (IconName.endsWith("n")) addmoon(x, y, IconSize);
+  if (isNightIcon(IconName)) addmoon(x, y, IconSize);
   y += 15;
   if (IconSize == LargeIcon) scale = Large;
   addcloud(x + (IconSize ? 10 : 0), y, scale * (IconSize ? 0.9 : 0.8), linesize);
   addsun((x + (IconSize ? 10 : 0)) - scale * 1.8, y - scale * 1.6, scale, IconSize);
 }
 
-void ScatteredClouds(int x, int y, bool IconSize, String IconName) {
+void ScatteredClouds(int x, int y, bool IconSize, const char *IconName) {
   int scale = Small, linesize = 5;
-  if (IconName.endsWith("n")) addmoon(x, y, IconSize);
+  if (isNightIcon(IconName)) addmoon(x, y, IconSize);
   y += 15;
   if (IconSize == LargeIcon) scale = Large;
   addcloud(x - (IconSize ? 35 : 0), y * (IconSize ? 0.75 : 0.93), scale / 2, linesize);
   addcloud(x, y, scale * 0.9, linesize);
 }
 
-void Rain(int x, int y, bool IconSize, String IconName) {
+void Rain(int x, int y, bool IconSize, const char *IconName) {
   int scale = Small, linesize = 5;
-  if (IconName.endsWith("n")) addmoon(x, y, IconSize);
+  if (isNightIcon(IconName)) addmoon(x, y, IconSize);
   y += 15;
   if (IconSize == LargeIcon) scale = Large;
   addcloud(x, y, scale * (IconSize ? 1 : 0.75), linesize);
   addrain(x, y, scale, IconSize);
 }
 
-void ChanceRain(int x, int y, bool IconSize, String IconName) {
+void ChanceRain(int x, int y, bool IconSize, const char *IconName) {
   int scale = Small, linesize = 5;
-  if (IconName.endsWith("n")) addmoon(x, y, IconSize);
+  if (isNightIcon(IconName)) addmoon(x, y, IconSize);
   if (IconSize == LargeIcon) scale = Large;
   y += 15;
   addsun(x - scale * 1.8, y - scale * 1.8, scale, IconSize);
@@ -221,113 +278,176 @@ void ChanceRain(int x, int y, bool IconSize, String IconName) {
   addrain(x, y, scale, IconSize);
 }
 
-void Thunderstorms(int x, int y, bool IconSize, String IconName) {
+void Thunderstorms(int x, int y, bool IconSize, const char *IconName) {
   int scale = Small, linesize = 5;
-  if (IconName.endsWith("n")) addmoon(x, y, IconSize);
+  if (isNightIcon(IconName)) addmoon(x, y, IconSize);
   if (IconSize == LargeIcon) scale = Large;
   y += 5;
   addcloud(x, y, scale * (IconSize ? 1 : 0.75), linesize);
   addtstorm(x, y, scale);
 }
 
-void Snow(int x, int y, bool IconSize, String IconName) {
+void Snow(int x, int y, bool IconSize, const char *IconName) {
   int scale = Small, linesize = 5;
-  if (IconName.endsWith("n")) addmoon(x, y, IconSize);
+  if (isNightIcon(IconName)) addmoon(x, y, IconSize);
   if (IconSize == LargeIcon) scale = Large;
   addcloud(x, y, scale * (IconSize ? 1 : 0.75), linesize);
   addsnow(x, y, scale, IconSize);
 }
 
-void Mist(int x, int y, bool IconSize, String IconName) {
+void Mist(int x, int y, bool IconSize, const char *IconName) {
   int scale = Small, linesize = 5;
-  if (IconName.endsWith("n")) addmoon(x, y, IconSize);
+  if (isNightIcon(IconName)) addmoon(x, y, IconSize);
   if (IconSize == LargeIcon) scale = Large;
   addsun(x, y, scale * (IconSize ? 1 : 0.75), linesize);
   addfog(x, y, scale, linesize, IconSize);
 }
 
-void Nodata(int x, int y, bool IconSize, String IconName) {
+void Nodata(int x, int y, bool IconSize, const char *IconName) {
   if (IconSize == LargeIcon) setFont(OpenSans24B); else setFont(OpenSans12B);
   drawString(x - 3, y - 10, "?", CENTER, Black);
 }
 
-// Icon selection and display function (from source repo)
-void DisplayConditionsSection(int x, int y, String IconName, bool IconSize) {
-#if DEBUG_LEVEL
-  if (Serial) {
-    Serial.println("Icon name: " + IconName);
+// Icon selection using the drawing primitives above (from source repo)
+static void drawConditionsPrimitives(int x, int y, const char *IconName, bool IconSize) {
+  if      (iconIs(IconName, "01")) ClearSky(x, y, IconSize, IconName);
+  else if (iconIs(IconName, "02")) FewClouds(x, y, IconSize, IconName);
+  else if (iconIs(IconName, "03")) ScatteredClouds(x, y, IconSize, IconName);
+  else if (iconIs(IconName, "04")) BrokenClouds(x, y, IconSize, IconName);
+  else if (iconIs(IconName, "09")) ChanceRain(x, y, IconSize, IconName);
+  else if (iconIs(IconName, "10")) Rain(x, y, IconSize, IconName);
+  else if (iconIs(IconName, "11")) Thunderstorms(x, y, IconSize, IconName);
+  else if (iconIs(IconName, "13")) Snow(x, y, IconSize, IconName);
+  else if (iconIs(IconName, "50")) Mist(x, y, IconSize, IconName);
+  else                             Nodata(x, y, IconSize, IconName);
+}
+
+#if ICON_SPRITES || ICON_BENCHMARK
+/**
+ * Find the pre-rasterized sprite for an icon code and size.
+ * Sprites are only valid for the layout row they were generated at (see tools/generate_icon_sprites.py).
+ */
+static const IconSprite *findIconSprite(const char *IconName, bool IconSize, int y) {
+  for (int i = 0; i < icon_sprite_count; i++) {
+    const IconSprite *sprite = &icon_sprites[i];
+    if (sprite->large == IconSize && sprite->anchor_y == y && strcmp(sprite->code, IconName) == 0) {
+      return sprite;
+    }
   }
-#endif
-  if      (IconName == "01d" || IconName == "01n") ClearSky(x, y, IconSize, IconName);
-  else if (IconName == "02d" || IconName == "02n") FewClouds(x, y, IconSize, IconName);
-  else if (IconName == "03d" || IconName == "03n") ScatteredClouds(x, y, IconSize, IconName);
-  else if (IconName == "04d" || IconName == "04n") BrokenClouds(x, y, IconSize, IconName);
-  else if (IconName == "09d" || IconName == "09n") ChanceRain(x, y, IconSize, IconName);
-  else if (IconName == "10d" || IconName == "10n") Rain(x, y, IconSize, IconName);
-  else if (IconName == "11d" || IconName == "11n") Thunderstorms(x, y, IconSize, IconName);
-  else if (IconName == "13d" || IconName == "13n") Snow(x, y, IconSize, IconName);
-  else if (IconName == "50d" || IconName == "50n") Mist(x, y, IconSize, IconName);
-  else                                             Nodata(x, y, IconSize, IconName);
+  return NULL;
 }
 
-// Helper function to convert Unix time to formatted string (time only, for sunrise/sunset)
-// Uses the timezone offset from the API to convert UTC to local time
-static String ConvertUnixTime(int unix_time, int timezone_offset) {
-  // Convert UTC timestamp to struct tm in UTC
-  time_t utc_time = (time_t)unix_time;
-  struct tm *utc_tm = gmtime(&utc_time);
-  
-  // Calculate local time by adding timezone offset (in seconds)
-  // timezone_offset: positive = east of UTC (ahead), negative = west of UTC (behind)
-  int local_seconds = utc_tm->tm_sec;
-  int local_minutes = utc_tm->tm_min;
-  int local_hours = utc_tm->tm_hour;
-  
-  // Add timezone offset (convert to hours, minutes, seconds)
-  int offset_seconds = timezone_offset % 60;
-  int offset_minutes = (timezone_offset / 60) % 60;
-  int offset_hours = timezone_offset / 3600;
-  
-  local_seconds += offset_seconds;
-  if (local_seconds >= 60) {
-    local_seconds -= 60;
-    local_minutes += 1;
-  } else if (local_seconds < 0) {
-    local_seconds += 60;
-    local_minutes -= 1;
+/**
+ * Blit a sprite into the framebuffer, keeping the darker of the two pixels (white is transparent).
+ * With FB_KERNEL the rows are combined a word at a time (fbBlitDarken()); otherwise whole
+ * bytes are combined when the sprite lands on an even column, and pixel by pixel elsewhere.
+ */
+static void blitIconSprite(const IconSprite *sprite, int x, int y) {
+  const int left = x + sprite->dx;
+  const int top = y + sprite->dy;
+#if FB_KERNEL
+  fbBlitDarken(framebuffer, left, top, sprite->data, sprite->width, sprite->height);
+#else
+  const int rowBytes = sprite->width / 2;
+  const bool aligned = (left & 1) == 0 && left >= 0 && left + sprite->width <= EPD_WIDTH;
+  
+  for (int row = 0; row < sprite->height; row++) {
+    int yy = top + row;
+    if (yy < 0 || yy >= EPD_HEIGHT) continue;
+    const uint8_t *src = sprite->data + row * rowBytes;
+    
+    if (aligned) {
+      uint8_t *dst = framebuffer + (yy * EPD_WIDTH + left) / 2;
+      for (int i = 0; i < rowBytes; i++) {
+        uint8_t s = src[i];
+        if (s == 0xFF) continue;
+        uint8_t d = dst[i];
+        uint8_t lo = ((s & 0x0F) < (d & 0x0F)) ? (s & 0x0F) : (d & 0x0F);
+        uint8_t hi = ((s & 0xF0) < (d & 0xF0)) ? (s & 0xF0) : (d & 0xF0);
+        dst[i] = hi | lo;
+      }
+    } else {
+      for (int px = 0; px < sprite->width; px++) {
+        int xx = left + px;
+        if (xx < 0 || xx >= EPD_WIDTH) continue;
+        uint8_t s = (px & 1) ? (src[px / 2] >> 4) : (src[px / 2] & 0x0F);
+        if (s == 0x0F) continue;
+        uint8_t *dst = &framebuffer[(yy * EPD_WIDTH + xx) / 2];
+        if (xx & 1) {
+          if (s < (*dst >> 4)) *dst = (*dst & 0x0F) | (s << 4);
+        } else {
+          if (s < (*dst & 0x0F)) *dst = (*dst & 0xF0) | s;
+        }
+      }
+    }
   }
-  
-  local_minutes += offset_minutes;
-  if (local_minutes >= 60) {
-    local_minutes -= 60;
-    local_hours += 1;
-  } else if (local_minutes < 0) {
-    local_minutes += 60;
-    local_hours -= 1;
+#endif
+}
+#endif
+
+// Icon selection and display function
+void DisplayConditionsSection(int x, int y, const char *IconName, bool IconSize) {
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.println("Icon name: " + String(IconName));
   }
-  
-  local_hours += offset_hours;
-  // Handle day rollover (hours can be 0-23, but offset might push outside)
-  while (local_hours >= 24) {
-    local_hours -= 24;
+#endif
+#if ICON_SPRITES
+  const IconSprite *sprite = findIconSprite(IconName, IconSize, y);
+  if (sprite) {
+    blitIconSprite(sprite, x, y);
+    return;
   }
-  while (local_hours < 0) {
-    local_hours += 24;
+#endif
+  drawConditionsPrimitives(x, y, IconName, IconSize);
+}
+
+#if ICON_BENCHMARK
+/**
+ * Micro-benchmark: draw every sprite's icon with the primitives and with the blit,
+ * at an even and an odd column, and report the time of each and any differing bytes.
+ * Leaves the framebuffer white.
+ */
+void benchmarkIconRendering() {
+  const size_t fb_size = EPD_WIDTH * EPD_HEIGHT / 2;
+  uint8_t *reference = (uint8_t *)ps_malloc(fb_size);
+  if (!reference) return;
+  
+  unsigned long totalPrimitive = 0, totalBlit = 0;
+  int totalMismatches = 0;
+  Serial.println("\n=== Icon benchmark (us) ===");
+  for (int i = 0; i < icon_sprite_count; i++) {
+    const IconSprite *sprite = &icon_sprites[i];
+    for (int x = DISP_WIDTH / 2; x <= DISP_WIDTH / 2 + 1; x++) {
+      memset(framebuffer, 0xFF, fb_size);
+      unsigned long start = micros();
+      drawConditionsPrimitives(x, sprite->anchor_y, sprite->code, sprite->large);
+      unsigned long primitiveUs = micros() - start;
+      memcpy(reference, framebuffer, fb_size);
+      
+      memset(framebuffer, 0xFF, fb_size);
+      start = micros();
+      blitIconSprite(sprite, x, sprite->anchor_y);
+      unsigned long blitUs = micros() - start;
+      
+      int mismatches = 0;
+      for (size_t b = 0; b < fb_size; b++) {
+        if (framebuffer[b] != reference[b]) mismatches++;
+      }
+      Serial.printf("%s %s x%%2=%d: primitives %lu, blit %lu, mismatched bytes %d\n",
+                    sprite->code, sprite->large ? "large" : "small", x & 1, primitiveUs, blitUs, mismatches);
+      totalPrimitive += primitiveUs;
+      totalBlit += blitUs;
+      totalMismatches += mismatches;
+    }
   }
+  Serial.printf("Total: primitives %lu us, blit %lu us, mismatched bytes %d\n", totalPrimitive, totalBlit, totalMismatches);
+  Serial.println("=== End icon benchmark ===\n");
   
-  char output[40];
-  if (String(settings.Units) == "M") {
-    // Format as "6:44" (no leading zero on hour)
-    snprintf(output, sizeof(output), "%d:%02d", local_hours, local_minutes);
-  } else {
-    // Format as "6:44AM" (no leading zero on hour)
-    int hour12 = local_hours % 12;
-    if (hour12 == 0) hour12 = 12;
-    char ampm = (local_hours < 12) ? 'A' : 'P';
-    snprintf(output, sizeof(output), "%d:%02d%cM", hour12, local_minutes, ampm);
-  }
-  return output;
+  memset(framebuffer, 0xFF, fb_size);
+  free(reference);
 }
+#endif
 
 // Helper function to convert wind direction to cardinal
 String WindDegToOrdinalDirection(float winddirection) {
@@ -360,73 +480,102 @@ void powerOffDisplay() {
   // Power off is done in main.ino
 }
 
+// Find the font subset supplement for settings.Language, if the font has any
+static const GFXfont *fontSupplement(GFXfont const &font) {
+#if FONT_SUBSET
+  const GFXfont *other = NULL;
+  for (int i = 0; i < font_supplement_count; i++) {
+    const FontSupplement *entry = &font_supplements[i];
+    if (entry->base->bitmap != font.bitmap) continue;
+    if (strcmp(entry->language, settings.Language) == 0) return entry->supplement;
+    if (entry->language[0] == '\0') other = entry->supplement;
+  }
+  return other;
+#else
+  return NULL;
+#endif
+}
+
 // Set font
 void setFont(GFXfont const &font) {
   currentFont = font;
+  currentFallback = fontSupplement(font);
+}
+
+// Measure string in the current font
+TextMetrics measureString(const char *text) {
+  return measureText(currentFont, text, currentFallback);
 }
 
 // Get string width
 uint16_t getStringWidth(const String &text) {
-  char *data = const_cast<char*>(text.c_str());
-  int32_t x1, y1, w, h;
-  int32_t x = 0, y = 0;
-  get_text_bounds(&currentFont, data, &x, &y, &x1, &y1, &w, &h, NULL);
-  return w;
+  return measureString(text.c_str()).width;
 }
 
 // Get string height
 uint16_t getStringHeight(const String &text) {
-  char *data = const_cast<char*>(text.c_str());
-  int32_t x1, y1, w, h;
-  int32_t x = 0, y = 0;
-  get_text_bounds(&currentFont, data, &x, &y, &x1, &y1, &w, &h, NULL);
-  return h;
+  return measureString(text.c_str()).height;
 }
 
-// Draw string with alignment
-void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment, uint8_t color) {
-  char *data = const_cast<char*>(text.c_str());
-  int32_t x1, y1, w, h;
-  int32_t xx = x, yy = y;
-  get_text_bounds(&currentFont, data, &xx, &yy, &x1, &y1, &w, &h, NULL);
-  if (alignment == RIGHT)  x = x - w;
-  if (alignment == CENTER) x = x - w / 2;
-  int32_t cursor_y = y + h;
+// Draw already-measured string with alignment (top of the text at y), on a background
+// of the given color (white unless the area was filled first)
+void drawMeasuredString(int16_t x, int16_t y, const char *text, const TextMetrics &metrics,
+                        alignment_t alignment, uint8_t color, uint8_t background) {
   int32_t cursor_x = x;
-  write_string(&currentFont, data, &cursor_x, &cursor_y, framebuffer);
+  if (alignment == RIGHT)  cursor_x = x - metrics.width;
+  if (alignment == CENTER) cursor_x = x - metrics.width / 2;
+  renderText(currentFont, text, cursor_x, y + metrics.height, color, currentFallback, background);
+}
+
+// Draw string with alignment
+void drawString(int16_t x, int16_t y, const char *text, alignment_t alignment, uint8_t color,
+                uint8_t background) {
+  drawMeasuredString(x, y, text, measureString(text), alignment, color, background);
+}
+
+void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment, uint8_t color,
+                uint8_t background) {
+  drawString(x, y, text.c_str(), alignment, color, background);
 }
 
 // Draw multi-line string (simplified version)
+// Lines are broken at the last space within max_width characters, or hard-broken
+// when a line has no space; the text is scanned once
 void drawMultiLnString(int16_t x, int16_t y, const String &text, alignment_t alignment, 
                        uint16_t max_width, uint16_t max_lines, int16_t line_spacing, uint8_t color) {
+  const char *remaining = text.c_str();
+  size_t remainingLen = text.length();
+  char line[128];
   uint16_t current_line = 0;
-  String textRemaining = text;
   
-  while (current_line < max_lines && !textRemaining.isEmpty()) {
-    int spaceRemaining = 0;
-    int p = 0;
-    int charCount = 0;
+  while (current_line < max_lines && remainingLen > 0) {
+    size_t spaceRemaining = 0;
+    size_t p = 0;
     
-    while (p < textRemaining.length() && charCount < max_width) {
-      if (textRemaining.substring(p, p + 1) == " ") spaceRemaining = p;
+    while (p < remainingLen && p < max_width) {
+      if (remaining[p] == ' ') spaceRemaining = p;
       p++;
-      charCount++;
     }
     
-    String line = textRemaining;
-    if (p < textRemaining.length()) {
+    size_t lineLen = remainingLen;
+    size_t consumed = remainingLen;
+    if (p < remainingLen) {
       if (spaceRemaining > 0) {
-        line = textRemaining.substring(0, spaceRemaining);
-        textRemaining = textRemaining.substring(spaceRemaining + 1);
+        lineLen = spaceRemaining;
+        consumed = spaceRemaining + 1;
       } else {
-        line = textRemaining.substring(0, p);
-        textRemaining = textRemaining.substring(p);
+        lineLen = p;
+        consumed = p;
       }
-    } else {
-      textRemaining = "";
     }
     
+    if (lineLen >= sizeof(line)) lineLen = sizeof(line) - 1;
+    memcpy(line, remaining, lineLen);
+    line[lineLen] = '\0';
     drawString(x, y + (current_line * line_spacing), line, alignment, color);
+    
+    remaining += consumed;
+    remainingLen -= consumed;
     current_line++;
   }
 }
@@ -437,67 +586,68 @@ void drawMultiLnString(int16_t x, int16_t y, const String &text, alignment_t ali
  * and weather details (sunrise, sunset, humidity, pressure, wind) in a left column.
  * 
  * @param current Array containing current weather data (index 0)
- * @param wifi_signal WiFi signal strength (currently unused in this function)
+ * @param view Derived view (buildCurrentView())
  */
-void drawCurrentConditions(Forecast_record_type *current, int wifi_signal) {
-  String dataStr, unitStr;
+void drawCurrentConditions(Forecast_record_type *current, const WeatherView &view) {
+  char dataStr[24];
+  const bool metric = view.metric;
+  const char *unitStr = metric ? "°C" : "°F";
   
   // Large weather icon positioned in upper left
-  DisplayConditionsSection(122, 117, current[0].Icon, LargeIcon);
+  DisplayConditionsSection(Layout::currentIcon.x, Layout::currentIcon.y, current[0].Icon, LargeIcon);
   
   // Current temperature display (large font)
+  // The unit offset has always been measured in the 12pt font, keep it that way
   setFont(OpenSans24B);
-  int tempX = 240; // Position to right of icon
-  int tempY = 50;
+  int tempX = Layout::temperature.x; // Position to right of icon
+  int tempY = Layout::temperature.y;
   
-  dataStr = String((int)round(current[0].Temperature));
-  unitStr = (String(settings.Units) == "M") ? "°C" : "°F";
+  snprintf(dataStr, sizeof(dataStr), "%d", roundTenths(current[0].Temperature));
   drawString(tempX, tempY, dataStr, LEFT, Black);
   setFont(OpenSans12B);
-  drawString(tempX + getStringWidth(dataStr) + 30, tempY - 5, unitStr, LEFT, Black);
+  drawString(tempX + measureString(dataStr).width + 30, tempY - 5, unitStr, LEFT, Black);
   
   // Feels-like temperature (label + value)
-  setFont(OpenSans12B);
   drawString(tempX, tempY + 40, TXT_FEELSLIKE, LEFT, Black);
   setFont(OpenSans24B);
-  String feelsLikeNum = String((int)round(current[0].FeelsLike));
-  drawString(tempX, tempY + 70, feelsLikeNum, LEFT, Black);
+  snprintf(dataStr, sizeof(dataStr), "%d", roundTenths(current[0].FeelsLike));
+  drawString(tempX, tempY + 70, dataStr, LEFT, Black);
   setFont(OpenSans12B);
-  String feelsLikeUnit = String(settings.Units) == "M" ? "°C" : "°F";
-  drawString(tempX + getStringWidth(feelsLikeNum) + 30, tempY + 65, feelsLikeUnit, LEFT, Black);
+  drawString(tempX + measureString(dataStr).width + 30, tempY + 65, unitStr, LEFT, Black);
   
   // Weather details column (left side of screen)
-  int detailsX = 5;
-  int gridY = 180;
-  int rowHeight = 65;
+  int detailsX = Layout::details.x;
+  int gridY = Layout::details.y;
+  int rowHeight = Layout::detailsRowStep;
   
   // Display weather details in vertical list
   setFont(OpenSans12B);
   drawString(detailsX, gridY + 12, TXT_SUNRISE, LEFT, Black);
   setFont(OpenSans18B);
-  drawString(detailsX, gridY + 38, ConvertUnixTime(current[0].Sunrise, current[0].FTimezone), LEFT, Black);
+  drawString(detailsX, gridY + 38, view.sunrise, LEFT, Black);
   
   gridY += rowHeight;
   setFont(OpenSans12B);
   drawString(detailsX, gridY + 12, TXT_SUNSET, LEFT, Black);
   setFont(OpenSans18B);
-  drawString(detailsX, gridY + 38, ConvertUnixTime(current[0].Sunset, current[0].FTimezone), LEFT, Black);
+  drawString(detailsX, gridY + 38, view.sunset, LEFT, Black);
   
   gridY += rowHeight;
   setFont(OpenSans12B);
   drawString(detailsX, gridY + 12, TXT_HUMIDITY, LEFT, Black);
   setFont(OpenSans18B);
-  drawString(detailsX, gridY + 41, String((int)round(current[0].Humidity)) + "%", LEFT, Black);
+  snprintf(dataStr, sizeof(dataStr), "%u%%", (unsigned)current[0].Humidity);
+  drawString(detailsX, gridY + 41, dataStr, LEFT, Black);
   
   gridY += rowHeight;
   setFont(OpenSans12B);
   drawString(detailsX, gridY + 12, TXT_PRESSURE, LEFT, Black);
   setFont(OpenSans18B);
-  if (String(settings.Units) == "M") {
-    dataStr = String((int)round(current[0].Pressure)) + " hPa";
+  if (metric) {
+    snprintf(dataStr, sizeof(dataStr), "%d hPa", current[0].Pressure);
   } else {
     float pressureInHg = current[0].Pressure * 0.02953; // Convert hPa to inches Hg
-    dataStr = String(pressureInHg, 1) + " in";
+    snprintf(dataStr, sizeof(dataStr), "%.1f in", pressureInHg);
   }
   drawString(detailsX, gridY + 38, dataStr, LEFT, Black);
   
@@ -505,183 +655,30 @@ void drawCurrentConditions(Forecast_record_type *current, int wifi_signal) {
   setFont(OpenSans12B);
   drawString(detailsX, gridY + 12, TXT_WIND, LEFT, Black);
   setFont(OpenSans18B);
-  if (String(settings.Units) == "M") {
-    dataStr = String((int)round(current[0].Windspeed)) + " m/s";
-  } else {
-    dataStr = String((int)round(current[0].Windspeed)) + " mph";
-  }
+  snprintf(dataStr, sizeof(dataStr), metric ? "%d m/s" : "%d mph", roundTenths(current[0].Windspeed));
   drawString(detailsX, gridY + 28, dataStr, LEFT, Black);
 }
 
 /**
- * Determine appropriate weather icon based on daily conditions.
- * Priority: snow > thunderstorm > rain > cloud cover.
+ * Draw 5-day forecast display: one entry per day with its weather icon and high/low.
  * 
- * @param avgCloudCover Average cloud cover percentage (0-100)
- * @param maxPop Maximum probability of precipitation (0.0-1.0)
- * @param totalRainfall Total rainfall for the day (mm or inches)
- * @param totalSnowfall Total snowfall for the day (mm or inches)
- * @param isDay true for day icons, false for night icons
- * @return OpenWeatherMap icon code (e.g., "01d", "10n")
+ * @param view Derived view (buildForecastView())
  */
-String getIconFromCloudCover(int avgCloudCover, float maxPop, float totalRainfall, float totalSnowfall, bool isDay) {
-  char dayNight = isDay ? 'd' : 'n';
+void drawForecast(const WeatherView &view) {
+  // Layout: 5 forecast boxes in top right area, one column per day
+  const int forecastY = Layout::forecastY;
   
-  // Priority 1: Snow (icon 13)
-  if (totalSnowfall > 0.5) {
-    return String("13") + dayNight;
-  }
-  
-  // Priority 2: Thunderstorm (icon 11) - high probability or heavy rain
-  if (maxPop > 0.5 || totalRainfall > 2.0) {
-    return String("11") + dayNight;
-  }
-  
-  // Priority 3: Rain (icon 10) - moderate probability or light rain
-  if (maxPop > 0.3 || totalRainfall > 0.5) {
-    return String("10") + dayNight;
-  }
-  
-  // Priority 4: Cloud cover determines icon
-  if (avgCloudCover <= 10) {
-    return String("01") + dayNight; // Clear sky
-  } else if (avgCloudCover <= 25) {
-    return String("02") + dayNight; // Few clouds
-  } else if (avgCloudCover <= 50) {
-    return String("03") + dayNight; // Scattered clouds
-  } else if (avgCloudCover <= 75) {
-    return String("04") + dayNight; // Broken clouds
-  } else {
-    return String("04") + dayNight; // Overcast (uses broken clouds icon)
-  }
-}
-
-/**
- * Draw 5-day forecast display.
- * Groups forecast periods by day, calculates daily statistics (high/low temp, avg cloud cover),
- * and displays one entry per day with appropriate weather icon.
- * 
- * @param forecast Array of daily forecast records
- * @param num_forecasts Number of forecast entries available
- * @param timeInfo Current time structure for day-of-week labels
- */
-void drawForecast(Forecast_record_type *forecast, int num_forecasts, tm *timeInfo) {
-  // Layout: 5 forecast boxes in top right area
-  int forecastY = 200;
-  int forecastWidth = 115; // Width per day (960px / 5 days with padding)
-  int forecastXStart = 385;
-  
-  // Structure to hold aggregated daily statistics
-  struct DailyForecast {
-    float highTemp;        // Maximum temperature for the day
-    float lowTemp;         // Minimum temperature for the day
-    int totalCloudCover;   // Sum of cloud cover values (for averaging)
-    int cloudCoverCount;   // Number of periods used for average
-    float maxPop;          // Maximum probability of precipitation
-    float totalRainfall;   // Total rainfall accumulation
-    float totalSnowfall;   // Total snowfall accumulation
-    int firstPeriodIndex; // Index of first forecast period for this day
-    time_t dayTime;        // Timestamp for day-of-week calculation
-  };
-  
-  DailyForecast dailyForecasts[5];
-  int dayCount = 0;
-  int lastDayOfYear = -1; // Track day of year to handle month boundaries correctly
-  
-  // Group forecast periods by day and aggregate statistics
-  for (int i = 0; i < num_forecasts; i++) {
-    time_t forecastTime = forecast[i].Dt;
-    struct tm *forecastTm = localtime(&forecastTime);
-    int forecastDayOfYear = forecastTm->tm_yday; // Day of year (0-365) handles month boundaries
-    
-    if (forecastDayOfYear != lastDayOfYear) {
-      // New day detected
-      if (dayCount < 5) {
-        // Finalize previous day's cloud cover average before starting new day
-        if (dayCount > 0 && dailyForecasts[dayCount - 1].cloudCoverCount > 0) {
-          dailyForecasts[dayCount - 1].totalCloudCover /= dailyForecasts[dayCount - 1].cloudCoverCount;
-        }
-        
-        // Initialize new day with first period's data
-        dailyForecasts[dayCount].highTemp = forecast[i].High;
-        dailyForecasts[dayCount].lowTemp = forecast[i].Low;
-        dailyForecasts[dayCount].totalCloudCover = forecast[i].Cloudcover;
-        dailyForecasts[dayCount].cloudCoverCount = 1;
-        dailyForecasts[dayCount].maxPop = forecast[i].Pop;
-        dailyForecasts[dayCount].totalRainfall = forecast[i].Rainfall;
-        dailyForecasts[dayCount].totalSnowfall = forecast[i].Snowfall;
-        dailyForecasts[dayCount].firstPeriodIndex = i;
-        dailyForecasts[dayCount].dayTime = forecastTime;
-        dayCount++;
-        lastDayOfYear = forecastDayOfYear;
-      } else {
-        // Have 5 days, stop processing
-        break;
-      }
-    } else {
-      // Same day - aggregate statistics
-      if (dayCount > 0) {
-        int dayIdx = dayCount - 1;
-        // Track daily min/max temperatures
-        if (forecast[i].High > dailyForecasts[dayIdx].highTemp) {
-          dailyForecasts[dayIdx].highTemp = forecast[i].High;
-        }
-        if (forecast[i].Low < dailyForecasts[dayIdx].lowTemp) {
-          dailyForecasts[dayIdx].lowTemp = forecast[i].Low;
-        }
-        // Accumulate cloud cover for averaging
-        dailyForecasts[dayIdx].totalCloudCover += forecast[i].Cloudcover;
-        dailyForecasts[dayIdx].cloudCoverCount++;
-        // Track maximum precipitation probability
-        if (forecast[i].Pop > dailyForecasts[dayIdx].maxPop) {
-          dailyForecasts[dayIdx].maxPop = forecast[i].Pop;
-        }
-        // Accumulate precipitation totals
-        dailyForecasts[dayIdx].totalRainfall += forecast[i].Rainfall;
-        dailyForecasts[dayIdx].totalSnowfall += forecast[i].Snowfall;
-      }
-    }
-  }
-  
-  // Finalize last day's cloud cover average
-  if (dayCount > 0 && dailyForecasts[dayCount - 1].cloudCoverCount > 0) {
-    dailyForecasts[dayCount - 1].totalCloudCover /= dailyForecasts[dayCount - 1].cloudCoverCount;
-  }
-  
-  // Display each day
-  for (int day = 0; day < dayCount; day++) {
-    int x = forecastXStart + (day * forecastWidth);
-    
-    // Get day of week from the day's timestamp
-    struct tm *dayTm = localtime(&dailyForecasts[day].dayTime);
+  for (int day = 0; day < view.dayCount; day++) {
+    int x = Layout::forecastCenterX[day];
     setFont(OpenSans12B);
-    char dayBuffer[8] = {};
-    strftime(dayBuffer, sizeof(dayBuffer), "%a", dayTm);
-    drawString(x + forecastWidth / 2, forecastY - 110, dayBuffer, CENTER, Black);
-    
-    // Determine day/night icon based on first period's hour (6 AM - 6 PM = day)
-    struct tm *firstPeriodTm = localtime(&dailyForecasts[day].dayTime);
-    int hour = firstPeriodTm->tm_hour;
-    bool isDay = (hour >= 6 && hour < 18);
-    
-    // Get icon based on average cloud cover and precipitation
-    String dayIcon = getIconFromCloudCover(
-      dailyForecasts[day].totalCloudCover,
-      dailyForecasts[day].maxPop,
-      dailyForecasts[day].totalRainfall,
-      dailyForecasts[day].totalSnowfall,
-      isDay
-    );
+    drawString(x, forecastY - 110, view.days[day].name, CENTER, Black);
     
     // Weather icon - small size
-    DisplayConditionsSection(x + forecastWidth / 2, forecastY - 40, dayIcon, SmallIcon);
+    DisplayConditionsSection(x, forecastY - 40, view.days[day].icon, SmallIcon);
     
     // High | Low temperatures - daily overall high/low
     setFont(OpenSans10B);
-    String hiStr = String((int)round(dailyForecasts[day].highTemp)) + "°";
-    String loStr = String((int)round(dailyForecasts[day].lowTemp)) + "°";
-    String tempStr = hiStr + "|" + loStr;
-    drawString(x + forecastWidth / 2, forecastY + 15, tempStr, CENTER, Black);
+    drawString(x, forecastY + 15, view.days[day].temps, CENTER, Black);
   }
 }
 
@@ -693,182 +690,60 @@ void drawForecast(Forecast_record_type *forecast, int num_forecasts, tm *timeInf
  */
 void drawLocationDate(const String &city, const String &date) {
   setFont(OpenSans18B);
-  drawString(DISP_WIDTH - 7, 0, city, RIGHT, Black);
+  drawString(Layout::locationRight, Layout::locationY, city, RIGHT, Black);
   setFont(OpenSans12B);
-  drawString(DISP_WIDTH - 7, 42, date, RIGHT, Black);
+  drawString(Layout::locationRight, Layout::dateY, date, RIGHT, Black);
 }
 
 /**
  * Draw 24-hour temperature and precipitation graph with dual Y-axes.
- * Filters forecast data to only include the next 24 hours based on timestamps.
  * Temperature line is drawn on top of precipitation bars.
  * 
- * @param forecast Array of hourly forecast records
- * @param num_forecasts Number of forecast entries available
- * @param timeInfo Current time structure (unused, kept for compatibility)
+ * @param view Derived view (buildGraphView()), series already in screen coordinates
  */
-void drawOutlookGraph(Forecast_record_type *forecast, int num_forecasts, tm *timeInfo) {
-  const int HOURS_TO_SHOW = 24;
-  const int SECONDS_PER_HOUR = 3600;
-  
-  // Filter forecasts to only include next 24 hours
-  time_t now = time(NULL);
-  time_t cutoffTime = now + (HOURS_TO_SHOW * SECONDS_PER_HOUR);
-  
-  int validForecastIndices[24]; // Maximum 24 hours of data
-  int forecastCount = 0;
-  
-  // Include forecasts within 24-hour window (allow 1 hour in past for current period)
-  for (int i = 0; i < num_forecasts && forecastCount < 24; i++) {
-    time_t forecastTime = forecast[i].Dt;
-    if (forecastTime >= (now - SECONDS_PER_HOUR) && forecastTime <= cutoffTime) {
-      validForecastIndices[forecastCount] = i;
-      forecastCount++;
-    }
-  }
-  
-  // Fallback if no valid forecasts found
-  if (forecastCount == 0 && num_forecasts > 0) {
-    validForecastIndices[0] = 0;
-    forecastCount = 1;
-  }
-  
-  // Graph dimensions and position
-  int graphX = 240;
-  int graphY = 255;
-  int graphWidth = 665;
-  int graphHeight = 230;
-  
-  // Calculate temperature range for left Y-axis scaling
-  float tempMin = forecast[validForecastIndices[0]].Temperature;
-  float tempMax = forecast[validForecastIndices[0]].Temperature;
-  for (int i = 0; i < forecastCount; i++) {
-    int idx = validForecastIndices[i];
-    if (forecast[idx].Temperature < tempMin) tempMin = forecast[idx].Temperature;
-    if (forecast[idx].Temperature > tempMax) tempMax = forecast[idx].Temperature;
-  }
-  
-  // Add 10% padding above/below for better visualization
-  float tempRange = tempMax - tempMin;
-  if (tempRange < 1.0) tempRange = 10.0; // Ensure minimum range
-  tempMin -= tempRange * 0.1;
-  tempMax += tempRange * 0.1;
-  
-  // Precipitation scale (right Y-axis): 0% to 100%
-  float rainMin = 0.0;
-  float rainMax = 100.0;
+void drawOutlookGraph(const WeatherView &view) {
+  if (view.pointCount == 0) return;
+  const LayoutRect &graph = Layout::graph;
+  const int graphBottom = Layout::graphBottom;
   
   // Draw graph background border - only top and bottom horizontal lines (vertical axis lines removed)
-  epd_draw_hline(graphX, graphY, graphWidth, Black, framebuffer); // Top border
-  epd_draw_hline(graphX, graphY + graphHeight, graphWidth, Black, framebuffer); // Bottom border
+  drawFastHLine(graph.x, graph.y, graph.width, Black); // Top border
+  drawFastHLine(graph.x, graphBottom, graph.width, Black); // Bottom border
   
-  // Draw left Y-axis (temperature) with labels
+  // Left Y-axis (temperature) labels with horizontal grid lines across the graph in grey,
+  // right Y-axis (precipitation, 0% to 100%) labels
   setFont(OpenSans8B);
-  int leftAxisX = graphX - 5;
-  int numTempTicks = 5;
-  for (int i = 0; i <= numTempTicks; i++) {
-    float tempValue = tempMin + (tempMax - tempMin) * (float)i / numTempTicks;
-    int y = graphY + graphHeight - (i * graphHeight / numTempTicks);
-    // Tick marks removed as requested
-    // Draw label
-    char tempLabel[15];
-    if (String(settings.Units) == "M") {
-      snprintf(tempLabel, sizeof(tempLabel), "%.0f°C", tempValue);
-    } else {
-      snprintf(tempLabel, sizeof(tempLabel), "%.0f°F", tempValue);
-    }
-    drawString(leftAxisX - 10, y, String(tempLabel), RIGHT, Black);
-    // Draw horizontal grid line across entire graph width in grey
-    epd_draw_hline(graphX, y, graphWidth, Grey, framebuffer);
-  }
-  
-  // Draw right Y-axis (rain percentage) with labels
-  int rightAxisX = graphX + graphWidth + 5;
-  int numRainTicks = 5;
-  for (int i = 0; i <= numRainTicks; i++) {
-    int rainValue = (int)(rainMin + (rainMax - rainMin) * (float)i / numRainTicks);
-    int y = graphY + graphHeight - (i * graphHeight / numRainTicks);
-    // Tick marks removed as requested
-    // Draw label
-    char rainLabel[10];
-    snprintf(rainLabel, sizeof(rainLabel), "%d%%", rainValue);
-    drawString(rightAxisX + 10, y, String(rainLabel), LEFT, Black);
+  int leftAxisX = graph.x - 5;
+  int rightAxisX = graph.x + graph.width + 5;
+  for (int i = 0; i <= GRAPH_AXIS_TICKS; i++) {
+    int y = Layout::graphTickY[i];
+    drawString(leftAxisX - 10, y, view.tempLabels[i], RIGHT, Black);
+    drawFastHLine(graph.x, y, graph.width, Grey);
+    char rainLabel[8];
+    snprintf(rainLabel, sizeof(rainLabel), "%d%%", i * 100 / GRAPH_AXIS_TICKS);
+    drawString(rightAxisX + 10, y, rainLabel, LEFT, Black);
   }
   
-  // Vertical axis lines removed as requested
-  
   // Draw precipitation bars first (so temperature line appears on top)
   uint8_t greyColor = 0xDD; // Light grey for precipitation bars
-  
-  for (int i = 0; i < forecastCount; i++) {
-    int idx = validForecastIndices[i];
-    // Convert probability of precipitation (0.0-1.0) to percentage (0-100%)
-    float rainPercent = forecast[idx].Pop * 100.0;
-    rainPercent = (rainPercent > 100.0) ? 100.0 : ((rainPercent < 0.0) ? 0.0 : rainPercent);
-    
-    // Calculate bar dimensions with zero gap between bars
-    // Each bar starts exactly where the previous one ends
-    int barX = graphX + (i * graphWidth / forecastCount);
-    // Calculate width to ensure bars fill entire graph width with no gaps
-    int nextBarX = (i < forecastCount - 1) ? (graphX + ((i + 1) * graphWidth / forecastCount)) : (graphX + graphWidth);
-    int currentBarWidth = nextBarX - barX;
-    
-    float rainRatio = rainPercent / 100.0;
-    // For testing set barHeight to 50% of graphHeight
-    int barHeight = (int)(rainRatio * graphHeight);
-    int barY = graphY + graphHeight - barHeight;
-    
-    if (barHeight > 0) {
-      epd_fill_rect(barX, barY, currentBarWidth, barHeight, greyColor, framebuffer);
+  for (int i = 0; i < view.pointCount; i++) {
+    const GraphPointView &point = view.points[i];
+    if (point.barY < graphBottom) {
+      fillRect(point.x, point.barY, point.width, graphBottom - point.barY, greyColor);
     }
   }
   
-  // Draw temperature line (2px thick) on top of bars
-  if (forecastCount > 1) {
-    for (int i = 0; i < forecastCount - 1; i++) {
-      int idx1 = validForecastIndices[i];
-      int idx2 = validForecastIndices[i + 1];
-      
-      // Calculate line endpoints
-      int x1 = graphX + (i * graphWidth / forecastCount);
-      float tempRatio1 = (forecast[idx1].Temperature - tempMin) / (tempMax - tempMin);
-      int y1 = graphY + graphHeight - (int)(tempRatio1 * graphHeight);
-      
-      int x2 = graphX + ((i + 1) * graphWidth / forecastCount);
-      float tempRatio2 = (forecast[idx2].Temperature - tempMin) / (tempMax - tempMin);
-      int y2 = graphY + graphHeight - (int)(tempRatio2 * graphHeight);
-      
-      // Draw 2px thick line (two 1px lines offset by 1px)
-      epd_write_line(x1, y1, x2, y2, Black, framebuffer);
-      epd_write_line(x1 + 1, y1, x2 + 1, y2, Black, framebuffer);
-    }
+  // Temperature curve on top of the bars: smoothed through the hourly points, anti-aliased
+  FbPoint curve[graph_hours_shown];
+  for (int i = 0; i < view.pointCount; i++) {
+    curve[i].x = FB_Q16(view.points[i].x);
+    curve[i].y = view.points[i].tempYFixed;
   }
+  fbCurveAA(framebuffer, curve, view.pointCount, GRAPH_LINE_WIDTH, Black);
   
-  // Draw x-axis time labels (approximately 4-5 labels across 24 hours)
-  setFont(OpenSans8B);
-  int labelInterval = (forecastCount > 0) ? (forecastCount / 4) : 6;
-  if (labelInterval < 1) labelInterval = 1;
-  
-  for (int i = 0; i < forecastCount; i += labelInterval) {
-    int idx = validForecastIndices[i];
-    int x = graphX + (i * graphWidth / forecastCount);
-    char timeBuffer[12] = {};
-    time_t ts = forecast[idx].Dt;  // UTC timestamp from API
-    // Convert UTC to local time by adding timezone offset
-    // globalTimezoneOffset: positive = east of UTC (ahead), negative = west of UTC (behind)
-    time_t local_ts = ts + globalTimezoneOffset;
-    struct tm *t = gmtime(&local_ts);  // Use gmtime since we've already applied offset
-    
-    if (String(settings.Units) == "M") {
-      strftime(timeBuffer, sizeof(timeBuffer), "%H", t); // 24-hour format
-    } else {
-      // 12-hour format without leading zero (e.g., "7AM" not "07AM")
-      int hour12 = t->tm_hour % 12;
-      if (hour12 == 0) hour12 = 12;
-      char ampm = (t->tm_hour < 12) ? 'A' : 'P';
-      snprintf(timeBuffer, sizeof(timeBuffer), "%d%cM", hour12, ampm);
-    }
-    drawString(x, graphY + graphHeight + 15, String(timeBuffer), CENTER, Black);
+  // Draw x-axis time labels
+  for (int i = 0; i < view.timeLabelCount; i++) {
+    drawString(view.timeLabels[i].x, graphBottom + 15, view.timeLabels[i].text, CENTER, Black);
   }
 }
 
@@ -914,7 +789,25 @@ void drawWiFiSignal(int x, int y, int rssi) {
 }
 
 /**
- * Draw battery icon with fill level, percentage, and voltage.
+ * Text right of the battery icon: percentage and voltage, then the predicted runtime
+ * (hours, or days from 2 days up), or "Charging" and the voltage.
+ */
+static String batteryText(uint8_t percentage, float voltage, int runtimeHours) {
+  if (voltage > 4.35) {
+    // Battery voltage above 4.2V indicates charging
+    return "Charging  " + String(voltage, 3) + "v";
+  }
+  String batStr = String(percentage) + "%  " + String(voltage, 3) + "v";
+  if (runtimeHours >= 48) {
+    batStr += "  ~" + String(runtimeHours / 24) + "d";
+  } else if (runtimeHours >= 0) {
+    batStr += "  ~" + String(runtimeHours) + "h";
+  }
+  return batStr;
+}
+
+/**
+ * Draw battery icon with fill level, percentage, voltage and remaining runtime.
  * Icon consists of a rectangle with a small terminal on the right side.
  * Fill level is proportional to battery percentage.
  * 
@@ -922,8 +815,9 @@ void drawWiFiSignal(int x, int y, int rssi) {
  * @param y Bottom position (icon drawn at y-14)
  * @param percentage Battery charge percentage (0-100)
  * @param voltage Battery voltage in volts
+ * @param runtimeHours Predicted hours to empty, -1 if unknown
  */
-void drawBatteryIcon(int x, int y, uint8_t percentage, float voltage) {
+void drawBatteryIcon(int x, int y, uint8_t percentage, float voltage, int runtimeHours) {
   int batWidth = 40;
   int batHeight = 15;
   int terminalWidth = 4;
@@ -947,30 +841,25 @@ void drawBatteryIcon(int x, int y, uint8_t percentage, float voltage) {
     }
   }
   
-  // Draw percentage/charging status and voltage text to the right of icon
+  // Draw percentage/charging status, voltage and runtime text to the right of icon
   setFont(OpenSans8B);
-  String batStr;
-  if (voltage > 4.35) {
-    // Battery voltage above 4.2V indicates charging
-    batStr = "Charging  " + String(voltage, 3) + "v";
-    drawString(x + 75, y - 17, batStr, LEFT, Black);
-  } else {
-    batStr = String(percentage) + "%  " + String(voltage, 3) + "v";
-    drawString(x + 75, y - 13, batStr, LEFT, Black);
-  }
+  drawString(x + 75, (voltage > 4.35) ? y - 17 : y - 13, batteryText(percentage, voltage, runtimeHours), LEFT, Black);
 }
 
 /**
  * Draw status bar at bottom of display.
  * Layout: WiFi signal (left), Refresh time (center), Battery (right).
+ * A status message is drawn as a badge (white on black) right of the WiFi signal.
  * 
- * @param statusStr Status message (currently unused)
+ * @param statusStr Status message, "" for none (e.g. the stale-data badge after a failed fetch)
  * @param refreshTimeStr Time string to display in center
  * @param rssi WiFi signal strength in dBm
  * @param batVoltage Battery voltage in millivolts
+ * @param runtimeHours Predicted battery runtime in hours, -1 if unknown (battery.h)
  */
-void drawStatusBar(const String &statusStr, const String &refreshTimeStr, int rssi, uint32_t batVoltage) {
-  int barY = DISP_HEIGHT - 25; // Vertical position of status bar
+void drawStatusBar(const String &statusStr, const String &refreshTimeStr, int rssi, uint32_t batVoltage,
+                   int runtimeHours) {
+  int barY = Layout::statusBar.y; // Vertical position of status bar
   
   // Draw light grey background for status bar (color 0xEE)
   fillRect(0, barY, DISP_WIDTH, DISP_HEIGHT - barY, 0xEE);
@@ -981,44 +870,55 @@ void drawStatusBar(const String &statusStr, const String &refreshTimeStr, int rs
   // WiFi signal strength icon on left
   drawWiFiSignal(2, barY + 20, rssi);
   
-  // Calculate battery percentage from voltage
-  uint8_t percentage = 100;
-  float voltage = 0.0;
-  if (batVoltage > 0) {
-    voltage = batVoltage / 1000.0; // Convert millivolts to volts
-    
-    if (voltage >= 4.20) {
-      percentage = 100; // Fully charged
-    } else if (voltage <= 3.20) {
-      percentage = 0; // Empty
-    } else {
-      // Polynomial curve fit for Li-ion battery (more accurate than linear)
-      // Formula derived from typical Li-ion discharge curve
-      percentage = 2836.9625 * pow(voltage, 4) - 43987.4889 * pow(voltage, 3) + 
-                    255233.8134 * pow(voltage, 2) - 656689.7123 * voltage + 632041.7303;
-      percentage = (percentage > 100) ? 100 : ((percentage < 0) ? 0 : percentage);
-    }
-  }
+  // Battery percentage from the Li-ion discharge curve
+  uint8_t percentage = (uint8_t)batteryCharge(batVoltage);
+  float voltage = batVoltage / 1000.0; // Convert millivolts to volts
   
   // Refresh time centered at bottom
   setFont(OpenSans8B);
   drawString(DISP_WIDTH / 2, barY + 5, refreshTimeStr, CENTER, Black);
   
+  if (statusStr.length() > 0) {
+    int badgeX = 120; // Clear of the WiFi bars and dB value
+    fillRect(badgeX, barY + 3, getStringWidth(statusStr) + 16, DISP_HEIGHT - barY - 5, Black);
+    drawString(badgeX + 8, barY + 5, statusStr, LEFT, White, Black);
+  }
+  
   // Battery icon and text on right
   // Calculate total width: icon starts at x+25, text ends at x+75+textWidth
   setFont(OpenSans8B);
-  String batStr;
-  if (voltage > 4.35) {
-    batStr = "Charging  " + String(voltage, 3) + "v";
-  } else {
-    batStr = String(percentage) + "%  " + String(voltage, 3) + "v";
-  }
-  uint16_t textWidth = getStringWidth(batStr);
+  uint16_t textWidth = getStringWidth(batteryText(percentage, voltage, runtimeHours));
   int totalWidth = 75 + textWidth; // Distance from icon start (x+25) to text end
   int batteryX = DISP_WIDTH - 2 - totalWidth; // Position from right edge
   int batteryY = barY + 17; // Align with time text (battery draws at y-14, time at barY)
   
-  drawBatteryIcon(batteryX, batteryY, percentage, voltage);
+  drawBatteryIcon(batteryX, batteryY, percentage, voltage, runtimeHours);
+}
+
+/**
+ * Draw the nowcast sparkline over the status bar: the next hour's precipitation as a bar
+ * per minute in a white box, with ticks every quarter hour. Nothing is drawn without a
+ * nowcast, so the status bar looks as it did before rain was near.
+ *
+ * @param view Derived view (buildNowcastView()), bars already in screen coordinates
+ */
+void drawNowcast(const WeatherView &view) {
+  if (view.nowcastCount == 0) return;
+  const LayoutRect &area = Layout::nowcast;
+  const int bottom = area.y + area.height - 1;
+  
+  fillRect(area.x, area.y, area.width, area.height, White);
+  drawRect(area.x, area.y, area.width, area.height, Grey);
+  for (int quarter = 1; quarter < 4; quarter++) {
+    drawFastVLine(Layout::nowcastColumnX[quarter * max_nowcast_readings / 4], area.y, 3, Grey);
+  }
+  
+  for (int i = 0; i < view.nowcastCount; i++) {
+    if (view.nowcastBarY[i] < bottom) {
+      int x = Layout::nowcastColumnX[i];
+      fillRect(x, view.nowcastBarY[i], Layout::nowcastColumnX[i + 1] - x, bottom - view.nowcastBarY[i], DarkGrey);
+    }
+  }
 }
 
 /**
@@ -1037,8 +937,8 @@ void drawLowBatteryScreen() {
   String message = "Low Battery";
   uint16_t textWidth = getStringWidth(message);
   uint16_t textHeight = getStringHeight(message);
-  int x = DISP_WIDTH / 2;
-  int y = DISP_HEIGHT / 2;
+  int x = Layout::center.x;
+  int y = Layout::center.y;
   
   // Draw centered text
   drawString(x, y, message, CENTER, Black);
@@ -1047,13 +947,15 @@ void drawLowBatteryScreen() {
 /**
  * Draw setup mode screen.
  * Displays "Setup Mode" centered on a white background.
+ *
+ * @param updatePin PIN a firmware upload must carry (setupUpdatePin())
  */
-void drawSetupModeScreen() {
+void drawSetupModeScreen(const char *updatePin) {
   // Ensure framebuffer is white
   memset(framebuffer, 0xFF, EPD_WIDTH * EPD_HEIGHT / 2);
   
-  int centerX = DISP_WIDTH / 2;
-  int centerY = DISP_HEIGHT / 2;
+  int centerX = Layout::center.x;
+  int centerY = Layout::center.y;
   
   // Draw "Setup Mode" in OpenSans24B
   setFont(OpenSans24B);
@@ -1065,24 +967,26 @@ void drawSetupModeScreen() {
   String line1 = "Connect to Wifi \"ESP Weather Station\"";
   String line2 = "and go to the site \"192.168.4.1\" to configure.";
   String line3 = "Or press the reset button to cancel.";
+  String line4 = "Firmware update PIN: " + String(updatePin);
   
   uint16_t lineHeight = getStringHeight(line1);
   int lineSpacing = lineHeight + 10; // 10px spacing between lines
   
   // Calculate total height of all text to center vertically
-  int totalHeight = titleHeight + 20 + (lineHeight * 3) + (lineSpacing * 2); // 20px gap between title and lines
+  int totalHeight = titleHeight + 20 + (lineHeight * 4) + (lineSpacing * 3); // 20px gap between title and lines
   int startY = centerY - (totalHeight / 2);
   
   // Draw title
   setFont(OpenSans24B);
   drawString(centerX, startY, title, CENTER, Black);
   
-  // Draw three lines below title
+  // Draw four lines below title
   setFont(OpenSans18B);
   int lineStartY = startY + titleHeight + 20; // 20px gap after title
   drawString(centerX, lineStartY, line1, CENTER, Black);
   drawString(centerX, lineStartY + lineSpacing, line2, CENTER, Black);
   drawString(centerX, lineStartY + (lineSpacing * 2) + 4, line3, CENTER, Black);
+  drawString(centerX, lineStartY + (lineSpacing * 3) + 8, line4, CENTER, Black);
 }
 
 /**
@@ -1101,8 +1005,8 @@ void drawWiFiErrorScreen() {
   String message = "Wifi Connection Failed";
   uint16_t textWidth = getStringWidth(message);
   uint16_t textHeight = getStringHeight(message);
-  int x = DISP_WIDTH / 2;
-  int y = DISP_HEIGHT / 2;
+  int x = Layout::center.x;
+  int y = Layout::center.y;
   
   // Draw centered text
   drawString(x, y, message, CENTER, Black);
@@ -1116,8 +1020,8 @@ void drawInvalidLocationScreen() {
   // Ensure framebuffer is white
   memset(framebuffer, 0xFF, EPD_WIDTH * EPD_HEIGHT / 2);
   
-  int centerX = DISP_WIDTH / 2;
-  int startY = DISP_HEIGHT / 4; // Start at 1/4 from top
+  int centerX = Layout::center.x;
+  int startY = Layout::messageTop; // Start at 1/4 from top
   
   // Draw title "Invalid Location String" in OpenSans24B
   setFont(OpenSans24B);
@@ -1142,8 +1046,8 @@ void drawInvalidAPIKeyScreen() {
   // Ensure framebuffer is white
   memset(framebuffer, 0xFF, EPD_WIDTH * EPD_HEIGHT / 2);
   
-  int centerX = DISP_WIDTH / 2;
-  int startY = DISP_HEIGHT / 4; // Start at 1/4 from top
+  int centerX = Layout::center.x;
+  int startY = Layout::messageTop; // Start at 1/4 from top
   
   // Draw title "OpenWeatherMap API Key Invalid" in OpenSans24B
   setFont(OpenSans24B);
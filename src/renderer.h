@@ -5,10 +5,29 @@
 #include <time.h>
 #include "forecast_record.h"
 #include "epd_driver.h"
+#include "text_renderer.h"
+#include "weather_view.h"
+#include "layout.h"
 
-// Display dimensions for LilyGo T5 4.7
-#define DISP_WIDTH  960
-#define DISP_HEIGHT 540
+// Icon rendering: 1 = blit pre-rasterized sprites (icon_sprites.h), 0 = draw with primitives
+#ifndef ICON_SPRITES
+#define ICON_SPRITES 1
+#endif
+
+// Fonts: 1 = the character subsets in font_subsets.h (tools/generate_font_subsets.py),
+// 0 = the full OpenSans*.h fonts
+#ifndef FONT_SUBSET
+#define FONT_SUBSET 1
+#endif
+
+// Set to 1 (with DEBUG_LEVEL) to time primitive vs sprite icon drawing at boot
+#ifndef ICON_BENCHMARK
+#define ICON_BENCHMARK 0
+#endif
+
+// Display dimensions (layout.h)
+#define DISP_WIDTH  Layout::width
+#define DISP_HEIGHT Layout::height
 
 typedef enum alignment {
   LEFT,
@@ -16,30 +35,44 @@ typedef enum alignment {
   CENTER
 } alignment_t;
 
+// Refresh regions (display_region_t) as the EPD driver takes them, from Layout::regions
+extern const Rect_t displayRegions[REGION_COUNT];
+
 // Main rendering functions
 void initDisplay();
 void powerOffDisplay();
-void drawCurrentConditions(Forecast_record_type *current, int wifi_signal);
-void drawForecast(Forecast_record_type *forecast, int num_forecasts, tm *timeInfo);
+void drawCurrentConditions(Forecast_record_type *current, const WeatherView &view);
+void drawForecast(const WeatherView &view);
 void drawLocationDate(const String &city, const String &date);
-void drawOutlookGraph(Forecast_record_type *forecast, int num_forecasts, tm *timeInfo);
-void drawStatusBar(const String &statusStr, const String &refreshTimeStr, int rssi, uint32_t batVoltage);
+void drawOutlookGraph(const WeatherView &view);
+void drawStatusBar(const String &statusStr, const String &refreshTimeStr, int rssi, uint32_t batVoltage,
+                   int runtimeHours);
+void drawNowcast(const WeatherView &view);
 void drawLowBatteryScreen();
 void drawWiFiErrorScreen();
-void drawSetupModeScreen();
+void drawSetupModeScreen(const char *updatePin);
 void drawInvalidLocationScreen();
 void drawInvalidAPIKeyScreen();
 
 // Helper drawing functions
-void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment, uint8_t color = 0x00);
+void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment, uint8_t color = 0x00,
+                uint8_t background = 0xFF);
+void drawString(int16_t x, int16_t y, const char *text, alignment_t alignment, uint8_t color = 0x00,
+                uint8_t background = 0xFF);
+void drawMeasuredString(int16_t x, int16_t y, const char *text, const TextMetrics &metrics,
+                        alignment_t alignment, uint8_t color = 0x00, uint8_t background = 0xFF);
 void drawMultiLnString(int16_t x, int16_t y, const String &text, alignment_t alignment, 
                        uint16_t max_width, uint16_t max_lines, int16_t line_spacing, uint8_t color = 0x00);
 uint16_t getStringWidth(const String &text);
 uint16_t getStringHeight(const String &text);
+TextMetrics measureString(const char *text);
 void setFont(GFXfont const &font);
 
 // Icon drawing functions
-void DisplayConditionsSection(int x, int y, String IconName, bool IconSize);
+void DisplayConditionsSection(int x, int y, const char *IconName, bool IconSize);
+#if ICON_BENCHMARK
+void benchmarkIconRendering();
+#endif
 
 // External framebuffer (defined in main.ino)
 extern uint8_t *framebuffer;
@@ -0,0 +1,34 @@
+#ifndef __RTC_BUDGET_H__
+#define __RTC_BUDGET_H__
+
+// RTC slow memory, where RTC_DATA_ATTR variables are placed: 8 KB on both boards, less
+// the ULP coprocessor reserve (CONFIG_ULP_COPROC_RESERVE_MEM) and a margin for the
+// framework's own RTC data and the alignment between variables
+#define RTC_SLOW_MEMORY_SIZE  8192
+#define RTC_ULP_RESERVE_SIZE  512
+#define RTC_FRAMEWORK_MARGIN  256
+#define RTC_USABLE_SIZE       (RTC_SLOW_MEMORY_SIZE - RTC_ULP_RESERVE_SIZE - RTC_FRAMEWORK_MARGIN)
+
+// Bytes allotted to the RTC_DATA_ATTR state of each module. Each module checks its
+// variables against its allotment, so growing one means raising it here, where the
+// total is checked. A new RTC_DATA_ATTR variable needs an allotment as well.
+#define RTC_BUDGET_FORECAST_CACHE  3768  // Forecast snapshot (forecast_cache.cpp)
+#define RTC_BUDGET_PERF_LOG        848   // Wake log ring buffer (perf_log.cpp)
+#define RTC_BUDGET_SETTINGS        416   // Settings blob mirror (settings.cpp)
+#define RTC_BUDGET_PARTIAL_REFRESH 608   // Region and tile hashes (partial_refresh.cpp)
+#define RTC_BUDGET_API_CLIENT      528   // DNS cache and TLS session (api_client.cpp)
+#define RTC_BUDGET_OTA_UPDATE      232   // Download progress (ota_update.cpp)
+#define RTC_BUDGET_BATTERY         208   // Voltage history (battery.cpp)
+#define RTC_BUDGET_NOWCAST         144   // Schedule and last nowcast (nowcast.cpp)
+#define RTC_BUDGET_MAIN            112   // WiFi cache and screen state (main.ino)
+#define RTC_BUDGET_LOCATIONS       40    // Rotation state (locations.cpp)
+#define RTC_BUDGET_RTC_DRIFT       32    // Drift estimate (rtc_drift.cpp)
+#define RTC_BUDGET_FETCH_BACKOFF   8     // Failure count (fetch_backoff.cpp)
+
+static_assert(RTC_BUDGET_FORECAST_CACHE + RTC_BUDGET_PERF_LOG + RTC_BUDGET_SETTINGS +
+              RTC_BUDGET_PARTIAL_REFRESH + RTC_BUDGET_API_CLIENT + RTC_BUDGET_OTA_UPDATE +
+              RTC_BUDGET_BATTERY + RTC_BUDGET_NOWCAST + RTC_BUDGET_MAIN + RTC_BUDGET_LOCATIONS +
+              RTC_BUDGET_RTC_DRIFT + RTC_BUDGET_FETCH_BACKOFF <= RTC_USABLE_SIZE,
+              "RTC_DATA_ATTR state larger than RTC slow memory");
+
+#endif // __RTC_BUDGET_H__
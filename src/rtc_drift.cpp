@@ -0,0 +1,123 @@
+/**
+ * RTC Drift Compensation
+ *
+ * In deep sleep both the wake-up timer and the system clock run from the RTC slow
+ * clock, which can be off by thousands of ppm. Each fetch compares the clock with the
+ * API's current time. The error is divided by the time slept since the previous fetch,
+ * and the result is smoothed into a ppm estimate kept in RTC memory. The estimate
+ * lengthens or shortens the sleep timer so wakes land on the scheduled boundary. It
+ * also corrects the clock on wakes that redraw from the cached forecast.
+ */
+
+#include <Arduino.h>
+#include <sys/time.h>
+#include "rtc_drift.h"
+#include "rtc_budget.h"
+
+typedef struct {
+  uint32_t magic;
+  int32_t  ppm;           // Smoothed estimate, positive = RTC runs fast
+  uint16_t samples;       // Measurements folded into the estimate
+  bool     synced;        // Clock was set from the API since RTC memory was lost
+  bool     sleeping;      // sleepStartUs is valid
+  int64_t  sleepStartUs;  // System time when the last sleep started
+  int64_t  sleptUs;       // Real time slept since the last API sync
+} RtcDriftState;
+
+// Persists across deep sleep
+RTC_DATA_ATTR static RtcDriftState drift;
+static_assert(sizeof(drift) <= RTC_BUDGET_RTC_DRIFT, "drift state over its RTC allotment");
+
+static int64_t nowMicros() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+static void setMicros(int64_t us) {
+  struct timeval tv;
+  tv.tv_sec = us / 1000000LL;
+  tv.tv_usec = us % 1000000LL;
+  settimeofday(&tv, NULL);
+}
+
+/**
+ * Start from the default estimate after power-on or reset.
+ */
+static void ensureState() {
+  if (drift.magic != RTC_DRIFT_MAGIC) {
+    memset(&drift, 0, sizeof(drift));
+    drift.magic = RTC_DRIFT_MAGIC;
+    drift.ppm = RTC_DRIFT_INITIAL_PPM;
+  }
+}
+
+void rtcDriftOnWake() {
+  ensureState();
+  if (!drift.sleeping) return;
+  drift.sleeping = false;
+
+  int64_t now = nowMicros();
+  int64_t elapsed = now - drift.sleepStartUs; // As counted by the RTC
+  if (elapsed <= 0) return;
+
+  // RTC time = real time * (1 + ppm / 1e6)
+  int64_t correction = elapsed * drift.ppm / (1000000LL + drift.ppm);
+  drift.sleptUs += elapsed - correction;
+  if (drift.synced && correction != 0) {
+    setMicros(now - correction);
+  }
+
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("RTC drift: %ld ppm, clock corrected by %ld ms\n", (long)drift.ppm, (long)(-correction / 1000));
+  }
+#endif
+}
+
+void rtcDriftOnSync(time_t apiTime) {
+  ensureState();
+
+  if (drift.synced && drift.sleptUs >= RTC_DRIFT_MIN_SAMPLE_SECONDS * 1000000LL) {
+    // The API time is truncated to the second, so compare against the middle of that second
+    int64_t errorUs = nowMicros() - ((int64_t)apiTime * 1000000LL + 500000LL);
+    // What is left after the corrections already applied, on top of the current estimate
+    int64_t sample = drift.ppm + errorUs * 1000000LL / drift.sleptUs;
+
+    if (sample >= -RTC_DRIFT_MAX_PPM && sample <= RTC_DRIFT_MAX_PPM) {
+      if (drift.samples == 0) {
+        drift.ppm = sample; // First measurement replaces the default
+      } else {
+        drift.ppm += (int32_t)((sample - drift.ppm) / RTC_DRIFT_EMA_DIVISOR);
+      }
+      if (drift.samples < 0xFFFF) drift.samples++;
+    }
+
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("RTC drift: off by %ld ms over %ld s of sleep, sample %ld ppm, estimate %ld ppm\n",
+                    (long)(errorUs / 1000), (long)(drift.sleptUs / 1000000LL), (long)sample, (long)drift.ppm);
+    }
+#endif
+  }
+
+  drift.synced = true;
+  drift.sleptUs = 0;
+}
+
+void rtcDriftOnClockSet() {
+  ensureState();
+  drift.sleptUs = 0;
+}
+
+uint64_t rtcDriftSleepMicros(long seconds) {
+  ensureState();
+  drift.sleeping = true;
+  drift.sleepStartUs = nowMicros();
+  return (uint64_t)seconds * (uint64_t)(1000000LL + drift.ppm);
+}
+
+int32_t rtcDriftPpm() {
+  ensureState();
+  return drift.ppm;
+}
@@ -0,0 +1,63 @@
+#ifndef __RTC_DRIFT_H__
+#define __RTC_DRIFT_H__
+
+#include <Arduino.h>
+#include <time.h>
+
+// Starting estimate before the first measurement (ppm, positive = RTC runs fast)
+#ifndef RTC_DRIFT_INITIAL_PPM
+#define RTC_DRIFT_INITIAL_PPM 0
+#endif
+
+// Sleep needed between two API times before a measurement is used (seconds)
+// The API time has one second resolution, so short windows are mostly noise
+#ifndef RTC_DRIFT_MIN_SAMPLE_SECONDS
+#define RTC_DRIFT_MIN_SAMPLE_SECONDS 900
+#endif
+
+// Measurements beyond this are discarded as bogus (ppm)
+#define RTC_DRIFT_MAX_PPM 50000
+
+// Smoothing: each measurement moves the estimate 1/RTC_DRIFT_EMA_DIVISOR of the way
+#define RTC_DRIFT_EMA_DIVISOR 4
+
+#define RTC_DRIFT_MAGIC 0x44524654  // "DRFT" in hex
+
+/**
+ * Correct the system clock for drift over the sleep that just ended.
+ * Call early in setup(), before the RTC time is used.
+ */
+void rtcDriftOnWake();
+
+/**
+ * Measure drift against an authoritative time and update the smoothed estimate.
+ * Call before the system clock is set to apiTime.
+ *
+ * @param apiTime Unix timestamp from the API (UTC)
+ */
+void rtcDriftOnSync(time_t apiTime);
+
+/**
+ * The system clock is about to be set from a time that is not authoritative (the fleet
+ * gateway's, which drifts too). No measurement is taken; the sleep since the last API
+ * time no longer counts towards one, as the clock has moved.
+ */
+void rtcDriftOnClockSet();
+
+/**
+ * Timer period for a sleep of the given length, corrected for drift, and mark the start of the sleep.
+ * Call just before esp_sleep_enable_timer_wakeup().
+ *
+ * @param seconds Real seconds to sleep
+ * @return Timer period in microseconds
+ */
+uint64_t rtcDriftSleepMicros(long seconds);
+
+/**
+ * Current drift estimate.
+ *
+ * @return Parts per million, positive = RTC runs fast
+ */
+int32_t rtcDriftPpm();
+
+#endif // __RTC_DRIFT_H__
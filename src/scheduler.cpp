@@ -0,0 +1,139 @@
+/**
+ * Sleep Scheduler
+ *
+ * Picks the next wake from the data instead of a fixed SleepDuration step: shorter
+ * when the hourly forecast is about to change, longer overnight, when nothing is
+ * changing or when the battery is running down. Wakes that would fall outside the
+ * wake hours are moved to WakeupHour, so the device sleeps through the night in one
+ * timer period instead of waking every interval just to go back to sleep.
+ */
+
+#include <Arduino.h>
+#include "scheduler.h"
+#include "settings.h"
+
+extern int globalTimezoneOffset;  // Timezone offset in seconds (positive = east of UTC)
+
+bool scheduleHourIsAwake(int hour) {
+  // SleepHour == 24 means "never sleep" (always wake)
+  if (settings.SleepHour == 24) {
+    return true;
+  }
+  // Handle wake hours that span midnight (e.g., 22:00 to 06:00)
+  if (settings.WakeupHour > settings.SleepHour) {
+    return (hour >= settings.WakeupHour || hour <= settings.SleepHour);
+  }
+  return (hour >= settings.WakeupHour && hour <= settings.SleepHour);
+}
+
+#if SCHEDULER_ADAPTIVE
+/**
+ * Spread of precipitation probability and temperature over the hourly entries
+ * between now and now + hours.
+ *
+ * @return false if fewer than two entries fall in the window
+ */
+static bool forecastSpread(time_t now, const Forecast_record_type *hourly, int hourlyCount, int hours,
+                           int *popSpread, int *tempSpread) {
+  int popMin = 255, popMax = 0, tempMin = 32767, tempMax = -32768, n = 0;
+  for (int i = 0; i < hourlyCount; i++) {
+    if (hourly[i].Dt <= now || hourly[i].Dt > now + hours * 3600L) continue;
+    popMin  = min(popMin, (int)hourly[i].Pop);
+    popMax  = max(popMax, (int)hourly[i].Pop);
+    tempMin = min(tempMin, (int)hourly[i].Temperature);
+    tempMax = max(tempMax, (int)hourly[i].Temperature);
+    n++;
+  }
+  if (n < 2) return false;
+  *popSpread = popMax - popMin;
+  *tempSpread = tempMax - tempMin;
+  return true;
+}
+#endif
+
+long scheduleSleepSeconds(time_t now, const Forecast_record_type *hourly, int hourlyCount, uint32_t batteryMv,
+                          int batteryHours) {
+  long base = (settings.SleepDuration > 0) ? settings.SleepDuration : 60;
+  if (now < 946684800) { // RTC not set (Unix timestamp for 2000-01-01): nothing to align to
+    return base * 60;
+  }
+
+  time_t local = now + globalTimezoneOffset;
+  long secOfDay = local % 86400;
+
+  long interval = base;
+  const char *reason = "fixed";
+#if SCHEDULER_ADAPTIVE
+  // Temperatures are tenths of the requested unit; thresholds are in tenths of a degree C
+  const bool metric = strcmp(settings.Units, "M") == 0;
+  const int volatileTemp = metric ? SCHEDULER_VOLATILE_TEMP : SCHEDULER_VOLATILE_TEMP * 9 / 5;
+  const int flatTemp = metric ? SCHEDULER_FLAT_TEMP : SCHEDULER_FLAT_TEMP * 9 / 5;
+  const int hour = (local / 3600) % 24;
+  const bool night = (SCHEDULER_NIGHT_START > SCHEDULER_NIGHT_END)
+                       ? (hour >= SCHEDULER_NIGHT_START || hour < SCHEDULER_NIGHT_END)
+                       : (hour >= SCHEDULER_NIGHT_START && hour < SCHEDULER_NIGHT_END);
+  int popSpread, tempSpread;
+
+  reason = "steady";
+  if (hourly && forecastSpread(now, hourly, hourlyCount, SCHEDULER_VOLATILE_HOURS, &popSpread, &tempSpread) &&
+      (popSpread >= SCHEDULER_VOLATILE_POP || tempSpread >= volatileTemp)) {
+    interval /= 2;
+    reason = "changing";
+  } else if (night) {
+    interval *= 2;
+    reason = "night";
+  } else if (hourly && forecastSpread(now, hourly, hourlyCount, SCHEDULER_FLAT_HOURS, &popSpread, &tempSpread) &&
+             popSpread <= SCHEDULER_FLAT_POP && tempSpread <= flatTemp) {
+    interval *= 2;
+    reason = "flat";
+  }
+  // Never tighter or looser than the user asked for beyond the scheduler bounds
+  interval = constrain(interval, min(base, (long)SCHEDULER_MIN_INTERVAL_MINUTES),
+                       max(base, (long)SCHEDULER_MAX_INTERVAL_MINUTES));
+
+  // Stretch linearly from 1x at FULL_MV to STRETCH_MAX x at the cutoff (0 = not measured),
+  // or by how far the predicted runtime falls short of RUNTIME_HOURS, whichever is more
+  long stretched = interval;
+  if (batteryMv > 0 && batteryMv < SCHEDULER_BATTERY_FULL_MV) {
+    long drop = SCHEDULER_BATTERY_FULL_MV - max(batteryMv, (uint32_t)SCHEDULER_BATTERY_CUTOFF_MV);
+    stretched += interval * (SCHEDULER_BATTERY_STRETCH_MAX - 1) * drop
+                 / (SCHEDULER_BATTERY_FULL_MV - SCHEDULER_BATTERY_CUTOFF_MV);
+  }
+  if (batteryHours >= 0 && batteryHours < SCHEDULER_BATTERY_RUNTIME_HOURS) {
+    long byRuntime = interval * SCHEDULER_BATTERY_RUNTIME_HOURS / max(batteryHours, 1);
+    stretched = max(stretched, min(byRuntime, interval * SCHEDULER_BATTERY_STRETCH_MAX));
+  }
+  if (stretched > interval) {
+    interval = min(stretched, 1440L);
+    reason = "battery";
+  }
+#endif
+
+  // Align to a multiple of the interval since local midnight
+  // Example: interval 30 min at 14:23:45 -> wake at 14:30:00
+  // A wake that lands just short of a boundary counts as on it, so it does not sleep again for a few seconds
+  long nextMin = ((secOfDay + SCHEDULER_BOUNDARY_SLACK_SECONDS) / 60 / interval + 1) * interval;
+  long seconds = nextMin * 60 - secOfDay;
+
+  // Outside wake hours: sleep through to the first awake hour instead
+  time_t target = local + seconds;
+  if (!scheduleHourIsAwake((target / 3600) % 24)) {
+    time_t hourStart = target - (target % 3600);
+    for (int h = 1; h <= 24; h++) {
+      if (scheduleHourIsAwake(((hourStart / 3600) + h) % 24)) {
+        seconds = (hourStart + h * 3600L) - local;
+        reason = "wake hours";
+        break;
+      }
+    }
+  }
+
+  (void)reason; // Only printed when DEBUG_LEVEL is set
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Scheduler: interval %ld min (%s), battery %lu mV / %d h, next wake in %ld s\n",
+                  interval, reason, (unsigned long)batteryMv, batteryHours, seconds);
+  }
+#endif
+  return seconds;
+}
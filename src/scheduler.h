@@ -0,0 +1,75 @@
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+#include <Arduino.h>
+#include <time.h>
+#include "forecast_record.h"
+
+// 1 = adapt the interval to the forecast and battery, 0 = always use SleepDuration
+#ifndef SCHEDULER_ADAPTIVE
+#define SCHEDULER_ADAPTIVE 1
+#endif
+
+// Bounds for the adapted interval (minutes)
+#define SCHEDULER_MIN_INTERVAL_MINUTES 10
+#define SCHEDULER_MAX_INTERVAL_MINUTES 240
+
+// Wakes this close before an interval boundary are treated as on it (seconds)
+#define SCHEDULER_BOUNDARY_SLACK_SECONDS 60
+
+// Forecast volatility: look this many hours ahead
+#define SCHEDULER_VOLATILE_HOURS 3   // Halve the interval if conditions change sharply within this window
+#define SCHEDULER_FLAT_HOURS     6   // Double the interval if conditions stay flat over this window
+
+// Precipitation probability spread (percent) and temperature spread (tenths of a degree C)
+#define SCHEDULER_VOLATILE_POP   40
+#define SCHEDULER_VOLATILE_TEMP  30
+#define SCHEDULER_FLAT_POP       10
+#define SCHEDULER_FLAT_TEMP      10
+
+// Local hours treated as overnight (interval doubled), start inclusive, end exclusive
+#define SCHEDULER_NIGHT_START 22
+#define SCHEDULER_NIGHT_END   6
+
+// Battery stretch: intervals grow linearly from 1x at FULL_MV to STRETCH_MAX x at the 3.2 V cutoff
+#define SCHEDULER_BATTERY_FULL_MV    3700
+#define SCHEDULER_BATTERY_CUTOFF_MV  3200
+#define SCHEDULER_BATTERY_STRETCH_MAX 4
+
+// Runtime stretch: when the discharge history predicts less runtime than this (hours),
+// intervals grow in proportion (up to STRETCH_MAX x), whichever stretch is larger
+#ifndef SCHEDULER_BATTERY_RUNTIME_HOURS
+#define SCHEDULER_BATTERY_RUNTIME_HOURS 168
+#endif
+
+/**
+ * Check whether a local hour falls within the configured wake hours
+ * (WakeupHour..SleepHour inclusive, spanning midnight if WakeupHour > SleepHour,
+ * SleepHour 24 = always awake).
+ *
+ * @param hour Local hour (0-23)
+ * @return true if the display is updated during this hour
+ */
+bool scheduleHourIsAwake(int hour);
+
+/**
+ * Choose how long to sleep before the next wake.
+ *
+ * The interval starts at SleepDuration. It is halved when precipitation probability
+ * or temperature change sharply in the next few hourly entries, doubled overnight or
+ * when the forecast is flat, and stretched as the battery falls toward the cutoff or
+ * when its predicted runtime is short.
+ * The wake is aligned to a multiple of the interval since local midnight. If it
+ * would land outside the wake hours, the device sleeps until WakeupHour instead.
+ *
+ * @param now Current UTC time (RTC)
+ * @param hourly Hourly forecast, or NULL if none is loaded
+ * @param hourlyCount Number of hourly entries
+ * @param batteryMv Battery voltage in millivolts, or 0 if unknown
+ * @param batteryHours Predicted battery runtime in hours (battery.h), or -1 if unknown
+ * @return Real seconds to sleep (rtc_drift.h converts this to a timer period)
+ */
+long scheduleSleepSeconds(time_t now, const Forecast_record_type *hourly, int hourlyCount, uint32_t batteryMv,
+                          int batteryHours);
+
+#endif // __SCHEDULER_H__
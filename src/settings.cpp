@@ -3,11 +3,42 @@
  * 
  * Handles loading and saving user settings to/from EEPROM using ESP32 Preferences.
  * On first boot, initializes with default values.
+ *
+ * The Settings struct is stored as one CRC-protected blob, read with a single lookup,
+ * and mirrored in RTC memory so wakes from deep sleep do not touch NVS at all.
+ * Settings written by older firmware (one key per field) are migrated on first boot.
+ * The additional locations are kept under a key of their own and read when the
+ * location rotation needs one.
  */
 
 #include <Arduino.h>
 #include <Preferences.h>
+#include <esp_rom_crc.h>
+#include <esp_sleep.h>
 #include "settings.h"
+#include "rtc_budget.h"
+
+// NVS keys of the settings blob and the additional locations in the "weather" namespace
+#define SETTINGS_BLOB_KEY      "settings"
+#define SETTINGS_LOCATIONS_KEY "locations"
+
+// Version 4 kept the additional locations in the blob, right after ExtraLocationCount
+#define SETTINGS_V4_LOCATIONS_OFFSET (offsetof(Settings, ExtraLocationCount) + sizeof(int))
+#define SETTINGS_V4_SIZE (SETTINGS_V4_LOCATIONS_OFFSET + (MAX_LOCATIONS - 1) * sizeof(SettingsLocation))
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;  // SETTINGS_VERSION of the firmware that wrote it
+  uint16_t size;     // Bytes of data stored (sizeof(Settings) of that version)
+  uint32_t crc;      // CRC32 of the first size bytes of data
+  Settings data;
+} SettingsBlob;
+
+// Room to read a blob of this version or of version 4
+typedef union {
+  SettingsBlob blob;
+  uint8_t bytes[offsetof(SettingsBlob, data) + SETTINGS_V4_SIZE];
+} SettingsBlobBuffer;
 
 // Preferences namespace for settings storage
 Preferences preferences;
@@ -15,6 +46,10 @@ Preferences preferences;
 // Global settings variable
 Settings settings;
 
+// Copy of the stored blob; persists across deep sleep, not valid after power-on
+RTC_DATA_ATTR static SettingsBlob rtcSettings;
+static_assert(sizeof(rtcSettings) <= RTC_BUDGET_SETTINGS, "settings mirror over its RTC allotment");
+
 // Default settings
 // Note: Using regular initialization instead of C99 designators for C++ compatibility
 const Settings defaultSettings = {
@@ -29,35 +64,167 @@ const Settings defaultSettings = {
   60,                           // SleepDuration
   0,                            // WakeupHour
   24,                           // SleepHour
-  SETTINGS_MAGIC                // magic
+  0,                            // MaxDataAge
+  SETTINGS_MAGIC,               // magic
+  0,                            // FleetRole (FLEET_ROLE_STANDALONE)
+  0                             // ExtraLocationCount
 };
 
+/**
+ * Check a blob read from NVS or RTC memory and copy it into settings.
+ */
+static bool applyBlob(const SettingsBlob *blob, size_t length) {
+  if (length < offsetof(SettingsBlob, data) || blob->magic != SETTINGS_MAGIC ||
+      blob->size > sizeof(Settings) || length < offsetof(SettingsBlob, data) + blob->size ||
+      blob->crc != esp_rom_crc32_le(0, (const uint8_t *)&blob->data, blob->size)) {
+    return false;
+  }
+  // Fields appended since an older version keep their defaults
+  memcpy(&settings, &defaultSettings, sizeof(Settings));
+  memcpy(&settings, &blob->data, blob->size);
+  settings.magic = SETTINGS_MAGIC;
+  return true;
+}
+
+/**
+ * Fill in a blob holding the current settings.
+ */
+static void buildBlob(SettingsBlob *blob) {
+  blob->magic   = SETTINGS_MAGIC;
+  blob->version = SETTINGS_VERSION;
+  blob->size    = sizeof(Settings);
+  memcpy(&blob->data, &settings, sizeof(Settings));
+  blob->crc     = esp_rom_crc32_le(0, (const uint8_t *)&blob->data, sizeof(Settings));
+}
+
+/**
+ * Read settings stored by firmware using one Preferences key per field (version 1).
+ */
+static void loadLegacySettings() {
+  // Load all settings (use default if key doesn't exist)
+  String ssidStr = preferences.getString("ssid", defaultSettings.ssid);
+  String passwordStr = preferences.getString("password", defaultSettings.password);
+  String apikeyStr = preferences.getString("apikey", defaultSettings.apikey);
+  String cityStr = preferences.getString("City", defaultSettings.City);
+  String latStr = preferences.getString("Latitude", defaultSettings.Latitude);
+  String lonStr = preferences.getString("Longitude", defaultSettings.Longitude);
+  String langStr = preferences.getString("Language", defaultSettings.Language);
+  String unitsStr = preferences.getString("Units", defaultSettings.Units);
+  
+  // Copy strings to settings structure
+  memcpy(&settings, &defaultSettings, sizeof(Settings));
+  strlcpy(settings.ssid, ssidStr.c_str(), sizeof(settings.ssid));
+  strlcpy(settings.password, passwordStr.c_str(), sizeof(settings.password));
+  strlcpy(settings.apikey, apikeyStr.c_str(), sizeof(settings.apikey));
+  strlcpy(settings.City, cityStr.c_str(), sizeof(settings.City));
+  strlcpy(settings.Latitude, latStr.c_str(), sizeof(settings.Latitude));
+  strlcpy(settings.Longitude, lonStr.c_str(), sizeof(settings.Longitude));
+  strlcpy(settings.Language, langStr.c_str(), sizeof(settings.Language));
+  strlcpy(settings.Units, unitsStr.c_str(), sizeof(settings.Units));
+  
+  settings.SleepDuration = preferences.getLong("SleepDuration", defaultSettings.SleepDuration);
+  settings.WakeupHour = preferences.getInt("WakeupHour", defaultSettings.WakeupHour);
+  settings.SleepHour = preferences.getInt("SleepHour", defaultSettings.SleepHour);
+  settings.MaxDataAge = preferences.getInt("MaxDataAge", defaultSettings.MaxDataAge);
+  settings.magic = SETTINGS_MAGIC;
+}
+
+/**
+ * Write settings as a blob to the open namespace and refresh the RTC copy.
+ */
+static void writeBlob() {
+  buildBlob(&rtcSettings);
+  preferences.putBytes(SETTINGS_BLOB_KEY, &rtcSettings, sizeof(rtcSettings));
+}
+
+/**
+ * Move the additional locations of a version 4 blob to their own key and apply the
+ * rest of it. The blob is rewritten without them when the namespace is writable.
+ */
+static bool migrateBlobV4(SettingsBlob *blob, size_t length) {
+  if (blob->magic != SETTINGS_MAGIC || blob->size != SETTINGS_V4_SIZE ||
+      length != offsetof(SettingsBlob, data) + SETTINGS_V4_SIZE ||
+      blob->crc != esp_rom_crc32_le(0, (const uint8_t *)&blob->data, blob->size)) {
+    return false;
+  }
+  const uint8_t *locations = (const uint8_t *)&blob->data + SETTINGS_V4_LOCATIONS_OFFSET;
+  preferences.putBytes(SETTINGS_LOCATIONS_KEY, locations, (MAX_LOCATIONS - 1) * sizeof(SettingsLocation));
+  blob->size = SETTINGS_V4_LOCATIONS_OFFSET;
+  blob->crc  = esp_rom_crc32_le(0, (const uint8_t *)&blob->data, blob->size);
+  if (!applyBlob(blob, offsetof(SettingsBlob, data) + blob->size)) {
+    return false;
+  }
+  writeBlob();
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.println("Additional locations moved out of the settings blob");
+  }
+#endif
+  return true;
+}
+
+/**
+ * Read the settings blob from the open namespace into settings.
+ */
+static bool readBlob() {
+  SettingsBlobBuffer buffer;
+  SettingsBlob *blob = &buffer.blob;
+  size_t length = preferences.getBytesLength(SETTINGS_BLOB_KEY);
+  if (length == 0 || length > sizeof(buffer) || preferences.getBytes(SETTINGS_BLOB_KEY, &buffer, length) != length) {
+    return false;
+  }
+  if (length >= offsetof(SettingsBlob, data) && blob->version == 4) {
+    return migrateBlobV4(blob, length);
+  }
+  if (length > sizeof(SettingsBlob) || !applyBlob(blob, length)) {
+    return false;
+  }
+  memcpy(&rtcSettings, blob, sizeof(rtcSettings));
+  return true;
+}
+
 /**
  * Initialize settings system.
- * Checks if settings exist in EEPROM, if not creates with defaults.
+ * Uses the RTC copy after deep sleep; otherwise reads EEPROM, migrating or creating settings as needed.
  */
 void initSettings() {
+  if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED &&
+      applyBlob(&rtcSettings, sizeof(rtcSettings))) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println("Settings restored from RTC memory");
+    }
+#endif
+    return;
+  }
+
   preferences.begin("weather", false); // Open preferences namespace "weather" in read-write mode
   
-  // Check if settings exist by reading magic number
-  uint32_t magic = preferences.getUInt("magic", 0);
-  
-  if (magic != SETTINGS_MAGIC) {
-    // Settings don't exist or are invalid - initialize with defaults
+  if (readBlob()) {
 #if DEBUG_LEVEL
     if (Serial) {
-      Serial.println("Settings not found in EEPROM. Initializing with defaults...");
+      Serial.println("Settings loaded from EEPROM");
+    }
+#endif
+  } else if (preferences.getUInt("magic", 0) == SETTINGS_MAGIC) {
+    // Per-key settings from older firmware - convert them
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println("Migrating settings to a single EEPROM blob...");
     }
 #endif
-    resetSettingsToDefaults();
+    loadLegacySettings();
+    preferences.clear();
+    writeBlob();
   } else {
-    // Settings exist - load them
+    // Settings don't exist or are invalid - initialize with defaults
 #if DEBUG_LEVEL
     if (Serial) {
-      Serial.println("Loading settings from EEPROM...");
+      Serial.println("Settings not found in EEPROM. Initializing with defaults...");
     }
 #endif
-    loadSettings();
+    memcpy(&settings, &defaultSettings, sizeof(Settings));
+    writeBlob();
   }
   
   preferences.end();
@@ -69,48 +236,15 @@ void initSettings() {
  */
 bool loadSettings() {
   preferences.begin("weather", true); // Open in read-only mode
-  
-  // Load all settings (use default if key doesn't exist)
-  String ssidStr = preferences.getString("ssid", defaultSettings.ssid);
-  String passwordStr = preferences.getString("password", defaultSettings.password);
-  String apikeyStr = preferences.getString("apikey", defaultSettings.apikey);
-  String cityStr = preferences.getString("City", defaultSettings.City);
-  String latStr = preferences.getString("Latitude", defaultSettings.Latitude);
-  String lonStr = preferences.getString("Longitude", defaultSettings.Longitude);
-  String langStr = preferences.getString("Language", defaultSettings.Language);
-  String unitsStr = preferences.getString("Units", defaultSettings.Units);
-  
-  // Copy strings to settings structure
-  strncpy(settings.ssid, ssidStr.c_str(), sizeof(settings.ssid) - 1);
-  settings.ssid[sizeof(settings.ssid) - 1] = '\0';
-  strncpy(settings.password, passwordStr.c_str(), sizeof(settings.password) - 1);
-  settings.password[sizeof(settings.password) - 1] = '\0';
-  strncpy(settings.apikey, apikeyStr.c_str(), sizeof(settings.apikey) - 1);
-  settings.apikey[sizeof(settings.apikey) - 1] = '\0';
-  strncpy(settings.City, cityStr.c_str(), sizeof(settings.City) - 1);
-  settings.City[sizeof(settings.City) - 1] = '\0';
-  strncpy(settings.Latitude, latStr.c_str(), sizeof(settings.Latitude) - 1);
-  settings.Latitude[sizeof(settings.Latitude) - 1] = '\0';
-  strncpy(settings.Longitude, lonStr.c_str(), sizeof(settings.Longitude) - 1);
-  settings.Longitude[sizeof(settings.Longitude) - 1] = '\0';
-  strncpy(settings.Language, langStr.c_str(), sizeof(settings.Language) - 1);
-  settings.Language[sizeof(settings.Language) - 1] = '\0';
-  strncpy(settings.Units, unitsStr.c_str(), sizeof(settings.Units) - 1);
-  settings.Units[sizeof(settings.Units) - 1] = '\0';
-  
-  settings.SleepDuration = preferences.getLong("SleepDuration", defaultSettings.SleepDuration);
-  settings.WakeupHour = preferences.getInt("WakeupHour", defaultSettings.WakeupHour);
-  settings.SleepHour = preferences.getInt("SleepHour", defaultSettings.SleepHour);
-  settings.magic = preferences.getUInt("magic", SETTINGS_MAGIC);
-  
+  bool loaded = readBlob();
   preferences.end();
   
 #if DEBUG_LEVEL
   if (Serial) {
-    Serial.println("Settings loaded from EEPROM");
+    Serial.println(loaded ? "Settings loaded from EEPROM" : "No valid settings in EEPROM");
   }
 #endif
-  return true;
+  return loaded;
 }
 
 /**
@@ -118,21 +252,7 @@ bool loadSettings() {
  */
 void saveSettings() {
   preferences.begin("weather", false); // Open in read-write mode
-  
-  // Save all settings
-  preferences.putString("ssid", settings.ssid);
-  preferences.putString("password", settings.password);
-  preferences.putString("apikey", settings.apikey);
-  preferences.putString("City", settings.City);
-  preferences.putString("Latitude", settings.Latitude);
-  preferences.putString("Longitude", settings.Longitude);
-  preferences.putString("Language", settings.Language);
-  preferences.putString("Units", settings.Units);
-  preferences.putLong("SleepDuration", settings.SleepDuration);
-  preferences.putInt("WakeupHour", settings.WakeupHour);
-  preferences.putInt("SleepHour", settings.SleepHour);
-  preferences.putUInt("magic", SETTINGS_MAGIC);
-  
+  writeBlob();
   preferences.end();
   
 #if DEBUG_LEVEL
@@ -159,4 +279,40 @@ void resetSettingsToDefaults() {
 #endif
 }
 
+/**
+ * Read the additional locations from EEPROM.
+ */
+int loadExtraLocations(SettingsLocation *locations) {
+  const size_t size = (MAX_LOCATIONS - 1) * sizeof(SettingsLocation);
+  memset(locations, 0, size);
+  int count = constrain(settings.ExtraLocationCount, 0, MAX_LOCATIONS - 1);
+  if (count == 0) {
+    return 0;
+  }
+
+  preferences.begin("weather", true); // Open in read-only mode
+  if (preferences.getBytesLength(SETTINGS_LOCATIONS_KEY) != size ||
+      preferences.getBytes(SETTINGS_LOCATIONS_KEY, locations, size) != size) {
+    memset(locations, 0, size);
+    count = 0;
+  }
+  preferences.end();
+  return count;
+}
+
+/**
+ * Save the additional locations to EEPROM.
+ */
+void saveExtraLocations(const SettingsLocation *locations, int count) {
+  SettingsLocation stored[MAX_LOCATIONS - 1];
+  count = constrain(count, 0, MAX_LOCATIONS - 1);
+  memset(stored, 0, sizeof(stored));
+  memcpy(stored, locations, count * sizeof(SettingsLocation));
+
+  preferences.begin("weather", false); // Open in read-write mode
+  preferences.putBytes(SETTINGS_LOCATIONS_KEY, stored, sizeof(stored));
+  preferences.end();
+  settings.ExtraLocationCount = count;
+}
+
 
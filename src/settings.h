@@ -3,6 +3,19 @@
 
 #include <Arduino.h>
 
+// Locations the display rotates through: settings.City plus up to MAX_LOCATIONS - 1 more
+#define MAX_LOCATIONS 4
+#define LOCATION_NAME_LEN 64
+
+/**
+ * An additional location, resolved to coordinates in setup mode like settings.City.
+ */
+typedef struct {
+  char City[LOCATION_NAME_LEN];
+  char Latitude[16];   // "-181" = not resolved yet
+  char Longitude[16];
+} SettingsLocation;
+
 // Debug level: 0 = disable serial and all debug output, 1 = enable serial and debug output
 // Can be overridden by defining DEBUG_LEVEL before including this header
 #ifndef DEBUG_LEVEL
@@ -11,7 +24,9 @@
 
 /**
  * Settings structure to hold all user-configurable values.
- * Stored in EEPROM (using ESP32 Preferences) for persistence.
+ * Stored in EEPROM (using ESP32 Preferences) as a single blob, so only ever append
+ * fields: a blob from an older version is read over the defaults up to its size.
+ * Bump SETTINGS_VERSION when adding one.
  */
 struct Settings {
   // WiFi credentials
@@ -32,14 +47,23 @@ struct Settings {
   long SleepDuration;  // Sleep duration in minutes
   int WakeupHour;     // Start of wake hours (0-23)
   int SleepHour;       // End of wake hours (1-23, or 24 for "never sleep"/always wake)
+  int MaxDataAge;      // Minutes a cached forecast may be redrawn without fetching (0 = always fetch)
   
   // Magic number to verify EEPROM data is valid
   uint32_t magic;
+  
+  // Fields added in later versions go after magic (older blobs leave them at their defaults)
+  int FleetRole;       // FLEET_ROLE_* (fleet.h): stand-alone, gateway or display
+  int ExtraLocationCount; // Additional locations in use (0 = show settings.City only), stored under their own key
 };
 
 // Magic number to identify valid settings in EEPROM
 #define SETTINGS_MAGIC 0x57454154  // "WEAT" in hex
 
+// Layout of the settings blob; version 1 was one Preferences key per field, 3 added FleetRole,
+// 4 the additional locations, 5 moved them out of the blob (and its RTC copy)
+#define SETTINGS_VERSION 5
+
 // Default settings (used on first boot)
 extern const Settings defaultSettings;
 
@@ -48,7 +72,8 @@ extern Settings settings;
 
 /**
  * Initialize settings system.
- * Checks if settings exist in EEPROM, if not creates with defaults.
+ * Wakes from deep sleep use the copy kept in RTC memory; otherwise settings are read
+ * from EEPROM, migrated from the per-key layout, or created with defaults.
  * Must be called before using any settings values.
  */
 void initSettings();
@@ -69,6 +94,24 @@ void saveSettings();
  */
 void resetSettingsToDefaults();
 
+/**
+ * Read the additional locations from EEPROM. They are not part of the settings blob, so
+ * they take no RTC memory; only the location rotation reads them, when it needs one.
+ *
+ * @param locations Output, MAX_LOCATIONS - 1 entries (those not in use are cleared)
+ * @return Number in use: settings.ExtraLocationCount, or 0 if none are stored
+ */
+int loadExtraLocations(SettingsLocation *locations);
+
+/**
+ * Save the additional locations to EEPROM and set settings.ExtraLocationCount;
+ * call saveSettings() afterwards to store the count.
+ *
+ * @param locations count entries
+ * @param count 0 to MAX_LOCATIONS - 1
+ */
+void saveExtraLocations(const SettingsLocation *locations, int count);
+
 #endif // __SETTINGS_H__
 
 
@@ -2,245 +2,717 @@
  * Setup Mode Implementation
  * 
  * Provides WiFi Access Point and web server for device configuration.
- * Based on: https://randomnerdtutorials.com/esp32-access-point-ap-web-server/
+ * The page (web/setup.html) is served from flash as one gzip blob; it loads the
+ * settings from /settings and posts them back to /save as JSON.
+ *
+ * While the access point is up the unit also joins the configured WiFi network, so the
+ * page can look the location up as it is typed (/geocode). Lookups block, so the async
+ * handlers only queue them and the runSetupMode() loop runs them.
+ *
+ * A new firmware can be uploaded to /update; it is written to the other OTA slot as it
+ * arrives (ota_update.h) and booted once complete.
  */
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include "freertos/FreeRTOS.h"
+#include "bootloader_random.h"
+#include <ESPAsyncWebServer.h>
 #include "setup_mode.h"
 #include "settings.h"
+#include "perf_log.h"
+#include "geocode.h"
+#include "fleet.h"
+#include "locations.h"
+#include "ota_update.h"
+#include "setup_page.h"
+
+// Largest accepted POST /save body; the settings JSON is a few hundred bytes
+#define SETUP_MAX_BODY 1024
+// JSON document for /settings and /save (string values are not copied into it)
+#define SETUP_JSON_DOC_SIZE 512
+// Let the response reach the browser before restarting
+#define SETUP_RESTART_DELAY_MS 500
+// Wrong update PINs before firmware uploads are refused until the restart
+#define SETUP_UPDATE_PIN_TRIES 5
+
+// /save body, copied only when it arrives in more than one TCP segment
+static char saveBody[SETUP_MAX_BODY + 1];
+// Request the body handler last ran for, and its outcome (read by the request handler)
+static AsyncWebServerRequest *saveRequest = NULL;
+static bool saveAccepted = false;
+static char saveError[192];
+// Request whose /connect body was queued (read by the request handler)
+static AsyncWebServerRequest *connectRequest = NULL;
+// millis() at which a restart was requested, checked by the runSetupMode() loop
+static volatile bool restartPending = false;
+static volatile unsigned long restartRequestedAt = 0;
+static volatile bool resolveBeforeRestart = false; // Settings were saved without coordinates
+// Request the firmware upload belongs to, and whether it is still good
+static AsyncWebServerRequest *updateRequest = NULL;
+static bool updateAccepted = false;
+static const char *updateError = NULL; // Refused before writing, NULL = see otaUploadError()
+static char updatePin[7] = "";
+static int updatePinFailures = 0;
+
+// Recent live lookups, answered from RAM while the user edits the location
+#define SETUP_LIVE_LOOKUPS 4
+
+typedef struct {
+  char query[GEOCODE_QUERY_LEN];  // Normalized, "" = unused
+  int  status;                    // geocodeLookup() result
+  int  count;
+  GeocodeResult results[GEOCODE_MAX_RESULTS];
+} LiveLookup;
+
+// Shared by the server task and the setup-mode loop, guarded by lookupLock
+static portMUX_TYPE lookupLock = portMUX_INITIALIZER_UNLOCKED;
+static LiveLookup liveLookups[SETUP_LIVE_LOOKUPS];
+static int liveLookupNext = 0;
+static char queuedQuery[GEOCODE_QUERY_LEN];     // Lookup waiting for the loop, "" = none
+static char queuedKey[sizeof(settings.apikey)]; // API key typed in the page (may not be saved yet)
+static char runningQuery[GEOCODE_QUERY_LEN];    // Lookup the loop is running
+static bool connectPending = false;             // Join the network typed in the page
+static char connectSsid[sizeof(settings.ssid)];
+static char connectPassword[sizeof(settings.password)];
+
+static void appendError(const char *text) {
+  strlcat(saveError, text, sizeof(saveError));
+}
 
 /**
- * Validate and geocode location if latitude/longitude are invalid.
- * Checks if lat/lon are -181 (invalid). If so, uses OpenWeatherMap Geocoding API
- * to get valid coordinates from the location string and saves them to EEPROM.
- * 
- * @return true if location is valid or successfully geocoded, false if geocoding fails
+ * Split the additional locations field (one per line) into locations without coordinates.
+ *
+ * @param text Field as posted
+ * @param locations Parsed locations (output, MAX_LOCATIONS - 1 entries)
+ * @return Number of non-empty lines, -1 if one is too long
  */
-int validateAndGeocodeLocation() {
-  // Check if latitude and longitude are invalid (-181)
-  float lat = String(settings.Latitude).toFloat();
-  float lon = String(settings.Longitude).toFloat();
-  
-  // If coordinates are valid (not -181), no geocoding needed
-  if (lat > -180.0 && lat < 180.0 && lon > -180.0 && lon < 180.0) {
-#if DEBUG_LEVEL
-    if (Serial) {
-      Serial.println("Location coordinates are valid. No geocoding needed.");
+static int parseExtraLocations(const char *text, SettingsLocation *locations) {
+  int count = 0;
+  while (*text) {
+    const char *end = strchr(text, '\n');
+    size_t length = end ? (size_t)(end - text) : strlen(text);
+    String line = String(text).substring(0, length);
+    line.trim();
+    if (line.length() >= LOCATION_NAME_LEN) {
+      return -1;
     }
-#endif
-    return 0; // Success
+    if (line.length() > 0) {
+      if (count < MAX_LOCATIONS - 1) {
+        memset(&locations[count], 0, sizeof(SettingsLocation));
+        strlcpy(locations[count].City, line.c_str(), sizeof(locations[count].City));
+      }
+      count++;
+    }
+    text += end ? length + 1 : length;
   }
-  
+  return count;
+}
+
+/**
+ * Coordinates of an additional location: those already saved for the same name, else
+ * the cached place, else "-181" for the setup-mode loop to look up before restarting.
+ */
+static void resolveExtraLocation(SettingsLocation *location) {
+  for (int i = 1; i < locationCount(); i++) {
+    const SettingsLocation *saved = locationExtra(i);
+    if (strcmp(saved->City, location->City) == 0 && locationHasCoordinates(saved)) {
+      memcpy(location, saved, sizeof(SettingsLocation));
+      return;
+    }
+  }
+  GeocodeResult result;
+  if (geocodeCacheGet(location->City, &result)) {
+    strlcpy(location->Latitude, String(result.lat, 6).c_str(), sizeof(location->Latitude));
+    strlcpy(location->Longitude, String(result.lon, 6).c_str(), sizeof(location->Longitude));
+  } else {
+    strlcpy(location->Latitude, "-181", sizeof(location->Latitude));
+    strlcpy(location->Longitude, "-181", sizeof(location->Longitude));
+  }
+}
+
+/**
+ * Whether the primary location or any additional one still needs a lookup.
+ */
+static bool locationsUnresolved() {
+  if (!geocodeHasCoordinates()) {
+    return true;
+  }
+  for (int i = 1; i < locationCount(); i++) {
+    if (!locationHasCoordinates(locationExtra(i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Validate the submitted settings and save them. Numeric fields that are missing keep
+ * the current value; out-of-range frequency and data age fall back to their defaults.
+ *
+ * @param form Parsed /save body
+ * @return true if saved, false with the reasons in saveError
+ */
+static bool applySettings(JsonObject form) {
+  const char *apiKey   = form["apikey"] | "";
+  const char *ssid     = form["ssid"] | "";
+  const char *password = form["password"] | "";
+  const char *location = form["location"] | "";
+  const char *units    = form["units"] | "";
+  const char *extra    = form["locations"] | "";
+  saveError[0] = '\0';
+
 #if DEBUG_LEVEL
   if (Serial) {
-    Serial.println("Location coordinates are invalid. Attempting geocoding...");
+    Serial.println("\n=== Configuration Received ===");
+    Serial.printf("OpenWeatherMap API Key: %s\n", apiKey[0] ? apiKey : "(empty)");
+    Serial.printf("WiFi SSID: %s\n", ssid[0] ? ssid : "(empty)");
+    Serial.printf("WiFi Password: %s\n", password[0] ? "***" : "(empty)");
+    Serial.printf("Location: %s\n", location[0] ? location : "(empty)");
+    Serial.printf("Units: %s\n", units[0] ? units : "(empty)");
+    Serial.println("=== End Configuration ===\n");
   }
 #endif
-  
-  // Check if location string is empty
-  if (strlen(settings.City) == 0) {
+
+  // Text fields must fit their settings buffers (including the terminator)
+  if (strlen(apiKey) >= sizeof(settings.apikey)) appendError("API Key too long (max 63 characters). ");
+  if (strlen(ssid) >= sizeof(settings.ssid)) appendError("WiFi SSID too long (max 63 characters). ");
+  if (strlen(password) >= sizeof(settings.password)) appendError("WiFi Password too long (max 63 characters). ");
+  if (strlen(location) >= sizeof(settings.City)) appendError("Location too long (max 127 characters). ");
+  SettingsLocation extraLocations[MAX_LOCATIONS - 1];
+  int extraCount = parseExtraLocations(extra, extraLocations);
+  if (extraCount < 0) appendError("Additional location too long (max 63 characters). ");
+  if (extraCount > MAX_LOCATIONS - 1) appendError("Too many additional locations (max 3). ");
+  if (units[0] && strcmp(units, "I") != 0 && strcmp(units, "M") != 0) {
+    appendError("Invalid Units value (must be 'I' or 'M'). ");
+  }
+
+  // Update Frequency: 1-1439 minutes, otherwise the default of 60
+  long sleepDuration = form["frequency"].is<long>() ? form["frequency"].as<long>() : settings.SleepDuration;
+  if (sleepDuration <= 0 || sleepDuration >= 1440) {
+    sleepDuration = 60;
 #if DEBUG_LEVEL
     if (Serial) {
-      Serial.println("Error: Location string is empty. Cannot geocode.");
+      Serial.println("Warning: Update Frequency out of range. Setting to default value of 60 minutes.");
     }
 #endif
-    return 2; // Other error (invalid location)
   }
-  
-  // Check if API key is set
-  if (strlen(settings.apikey) == 0) {
+
+  // Max Data Age: 0 disables the cache, otherwise 1-1439 minutes
+  int maxDataAge = form["maxAge"].is<int>() ? form["maxAge"].as<int>() : settings.MaxDataAge;
+  if (maxDataAge < 0 || maxDataAge >= 1440) {
+    maxDataAge = 0;
 #if DEBUG_LEVEL
     if (Serial) {
-      Serial.println("Error: API key is not set. Cannot geocode.");
+      Serial.println("Warning: Max Data Age out of range. Setting to 0 (always fetch).");
     }
 #endif
-    return 2; // Other error (missing API key, but not invalid API key)
   }
-  
-  // Connect to WiFi if not already connected
-  if (WiFi.status() != WL_CONNECTED) {
-    // Check if WiFi SSID is set
-    if (strlen(settings.ssid) == 0) {
-#if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("Error: WiFi SSID is not set. Cannot connect for geocoding.");
-      }
-#endif
-      return false;
-    }
-    
+
+  // Start Hour 0-23 (0 = none), Stop Hour 1-23 or 24 (none)
+  int wakeupHour = form["startHour"].is<int>() ? form["startHour"].as<int>() : settings.WakeupHour;
+  if (wakeupHour < 0 || wakeupHour > 23) appendError("Invalid Start Hour (must be 0-23 or 'none'). ");
+  int sleepHour = form["stopHour"].is<int>() ? form["stopHour"].as<int>() : settings.SleepHour;
+  if (sleepHour < 1 || sleepHour > 24) appendError("Invalid Stop Hour (must be 1-23 or 'none'). ");
+
+  int fleetRole = form["fleet"].is<int>() ? form["fleet"].as<int>() : settings.FleetRole;
+  if (fleetRole < FLEET_ROLE_STANDALONE || fleetRole > FLEET_ROLE_DISPLAY) appendError("Invalid Fleet Mode. ");
+
+  if (saveError[0]) {
 #if DEBUG_LEVEL
     if (Serial) {
-      Serial.print("Connecting to WiFi: ");
-      Serial.println(settings.ssid);
+      Serial.print("Validation error: ");
+      Serial.println(saveError);
     }
 #endif
-    
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(settings.ssid, settings.password);
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-      delay(500);
-#if DEBUG_LEVEL
-      if (Serial) {
-        Serial.print(".");
-      }
-#endif
-      attempts++;
-    }
+    return false;
+  }
+
+  // Start hour must be before stop hour, otherwise stop at the start hour (24 = never stop)
+  if (sleepHour != 24 && wakeupHour >= sleepHour) {
+    sleepHour = wakeupHour;
 #if DEBUG_LEVEL
     if (Serial) {
-      Serial.println();
+      Serial.printf("Warning: Start Hour (%d) is not less than Stop Hour. Setting Stop Hour to %d\n",
+                    wakeupHour, sleepHour);
     }
 #endif
-    
-    if (WiFi.status() != WL_CONNECTED) {
-#if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("Error: Failed to connect to WiFi for geocoding.");
-      }
-#endif
-      return 2; // Other error
+  }
+
+  bool locationChanged = strcmp(location, settings.City) != 0;
+  strlcpy(settings.apikey, apiKey, sizeof(settings.apikey));
+  strlcpy(settings.ssid, ssid, sizeof(settings.ssid));
+  strlcpy(settings.password, password, sizeof(settings.password));
+  strlcpy(settings.City, location, sizeof(settings.City));
+  if (units[0]) {
+    settings.Units[0] = units[0];
+  }
+  settings.SleepDuration = sleepDuration;
+  settings.WakeupHour = wakeupHour;
+  settings.SleepHour = sleepHour;
+  settings.MaxDataAge = maxDataAge;
+  settings.FleetRole = fleetRole;
+
+  // Coordinates: the candidate picked in the page, else the current ones if the location
+  // is unchanged, else the cached place for it. Failing all three, the setup-mode loop
+  // looks the location up before restarting.
+  JsonObject place = form["place"];
+  GeocodeResult result;
+  memset(&result, 0, sizeof(result));
+  bool resolved = false;
+  if (!place.isNull() && place["lat"].is<float>() && place["lon"].is<float>()) {
+    result.lat = place["lat"];
+    result.lon = place["lon"];
+    strlcpy(result.name, place["name"] | "", sizeof(result.name));
+    strlcpy(result.state, place["state"] | "", sizeof(result.state));
+    strlcpy(result.country, place["country"] | "", sizeof(result.country));
+    resolved = result.lat >= -90.0 && result.lat <= 90.0 && result.lon >= -180.0 && result.lon <= 180.0;
+    if (resolved) {
+      geocodeCachePut(location, &result);
     }
-    
+  }
+  if (resolved) {
+    geocodeApply(&result);
+  } else if (!locationChanged && geocodeHasCoordinates()) {
+    // Keep the coordinates already in settings
+  } else if (geocodeCacheGet(location, &result)) {
+    geocodeApply(&result);
+  } else {
+    strlcpy(settings.Latitude, "-181", sizeof(settings.Latitude));
+    strlcpy(settings.Longitude, "-181", sizeof(settings.Longitude));
+  }
+  for (int i = 0; i < extraCount; i++) {
+    resolveExtraLocation(&extraLocations[i]);
+  }
+  locationSetExtras(extraLocations, extraCount);
+
+  saveSettings();
 #if DEBUG_LEVEL
-    if (Serial) {
-      Serial.print("WiFi connected. IP address: ");
-      Serial.println(WiFi.localIP());
-    }
+  if (Serial) {
+    Serial.println("Settings saved to EEPROM successfully.");
+  }
 #endif
+  return true;
+}
+
+/**
+ * Parse a complete /save body in place and apply it.
+ */
+static void parseSaveBody(char *body, size_t length) {
+  StaticJsonDocument<SETUP_JSON_DOC_SIZE> doc;
+  // A writable char* input makes ArduinoJson keep pointers into the body instead of copying strings
+  DeserializationError error = deserializeJson(doc, body, length);
+  if (error || !doc.is<JsonObject>()) {
+    strlcpy(saveError, "Invalid request.", sizeof(saveError));
+    saveAccepted = false;
+    return;
   }
-  
-  // Build geocoding API request
-  // API endpoint: http://api.openweathermap.org/geo/1.0/direct?q={city name}&limit=1&appid={API key}
-  WiFiClient client;
-  HTTPClient http;
-  
-  String locationQuery = String(settings.City);
-  locationQuery.replace(" ", "+"); // URL encode spaces
-  locationQuery.replace(",", "%2C"); // URL encode commas
-  
-  String uri = "/geo/1.0/direct?q=" + locationQuery + "&limit=1&appid=" + String(settings.apikey);
-  
+  saveAccepted = applySettings(doc.as<JsonObject>());
+}
+
+/**
+ * Body of POST /save, called per TCP segment before the request handler.
+ * A body in one segment (the usual case) is parsed where it lies; a split body is
+ * collected in saveBody. Bodies over SETUP_MAX_BODY are ignored and refused with 413.
+ */
+static void handleSaveBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+  if (total > SETUP_MAX_BODY || index + len > total) {
+    return;
+  }
+  if (index == 0) {
+    saveRequest = request;
+    saveAccepted = false;
+    strlcpy(saveError, "Incomplete request.", sizeof(saveError));
+    if (len == total) {
+      parseSaveBody((char *)data, len);
+      return;
+    }
+  }
+  if (saveRequest != request) {
+    return; // Another phone started a save in between; this one is answered as incomplete
+  }
+  memcpy(saveBody + index, data, len);
+  if (index + len == total) {
+    parseSaveBody(saveBody, total);
+  }
+}
+
+static void requestRestart() {
+  restartRequestedAt = millis();
+  restartPending = true;
+}
+
+static void handleSave(AsyncWebServerRequest *request) {
+  if (request->contentLength() > SETUP_MAX_BODY) {
+    request->send(413, "application/json", "{\"ok\":false,\"error\":\"Request too large.\"}");
+    return;
+  }
+  if (saveRequest != request || !saveAccepted) {
+    StaticJsonDocument<256> reply;
+    reply["ok"] = false;
+    reply["error"] = (saveRequest == request) ? saveError : "Incomplete request.";
+    String json;
+    serializeJson(reply, json);
+    saveRequest = NULL;
+    request->send(400, "application/json", json);
+    return;
+  }
+  saveRequest = NULL;
+  resolveBeforeRestart = locationsUnresolved();
+  request->send(200, "application/json", resolveBeforeRestart ? "{\"ok\":true,\"resolved\":false}"
+                                                              : "{\"ok\":true,\"resolved\":true}");
 #if DEBUG_LEVEL
   if (Serial) {
-    Serial.print("Geocoding API request: ");
-    Serial.print("api.openweathermap.org");
-    Serial.println(uri);
+    Serial.println("Rebooting ESP32...");
   }
 #endif
-  
-  http.begin(client, "api.openweathermap.org", 80, uri);
-  int httpCode = http.GET();
-  
-  if (httpCode == HTTP_CODE_UNAUTHORIZED || httpCode == 401) {
-    // API key is invalid
+  requestRestart();
+}
+
+static void handleReboot(AsyncWebServerRequest *request) {
 #if DEBUG_LEVEL
-    if (Serial) {
-      Serial.print("Geocoding API error: Invalid API key. HTTP code: ");
-      Serial.println(httpCode);
-    }
+  if (Serial) {
+    Serial.println("\n=== Reboot Requested (No Save) ===");
+    Serial.println("Rebooting without saving settings...");
+  }
 #endif
-    http.end();
-    return 1; // API key invalid
+  request->send(200, "application/json", "{\"ok\":true}");
+  requestRestart();
+}
+
+const char *setupUpdatePin() {
+  if (!updatePin[0]) {
+    // Before WiFi is on, the hardware RNG only has entropy with the SAR ADC noise source enabled
+    bootloader_random_enable();
+    uint32_t pin = esp_random() % 1000000;
+    bootloader_random_disable();
+    snprintf(updatePin, sizeof(updatePin), "%06u", (unsigned)pin);
   }
-  
-  if (httpCode != HTTP_CODE_OK) {
-#if DEBUG_LEVEL
-    if (Serial) {
-      Serial.print("Geocoding API error. HTTP code: ");
-      Serial.println(httpCode);
+  return updatePin;
+}
+
+/**
+ * Whether an upload carries the update PIN. After SETUP_UPDATE_PIN_TRIES wrong ones,
+ * every upload is refused, so the PIN cannot be guessed by trying them all.
+ */
+static bool checkUpdatePin(AsyncWebServerRequest *request) {
+  if (updatePinFailures >= SETUP_UPDATE_PIN_TRIES) {
+    updateError = "Too many wrong PINs, restart the unit to try again.";
+    return false;
+  }
+  if (!request->hasParam("pin") || request->getParam("pin")->value() != setupUpdatePin()) {
+    updatePinFailures++;
+    updateError = "Wrong update PIN.";
+    return false;
+  }
+  updateError = NULL;
+  return true;
+}
+
+/**
+ * Body of POST /update?pin=... (firmware.bin or a packed image), written to the OTA
+ * partition per TCP segment as it arrives. A new upload abandons one that was left
+ * unfinished; one without the update PIN is refused before anything is written.
+ */
+static void handleUpdateBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+  if (index == 0) {
+    updateRequest = request;
+    updateAccepted = checkUpdatePin(request) && otaUploadBegin();
+  }
+  if (updateRequest != request || !updateAccepted) {
+    return;
+  }
+  updateAccepted = otaUploadWrite(data, len);
+  if (updateAccepted && index + len == total) {
+    updateAccepted = otaUploadEnd();
+  }
+}
+
+static void handleUpdate(AsyncWebServerRequest *request) {
+  if (updateRequest != request || !updateAccepted) {
+    const bool refused = (updateRequest == request && updateError);
+    StaticJsonDocument<192> reply;
+    reply["ok"] = false;
+    if (updateRequest != request) {
+      reply["error"] = "Incomplete upload.";
+    } else {
+      reply["error"] = refused ? updateError : otaUploadError();
     }
-#endif
-    http.end();
-    return 2; // Other error
+    String json;
+    serializeJson(reply, json);
+    updateRequest = NULL;
+    request->send(refused ? 403 : 400, "application/json", json);
+    return;
   }
-  
-  // Parse JSON response
-  // Expected format: [{"name":"...","lat":51.5085,"lon":-0.1257,"country":"GB",...}]
-  auto doc = DynamicJsonDocument(8192);
-  DeserializationError error = deserializeJson(doc, http.getStream());
-  http.end();
-  
-  if (error) {
+  updateRequest = NULL;
+  request->send(200, "application/json", "{\"ok\":true}");
 #if DEBUG_LEVEL
-    if (Serial) {
-      Serial.print("Failed to parse geocoding JSON: ");
-      Serial.println(error.c_str());
-    }
+  if (Serial) {
+    Serial.println("Firmware updated, rebooting...");
+  }
 #endif
-    return 2; // Other error
+  requestRestart();
+}
+
+/**
+ * The page: static, so it is sent as stored and revalidated by ETag.
+ */
+static void handlePage(AsyncWebServerRequest *request) {
+  if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == SETUP_PAGE_ETAG) {
+    request->send(304);
+    return;
   }
-  
-  // Check if response is an array with at least one result
-  if (!doc.is<JsonArray>() || doc.size() == 0) {
-#if DEBUG_LEVEL
-    if (Serial) {
-      Serial.println("Geocoding API returned no results.");
+  AsyncWebServerResponse *response = request->beginResponse_P(200, "text/html", setup_page_gz, sizeof(setup_page_gz));
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("Cache-Control", "no-cache"); // Cached, but checked against the ETag on every load
+  response->addHeader("ETag", SETUP_PAGE_ETAG);
+  request->send(response);
+}
+
+/**
+ * Current settings for the page to fill in its form.
+ */
+static void handleSettings(AsyncWebServerRequest *request) {
+  char extra[(MAX_LOCATIONS - 1) * LOCATION_NAME_LEN] = "";
+  for (int i = 1; i < locationCount(); i++) {
+    if (i > 1) strlcat(extra, "\n", sizeof(extra));
+    strlcat(extra, locationExtra(i)->City, sizeof(extra));
+  }
+
+  StaticJsonDocument<SETUP_JSON_DOC_SIZE> doc;
+  doc["apikey"]    = (const char *)settings.apikey; // Stored by pointer, not copied
+  doc["ssid"]      = (const char *)settings.ssid;
+  doc["password"]  = (const char *)settings.password;
+  doc["location"]  = (const char *)settings.City;
+  doc["units"]     = (const char *)settings.Units;
+  doc["frequency"] = settings.SleepDuration;
+  doc["maxAge"]    = settings.MaxDataAge;
+  doc["startHour"] = settings.WakeupHour;
+  doc["stopHour"]  = settings.SleepHour;
+  doc["fleet"]     = settings.FleetRole;
+  doc["locations"] = (const char *)extra;
+
+  AsyncResponseStream *response = request->beginResponseStream("application/json");
+  response->addHeader("Cache-Control", "no-store");
+  serializeJson(doc, *response);
+  request->send(response);
+}
+
+/**
+ * Wake timings and energy estimate (perf_log.h) as plain text.
+ */
+static void handlePerf(AsyncWebServerRequest *request) {
+  AsyncResponseStream *response = request->beginResponseStream("text/plain");
+  perfPrintReport(*response, 0);
+  request->send(response);
+}
+
+/**
+ * Send the candidates of a lookup.
+ *
+ * @param status "ok", "pending" (ask again shortly), "offline" (no station connection),
+ *               "invalid_key" or "error"
+ */
+static void sendLookup(AsyncWebServerRequest *request, const char *status, const GeocodeResult *results, int count) {
+  StaticJsonDocument<SETUP_JSON_DOC_SIZE * 2> doc;
+  doc["status"] = status;
+  JsonArray list = doc.createNestedArray("results");
+  for (int i = 0; i < count; i++) {
+    JsonObject place = list.createNestedObject();
+    place["name"]    = (const char *)results[i].name;
+    place["state"]   = (const char *)results[i].state;
+    place["country"] = (const char *)results[i].country;
+    place["lat"]     = results[i].lat;
+    place["lon"]     = results[i].lon;
+  }
+  AsyncResponseStream *response = request->beginResponseStream("application/json");
+  response->addHeader("Cache-Control", "no-store");
+  serializeJson(doc, *response);
+  request->send(response);
+}
+
+/**
+ * Live lookup: GET /geocode?q=<location>&key=<API key>.
+ * Answers from recent lookups or the NVS cache, otherwise queues the lookup for the
+ * loop and replies "pending"; the page polls until the result is in.
+ */
+static void handleGeocode(AsyncWebServerRequest *request) {
+  char query[GEOCODE_QUERY_LEN];
+  geocodeNormalize(request->hasParam("q") ? request->getParam("q")->value().c_str() : "", query, sizeof(query));
+  if (strlen(query) < 3) {
+    sendLookup(request, "ok", NULL, 0);
+    return;
+  }
+
+  LiveLookup lookup;
+  bool found = false;
+  bool pending = false;
+  portENTER_CRITICAL(&lookupLock);
+  for (int i = 0; i < SETUP_LIVE_LOOKUPS && !found; i++) {
+    if (strcmp(liveLookups[i].query, query) == 0) {
+      memcpy(&lookup, &liveLookups[i], sizeof(lookup));
+      found = true;
     }
-#endif
-    return 2; // Other error (invalid location)
   }
-  
-  // Get first result
-  JsonObject firstResult = doc[0];
-  if (!firstResult.containsKey("lat") || !firstResult.containsKey("lon")) {
+  pending = strcmp(queuedQuery, query) == 0 || strcmp(runningQuery, query) == 0;
+  portEXIT_CRITICAL(&lookupLock);
+
+  if (found) {
+    const char *status = (lookup.status == 0) ? "ok" : (lookup.status == 1) ? "invalid_key" : "error";
+    sendLookup(request, status, lookup.results, lookup.count);
+    return;
+  }
+  GeocodeResult cached;
+  if (!pending && geocodeCacheGet(query, &cached)) {
+    sendLookup(request, "ok", &cached, 1);
+    return;
+  }
+  if (WiFi.status() != WL_CONNECTED) {
+    sendLookup(request, "offline", NULL, 0);
+    return;
+  }
+  if (!pending) {
+    String key = request->hasParam("key") ? request->getParam("key")->value() : String(settings.apikey);
+    portENTER_CRITICAL(&lookupLock);
+    strlcpy(queuedQuery, query, sizeof(queuedQuery)); // The latest text replaces a lookup not yet started
+    strlcpy(queuedKey, key.c_str(), sizeof(queuedKey));
+    portEXIT_CRITICAL(&lookupLock);
+  }
+  sendLookup(request, "pending", NULL, 0);
+}
+
+/**
+ * Join the network typed in the page: POST /connect {"ssid":..., "password":...}.
+ * Small body, so it is only accepted in one segment; anything else is refused by handleConnect.
+ */
+static void handleConnectBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+  if (index == 0) {
+    connectRequest = NULL;
+  }
+  if (index != 0 || len != total || total > SETUP_MAX_BODY) {
+    return;
+  }
+  StaticJsonDocument<SETUP_JSON_DOC_SIZE> doc;
+  if (deserializeJson(doc, (char *)data, len) || strlen(doc["ssid"] | "") >= sizeof(connectSsid) ||
+      strlen(doc["password"] | "") >= sizeof(connectPassword)) {
+    return;
+  }
+  portENTER_CRITICAL(&lookupLock);
+  strlcpy(connectSsid, doc["ssid"] | "", sizeof(connectSsid));
+  strlcpy(connectPassword, doc["password"] | "", sizeof(connectPassword));
+  connectPending = true;
+  portEXIT_CRITICAL(&lookupLock);
+  connectRequest = request;
+}
+
+static void handleConnect(AsyncWebServerRequest *request) {
+  if (request->contentLength() > SETUP_MAX_BODY) {
+    request->send(413, "application/json", "{\"ok\":false,\"error\":\"Request too large.\"}");
+    return;
+  }
+  if (connectRequest != request) {
+    request->send(400, "application/json", "{\"ok\":false,\"error\":\"Invalid request.\"}");
+    return;
+  }
+  connectRequest = NULL;
+  request->send(200, "application/json", "{\"ok\":true}");
+}
+
+/**
+ * Run the work the handlers queued: joining a network and the latest location lookup.
+ */
+static void runQueuedWork() {
+  char ssid[sizeof(connectSsid)];
+  char password[sizeof(connectPassword)];
+  char query[GEOCODE_QUERY_LEN];
+  char key[sizeof(queuedKey)];
+  bool connect;
+  portENTER_CRITICAL(&lookupLock);
+  connect = connectPending;
+  connectPending = false;
+  memcpy(ssid, connectSsid, sizeof(ssid));
+  memcpy(password, connectPassword, sizeof(password));
+  memcpy(query, queuedQuery, sizeof(query));
+  memcpy(key, queuedKey, sizeof(key));
+  memcpy(runningQuery, queuedQuery, sizeof(runningQuery));
+  queuedQuery[0] = '\0';
+  portEXIT_CRITICAL(&lookupLock);
+
+  if (connect && ssid[0] && (strcmp(ssid, WiFi.SSID().c_str()) != 0 || WiFi.status() != WL_CONNECTED)) {
 #if DEBUG_LEVEL
     if (Serial) {
-      Serial.println("Geocoding API response missing lat/lon fields.");
+      Serial.print("Connecting to WiFi for location lookups: ");
+      Serial.println(ssid);
     }
 #endif
-    return 2; // Other error
+    WiFi.disconnect();
+    WiFi.begin(ssid, password);
   }
-  
-  float geocodedLat = firstResult["lat"].as<float>();
-  float geocodedLon = firstResult["lon"].as<float>();
-  
-  // Validate geocoded coordinates
-  if (geocodedLat < -90.0 || geocodedLat > 90.0 || 
-      geocodedLon < -180.0 || geocodedLon > 180.0) {
-#if DEBUG_LEVEL
-    if (Serial) {
-      Serial.println("Geocoding API returned invalid coordinates.");
+  if (!query[0]) {
+    return;
+  }
+
+  LiveLookup lookup;
+  memset(&lookup, 0, sizeof(lookup));
+  strlcpy(lookup.query, query, sizeof(lookup.query));
+  lookup.status = geocodeLookup(query, key, lookup.results, &lookup.count);
+
+  portENTER_CRITICAL(&lookupLock);
+  memcpy(&liveLookups[liveLookupNext], &lookup, sizeof(lookup));
+  liveLookupNext = (liveLookupNext + 1) % SETUP_LIVE_LOOKUPS;
+  runningQuery[0] = '\0';
+  portEXIT_CRITICAL(&lookupLock);
+}
+
+/**
+ * Saved without coordinates (nothing picked, nothing cached): look the locations up
+ * now, so the next boot does not need to. Additional locations take the first match.
+ */
+static void resolveSavedLocation() {
+  if (!resolveBeforeRestart || WiFi.status() != WL_CONNECTED) {
+    return;
+  }
+  GeocodeResult results[GEOCODE_MAX_RESULTS];
+  int count = 0;
+  bool changed = false;
+  if (settings.City[0] && !geocodeHasCoordinates() &&
+      geocodeLookup(settings.City, settings.apikey, results, &count) == 0 && count > 0) {
+    geocodeApply(&results[0]);
+    geocodeCachePut(settings.City, &results[0]);
+    changed = true;
+  }
+  SettingsLocation extraLocations[MAX_LOCATIONS - 1];
+  int extraCount = loadExtraLocations(extraLocations);
+  bool extraChanged = false;
+  for (int i = 0; i < extraCount; i++) {
+    SettingsLocation *location = &extraLocations[i];
+    if (locationHasCoordinates(location) ||
+        geocodeLookup(location->City, settings.apikey, results, &count) != 0 || count == 0) {
+      continue;
     }
-#endif
-    return 2; // Other error
+    strlcpy(location->Latitude, String(results[0].lat, 6).c_str(), sizeof(location->Latitude));
+    strlcpy(location->Longitude, String(results[0].lon, 6).c_str(), sizeof(location->Longitude));
+    geocodeCachePut(location->City, &results[0]);
+    extraChanged = true;
   }
-  
-  // Convert to strings and save to settings
-  String latStr = String(geocodedLat, 6); // 6 decimal places for precision
-  String lonStr = String(geocodedLon, 6);
-  
-  strncpy(settings.Latitude, latStr.c_str(), sizeof(settings.Latitude) - 1);
-  settings.Latitude[sizeof(settings.Latitude) - 1] = '\0';
-  strncpy(settings.Longitude, lonStr.c_str(), sizeof(settings.Longitude) - 1);
-  settings.Longitude[sizeof(settings.Longitude) - 1] = '\0';
-  
-  // Save to EEPROM
-  saveSettings();
-  
-#if DEBUG_LEVEL
-  if (Serial) {
-    Serial.print("Geocoding successful. Coordinates: ");
-    Serial.print(settings.Latitude);
-    Serial.print(", ");
-    Serial.println(settings.Longitude);
+  if (extraChanged) {
+    locationSetExtras(extraLocations, extraCount);
+  }
+  if (changed || extraChanged) {
+    saveSettings();
   }
-#endif
-  
-  return 0; // Success
 }
 
 /**
  * Run setup mode with WiFi Access Point and web server.
  * Creates an AP with SSID "ESP Weather" (no password) and serves a configuration page.
- * Based on: https://randomnerdtutorials.com/esp32-access-point-ap-web-server/
+ * Requests are handled by the async web server on its own task, so several phones
+ * can load the page at once; this loop only waits for a requested restart.
  */
 void runSetupMode() {
+  setupUpdatePin(); // Normally made for the setup screen already; must be before WiFi starts
+  
   // Set up WiFi Access Point
   const char* ap_ssid = "ESP Weather Station";
   const char* ap_password = "";  // No password
@@ -250,538 +722,41 @@ void runSetupMode() {
     Serial.print("Setting AP (Access Point)…");
   }
 #endif
+  WiFi.mode(WIFI_AP_STA); // Station side for location lookups
   WiFi.softAP(ap_ssid, ap_password);
+  if (strlen(settings.ssid) > 0) {
+    WiFi.begin(settings.ssid, settings.password);
+  }
   
-  IPAddress IP = WiFi.softAPIP();
 #if DEBUG_LEVEL
   if (Serial) {
     Serial.print("AP IP address: ");
-    Serial.println(IP);
+    Serial.println(WiFi.softAPIP());
     Serial.println("Web server started. Connect to WiFi 'ESP Weather Station' and navigate to http://192.168.4.1");
   }
 #endif
   
   // Start web server on port 80
-  WiFiServer server(80);
+  AsyncWebServer server(80);
+  server.on("/", HTTP_GET, handlePage);
+  server.on("/settings", HTTP_GET, handleSettings);
+  server.on("/save", HTTP_POST, handleSave, NULL, handleSaveBody);
+  server.on("/reboot", HTTP_POST, handleReboot);
+  server.on("/geocode", HTTP_GET, handleGeocode);
+  server.on("/connect", HTTP_POST, handleConnect, NULL, handleConnectBody);
+  server.on("/perf", HTTP_GET, handlePerf);
+  server.on("/update", HTTP_POST, handleUpdate, NULL, handleUpdateBody);
+  server.onNotFound([](AsyncWebServerRequest *request) {
+    request->redirect("/");
+  });
   server.begin();
   
-  // Main loop to handle web server requests
   while (true) {
-    WiFiClient client = server.available();   // Listen for incoming clients
-    
-    if (client) {                             // If a new client connects,
-#if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("New Client.");          // print a message out in the serial port
-      }
-#endif
-      String currentLine = "";                // make a String to hold incoming data from the client
-      String header = "";                     // Variable to store the HTTP request
-      
-      while (client.connected()) {            // loop while the client's connected
-        if (client.available()) {             // if there's bytes to read from the client,
-          char c = client.read();             // read a byte, then
-#if DEBUG_LEVEL
-          if (Serial && Serial.availableForWrite() > 0) {
-            Serial.write(c);                    // print it out the serial monitor
-          }
-#endif
-          header += c;
-          if (c == '\n') {                    // if the byte is a newline character
-            // if the current line is blank, you got two newline characters in a row.
-            // that's the end of the client HTTP request, so send a response:
-            if (currentLine.length() == 0) {
-              // HTTP headers always start with a response code (e.g. HTTP/1.1 200 OK)
-              // and a content-type so the client knows what's coming, then a blank line:
-              client.println("HTTP/1.1 200 OK");
-              client.println("Content-type:text/html");
-              client.println("Connection: close");
-              client.println();
-              
-              // Check if the "Reboot without Saving" button was pressed
-              bool isRebootRequest = (header.indexOf("GET /reboot") >= 0);
-              
-              if (isRebootRequest) {
-                // Reboot without saving
-#if DEBUG_LEVEL
-                if (Serial) {
-                  Serial.println("\n=== Reboot Requested (No Save) ===");
-                  Serial.println("Rebooting without saving settings...");
-                }
-#endif
-                
-                // Send response before rebooting
-                client.println("<!DOCTYPE html><html>");
-                client.println("<head><meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">");
-                client.println("<title>ESP Weather Setup</title>");
-                client.println("<body><h1>Rebooting...</h1>");
-                client.println("<p>ESP32 will reboot now without saving changes.</p>");
-                client.println("</body></html>");
-                client.println();
-                client.stop();
-                
-                // Reset the ESP32
-                delay(500);
-#if DEBUG_LEVEL
-                if (Serial) {
-                  Serial.println("Rebooting ESP32...");
-                }
-#endif
-                ESP.restart();
-              }
-              
-              // Check if the "Save and Reboot" button was pressed
-              bool isSaveRequest = (header.indexOf("GET /save") >= 0 || header.indexOf("/save?") >= 0);
-              
-              if (isSaveRequest) {
-                // Helper function to extract URL parameter value from header
-                auto extractParam = [](const String& header, const String& paramName) -> String {
-                  String searchStr = paramName + "=";
-                  int start = header.indexOf(searchStr);
-                  if (start < 0) return "";
-                  start += searchStr.length();
-                  int end = start;
-                  while (end < header.length() && 
-                         header.charAt(end) != ' ' && 
-                         header.charAt(end) != '&' && 
-                         header.charAt(end) != '\n' &&
-                         header.charAt(end) != '\r') {
-                    end++;
-                  }
-                  String value = header.substring(start, end);
-                  // Basic URL decoding
-                  value.replace("+", " ");
-                  value.replace("%20", " ");
-                  value.replace("%2B", "+");
-                  value.replace("%2C", ",");
-                  value.replace("%2F", "/");
-                  return value;
-                };
-                
-                // Extract all form parameters
-                String apiKey = extractParam(header, "apikey");
-                String ssid = extractParam(header, "ssid");
-                String password = extractParam(header, "password");
-                String location = extractParam(header, "location");
-                String units = extractParam(header, "units");
-                String frequency = extractParam(header, "frequency");
-                String startHour = extractParam(header, "startHour");
-                String stopHour = extractParam(header, "stopHour");
-                
-                // Print all received values to serial
-#if DEBUG_LEVEL
-                if (Serial) {
-                  Serial.println("\n=== Configuration Received ===");
-                  Serial.print("OpenWeatherMap API Key: ");
-                  Serial.println(apiKey.length() > 0 ? apiKey : "(empty)");
-                  Serial.print("WiFi SSID: ");
-                  Serial.println(ssid.length() > 0 ? ssid : "(empty)");
-                  Serial.print("WiFi Password: ");
-                  Serial.println(password.length() > 0 ? "***" : "(empty)");
-                  Serial.print("Location: ");
-                  Serial.println(location.length() > 0 ? location : "(empty)");
-                  Serial.print("Units: ");
-                  Serial.println(units.length() > 0 ? units : "(empty)");
-                  Serial.print("Update Frequency (minutes): ");
-                  Serial.println(frequency.length() > 0 ? frequency : "(empty)");
-                  Serial.print("Start Updating Hour: ");
-                  Serial.println(startHour.length() > 0 ? startHour : "(empty)");
-                  Serial.print("Stop Updating Hour: ");
-                  Serial.println(stopHour.length() > 0 ? stopHour : "(empty)");
-                  Serial.println("=== End Configuration ===\n");
-                  
-                  // Validate and save settings
-                  Serial.println("Validating and saving settings...");
-                }
-#endif
-                bool validationError = false;
-                String errorMessage = "";
-                
-                // Validate API Key (max 63 chars, allow empty but warn)
-                if (apiKey.length() > 63) {
-                  validationError = true;
-                  errorMessage += "API Key too long (max 63 characters). ";
-                }
-                
-                // Validate WiFi SSID (max 63 chars, allow empty but warn)
-                if (ssid.length() > 63) {
-                  validationError = true;
-                  errorMessage += "WiFi SSID too long (max 63 characters). ";
-                }
-                
-                // Validate WiFi Password (max 63 chars)
-                if (password.length() > 63) {
-                  validationError = true;
-                  errorMessage += "WiFi Password too long (max 63 characters). ";
-                }
-                
-                // Validate Location/City (max 127 chars)
-                if (location.length() > 127) {
-                  validationError = true;
-                  errorMessage += "Location too long (max 127 characters). ";
-                }
-                
-                // Validate Units (must be "I" or "M")
-                if (units.length() > 0 && units != "I" && units != "M") {
-                  validationError = true;
-                  errorMessage += "Invalid Units value (must be 'I' or 'M'). ";
-                }
-                
-                // Validate Update Frequency (must be a positive integer between 1 and 1439)
-                long sleepDuration = settings.SleepDuration; // Default to current value
-                if (frequency.length() > 0) {
-                  sleepDuration = frequency.toInt();
-                  if (sleepDuration <= 0 || sleepDuration >= 1440) {
-                    // Invalid value - set to default of 60 minutes
-                    sleepDuration = 60;
-#if DEBUG_LEVEL
-                    if (Serial) {
-                      Serial.println("Warning: Update Frequency out of range. Setting to default value of 60 minutes.");
-                    }
-#endif
-                  }
-                } else {
-                  // If no value provided, validate current value
-                  if (sleepDuration <= 0 || sleepDuration >= 1440) {
-                    sleepDuration = 60;
-#if DEBUG_LEVEL
-                    if (Serial) {
-                      Serial.println("Warning: Current Update Frequency is invalid. Setting to default value of 60 minutes.");
-                    }
-#endif
-                  }
-                }
-                
-                // Validate Start Hour (must be "none" or 0-23)
-                int wakeupHour = settings.WakeupHour; // Default to current value
-                if (startHour.length() > 0) {
-                  if (startHour == "none") {
-                    wakeupHour = 0;
-                  } else {
-                    int hour = startHour.toInt();
-                    if (hour < 0 || hour > 23) {
-                      validationError = true;
-                      errorMessage += "Invalid Start Hour (must be 0-23 or 'none'). ";
-                    } else {
-                      wakeupHour = hour;
-                    }
-                  }
-                }
-                
-                // Validate Stop Hour (must be "none" or 1-23)
-                // "none" maps to 24, otherwise 1 AM = 1, 2 AM = 2, ..., 11 PM = 23
-                int sleepHour = settings.SleepHour; // Default to current value
-                if (stopHour.length() > 0) {
-                  if (stopHour == "none") {
-                    sleepHour = 24; // "12 AM/None" maps to 24
-                  } else {
-                    int hour = stopHour.toInt();
-                    if (hour < 1 || hour > 23) {
-                      validationError = true;
-                      errorMessage += "Invalid Stop Hour (must be 1-23 or 'none'). ";
-                    } else {
-                      sleepHour = hour;
-                    }
-                  }
-                }
-                
-                // Validate that startHour is less than stopHour
-                // If not, set stopHour equal to startHour
-                // Note: If stopHour is 24 (never sleep), skip this check as 24 is a special value
-                if (!validationError && sleepHour != 24) {
-                  if (wakeupHour >= sleepHour) {
-                    // Start hour is not less than stop hour - set stopHour equal to startHour
-                    sleepHour = wakeupHour;
-#if DEBUG_LEVEL
-                    if (Serial) {
-                      Serial.print("Warning: Start Hour (");
-                      Serial.print(wakeupHour);
-                      Serial.print(") is not less than Stop Hour. Setting Stop Hour to ");
-                      Serial.println(sleepHour);
-                    }
-#endif
-                  }
-                }
-                
-                // If validation failed, send error response
-                if (validationError) {
-#if DEBUG_LEVEL
-                  if (Serial) {
-                    Serial.print("Validation error: ");
-                    Serial.println(errorMessage);
-                  }
-#endif
-                  client.println("<!DOCTYPE html><html>");
-                  client.println("<head><meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">");
-                  client.println("<title>ESP Weather Setup - Error</title>");
-                  client.println("<body><h1>Validation Error</h1>");
-                  client.print("<p style=\"color: red;\">");
-                  client.print(errorMessage);
-                  client.println("</p>");
-                  client.println("<p><a href=\"/\">Go back to form</a></p>");
-                  client.println("</body></html>");
-                  client.println();
-                  client.stop();
-                  return; // Don't reboot on validation error
-                }
-                
-                // All validation passed - save to settings structure
-#if DEBUG_LEVEL
-                if (Serial) {
-                  Serial.println("Validation passed. Saving to EEPROM...");
-                }
-#endif
-                
-                // Copy validated strings to settings (with length limits)
-                strncpy(settings.apikey, apiKey.c_str(), sizeof(settings.apikey) - 1);
-                settings.apikey[sizeof(settings.apikey) - 1] = '\0';
-                
-                strncpy(settings.ssid, ssid.c_str(), sizeof(settings.ssid) - 1);
-                settings.ssid[sizeof(settings.ssid) - 1] = '\0';
-                
-                strncpy(settings.password, password.c_str(), sizeof(settings.password) - 1);
-                settings.password[sizeof(settings.password) - 1] = '\0';
-                
-                strncpy(settings.City, location.c_str(), sizeof(settings.City) - 1);
-                settings.City[sizeof(settings.City) - 1] = '\0';
-                
-                // Set Units (use validated value or keep current)
-                if (units.length() > 0 && (units == "I" || units == "M")) {
-                  settings.Units[0] = units.charAt(0);
-                }
-                
-                // Set numeric values
-                settings.SleepDuration = sleepDuration;
-                settings.WakeupHour = wakeupHour;
-                settings.SleepHour = sleepHour;
-                
-                // Set Latitude and Longitude to invalid value (-181)
-                strncpy(settings.Latitude, "-181", sizeof(settings.Latitude) - 1);
-                settings.Latitude[sizeof(settings.Latitude) - 1] = '\0';
-                strncpy(settings.Longitude, "-181", sizeof(settings.Longitude) - 1);
-                settings.Longitude[sizeof(settings.Longitude) - 1] = '\0';
-                
-                // Save settings to EEPROM
-                saveSettings();
-#if DEBUG_LEVEL
-                if (Serial) {
-                  Serial.println("Settings saved to EEPROM successfully.");
-                }
-#endif
-                
-                // Send success response before resetting
-                client.println("<!DOCTYPE html><html>");
-                client.println("<head><meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">");
-                client.println("<title>ESP Weather Setup</title>");
-                client.println("<body><h1>Configuration Saved!</h1>");
-                client.println("<p>Settings have been saved to EEPROM.</p>");
-                client.println("<p>ESP32 will reboot now...</p>");
-                client.println("</body></html>");
-                client.println();
-                client.stop();
-                
-                // Reset the ESP32
-                delay(500);
-#if DEBUG_LEVEL
-                if (Serial) {
-                  Serial.println("Rebooting ESP32...");
-                }
-#endif
-                ESP.restart();
-              } else {
-                // Display the HTML web page (normal form)
-                client.println("<!DOCTYPE html><html>");
-                client.println("<head><meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">");
-                client.println("<title>ESP Weather Setup</title>");
-                client.println("<style>");
-                client.println("html { font-family: Helvetica; display: inline-block; margin: 0px auto; text-align: center; padding: 20px;}");
-                client.println("h1 { color: #0F3376; }");
-                client.println(".input-group { margin: 20px 0; }");
-                client.println("label { display: block; margin-bottom: 5px; font-weight: bold; }");
-                client.println("input[type=\"text\"], select { width: 300px; padding: 10px; font-size: 16px; border: 1px solid #ccc; border-radius: 4px; }");
-                client.println(".help-text { font-style: italic; font-size: 12px; color: #666; margin-top: 5px; }");
-                client.println(".button { background-color: #4CAF50; border: none; color: white; padding: 16px 40px;");
-                client.println("text-decoration: none; font-size: 20px; margin: 20px 10px; cursor: pointer; border-radius: 4px; }");
-                client.println(".button:hover { background-color: #45a049; }");
-                client.println("</style></head>");
-                
-                // Web Page Heading
-                client.println("<body><h1>ESP Weather Setup</h1>");
-                
-                // Form with all configuration fields (pre-populated with current settings)
-                client.println("<form action=\"/save\" method=\"GET\">");
-                
-                // Helper function to escape HTML special characters
-                auto escapeHtml = [](const String& str) -> String {
-                  String escaped = str;
-                  escaped.replace("&", "&amp;");
-                  escaped.replace("<", "&lt;");
-                  escaped.replace(">", "&gt;");
-                  escaped.replace("\"", "&quot;");
-                  escaped.replace("'", "&#39;");
-                  return escaped;
-                };
-                
-                // OpenWeatherMap API Key
-                client.println("<div class=\"input-group\">");
-                client.println("<label for=\"apikey\">OpenWeatherMap API Key:</label>");
-                client.print("<input type=\"text\" id=\"apikey\" name=\"apikey\" value=\"");
-                client.print(escapeHtml(String(settings.apikey)));
-                client.println("\" placeholder=\"Enter your API key\">");
-                client.println("</div>");
-                
-                // WiFi SSID
-                client.println("<div class=\"input-group\">");
-                client.println("<label for=\"ssid\">Wifi SSID:</label>");
-                client.print("<input type=\"text\" id=\"ssid\" name=\"ssid\" value=\"");
-                client.print(escapeHtml(String(settings.ssid)));
-                client.println("\" placeholder=\"Enter WiFi network name\">");
-                client.println("</div>");
-                
-                // WiFi Password
-                client.println("<div class=\"input-group\">");
-                client.println("<label for=\"password\">Wifi Password:</label>");
-                client.print("<input type=\"text\" id=\"password\" name=\"password\" value=\"");
-                client.print(escapeHtml(String(settings.password)));
-                client.println("\" placeholder=\"Enter WiFi password\">");
-                client.println("</div>");
-                
-                // Location
-                client.println("<div class=\"input-group\">");
-                client.println("<label for=\"location\">Location:</label>");
-                client.print("<input type=\"text\" id=\"location\" name=\"location\" value=\"");
-                client.print(escapeHtml(String(settings.City)));
-                client.println("\" placeholder=\"Chicago, IL, US\">");
-                client.println("<div class=\"help-text\">In the format Town/City, State/Province, Country; example 'Chicago, IL, US'</div>");
-                client.println("</div>");
-                
-                // Units dropdown
-                client.println("<div class=\"input-group\">");
-                client.println("<label for=\"units\">Units:</label>");
-                client.println("<select id=\"units\" name=\"units\">");
-                if (String(settings.Units) == "I") {
-                  client.println("<option value=\"I\" selected>Imperial</option>");
-                  client.println("<option value=\"M\">Metric</option>");
-                } else {
-                  client.println("<option value=\"I\">Imperial</option>");
-                  client.println("<option value=\"M\" selected>Metric</option>");
-                }
-                client.println("</select>");
-                client.println("</div>");
-                
-                // Update Frequency
-                client.println("<div class=\"input-group\">");
-                client.println("<label for=\"frequency\">Update Frequency (minutes):</label>");
-                client.print("<input type=\"text\" id=\"frequency\" name=\"frequency\" value=\"");
-                client.print(settings.SleepDuration);
-                client.println("\" placeholder=\"60\">");
-                client.println("</div>");
-                
-                // Start Updating Hour dropdown
-                client.println("<div class=\"input-group\">");
-                client.println("<label for=\"startHour\">Start Updating Hour:</label>");
-                client.println("<select id=\"startHour\" name=\"startHour\">");
-                int startHour = settings.WakeupHour;
-                for (int hour = 0; hour <= 23; hour++) {
-                  client.print("<option value=\"");
-                  if (hour == 0) {
-                    client.print("none");
-                  } else {
-                    client.print(hour);
-                  }
-                  client.print("\"");
-                  if ((hour == 0 && startHour == 0) || (hour == startHour && startHour != 0)) {
-                    client.print(" selected");
-                  }
-                  client.print(">");
-                  if (hour == 0) {
-                    client.print("12 AM/None");
-                  } else if (hour < 12) {
-                    client.print(hour);
-                    client.print(" AM");
-                  } else if (hour == 12) {
-                    client.print("12 PM");
-                  } else {
-                    client.print(hour - 12);
-                    client.print(" PM");
-                  }
-                  client.println("</option>");
-                }
-                client.println("</select>");
-                client.println("</div>");
-                
-                // Stop Updating Hour dropdown
-                client.println("<div class=\"input-group\">");
-                client.println("<label for=\"stopHour\">Stop Updating Hour:</label>");
-                client.println("<select id=\"stopHour\" name=\"stopHour\">");
-                int stopHour = settings.SleepHour;
-                
-                // First option: "12 AM/None" with value "none"
-                // Maps to sleepHour value of 24
-                client.print("<option value=\"none\"");
-                if (stopHour == 24) {  // "12 AM/None" maps to 24
-                  client.print(" selected");
-                }
-                client.println(">12 AM/None</option>");
-                
-                // Generate options from 1 AM to 11 PM in forward order
-                for (int hour = 1; hour <= 23; hour++) {
-                  client.print("<option value=\"");
-                  client.print(hour);
-                  client.print("\"");
-                  if (hour == stopHour) {
-                    client.print(" selected");
-                  }
-                  client.print(">");
-                  if (hour < 12) {
-                    client.print(hour);
-                    client.print(" AM");
-                  } else if (hour == 12) {
-                    client.print("12 PM");
-                  } else {
-                    client.print(hour - 12);
-                    client.print(" PM");
-                  }
-                  client.println("</option>");
-                }
-                client.println("</select>");
-                client.println("</div>");
-                
-                // Save and Reboot button (at the bottom)
-                client.println("<button type=\"submit\" class=\"button\">Save and Reboot</button>");
-                client.println("</form>");
-                
-                // Reboot without Saving button (separate form/link)
-                client.println("<form action=\"/reboot\" method=\"GET\" style=\"margin-top: 20px;\">");
-                client.println("<button type=\"submit\" class=\"button\" style=\"background-color: #f44336;\">Reboot without Saving</button>");
-                client.println("</form>");
-                
-                client.println("</body></html>");
-                client.println();
-              }
-              
-              // Break out of the while loop
-              break;
-            } else { // if you got a newline, then clear currentLine
-              currentLine = "";
-            }
-          } else if (c != '\r') {  // if you got anything else but a carriage return character,
-            currentLine += c;      // add it to the end of the currentLine
-          }
-        }  // End of if (client.available())
-      }  // End of while (client.connected())
-      // Clear the header variable
-      header = "";
-      // Close the connection
-      client.stop();
-#if DEBUG_LEVEL
-      if (Serial) {
-        Serial.println("Client disconnected.");
-        Serial.println("");
-      }
-#endif
+    if (restartPending && millis() - restartRequestedAt >= SETUP_RESTART_DELAY_MS) {
+      resolveSavedLocation();
+      ESP.restart();
     }
+    runQueuedWork();
     delay(10); // Small delay to prevent watchdog issues
   }
 }
-
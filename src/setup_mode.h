@@ -7,20 +7,18 @@
 /**
  * Run setup mode with WiFi Access Point and web server.
  * Creates an AP with SSID "ESP Weather" (no password) and serves a configuration page.
- * Based on: https://randomnerdtutorials.com/esp32-access-point-ap-web-server/
+ * The async web server answers any number of clients from its own task.
  * 
- * This function runs in an infinite loop, handling web server requests until the device is reset.
+ * This function never returns: it waits until a save or reboot request restarts the device.
  */
 void runSetupMode();
 
 /**
- * Validate and geocode location if latitude/longitude are invalid.
- * Checks if lat/lon are -181 (invalid). If so, uses OpenWeatherMap Geocoding API
- * to get valid coordinates from the location string and saves them to EEPROM.
- * 
- * @return 0 if location is valid or successfully geocoded, 1 if API key is invalid (401), 2 if other error (invalid location, etc.)
+ * PIN that a firmware upload in setup mode (POST /update) must carry: 6 random digits,
+ * made on first use and kept until the restart. Shown on the setup mode screen, so only
+ * someone who can see the panel can replace the firmware over the open access point.
  */
-int validateAndGeocodeLocation();
+const char *setupUpdatePin();
 
 #endif // __SETUP_MODE_H__
 
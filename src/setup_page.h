@@ -0,0 +1,234 @@
+#pragma once
+// Generated by tools/generate_setup_page.py from web/setup.html - do not edit by hand.
+// Setup mode page, gzip-compressed (3586 bytes, 10870 uncompressed).
+#include <Arduino.h>
+
+#define SETUP_PAGE_ETAG "\"0aa8b910\""
+
+static const uint8_t setup_page_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x5a, 0x7b, 0x73, 0xdb, 0x36,
+  0x12, 0xff, 0x5f, 0x9f, 0x02, 0x51, 0xe6, 0x4e, 0xf2, 0x54, 0xa6, 0xe4, 0x47, 0xdc, 0x46, 0x0f,
+  0x77, 0x52, 0xc7, 0x69, 0xdd, 0xb3, 0x13, 0x4f, 0xec, 0x5c, 0xe6, 0xc6, 0x93, 0xe9, 0x40, 0x24,
+  0x24, 0x21, 0xa6, 0x08, 0x86, 0x00, 0xad, 0xa8, 0xa9, 0xbf, 0xfb, 0xed, 0x2e, 0x00, 0x8a, 0x94,
+  0x25, 0x59, 0x4e, 0x3b, 0x9d, 0x54, 0x24, 0xb0, 0xbb, 0x58, 0xec, 0xe3, 0xb7, 0x0b, 0xd0, 0xfd,
+  0x67, 0xaf, 0xdf, 0x9d, 0x5c, 0xff, 0xef, 0xf2, 0x94, 0x4d, 0xcc, 0x34, 0x3e, 0xae, 0xf5, 0xfd,
+  0x8f, 0xe0, 0x11, 0xfc, 0x4c, 0x85, 0xe1, 0x2c, 0xe1, 0x53, 0x31, 0xa8, 0xdf, 0x49, 0x31, 0x4b,
+  0x55, 0x66, 0xea, 0x2c, 0x54, 0x89, 0x11, 0x89, 0x19, 0xd4, 0x67, 0x32, 0x32, 0x93, 0x41, 0x24,
+  0xee, 0x64, 0x28, 0x76, 0xe9, 0xa5, 0xc5, 0x64, 0x22, 0x8d, 0xe4, 0xf1, 0xae, 0x0e, 0x79, 0x2c,
+  0x06, 0x7b, 0x75, 0x2f, 0x24, 0x9c, 0xf0, 0x4c, 0x0b, 0x60, 0xca, 0xcd, 0x68, 0xf7, 0x27, 0x1c,
+  0x36, 0xd2, 0xc4, 0xe2, 0xf8, 0xf4, 0xea, 0x92, 0x7d, 0x14, 0xdc, 0x4c, 0x44, 0xc6, 0xae, 0x84,
+  0xc9, 0xd3, 0x7e, 0xdb, 0x4e, 0xd4, 0xfa, 0xda, 0xcc, 0xf1, 0x17, 0x35, 0x62, 0xdf, 0xd8, 0x08,
+  0x56, 0xdd, 0x1d, 0xf1, 0xa9, 0x8c, 0xe7, 0x5d, 0xf6, 0x9b, 0x88, 0xef, 0x84, 0x91, 0x21, 0xef,
+  0xb1, 0x48, 0xea, 0x34, 0xe6, 0x30, 0x26, 0x93, 0x58, 0x26, 0x62, 0x77, 0x18, 0xab, 0xf0, 0xb6,
+  0xc7, 0xa6, 0x3c, 0x1b, 0xcb, 0xa4, 0xcb, 0x3a, 0xe9, 0x57, 0xc6, 0x73, 0xa3, 0x7a, 0xcc, 0x88,
+  0xaf, 0x66, 0x97, 0xc7, 0x72, 0x0c, 0xa3, 0x21, 0xe8, 0x2f, 0xb2, 0x1e, 0x4b, 0x79, 0x14, 0xc9,
+  0x64, 0xdc, 0x65, 0xfb, 0x40, 0xd7, 0x63, 0xf7, 0xb5, 0xc9, 0x1e, 0x2c, 0x15, 0xaa, 0x58, 0x65,
+  0x5d, 0xf6, 0xbc, 0xf3, 0xe6, 0xe0, 0xe0, 0xc7, 0x23, 0x1c, 0x0e, 0x64, 0x92, 0xe6, 0x66, 0x77,
+  0x9c, 0xa9, 0x3c, 0x05, 0x02, 0x2f, 0x1c, 0xb9, 0x58, 0x07, 0x09, 0x62, 0x3e, 0x14, 0xa8, 0x65,
+  0xa1, 0x4d, 0x45, 0x8d, 0xdd, 0xa1, 0x32, 0x46, 0x4d, 0xbb, 0xec, 0x05, 0xae, 0x42, 0x3b, 0x99,
+  0x09, 0x39, 0x9e, 0x18, 0xa0, 0x53, 0x71, 0x84, 0x02, 0x68, 0x81, 0x1b, 0x33, 0x4f, 0xc1, 0xd4,
+  0xa8, 0x69, 0xfd, 0x53, 0x8b, 0x69, 0x11, 0x8b, 0xd0, 0xb4, 0x48, 0x73, 0x9e, 0x09, 0x0e, 0xf2,
+  0xc9, 0xca, 0x5d, 0x76, 0xd0, 0x21, 0x7d, 0x0b, 0xf5, 0xf7, 0x3a, 0x85, 0x60, 0x2d, 0xff, 0x14,
+  0x30, 0x70, 0x84, 0x03, 0x43, 0x95, 0x45, 0x02, 0x76, 0xb2, 0x07, 0x6a, 0x6a, 0x15, 0xcb, 0x88,
+  0x3d, 0x0f, 0xc3, 0xd0, 0x8f, 0xef, 0x66, 0x3c, 0x92, 0xb9, 0xee, 0xb2, 0x43, 0xbb, 0xf7, 0x60,
+  0x22, 0xe2, 0x74, 0x17, 0x17, 0xf3, 0xe6, 0x26, 0x0f, 0x80, 0x65, 0x0d, 0x98, 0x2d, 0xac, 0xca,
+  0xdf, 0x47, 0x1e, 0x6f, 0xa8, 0xa3, 0xa3, 0xa3, 0x62, 0xab, 0x46, 0xa5, 0x6e, 0x9f, 0x20, 0x71,
+  0x98, 0xc3, 0xbe, 0x13, 0x10, 0x37, 0xe4, 0xe1, 0x2d, 0x5a, 0x2f, 0x89, 0x76, 0x3d, 0xd3, 0xe1,
+  0xc9, 0xab, 0x37, 0x2f, 0x3a, 0x0b, 0x25, 0x13, 0x95, 0x88, 0x42, 0xe4, 0x6c, 0x22, 0x8d, 0x28,
+  0x6f, 0x10, 0xf6, 0xc3, 0x0e, 0x71, 0x97, 0x35, 0xf2, 0x63, 0x24, 0x42, 0x95, 0x71, 0x23, 0x55,
+  0xe2, 0x19, 0x4b, 0xca, 0x59, 0x67, 0x56, 0x9c, 0x64, 0x0d, 0x14, 0xe6, 0x99, 0x46, 0xe9, 0xa9,
+  0x92, 0xd6, 0xff, 0x6b, 0x0c, 0x61, 0xd5, 0xee, 0x4e, 0xd4, 0x1d, 0x44, 0xe5, 0x6a, 0xe5, 0x5f,
+  0xf0, 0xce, 0xe1, 0xcb, 0x32, 0x31, 0x78, 0x9e, 0x0f, 0x63, 0x11, 0xad, 0xa6, 0x7f, 0xf9, 0xf2,
+  0xe5, 0x62, 0xf9, 0x48, 0x8c, 0x78, 0x1e, 0x1b, 0xe4, 0x7e, 0x9e, 0x89, 0xa1, 0x52, 0x66, 0x35,
+  0xd3, 0xe8, 0xf0, 0xf0, 0xe0, 0x80, 0xe2, 0xef, 0xf9, 0x54, 0x68, 0xcd, 0xc7, 0xc2, 0x3b, 0x66,
+  0x39, 0x7a, 0xfc, 0x7c, 0x20, 0xb2, 0x4c, 0x65, 0x8b, 0x10, 0xce, 0x84, 0x9d, 0x86, 0x98, 0x0c,
+  0x85, 0x2e, 0xc5, 0x4f, 0xd5, 0x44, 0x2f, 0x8a, 0x24, 0x81, 0xfd, 0x10, 0xed, 0x8a, 0x50, 0x76,
+  0xac, 0x7b, 0x9d, 0xce, 0xbf, 0x4a, 0x8e, 0xf9, 0xa9, 0x2c, 0xe7, 0xd0, 0xa6, 0x43, 0x39, 0x4e,
+  0xc8, 0xa4, 0x8b, 0xbd, 0xd1, 0xae, 0xf0, 0xbf, 0x5e, 0xed, 0x29, 0xc1, 0xf9, 0xc0, 0x71, 0xe5,
+  0x64, 0x8e, 0xc5, 0xc8, 0x2c, 0x34, 0x0f, 0x6c, 0xd6, 0x2c, 0x39, 0x02, 0xd6, 0x8d, 0x46, 0xa3,
+  0x4e, 0xf4, 0x53, 0x21, 0x7f, 0x39, 0x0c, 0xef, 0x6b, 0xfd, 0xb6, 0x43, 0x9c, 0x7e, 0xdb, 0xc1,
+  0xdf, 0x50, 0x45, 0x73, 0x04, 0xc3, 0xbd, 0x55, 0x30, 0x05, 0xa3, 0xb5, 0xfe, 0x48, 0x65, 0x53,
+  0x26, 0xa3, 0x41, 0x5d, 0xe3, 0x20, 0xc2, 0x5a, 0x24, 0xef, 0x58, 0x18, 0x73, 0xad, 0x07, 0xf5,
+  0x12, 0x68, 0xe0, 0x8c, 0xc5, 0x08, 0xe0, 0x18, 0xd4, 0x79, 0x2a, 0x6f, 0xc5, 0xbc, 0x7e, 0xfc,
+  0x2e, 0x15, 0x89, 0x13, 0x7b, 0xc1, 0x53, 0xf6, 0xea, 0xf2, 0x8c, 0xfd, 0x47, 0xcc, 0xbb, 0xfd,
+  0x36, 0xd1, 0x02, 0x0f, 0x89, 0x60, 0x25, 0x58, 0xa0, 0xc5, 0x1c, 0xbb, 0x43, 0x66, 0xff, 0x36,
+  0xe5, 0x5f, 0x63, 0x91, 0x8c, 0x01, 0x92, 0xeb, 0x47, 0x07, 0x75, 0x46, 0xd6, 0x98, 0x40, 0x80,
+  0x08, 0x58, 0xf0, 0x14, 0xcd, 0xc6, 0xe6, 0x2a, 0xcf, 0x68, 0x11, 0x5a, 0x1c, 0xf6, 0x09, 0xca,
+  0x6e, 0xab, 0xb2, 0xd6, 0x32, 0xaa, 0x1f, 0x7f, 0x94, 0x23, 0xc9, 0xae, 0xae, 0xce, 0x5e, 0x3f,
+  0xaa, 0x23, 0xd1, 0x3b, 0x0d, 0xed, 0xf3, 0xe3, 0xfa, 0x7d, 0x94, 0x6f, 0x24, 0x4b, 0x84, 0x99,
+  0xa9, 0xec, 0x96, 0x58, 0x9f, 0xaa, 0x64, 0x0a, 0xf3, 0xc0, 0xec, 0x15, 0xbd, 0x74, 0xaf, 0x8f,
+  0x2a, 0x5b, 0xf0, 0x39, 0x85, 0x17, 0xef, 0x5b, 0x2a, 0xbd, 0x58, 0xf8, 0x69, 0x0a, 0x43, 0x6a,
+  0x11, 0x8a, 0xd5, 0x8f, 0xcf, 0xdd, 0xd3, 0xa3, 0xba, 0x16, 0x2c, 0x4e, 0xd7, 0xc5, 0x7b, 0x49,
+  0xd7, 0xbd, 0xfd, 0x1f, 0x97, 0x94, 0x3d, 0x99, 0x40, 0xb9, 0x1c, 0xab, 0x16, 0x3b, 0x3b, 0x6f,
+  0xb1, 0x0f, 0x57, 0x4b, 0xa1, 0x5a, 0x40, 0x7f, 0xfd, 0xf8, 0x2c, 0x61, 0x10, 0x8f, 0xa8, 0xde,
+  0x94, 0x1b, 0x76, 0xad, 0x66, 0x49, 0xfb, 0x44, 0x9a, 0x79, 0x8b, 0x5d, 0x19, 0x6e, 0x44, 0xfb,
+  0x32, 0x53, 0x77, 0x32, 0x09, 0x45, 0x8b, 0x9d, 0x40, 0x62, 0x99, 0x6c, 0xde, 0x63, 0xe2, 0x2b,
+  0x9f, 0xa6, 0xb1, 0x60, 0x8d, 0xa5, 0x35, 0x1a, 0x2b, 0x4c, 0xb1, 0x58, 0xc8, 0x6d, 0x46, 0xdd,
+  0xa2, 0x51, 0xca, 0x94, 0xe4, 0x10, 0x02, 0xac, 0xc5, 0xf8, 0xf7, 0xd8, 0x14, 0xd8, 0x5f, 0x01,
+  0x4a, 0xe1, 0x23, 0x8f, 0x99, 0xb7, 0xaf, 0x2e, 0x19, 0xb8, 0x28, 0xac, 0x65, 0xbb, 0xea, 0x65,
+  0xc3, 0xc2, 0x40, 0xa6, 0x66, 0xb0, 0xe4, 0xb2, 0xff, 0xcf, 0x55, 0x12, 0xa9, 0xa4, 0xc5, 0x7e,
+  0xfd, 0x05, 0x15, 0xf5, 0xc2, 0xd6, 0x1a, 0xf6, 0x43, 0xca, 0x8c, 0x62, 0x07, 0x6c, 0xaa, 0x32,
+  0xb0, 0x1e, 0x14, 0x2d, 0x96, 0x42, 0xf8, 0x60, 0xd3, 0x02, 0xbd, 0x0b, 0xd9, 0x5c, 0xc3, 0xba,
+  0xce, 0xf0, 0x3d, 0x1a, 0x70, 0x18, 0xcc, 0xf4, 0x04, 0x14, 0x20, 0x16, 0xaf, 0x14, 0xf1, 0xe6,
+  0x69, 0x04, 0x2e, 0x01, 0x59, 0x19, 0x51, 0x27, 0x58, 0xba, 0x91, 0x68, 0x36, 0x11, 0x56, 0xa0,
+  0xab, 0xbf, 0x52, 0xb3, 0x34, 0x83, 0x0a, 0x21, 0xa2, 0x80, 0x9d, 0xf2, 0x70, 0x82, 0x03, 0x68,
+  0x79, 0x00, 0x49, 0xe8, 0x67, 0x86, 0x02, 0x96, 0x14, 0x44, 0x9f, 0x43, 0xf7, 0x06, 0x45, 0x43,
+  0xc3, 0x46, 0x8c, 0x66, 0x3c, 0x89, 0x98, 0xe1, 0xb7, 0x50, 0x38, 0x28, 0x20, 0x64, 0xa6, 0x0d,
+  0xc4, 0x98, 0x09, 0x27, 0xdf, 0xe3, 0x15, 0x14, 0x0d, 0x1e, 0xf9, 0x80, 0x3f, 0x25, 0x17, 0x58,
+  0xb4, 0x26, 0x07, 0x58, 0x0a, 0x67, 0x7c, 0x47, 0x5e, 0xeb, 0xab, 0x94, 0xb6, 0x7b, 0xc7, 0xe3,
+  0x1c, 0x86, 0xcf, 0x20, 0x3e, 0xa7, 0xb0, 0x75, 0x68, 0x31, 0xfb, 0x6d, 0x3b, 0xf5, 0x80, 0xe6,
+  0xa2, 0x7e, 0x7c, 0x21, 0x4c, 0x26, 0xc3, 0x12, 0x45, 0xdb, 0xae, 0xf3, 0x44, 0x9d, 0x47, 0x99,
+  0xf8, 0x92, 0x8b, 0x24, 0x9c, 0xa3, 0xf3, 0xd0, 0xd4, 0xec, 0x8d, 0x1f, 0x61, 0xcd, 0xa9, 0x4c,
+  0x72, 0x23, 0xf4, 0xce, 0xa3, 0x09, 0xbb, 0x90, 0xe2, 0xf6, 0x56, 0x1a, 0x20, 0x8e, 0xa9, 0x8a,
+  0x60, 0x34, 0xc9, 0xa7, 0xb0, 0xaf, 0x70, 0x29, 0xc6, 0x8e, 0x3a, 0x4f, 0x85, 0x14, 0x40, 0x81,
+  0x57, 0x63, 0x40, 0xce, 0x0b, 0xfe, 0x95, 0xbd, 0xe6, 0xd0, 0x7a, 0xc3, 0xdb, 0x13, 0xb4, 0x75,
+  0xec, 0x4e, 0x55, 0xff, 0xf6, 0xa8, 0x9e, 0x9d, 0xf5, 0x80, 0xf2, 0x5e, 0x44, 0x19, 0x9f, 0xb1,
+  0x51, 0xa6, 0xa6, 0x14, 0x48, 0x40, 0x60, 0x50, 0x55, 0x11, 0xe2, 0xc3, 0x4c, 0x9a, 0x89, 0x02,
+  0x3d, 0x72, 0x0d, 0xfd, 0x84, 0x05, 0x53, 0x80, 0x15, 0x19, 0x43, 0xd7, 0x89, 0x61, 0x6a, 0x26,
+  0xf0, 0x3f, 0xea, 0x72, 0x3a, 0x6c, 0x24, 0x20, 0xf6, 0x04, 0xe6, 0x01, 0x13, 0xd0, 0x99, 0xcd,
+  0x5d, 0xfc, 0x7f, 0x4f, 0x34, 0x52, 0x84, 0xff, 0x06, 0xe5, 0xb0, 0x7e, 0x7c, 0x85, 0x8f, 0x8c,
+  0xfc, 0x8b, 0x1a, 0xe0, 0xe0, 0xea, 0xf8, 0x5c, 0xf0, 0xf8, 0xb2, 0xb6, 0x10, 0xf2, 0x9d, 0x01,
+  0xa6, 0xa1, 0x5b, 0xf6, 0x5a, 0xa8, 0x74, 0x3b, 0x25, 0x1c, 0x47, 0xa1, 0x83, 0x97, 0xf0, 0xbd,
+  0x31, 0x1e, 0x0b, 0x01, 0x4e, 0x7a, 0x83, 0x3f, 0xec, 0x02, 0x3c, 0xbc, 0x7a, 0x5d, 0x4b, 0xe6,
+  0x03, 0xd8, 0xf2, 0x2c, 0x27, 0x5e, 0x87, 0x8c, 0x09, 0x0d, 0x2c, 0x8f, 0x01, 0x85, 0xd6, 0xe6,
+  0x27, 0x1c, 0x0a, 0x7f, 0x05, 0xb7, 0xcd, 0xf8, 0x7c, 0x2d, 0xc9, 0x7e, 0xfd, 0xf8, 0xb5, 0x85,
+  0xbe, 0x95, 0x39, 0xbc, 0x3a, 0xce, 0x3e, 0x42, 0x24, 0xc1, 0x99, 0x09, 0x22, 0x03, 0xe0, 0xde,
+  0x21, 0x27, 0x05, 0x0b, 0x42, 0x62, 0xb9, 0xb5, 0xb0, 0xe0, 0x3b, 0xe5, 0x32, 0xd1, 0xbb, 0xa9,
+  0x9a, 0x09, 0xe8, 0x92, 0xd9, 0xd8, 0x6a, 0x54, 0xc4, 0x98, 0x2b, 0x81, 0x36, 0x46, 0x11, 0x08,
+  0xb5, 0x48, 0x22, 0x8d, 0x41, 0x09, 0x18, 0x5e, 0x82, 0x66, 0xdd, 0xc2, 0xb3, 0x0a, 0x40, 0x2a,
+  0x31, 0xd2, 0xfc, 0x44, 0x4c, 0x35, 0x9e, 0x4f, 0x71, 0xed, 0x78, 0xce, 0xe4, 0x88, 0xe8, 0xfd,
+  0x02, 0x91, 0x82, 0x89, 0x44, 0xa1, 0x50, 0x0d, 0x4b, 0x2f, 0x05, 0x6f, 0x6a, 0x73, 0xd0, 0x76,
+  0xf3, 0xe8, 0xd3, 0x14, 0xdb, 0x50, 0x8b, 0xe2, 0x36, 0x53, 0x75, 0x3e, 0x9c, 0x4a, 0x3c, 0x85,
+  0xdb, 0xfd, 0xdb, 0x39, 0xd7, 0x72, 0xf1, 0x3b, 0x48, 0x55, 0x7f, 0x10, 0x39, 0xbe, 0x82, 0x57,
+  0x52, 0xfd, 0x3d, 0x9d, 0x31, 0xfa, 0x6d, 0x4b, 0x8b, 0x8b, 0x61, 0x8d, 0x59, 0x16, 0xec, 0x25,
+  0xad, 0x10, 0x6c, 0x0f, 0x29, 0x98, 0xc9, 0x74, 0x58, 0xf1, 0x29, 0x0b, 0x0b, 0x40, 0xb0, 0x96,
+  0xe4, 0x6e, 0x17, 0x70, 0x32, 0x9b, 0xce, 0xa0, 0x50, 0x42, 0xcc, 0xb9, 0x27, 0x1b, 0xf7, 0x62,
+  0x0d, 0x34, 0x8d, 0x64, 0x2c, 0x1c, 0x90, 0x7a, 0x4e, 0xc6, 0xc3, 0x50, 0xa4, 0x66, 0x50, 0x0f,
+  0x86, 0x32, 0x69, 0x05, 0xca, 0xf0, 0xfa, 0x5a, 0x3c, 0xb3, 0x18, 0x71, 0x29, 0x93, 0xd5, 0x20,
+  0x56, 0xee, 0xef, 0x96, 0x20, 0xcd, 0x41, 0xfe, 0xe5, 0xd9, 0xdb, 0xf5, 0xd8, 0xe6, 0x55, 0x42,
+  0x45, 0x16, 0x08, 0x37, 0xcc, 0x65, 0x1c, 0x51, 0x59, 0x2e, 0xe6, 0x41, 0x47, 0x37, 0xaf, 0x54,
+  0xac, 0xdb, 0x29, 0x9c, 0x4c, 0xfe, 0x80, 0xb1, 0x3f, 0xe4, 0x14, 0x8f, 0x6d, 0x29, 0xb4, 0x57,
+  0x54, 0x6d, 0xb1, 0x06, 0x17, 0xcb, 0x52, 0xd9, 0xc7, 0xf0, 0x2d, 0x07, 0x5c, 0xc0, 0xae, 0x1f,
+  0x14, 0x6a, 0x38, 0x14, 0x29, 0x0c, 0x3d, 0x05, 0x7d, 0x19, 0xfe, 0x4e, 0xb8, 0x86, 0xaa, 0x0e,
+  0x3d, 0xc0, 0x2c, 0x93, 0xc6, 0xc0, 0x2f, 0xca, 0x86, 0xb0, 0x0e, 0xa1, 0xe2, 0x07, 0x3e, 0xd4,
+  0xb6, 0x75, 0x7e, 0x9e, 0xc6, 0x8a, 0x47, 0x58, 0x01, 0xf1, 0x97, 0x79, 0xa7, 0x95, 0xdc, 0x9e,
+  0x96, 0xe8, 0x2e, 0xaa, 0xa1, 0xeb, 0xc3, 0xfa, 0xb8, 0xcf, 0xd9, 0x24, 0x13, 0xa3, 0x41, 0xbd,
+  0x0d, 0xd5, 0x7b, 0x04, 0xc9, 0x0a, 0x7d, 0x05, 0xf4, 0x20, 0x63, 0x52, 0x4d, 0x24, 0x22, 0x1b,
+  0xcf, 0x19, 0x6c, 0x07, 0xcc, 0x81, 0x80, 0xce, 0x1d, 0xbb, 0x0e, 0x33, 0x99, 0x42, 0xc6, 0xdf,
+  0xf1, 0x8c, 0xfa, 0x22, 0x36, 0x80, 0xfc, 0x09, 0xc1, 0x77, 0x89, 0x09, 0xc6, 0xc2, 0x9c, 0xc6,
+  0x02, 0x1f, 0x7f, 0x99, 0x9f, 0x45, 0xcd, 0x06, 0x9d, 0xc0, 0x1a, 0x3b, 0x3d, 0x22, 0xf6, 0xe7,
+  0xe5, 0x0d, 0xf4, 0x8e, 0xc4, 0x73, 0xd8, 0x4e, 0xf4, 0x1a, 0x5b, 0xa8, 0x0d, 0x4c, 0x96, 0xca,
+  0xf3, 0xb8, 0x63, 0xf5, 0x06, 0x7a, 0x4b, 0xe1, 0xe9, 0xfd, 0xd1, 0xf4, 0x92, 0x8e, 0xd8, 0x03,
+  0x96, 0xe4, 0x71, 0xdc, 0x63, 0xed, 0x36, 0x3b, 0x01, 0x2b, 0x48, 0x72, 0x7b, 0x2a, 0xd1, 0x49,
+  0xb8, 0x59, 0x72, 0x3a, 0xdd, 0xc6, 0xb8, 0xee, 0xb0, 0x68, 0xfd, 0x46, 0x52, 0xc4, 0x51, 0x59,
+  0x69, 0x09, 0xc1, 0xec, 0xc5, 0xd5, 0x40, 0x5c, 0x87, 0xac, 0xba, 0x7f, 0x08, 0x67, 0x5d, 0x80,
+  0xc4, 0xa9, 0xe0, 0x09, 0xab, 0x27, 0x0a, 0x5a, 0x4d, 0x42, 0x8e, 0x26, 0x45, 0x0d, 0x83, 0xe6,
+  0x7e, 0x2a, 0xa3, 0x04, 0x2f, 0x12, 0x58, 0x1b, 0xa0, 0x11, 0xef, 0x3a, 0xb0, 0x9a, 0xec, 0xd4,
+  0x46, 0x79, 0x12, 0xd2, 0x42, 0x90, 0xe5, 0xd9, 0x39, 0xa6, 0x64, 0x73, 0xb2, 0xc3, 0xbe, 0xd5,
+  0x00, 0xc9, 0x9a, 0x13, 0x36, 0x18, 0x80, 0xfc, 0xbf, 0xfe, 0x62, 0xf4, 0xb4, 0x7f, 0xb8, 0x03,
+  0x61, 0x68, 0xf2, 0x2c, 0x61, 0x8d, 0xbd, 0x7d, 0xf6, 0xea, 0xa2, 0xfd, 0x16, 0xb0, 0xb5, 0xd1,
+  0x73, 0xb4, 0x7d, 0xb6, 0xb7, 0x5f, 0x10, 0x4c, 0xd8, 0x0f, 0xac, 0x01, 0x24, 0xc5, 0x2c, 0xf0,
+  0x97, 0xa6, 0x91, 0xff, 0x12, 0x27, 0xdd, 0x3b, 0x10, 0xec, 0xd2, 0x3c, 0x72, 0xd1, 0xc4, 0xfd,
+  0x42, 0x33, 0x1e, 0x45, 0x58, 0xf5, 0x74, 0xd3, 0xdf, 0x91, 0xa1, 0xaa, 0x1a, 0x95, 0xa4, 0x87,
+  0x00, 0xec, 0x87, 0x8d, 0x6e, 0xb3, 0x60, 0xb0, 0x3b, 0x40, 0x9b, 0xb9, 0x4a, 0x53, 0x72, 0x5a,
+  0x08, 0x5d, 0xbb, 0x11, 0xce, 0x6f, 0xcd, 0x86, 0x25, 0x40, 0x9f, 0xd9, 0xa7, 0x80, 0x8a, 0x12,
+  0x30, 0x4c, 0x8a, 0x11, 0x74, 0xcb, 0x89, 0xbd, 0x06, 0xc5, 0xf1, 0x92, 0x99, 0x7a, 0x35, 0xab,
+  0x51, 0xc0, 0x53, 0x38, 0xdb, 0x47, 0x70, 0x22, 0x8a, 0xa3, 0xa6, 0xe5, 0x82, 0xb9, 0xfb, 0x9d,
+  0xca, 0x2e, 0x30, 0xbf, 0x9b, 0x28, 0xab, 0x05, 0xad, 0xce, 0x29, 0x5e, 0xdd, 0xa0, 0x92, 0xfe,
+  0x2e, 0xa7, 0xba, 0x08, 0xbe, 0xf5, 0x8a, 0x39, 0xca, 0xd3, 0xb7, 0x78, 0x5c, 0x18, 0x78, 0x56,
+  0xf6, 0x33, 0x6b, 0xd0, 0xf5, 0x4f, 0x83, 0x75, 0x59, 0x83, 0xcc, 0x45, 0x31, 0xe7, 0x9b, 0x14,
+  0x8c, 0xd3, 0x1b, 0xbc, 0x55, 0x74, 0x1d, 0x03, 0xbd, 0xef, 0x1f, 0x7e, 0xea, 0xd5, 0x30, 0xd8,
+  0x9a, 0x48, 0x0b, 0x2e, 0xc1, 0xfb, 0x1b, 0xf0, 0x1b, 0x78, 0xf6, 0x00, 0x1e, 0x7e, 0xf8, 0x61,
+  0xa7, 0x24, 0x20, 0x48, 0x73, 0x3d, 0xa1, 0x3d, 0x56, 0x38, 0xf6, 0x1e, 0x72, 0xb8, 0x15, 0x16,
+  0x0c, 0x85, 0xbf, 0x30, 0x8b, 0x83, 0x42, 0x64, 0xab, 0x24, 0x7d, 0x05, 0x95, 0x15, 0x53, 0x52,
+  0x19, 0x97, 0xc6, 0x3a, 0xdb, 0x6c, 0x40, 0x33, 0x60, 0xb0, 0x55, 0x82, 0xdc, 0x0a, 0x20, 0x39,
+  0x92, 0x92, 0xa7, 0xd1, 0x88, 0x3e, 0xa8, 0xb2, 0xe0, 0xb3, 0x56, 0x49, 0x73, 0xa7, 0xc7, 0xee,
+  0x1f, 0xd0, 0x51, 0xb8, 0xdc, 0x34, 0xec, 0xf5, 0x49, 0xa3, 0xc5, 0x1a, 0x78, 0x4d, 0x81, 0xbf,
+  0xfe, 0x30, 0x8f, 0xcf, 0x3e, 0xe9, 0xca, 0xcf, 0x1a, 0x5f, 0xe8, 0x80, 0x82, 0x0f, 0x45, 0x37,
+  0x8f, 0x2f, 0xb6, 0x5f, 0x26, 0x61, 0x7e, 0x63, 0xf6, 0xc5, 0x6e, 0x80, 0xe8, 0xb1, 0x79, 0x6a,
+  0x7c, 0x5a, 0x11, 0xa2, 0xb7, 0xa8, 0x10, 0x6e, 0xfd, 0xe6, 0xf6, 0x53, 0x11, 0x74, 0x1a, 0x5e,
+  0x6c, 0xe0, 0x58, 0xa3, 0x40, 0x51, 0x0f, 0x8a, 0xbb, 0xc6, 0x01, 0x1b, 0xf1, 0x58, 0x0b, 0x9c,
+  0x0f, 0x42, 0x3c, 0x99, 0x95, 0xa4, 0xa1, 0x30, 0x0a, 0xb0, 0x06, 0x1c, 0xd4, 0xe3, 0x88, 0x7a,
+  0x0e, 0x42, 0x70, 0xc4, 0x92, 0x30, 0xcf, 0x32, 0x8c, 0x2b, 0x6f, 0xc5, 0x16, 0x18, 0xac, 0x98,
+  0x4c, 0x11, 0x39, 0xb1, 0xcd, 0x81, 0x16, 0x9b, 0x8f, 0xa1, 0x4d, 0x0a, 0x40, 0x6f, 0x93, 0xe5,
+  0xc2, 0x45, 0x70, 0xb1, 0x06, 0xa1, 0x9b, 0x8d, 0xfc, 0x14, 0x97, 0x73, 0x46, 0xbf, 0x49, 0x03,
+  0xec, 0x13, 0x5b, 0x2c, 0x45, 0x4f, 0x1b, 0x7a, 0x08, 0xed, 0x65, 0x01, 0x6c, 0x5b, 0xc6, 0x46,
+  0x64, 0x25, 0x3d, 0x53, 0xb0, 0x53, 0xc9, 0x63, 0xf8, 0x4a, 0xde, 0xfa, 0xac, 0x64, 0xd2, 0x44,
+  0x83, 0x3d, 0xcc, 0x19, 0xc2, 0x4f, 0xdd, 0x84, 0xfa, 0x97, 0xc7, 0x86, 0xdc, 0x68, 0x71, 0x36,
+  0x90, 0x09, 0x54, 0x92, 0xdf, 0xae, 0x2f, 0xce, 0xc1, 0x32, 0x0d, 0x82, 0x12, 0xa2, 0x58, 0x61,
+  0xeb, 0xd4, 0xc3, 0x81, 0x2b, 0x83, 0xeb, 0xe1, 0xc0, 0x12, 0xa0, 0x16, 0xf6, 0x29, 0xc0, 0x8a,
+  0x89, 0xf2, 0xdd, 0x44, 0x31, 0x5e, 0xce, 0x49, 0x0b, 0xfc, 0x0d, 0xc0, 0xae, 0xe6, 0x12, 0xe8,
+  0x03, 0xe8, 0xa5, 0x98, 0xaa, 0x45, 0x31, 0xb0, 0xe9, 0x5a, 0x12, 0x5f, 0x49, 0xfb, 0xaa, 0x89,
+  0x11, 0x0a, 0x9b, 0x28, 0x35, 0x0d, 0x62, 0x6e, 0x02, 0xa3, 0xde, 0xc8, 0xaf, 0x22, 0x6a, 0x5a,
+  0x90, 0x04, 0x53, 0xd9, 0x19, 0x14, 0x52, 0x99, 0xd9, 0x59, 0x28, 0x09, 0x29, 0x76, 0x7a, 0x07,
+  0xa2, 0xcf, 0xa5, 0x36, 0x58, 0x76, 0x9b, 0x8d, 0x30, 0x86, 0x92, 0x03, 0xcc, 0x4b, 0x91, 0xb3,
+  0x54, 0xaa, 0x52, 0x17, 0x7f, 0x3e, 0x07, 0x8a, 0xf8, 0xac, 0x28, 0xd8, 0xab, 0x2d, 0xca, 0xe8,
+  0xd2, 0x46, 0x1a, 0xfe, 0x02, 0x06, 0x63, 0x2e, 0x00, 0x85, 0x56, 0x38, 0xd2, 0x86, 0x97, 0xf3,
+  0x65, 0x19, 0x40, 0xad, 0xf2, 0x05, 0x80, 0x42, 0x89, 0x2b, 0x9a, 0x20, 0xdb, 0x46, 0x6b, 0x56,
+  0x47, 0x6a, 0x08, 0xe5, 0x3a, 0xf6, 0xe3, 0x31, 0xb5, 0x41, 0x5c, 0xdf, 0x6a, 0x56, 0xbd, 0x62,
+  0xed, 0xe1, 0xa0, 0x0d, 0x6a, 0x77, 0xcc, 0xc4, 0x80, 0xb7, 0x32, 0xf0, 0xb8, 0x29, 0x93, 0x45,
+  0xa4, 0xd9, 0xad, 0x34, 0x7d, 0xa0, 0x7c, 0xc1, 0x6c, 0x7b, 0x68, 0x82, 0xc0, 0x64, 0x72, 0x0a,
+  0x00, 0x53, 0x0b, 0x63, 0xc1, 0x33, 0x2c, 0xc5, 0xd0, 0x1a, 0x37, 0x4b, 0x85, 0x79, 0xc7, 0x96,
+  0xbb, 0x2f, 0x81, 0xed, 0x33, 0xa1, 0x26, 0x1e, 0xa0, 0xc8, 0xf5, 0x86, 0xaa, 0xda, 0xe6, 0xe6,
+  0xd3, 0x8e, 0x2f, 0x89, 0x94, 0x07, 0x0e, 0xfe, 0xc6, 0x42, 0x85, 0xd0, 0xc9, 0xfe, 0xfc, 0x65,
+  0x80, 0x4e, 0x07, 0xf8, 0x81, 0x97, 0x0f, 0xef, 0xcf, 0x4e, 0xd4, 0x34, 0x85, 0x02, 0x0c, 0x71,
+  0xfb, 0x85, 0x3c, 0xff, 0x6f, 0x80, 0xb6, 0x75, 0x14, 0xb4, 0x19, 0x8b, 0x7e, 0x95, 0xad, 0xec,
+  0xec, 0xd4, 0xbe, 0x17, 0x52, 0x33, 0xdf, 0x26, 0xac, 0x37, 0x14, 0x7b, 0x06, 0x19, 0xf0, 0xc5,
+  0x57, 0x7d, 0xea, 0x7e, 0xae, 0x21, 0xa1, 0x22, 0x6c, 0x73, 0x5d, 0xa3, 0x83, 0x0d, 0x0b, 0x74,
+  0x82, 0x82, 0x24, 0x65, 0x84, 0x21, 0xb9, 0xc6, 0x6e, 0xa1, 0xe1, 0x7c, 0xdc, 0xd8, 0x6c, 0xc0,
+  0x73, 0x98, 0xc1, 0x53, 0x74, 0x9e, 0x06, 0x01, 0x46, 0x5a, 0xb5, 0x4b, 0x82, 0xf0, 0xab, 0x7a,
+  0xa9, 0xc5, 0x7e, 0xec, 0x74, 0x30, 0xae, 0x98, 0x00, 0x2c, 0x65, 0x0f, 0x16, 0x55, 0xa3, 0x11,
+  0x5e, 0xd2, 0x3d, 0xb2, 0xa8, 0xbd, 0x0c, 0x46, 0xf5, 0xe9, 0xa8, 0x89, 0x77, 0xe4, 0xd4, 0x85,
+  0xf9, 0x62, 0xc2, 0xf8, 0x50, 0xc1, 0x79, 0x4c, 0xab, 0xc5, 0x45, 0x5b, 0xc8, 0x6d, 0x90, 0x55,
+  0xbb, 0x3b, 0xd0, 0x7a, 0x1b, 0x9d, 0x0f, 0x3a, 0x1b, 0x95, 0x96, 0x09, 0x18, 0x5d, 0x46, 0x7f,
+  0x60, 0x69, 0xdb, 0xac, 0x38, 0x66, 0x92, 0xfb, 0x26, 0xc0, 0x66, 0x70, 0x70, 0xc8, 0xc4, 0x67,
+  0xfb, 0xfd, 0x64, 0x38, 0x5f, 0x4a, 0x1e, 0xd4, 0x6b, 0xdd, 0x7a, 0xb6, 0xf3, 0x78, 0xdc, 0x2f,
+  0x79, 0x0a, 0x25, 0x0b, 0xf2, 0x33, 0x2a, 0x09, 0xdb, 0xc0, 0x93, 0x05, 0x1e, 0xc2, 0x5d, 0xf6,
+  0x00, 0x72, 0x5e, 0x02, 0x5e, 0xd9, 0x38, 0xc1, 0x8a, 0x87, 0x8e, 0x26, 0xc4, 0xe8, 0x12, 0x90,
+  0xbe, 0x55, 0xbe, 0x2b, 0x1f, 0xe1, 0x77, 0x9f, 0x65, 0xa0, 0x09, 0x4a, 0x50, 0xb3, 0xae, 0x68,
+  0x6e, 0x6d, 0x7a, 0x5b, 0x98, 0x2a, 0x91, 0xfe, 0x10, 0x5e, 0xe9, 0xd0, 0xf9, 0x28, 0xbc, 0xda,
+  0xd6, 0x7d, 0x03, 0x84, 0x3c, 0xaa, 0xd4, 0x8b, 0x42, 0xa7, 0x45, 0x79, 0x56, 0xda, 0x34, 0xf3,
+  0x2c, 0x6e, 0x31, 0xfc, 0x90, 0x55, 0x2a, 0xd0, 0x16, 0x44, 0x68, 0xe6, 0x1b, 0x64, 0x1b, 0x9c,
+  0xe6, 0x23, 0x30, 0xdd, 0xe5, 0xbb, 0xab, 0x6b, 0x50, 0x14, 0xbf, 0x7d, 0x01, 0xa0, 0x76, 0x61,
+  0xaa, 0xe1, 0x1c, 0xb1, 0x8b, 0x19, 0xda, 0x00, 0x12, 0xc0, 0x64, 0xa8, 0x16, 0xb4, 0xd5, 0x36,
+  0xa2, 0x40, 0x83, 0xdd, 0x5b, 0xe1, 0x5d, 0xf6, 0xfb, 0xd5, 0xbb, 0xb7, 0x10, 0x10, 0x19, 0xf8,
+  0x43, 0x8e, 0xe6, 0x4d, 0xbb, 0xe2, 0xfd, 0xf6, 0x50, 0xe2, 0x70, 0xfd, 0x77, 0xe5, 0x40, 0xc0,
+  0x7f, 0x06, 0x1a, 0x0a, 0xf4, 0x30, 0xd6, 0x5c, 0x38, 0x51, 0x43, 0xf6, 0xd8, 0xfd, 0x6a, 0xe6,
+  0x26, 0x8b, 0xab, 0x6b, 0xdf, 0xc9, 0x30, 0xbc, 0x50, 0xc0, 0x2e, 0x29, 0x5a, 0x18, 0x22, 0x54,
+  0xd0, 0x17, 0x84, 0xa6, 0x59, 0x41, 0x27, 0xec, 0xf6, 0xaa, 0xc8, 0x84, 0xb5, 0x19, 0x2a, 0xb1,
+  0x87, 0xa6, 0x1a, 0xd9, 0xaf, 0xd1, 0x76, 0xdc, 0x0d, 0x34, 0x16, 0x32, 0x75, 0xd9, 0x6a, 0xfe,
+  0x56, 0x91, 0xeb, 0x8e, 0xc2, 0xbf, 0x56, 0x57, 0xd9, 0x80, 0x9a, 0xcf, 0xb2, 0x40, 0x41, 0x13,
+  0xb8, 0xdc, 0xb5, 0x7d, 0x5e, 0xb2, 0x49, 0x97, 0x0a, 0x7d, 0x66, 0x3f, 0xf6, 0x96, 0x3a, 0xb3,
+  0x55, 0xd1, 0x5c, 0x0a, 0x52, 0x52, 0x78, 0x45, 0xfd, 0x9f, 0xf0, 0x84, 0x5a, 0x56, 0xb7, 0x4f,
+  0xdf, 0x69, 0x16, 0xda, 0x6f, 0xcf, 0xf2, 0x90, 0xd2, 0xde, 0x56, 0x55, 0xc2, 0x5f, 0xe0, 0x6e,
+  0x45, 0x90, 0x66, 0x02, 0x49, 0x5f, 0xdb, 0x6f, 0xe1, 0x4d, 0x7f, 0x42, 0x86, 0xe0, 0xfe, 0x76,
+  0xdf, 0xfb, 0xbb, 0x6d, 0xf9, 0xba, 0xee, 0x9a, 0xba, 0x69, 0x57, 0xc7, 0x8b, 0x26, 0xdb, 0x57,
+  0x70, 0x0a, 0xc2, 0x9b, 0x7f, 0xba, 0x9f, 0xf7, 0xf1, 0xb6, 0xbc, 0x1c, 0xd5, 0x41, 0x8c, 0x36,
+  0xa7, 0x52, 0x8a, 0x7f, 0x1f, 0x73, 0xe6, 0xca, 0x72, 0x41, 0xdc, 0x62, 0x7b, 0x3e, 0xad, 0x51,
+  0x50, 0x05, 0x36, 0x80, 0xd5, 0x7d, 0xac, 0x1f, 0x54, 0x6f, 0x16, 0xd6, 0x1c, 0x15, 0x30, 0x4e,
+  0x8a, 0xa0, 0xc6, 0x49, 0xd0, 0x5e, 0xaf, 0x0f, 0x46, 0x1b, 0x8b, 0xdf, 0x6a, 0x45, 0x5f, 0x8c,
+  0x29, 0x5d, 0xed, 0xb0, 0xf1, 0xcb, 0x38, 0x40, 0xc4, 0x48, 0x8e, 0x73, 0xfb, 0xc7, 0x18, 0x78,
+  0x25, 0x28, 0xa2, 0x67, 0xf4, 0x71, 0xbc, 0x9f, 0x1e, 0x5f, 0xf9, 0x9c, 0x9c, 0xe0, 0x55, 0x24,
+  0xdd, 0x48, 0x51, 0x66, 0xe2, 0xe1, 0xe2, 0xf4, 0xf4, 0xf2, 0xfd, 0xbb, 0x8b, 0x00, 0xef, 0x79,
+  0x20, 0x9a, 0x6b, 0x16, 0x9a, 0x55, 0x8c, 0xb3, 0x80, 0xf1, 0x84, 0xe5, 0x20, 0xe1, 0xba, 0x54,
+  0x19, 0x21, 0xe7, 0x65, 0x1c, 0x83, 0x98, 0x2d, 0xbe, 0x5d, 0x59, 0xb9, 0xd0, 0x02, 0xd5, 0x50,
+  0xca, 0xe9, 0xd5, 0xe5, 0xc1, 0xbe, 0xe5, 0x76, 0x7f, 0x6f, 0x91, 0xa8, 0x19, 0xf4, 0x06, 0x44,
+  0x54, 0x2a, 0x43, 0x36, 0xf1, 0xfe, 0x8b, 0x85, 0xd3, 0x6e, 0x87, 0x0e, 0xd6, 0xab, 0xd3, 0x6d,
+  0xe3, 0x69, 0x6c, 0xf3, 0x79, 0x0c, 0x37, 0x65, 0xff, 0x6a, 0x8a, 0x45, 0x32, 0x2a, 0x5d, 0x06,
+  0xb7, 0x56, 0x1e, 0xb9, 0x36, 0x9f, 0xfb, 0xec, 0xbf, 0xb5, 0x17, 0x50, 0xf6, 0x56, 0x0e, 0x0e,
+  0xc9, 0xdb, 0x36, 0xfe, 0x74, 0xd5, 0x86, 0x0d, 0xf4, 0x86, 0x5b, 0x2d, 0x7f, 0xab, 0x09, 0x62,
+  0x91, 0x54, 0xdf, 0x74, 0x3e, 0xd9, 0xf4, 0xad, 0xdc, 0x01, 0x6e, 0x92, 0x50, 0x21, 0x6c, 0xb8,
+  0xe8, 0x7e, 0x86, 0xc2, 0x16, 0xf0, 0x8b, 0x9f, 0x7e, 0x1e, 0xc6, 0x6f, 0x85, 0x73, 0xb9, 0xc3,
+  0xb0, 0x77, 0x94, 0x58, 0x30, 0xd0, 0x65, 0x28, 0x8e, 0x4e, 0xa2, 0xd8, 0x09, 0xdb, 0x56, 0x90,
+  0x6e, 0xed, 0x24, 0x1e, 0xf7, 0x56, 0x34, 0xc4, 0x1b, 0xb4, 0x75, 0x77, 0xc8, 0xb0, 0xe1, 0x4a,
+  0xa7, 0xbc, 0xb8, 0x8e, 0xb0, 0x24, 0x3f, 0x83, 0x6c, 0x6a, 0xb7, 0xe1, 0xf7, 0xef, 0xd4, 0x56,
+  0x05, 0xb9, 0x8c, 0x7f, 0x7e, 0x05, 0x27, 0xd1, 0x69, 0xa9, 0xc6, 0x92, 0x5f, 0xee, 0xff, 0x81,
+  0xf6, 0x7c, 0xcb, 0xdc, 0x5e, 0xba, 0xa0, 0x5f, 0x24, 0xf6, 0xc3, 0x84, 0xa2, 0x2b, 0x68, 0x5b,
+  0xa3, 0x66, 0xc5, 0xad, 0xf7, 0x9a, 0x34, 0x7b, 0xc4, 0x85, 0x74, 0x0f, 0x6a, 0x9b, 0xc4, 0x4a,
+  0xea, 0x6d, 0x13, 0xe5, 0x4f, 0xc8, 0xc5, 0x8d, 0x5a, 0x6c, 0x97, 0xa2, 0xdf, 0xa9, 0xd1, 0x63,
+  0x39, 0x6b, 0x4d, 0xfa, 0x84, 0x9c, 0x75, 0x98, 0xee, 0xf8, 0x5a, 0x58, 0xf5, 0x97, 0x5d, 0xbf,
+  0x85, 0xb7, 0xed, 0xd7, 0x1d, 0x48, 0x1e, 0x72, 0xd9, 0x3a, 0x47, 0x83, 0x4b, 0x8b, 0x0f, 0x40,
+  0x9a, 0x3e, 0x00, 0x31, 0xdb, 0x0e, 0xe8, 0xc2, 0xcf, 0x6e, 0x7f, 0xfd, 0xb6, 0xbf, 0xbe, 0xef,
+  0xb7, 0xdd, 0x5f, 0x52, 0xb5, 0xed, 0x9f, 0x97, 0xfe, 0x1f, 0xfe, 0x43, 0x6b, 0x44, 0x76, 0x2a,
+  0x00, 0x00,
+};
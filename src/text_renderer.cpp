@@ -0,0 +1,322 @@
+/**
+ * Text Renderer
+ *
+ * Measures and draws GFXfont text directly into the 4bpp framebuffer.
+ * The EPD driver's write_string() allocates an inflate state and a bitmap for every
+ * glyph it draws; here a single static inflate state and glyph buffer are reused,
+ * using the miniz inflater in the ESP32 ROM. Inflated glyphs are also kept in a small
+ * PSRAM cache, so digits and symbols drawn several times per frame are inflated once.
+ */
+
+#include <Arduino.h>
+#include "text_renderer.h"
+#include "memory_arena.h"
+
+#ifdef ESP32_S3_PLATFORM
+#include "esp32s3/rom/miniz.h"
+#else
+#include "esp32/rom/miniz.h"
+#endif
+
+// External framebuffer (defined in main.ino)
+extern uint8_t *framebuffer;
+
+// Inflate state (~11 KB) and glyph bitmap, shared by every glyph drawn
+static tinfl_decompressor glyphDecompressor;
+static uint8_t glyphBuffer[TEXT_GLYPH_BUFFER_SIZE];
+
+// Glyph nibble -> framebuffer nibble, and glyph byte -> framebuffer byte, for lutColor on lutBackground
+static uint8_t nibbleLut[16];
+static uint8_t byteLut[256];
+static int16_t lutColor = -1;
+static int16_t lutBackground = -1;
+
+#if TEXT_GLYPH_CACHE_SIZE
+typedef struct {
+  const GFXglyph *glyph;  // NULL = free slot
+  uint32_t offset;        // Bitmap offset in glyphCacheData
+} GlyphCacheEntry;
+
+// Both in the ARENA_GLYPHS region (PSRAM); NULL when PSRAM is missing (cache disabled)
+static GlyphCacheEntry *glyphCacheTable = NULL;
+static uint8_t *glyphCacheData = NULL;
+static uint32_t glyphCacheUsed = 0;     // Bytes of glyphCacheData in use
+static uint16_t glyphCacheEntries = 0;  // Slots of glyphCacheTable in use
+static bool glyphCacheTried = false;
+#endif
+
+/**
+ * Decode the next UTF-8 code point and advance the string pointer.
+ * @return Code point, or 0 at the end of the string
+ */
+static uint32_t nextCodepoint(const uint8_t **string) {
+  const uint8_t *s = *string;
+  if (*s == 0) return 0;
+
+  uint32_t cp;
+  int extra;
+  if (*s < 0x80) {
+    cp = *s;
+    extra = 0;
+  } else if ((*s & 0xE0) == 0xC0) {
+    cp = *s & 0x1F;
+    extra = 1;
+  } else if ((*s & 0xF0) == 0xE0) {
+    cp = *s & 0x0F;
+    extra = 2;
+  } else {
+    cp = *s & 0x07;
+    extra = 3;
+  }
+  s++;
+  for (; extra > 0 && *s; extra--) {
+    cp = (cp << 6) | (*s & 0x3F);
+    s++;
+  }
+  *string = s;
+  return cp;
+}
+
+/**
+ * Look up the glyph for a code point in the font's sorted unicode intervals.
+ */
+static const GFXglyph *findGlyph(const GFXfont &font, uint32_t cp) {
+  for (uint32_t i = 0; i < font.interval_count; i++) {
+    const UnicodeInterval *interval = &font.intervals[i];
+    if (cp < interval->first) break;
+    if (cp <= interval->last) {
+      return &font.glyph[interval->offset + (cp - interval->first)];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Look up a glyph in the font, then in the fallback font.
+ * @param source Set to the font the glyph belongs to
+ */
+static const GFXglyph *findGlyph(const GFXfont &font, const GFXfont *fallback, uint32_t cp,
+                                 const GFXfont **source) {
+  const GFXglyph *glyph = findGlyph(font, cp);
+  *source = &font;
+  if (!glyph && fallback) {
+    glyph = findGlyph(*fallback, cp);
+    *source = fallback;
+  }
+  return glyph;
+}
+
+/**
+ * Build the lookup tables mapping glyph coverage (0 = background, 15 = ink) to pixels.
+ * Same blend as the EPD driver, which always has a white background.
+ */
+static void buildColorLut(uint8_t color, uint8_t background) {
+  if (lutColor == color && lutBackground == background) return;
+  const int fg = color >> 4;
+  const int bg = background >> 4;
+  for (int c = 0; c < 16; c++) {
+    int value = bg + c * (fg - bg) / 15;
+    nibbleLut[c] = (value < 0) ? 0 : ((value > 15) ? 15 : value);
+  }
+  for (int b = 0; b < 256; b++) {
+    byteLut[b] = nibbleLut[b & 0x0F] | (nibbleLut[b >> 4] << 4);
+  }
+  lutColor = color;
+  lutBackground = background;
+}
+
+/**
+ * Inflate a glyph bitmap into dest.
+ * @return true on success
+ */
+static bool inflateGlyph(const GFXfont &font, const GFXglyph *glyph, uint8_t *dest, size_t size) {
+  size_t inSize = glyph->compressed_size;
+  size_t outSize = size;
+  tinfl_init(&glyphDecompressor);
+  tinfl_status status = tinfl_decompress(&glyphDecompressor, &font.bitmap[glyph->data_offset], &inSize,
+                                         dest, dest, &outSize,
+                                         TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+  return status == TINFL_STATUS_DONE;
+}
+
+#if TEXT_GLYPH_CACHE_SIZE
+/**
+ * Take the glyph cache from its arena region on first use.
+ * @return true if the cache is available
+ */
+static bool glyphCacheReady() {
+  if (!glyphCacheTried) {
+    glyphCacheTried = true;
+    glyphCacheTable = (GlyphCacheEntry *)arenaAlloc(ARENA_GLYPHS, TEXT_GLYPH_CACHE_ENTRIES * sizeof(GlyphCacheEntry));
+    glyphCacheData = (uint8_t *)arenaAlloc(ARENA_GLYPHS, TEXT_GLYPH_CACHE_SIZE);
+    if (glyphCacheTable && glyphCacheData) {
+      memset(glyphCacheTable, 0, TEXT_GLYPH_CACHE_ENTRIES * sizeof(GlyphCacheEntry));
+    } else {
+      arenaReset(ARENA_GLYPHS);
+      glyphCacheTable = NULL;
+      glyphCacheData = NULL;
+    }
+  }
+  return glyphCacheData != NULL;
+}
+
+/**
+ * Find the cache slot for a glyph (open addressing on the glyph's address).
+ */
+static GlyphCacheEntry *glyphCacheSlot(const GFXglyph *glyph) {
+  uint32_t index = ((uint32_t)(uintptr_t)glyph * 2654435761u) >> 16;
+  for (;;) {
+    GlyphCacheEntry *entry = &glyphCacheTable[index & (TEXT_GLYPH_CACHE_ENTRIES - 1)];
+    if (entry->glyph == glyph || entry->glyph == NULL) return entry;
+    index++;
+  }
+}
+
+/**
+ * Return the cached bitmap for a glyph, inflating it into the cache on a miss.
+ * When the cache is full it is emptied and refilled, one frame rarely needs it all.
+ * @return Bitmap, or NULL if the glyph could not be cached
+ */
+static const uint8_t *cachedGlyph(const GFXfont &font, const GFXglyph *glyph, size_t size) {
+  if (!glyphCacheReady() || size > TEXT_GLYPH_CACHE_SIZE) return NULL;
+
+  GlyphCacheEntry *entry = glyphCacheSlot(glyph);
+  if (entry->glyph == glyph) return glyphCacheData + entry->offset;
+
+  // Keep the table at most 3/4 full so probe runs stay short
+  if (glyphCacheUsed + size > TEXT_GLYPH_CACHE_SIZE || glyphCacheEntries >= TEXT_GLYPH_CACHE_ENTRIES * 3 / 4) {
+    memset(glyphCacheTable, 0, TEXT_GLYPH_CACHE_ENTRIES * sizeof(GlyphCacheEntry));
+    glyphCacheUsed = 0;
+    glyphCacheEntries = 0;
+    entry = glyphCacheSlot(glyph);
+  }
+
+  uint8_t *dest = glyphCacheData + glyphCacheUsed;
+  if (!inflateGlyph(font, glyph, dest, size)) return NULL;
+  entry->glyph = glyph;
+  entry->offset = glyphCacheUsed;
+  glyphCacheUsed += (size + 3) & ~3;
+  glyphCacheEntries++;
+  return dest;
+}
+#endif
+
+/**
+ * Draw one glyph with its origin at (cursorX, cursorY) (baseline).
+ */
+static void drawGlyph(const GFXfont &font, const GFXglyph *glyph, int32_t cursorX, int32_t cursorY) {
+  const int width = glyph->width;
+  const int height = glyph->height;
+  if (width == 0 || height == 0) return;
+
+  const int byteWidth = width / 2 + width % 2;
+  const size_t bitmapSize = byteWidth * height;
+  const uint8_t *bitmap = NULL;
+  uint8_t *allocated = NULL;
+
+  if (!font.compressed) {
+    bitmap = &font.bitmap[glyph->data_offset];
+  }
+#if TEXT_GLYPH_CACHE_SIZE
+  else {
+    bitmap = cachedGlyph(font, glyph, bitmapSize);
+  }
+#endif
+  if (!bitmap) {
+    // No cache: inflate into the scratch buffer
+    uint8_t *dest = glyphBuffer;
+    if (bitmapSize > sizeof(glyphBuffer)) {
+      // Larger than any glyph in the bundled fonts - fall back to the heap
+      dest = allocated = (uint8_t *)malloc(bitmapSize);
+      if (!dest) return;
+    }
+    if (!inflateGlyph(font, glyph, dest, bitmapSize)) {
+      free(allocated);
+      return;
+    }
+    bitmap = dest;
+  }
+
+  const int startX = cursorX + glyph->left;
+  const bool unclipped = startX >= 0 && startX + width <= EPD_WIDTH;
+
+  for (int y = 0; y < height; y++) {
+    const int yy = cursorY - glyph->top + y;
+    if (yy < 0 || yy >= EPD_HEIGHT) continue;
+    const uint8_t *src = bitmap + y * byteWidth;
+    uint8_t *row = framebuffer + yy * (EPD_WIDTH / 2);
+
+    if (unclipped && (startX & 1) == 0) {
+      // Nibble-aligned: each glyph byte maps to one framebuffer byte
+      uint8_t *dst = row + startX / 2;
+      const int pairs = width / 2;
+      for (int i = 0; i < pairs; i++) {
+        dst[i] = byteLut[src[i]];
+      }
+      if (width & 1) {
+        dst[pairs] = (dst[pairs] & 0xF0) | nibbleLut[src[pairs] & 0x0F];
+      }
+    } else {
+      for (int x = 0; x < width; x++) {
+        const int xx = startX + x;
+        if (xx < 0 || xx >= EPD_WIDTH) continue;
+        const uint8_t bm = (x & 1) ? (src[x / 2] >> 4) : (src[x / 2] & 0x0F);
+        uint8_t *dst = &row[xx / 2];
+        if (xx & 1) {
+          *dst = (*dst & 0x0F) | (nibbleLut[bm] << 4);
+        } else {
+          *dst = (*dst & 0xF0) | nibbleLut[bm];
+        }
+      }
+    }
+  }
+
+  free(allocated);
+}
+
+TextMetrics measureText(const GFXfont &font, const char *text, const GFXfont *fallback) {
+  TextMetrics metrics = {0, 0, 0, 0};
+  if (text == NULL || *text == '\0') return metrics;
+
+  int32_t minx = 100000, miny = 100000, maxx = -1, maxy = -1;
+  int32_t x = 0;
+  const uint8_t *p = (const uint8_t *)text;
+  uint32_t cp;
+  while ((cp = nextCodepoint(&p))) {
+    const GFXfont *source;
+    const GFXglyph *glyph = findGlyph(font, fallback, cp, &source);
+    if (!glyph) continue;
+    int32_t x1 = x + glyph->left;
+    int32_t y1 = glyph->top - glyph->height;
+    int32_t x2 = x1 + glyph->width;
+    int32_t y2 = y1 + glyph->height;
+    if (x1 < minx) minx = x1;
+    if (y1 < miny) miny = y1;
+    if (x2 > maxx) maxx = x2;
+    if (y2 > maxy) maxy = y2;
+    x += glyph->advance_x;
+  }
+  if (maxx < 0 && maxy < 0) return metrics; // No drawable glyphs
+
+  metrics.x1 = (minx < 0) ? minx : 0;
+  metrics.width = maxx - metrics.x1;
+  metrics.height = maxy - miny;
+  metrics.ascent = maxy;
+  return metrics;
+}
+
+void renderText(const GFXfont &font, const char *text, int32_t x, int32_t y, uint8_t color,
+                const GFXfont *fallback, uint8_t background) {
+  if (text == NULL || framebuffer == NULL) return;
+  buildColorLut(color, background);
+
+  const uint8_t *p = (const uint8_t *)text;
+  uint32_t cp;
+  while ((cp = nextCodepoint(&p))) {
+    const GFXfont *source;
+    const GFXglyph *glyph = findGlyph(font, fallback, cp, &source);
+    if (!glyph) continue;
+    drawGlyph(*source, glyph, x, y);
+    x += glyph->advance_x;
+  }
+}
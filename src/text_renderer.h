@@ -0,0 +1,62 @@
+#ifndef __TEXT_RENDERER_H__
+#define __TEXT_RENDERER_H__
+
+#include <Arduino.h>
+#include "epd_driver.h"
+
+// Scratch buffer for one decompressed glyph; the largest OpenSans24B glyph needs 900 bytes
+#define TEXT_GLYPH_BUFFER_SIZE 1024
+
+// PSRAM cache of decompressed glyphs in bytes (0 disables the cache)
+// Every glyph of the font subsets together inflates to about 67 KB
+#ifndef TEXT_GLYPH_CACHE_SIZE
+#define TEXT_GLYPH_CACHE_SIZE (64 * 1024)
+#endif
+
+// Glyph cache slots (power of two)
+#ifndef TEXT_GLYPH_CACHE_ENTRIES
+#define TEXT_GLYPH_CACHE_ENTRIES 1024
+#endif
+
+/**
+ * Bounds of a run of text, measured once from the glyph table.
+ * Matches what get_text_bounds() reports for a cursor at (0, 0).
+ */
+typedef struct {
+  int32_t x1;      // Left edge relative to the cursor (<= 0)
+  int32_t width;   // Width from x1 to the right edge of the last glyph
+  int32_t height;  // Height from the lowest to the highest glyph edge
+  int32_t ascent;  // Highest glyph top above the baseline
+} TextMetrics;
+
+/**
+ * Measure a UTF-8 string in the given font without decompressing any glyphs.
+ *
+ * @param font Font to measure with
+ * @param text Null-terminated UTF-8 text
+ * @param fallback Font for code points missing from font (e.g. a font subset supplement), or NULL
+ * @return Bounds of the run
+ */
+TextMetrics measureText(const GFXfont &font, const char *text, const GFXfont *fallback = NULL);
+
+/**
+ * Draw a UTF-8 string into the framebuffer with its baseline at y.
+ * Produces the same pixels as write_string(), but glyphs are inflated once into the
+ * PSRAM glyph cache (or a static buffer without PSRAM, never a heap allocation per
+ * glyph) and glyph rows that start on an even column are written a whole byte
+ * (two pixels) at a time.
+ *
+ * @param font Font to draw with
+ * @param text Null-terminated UTF-8 text
+ * @param x Cursor x position
+ * @param y Baseline y position
+ * @param color Text color (high nibble used, 0x00 = black)
+ * @param fallback Font for code points missing from font, or NULL
+ * @param background Color the glyph boxes are filled with around the ink (high nibble
+ *                   used); the area under the text should already be this color.
+ *                   write_string() only draws on white (0xFF).
+ */
+void renderText(const GFXfont &font, const char *text, int32_t x, int32_t y, uint8_t color,
+                const GFXfont *fallback = NULL, uint8_t background = 0xFF);
+
+#endif // __TEXT_RENDERER_H__
@@ -0,0 +1,287 @@
+/**
+ * TLS Client
+ *
+ * mbedtls over the socket of a plain WiFiClient. The connection, DNS and timeouts
+ * are handled by WiFiClient, as with WiFiClientSecure, but the handshake is run here
+ * so a saved session can be offered for resumption.
+ */
+
+#include <Arduino.h>
+#include <fcntl.h>
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/error.h"
+#include "mbedtls/platform.h"
+#include "tls_client.h"
+#include "settings.h"
+
+#define TLS_DEFAULT_TIMEOUT_MS 5000
+
+static int tlsSend(void *ctx, const unsigned char *buf, size_t len) {
+  return mbedtls_net_send(ctx, buf, len);
+}
+
+static int tlsRecv(void *ctx, unsigned char *buf, size_t len) {
+  return mbedtls_net_recv(ctx, buf, len);
+}
+
+TlsClient::TlsClient()
+  : socketFd(-1), ready(false), sessionResumed(false), peeked(-1),
+    caPem(NULL), hostname(NULL), sessionData(NULL), sessionCapacity(0), sessionLength(NULL) {
+}
+
+TlsClient::~TlsClient() {
+  stop();
+}
+
+void TlsClient::setCACert(const char *pem) {
+  caPem = pem;
+}
+
+void TlsClient::setHostname(const char *name) {
+  hostname = name;
+}
+
+void TlsClient::setSessionCache(uint8_t *data, size_t capacity, uint16_t *length) {
+  sessionData = data;
+  sessionCapacity = capacity;
+  sessionLength = length;
+  if (*sessionLength > sessionCapacity) {
+    *sessionLength = 0;
+  }
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port) {
+  return connect(ip, port, TLS_DEFAULT_TIMEOUT_MS);
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port, int32_t timeout) {
+  stop();
+  if (!tcp.connect(ip, port, timeout)) {
+    return 0;
+  }
+  return handshake(hostname, timeout);
+}
+
+int TlsClient::connect(const char *host, uint16_t port) {
+  return connect(host, port, TLS_DEFAULT_TIMEOUT_MS);
+}
+
+int TlsClient::connect(const char *host, uint16_t port, int32_t timeout) {
+  stop();
+  if (!tcp.connect(host, port, timeout)) {
+    return 0;
+  }
+  return handshake(hostname ? hostname : host, timeout);
+}
+
+/**
+ * Run the TLS handshake on the connected socket, offering the cached session.
+ *
+ * @param name Server name for SNI and certificate verification (NULL = none)
+ * @param timeout Milliseconds allowed for the handshake
+ * @return 1 on success, 0 on failure (the connection is closed)
+ */
+int TlsClient::handshake(const char *name, int32_t timeout) {
+  socketFd = tcp.fd();
+  mbedtls_ssl_init(&ssl);
+  mbedtls_ssl_config_init(&conf);
+  mbedtls_entropy_init(&entropy);
+  mbedtls_ctr_drbg_init(&drbg);
+  mbedtls_x509_crt_init(&ca);
+  ready = true; // Contexts need freeing from here on
+  sessionResumed = false;
+  peeked = -1;
+
+  unsigned long start = millis();
+  int ret = mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy, NULL, 0);
+  if (ret == 0 && caPem) ret = mbedtls_x509_crt_parse(&ca, (const unsigned char *)caPem, strlen(caPem) + 1);
+  if (ret == 0) ret = mbedtls_ssl_config_defaults(&conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                                  MBEDTLS_SSL_PRESET_DEFAULT);
+  if (ret == 0) {
+    mbedtls_ssl_conf_authmode(&conf, caPem ? MBEDTLS_SSL_VERIFY_REQUIRED : MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_ca_chain(&conf, &ca, NULL);
+    mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &drbg);
+    ret = mbedtls_ssl_setup(&ssl, &conf);
+  }
+  if (ret == 0 && name) ret = mbedtls_ssl_set_hostname(&ssl, name);
+  if (ret != 0) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("TLS setup failed: -0x%04x\n", -ret);
+    }
+#endif
+    stop();
+    return 0;
+  }
+
+  // Offer the saved session; the server accepts it by echoing its session ID
+  unsigned char offeredId[32];
+  size_t offeredIdLen = 0;
+  if (sessionData && *sessionLength > 0) {
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    if (mbedtls_ssl_session_load(&session, sessionData, *sessionLength) == 0 &&
+        mbedtls_ssl_set_session(&ssl, &session) == 0) {
+      offeredIdLen = session.id_len;
+      memcpy(offeredId, session.id, offeredIdLen);
+    } else {
+      *sessionLength = 0;
+    }
+    mbedtls_ssl_session_free(&session);
+  }
+
+  fcntl(socketFd, F_SETFL, fcntl(socketFd, F_GETFL, 0) | O_NONBLOCK);
+  mbedtls_ssl_set_bio(&ssl, &socketFd, tlsSend, tlsRecv, NULL);
+  while ((ret = mbedtls_ssl_handshake(&ssl)) != 0) {
+    if ((ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+        (long)(millis() - start) > timeout) {
+#if DEBUG_LEVEL
+      if (Serial) {
+        Serial.printf("TLS handshake failed: -0x%04x\n", -ret);
+      }
+#endif
+      if (sessionData) *sessionLength = 0; // A rejected session could be the cause
+      stop();
+      return 0;
+    }
+    delay(1);
+  }
+
+  const mbedtls_ssl_session *established = ssl.session;
+  sessionResumed = offeredIdLen > 0 && established && established->id_len == offeredIdLen &&
+                   memcmp(established->id, offeredId, offeredIdLen) == 0;
+  if (!sessionResumed) {
+    saveSession();
+  }
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("TLS %s handshake in %lu ms (%s)\n", sessionResumed ? "resumed" : "full",
+                  millis() - start, mbedtls_ssl_get_ciphersuite(&ssl));
+  }
+#endif
+  return 1;
+}
+
+/**
+ * Store the session just negotiated (including any session ticket) in the cache,
+ * without the server certificate.
+ */
+void TlsClient::saveSession() {
+  if (!sessionData) return;
+  *sessionLength = 0;
+
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  size_t length = 0;
+  bool copied = mbedtls_ssl_get_session(&ssl, &session) == 0;
+#if defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+  // Resuming skips the certificate exchange, so the server certificate (over 1 KB) is not kept
+  if (copied && session.peer_cert) {
+    mbedtls_x509_crt_free(session.peer_cert);
+    mbedtls_free(session.peer_cert);
+    session.peer_cert = NULL;
+  }
+#endif
+  if (copied &&
+      mbedtls_ssl_session_save(&session, sessionData, sessionCapacity, &length) == 0) {
+    *sessionLength = length;
+  } else {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.printf("TLS session not cached (needs %u of %u bytes)\n", (unsigned)length, (unsigned)sessionCapacity);
+    }
+#endif
+  }
+  mbedtls_ssl_session_free(&session);
+}
+
+size_t TlsClient::write(uint8_t data) {
+  return write(&data, 1);
+}
+
+size_t TlsClient::write(const uint8_t *buf, size_t size) {
+  if (!ready) return 0;
+  size_t written = 0;
+  unsigned long start = millis();
+  while (written < size) {
+    int ret = mbedtls_ssl_write(&ssl, buf + written, size - written);
+    if (ret > 0) {
+      written += ret;
+    } else if ((ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+               millis() - start > TLS_DEFAULT_TIMEOUT_MS) {
+      stop();
+      break;
+    } else {
+      delay(1);
+    }
+  }
+  return written;
+}
+
+int TlsClient::available() {
+  if (!ready) return 0;
+  int pending = (peeked >= 0) ? 1 : 0;
+  if (mbedtls_ssl_get_bytes_avail(&ssl) == 0) {
+    // Process the next record, if one has arrived, without consuming application data
+    int ret = mbedtls_ssl_read(&ssl, NULL, 0);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      if (!pending) stop(); // Closed by the server (close_notify) or broken
+      return pending;
+    }
+  }
+  return pending + mbedtls_ssl_get_bytes_avail(&ssl);
+}
+
+int TlsClient::read() {
+  uint8_t c;
+  return (read(&c, 1) == 1) ? c : -1;
+}
+
+int TlsClient::read(uint8_t *buf, size_t size) {
+  if (!ready || size == 0) return -1;
+  int count = 0;
+  if (peeked >= 0) {
+    buf[count++] = peeked;
+    peeked = -1;
+    if (--size == 0 || mbedtls_ssl_get_bytes_avail(&ssl) == 0) return count;
+  }
+  int ret = mbedtls_ssl_read(&ssl, buf + count, size);
+  if (ret > 0) return count + ret;
+  if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+    stop();
+  }
+  return count ? count : -1;
+}
+
+int TlsClient::peek() {
+  if (peeked < 0 && available() > 0) {
+    peeked = read();
+  }
+  return peeked;
+}
+
+void TlsClient::flush() {
+}
+
+uint8_t TlsClient::connected() {
+  return ready && (peeked >= 0 || mbedtls_ssl_get_bytes_avail(&ssl) > 0 || tcp.connected());
+}
+
+void TlsClient::freeContexts() {
+  mbedtls_ssl_free(&ssl);
+  mbedtls_ssl_config_free(&conf);
+  mbedtls_ctr_drbg_free(&drbg);
+  mbedtls_entropy_free(&entropy);
+  mbedtls_x509_crt_free(&ca);
+}
+
+void TlsClient::stop() {
+  if (ready) {
+    ready = false;
+    mbedtls_ssl_close_notify(&ssl);
+    freeContexts();
+  }
+  peeked = -1;
+  socketFd = -1;
+  tcp.stop();
+}
@@ -0,0 +1,90 @@
+#ifndef __TLS_CLIENT_H__
+#define __TLS_CLIENT_H__
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "mbedtls/ssl.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/x509_crt.h"
+
+/**
+ * TLS client over a WiFiClient socket that can resume a previous session.
+ *
+ * WiFiClientSecure always does a full handshake, because it has no way to offer a
+ * saved session. This client offers the session kept in a caller-provided buffer and
+ * saves the new one after each handshake. A resumed handshake skips the certificate
+ * exchange and verification, which is most of the handshake time on an ESP32.
+ *
+ * Derives from WiFiClient so HTTPClient can use it, like WiFiClientSecure.
+ */
+class TlsClient : public WiFiClient {
+public:
+  TlsClient();
+  ~TlsClient();
+
+  /**
+   * Trust only these CA certificates.
+   *
+   * @param pem NUL-terminated PEM bundle, must stay valid while the client is used
+   */
+  void setCACert(const char *pem);
+
+  /**
+   * Name sent for SNI and checked against the server certificate, needed when connecting by IP address.
+   */
+  void setHostname(const char *hostname);
+
+  /**
+   * Offer and refresh a saved session on every connect.
+   * The buffer must persist as long as resumption is wanted (e.g. in RTC memory).
+   *
+   * @param data Serialized session (mbedtls_ssl_session_save() format)
+   * @param capacity Size of data
+   * @param length Bytes used in data, 0 = no session
+   */
+  void setSessionCache(uint8_t *data, size_t capacity, uint16_t *length);
+
+  /**
+   * Whether the last handshake resumed the cached session.
+   */
+  bool resumed() const { return sessionResumed; }
+
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(IPAddress ip, uint16_t port, int32_t timeout) override;
+  int connect(const char *host, uint16_t port) override;
+  int connect(const char *host, uint16_t port, int32_t timeout) override;
+  size_t write(uint8_t data) override;
+  size_t write(const uint8_t *buf, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t *buf, size_t size) override;
+  int peek() override;
+  void flush() override;
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() { return connected(); }
+
+private:
+  int handshake(const char *name, int32_t timeout);
+  void saveSession();
+  void freeContexts();
+
+  WiFiClient tcp;
+  int socketFd;
+  bool ready;
+  bool sessionResumed;
+  int peeked;
+  const char *caPem;
+  const char *hostname;
+  uint8_t *sessionData;
+  size_t sessionCapacity;
+  uint16_t *sessionLength;
+  mbedtls_ssl_context ssl;
+  mbedtls_ssl_config conf;
+  mbedtls_entropy_context entropy;
+  mbedtls_ctr_drbg_context drbg;
+  mbedtls_x509_crt ca;
+};
+
+#endif // __TLS_CLIENT_H__
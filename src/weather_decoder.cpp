@@ -0,0 +1,325 @@
+/**
+ * Weather Decoder
+ *
+ * Streams the One Call API 3.0 response into the forecast records, and the minutely
+ * response of a nowcast wake into the nowcast record. Kept apart from main.ino so the
+ * host benchmark (bench/) can run it on recorded responses.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "weather_decoder.h"
+#include "memory_arena.h"
+#include "weather_view.h"
+#include "settings.h"
+#include "locations.h"
+
+/**
+ * Parse OpenWeatherMap One Call API 3.0 JSON response.
+ * Extracts current weather, hourly forecasts (48h), and daily forecasts (8 days).
+ * Sets RTC time from API response timestamp.
+ * 
+ * The response is decoded as a stream rather than as one document: the decoder seeks to
+ * each top-level section ("timezone_offset", "current", "hourly", "daily") in the order
+ * the API emits them and deserializes one object at a time through a filter, so only the
+ * fields the display uses are ever stored. The scratch document is reused for every
+ * element, which keeps the peak JSON memory to a couple of KB instead of the whole body.
+ * With PIPELINED_FETCH each section is announced as soon as it is stored, so it can be drawn
+ * while the rest of the body is still arriving.
+ * 
+ * @param json Stream containing the JSON response body
+ * @return true if parsing successful, false on error
+ */
+bool DecodeWeather(Stream &json) {
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.print(F("\nDecoding One Call API 3.0 json stream... "));
+  }
+  unsigned long decodeStart = millis();
+  uint32_t heapBefore = ESP.getFreeHeap();
+  size_t peakDocUsage = 0;
+#endif
+  BasicJsonDocument<ArenaJsonAllocator> doc(JSON_ELEMENT_DOC_SIZE);  // Scratch document, reused for every element
+  StaticJsonDocument<JSON_FILTER_DOC_SIZE> filter; // Fields to keep for the section being decoded
+  DeserializationError error;
+  
+  // Timezone offset precedes "current" and is a bare number
+  if (!json.find("\"timezone_offset\":")) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println(F("timezone_offset not found"));
+    }
+#endif
+    return false;
+  }
+  int timezoneOffset = json.parseInt();
+  
+  // Parse current weather conditions
+  if (!json.find("\"current\":")) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println(F("current section not found"));
+    }
+#endif
+    return false;
+  }
+  filter["dt"]         = true;
+  filter["sunrise"]    = true;
+  filter["sunset"]     = true;
+  filter["temp"]       = true;
+  filter["feels_like"] = true;
+  filter["pressure"]   = true;
+  filter["humidity"]   = true;
+  filter["clouds"]     = true;
+  filter["visibility"] = true;
+  filter["wind_speed"] = true;
+  filter["wind_deg"]   = true;
+  filter["weather"][0]["description"] = true;
+  filter["weather"][0]["icon"]        = true;
+  error = deserializeJson(doc, json, DeserializationOption::Filter(filter));
+  if (error) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.print(F("current deserializeJson() failed: "));
+      Serial.println(error.c_str());
+    }
+#endif
+    return false;
+  }
+#if DEBUG_LEVEL
+  peakDocUsage = doc.memoryUsage();
+#endif
+  JsonObject current = doc.as<JsonObject>();
+  time_t apiTime = current["dt"].as<int>(); // Unix timestamp (UTC)
+  
+  // Store current weather data
+  memset(&WxConditions[0], 0, sizeof(Forecast_record_type));
+  WxConditions[0].FTimezone   = timezoneOffset;
+  WxConditions[0].Dt          = apiTime;
+  WxConditions[0].Sunrise     = current["sunrise"].as<int>();
+  WxConditions[0].Sunset      = current["sunset"].as<int>();
+  WxConditions[0].Temperature = toTenths(current["temp"].as<float>());
+  WxConditions[0].FeelsLike   = toTenths(current["feels_like"].as<float>());
+  WxConditions[0].Pressure    = current["pressure"].as<int>();
+  WxConditions[0].Humidity    = current["humidity"].as<int>();
+  WxConditions[0].Cloudcover  = current["clouds"].as<int>();
+  WxConditions[0].Visibility  = current["visibility"].as<int>();
+  WxConditions[0].Windspeed   = toTenths(current["wind_speed"].as<float>());
+  WxConditions[0].Winddir     = current["wind_deg"].as<int>();
+  setRecordText(WxConditions[0].Description, sizeof(WxConditions[0].Description), current["weather"][0]["description"].as<const char*>());
+  setRecordText(WxConditions[0].Icon, sizeof(WxConditions[0].Icon), current["weather"][0]["icon"].as<const char*>());
+  
+  // Synchronize RTC with API time
+  SetRTCTimeFromAPI(apiTime, timezoneOffset);
+  buildCurrentView(WxConditions[0]);
+  fetchProgress(FETCH_CURRENT_READY);
+  
+  // Parse hourly forecasts (48 hours) - used for 24-hour graph. Only the hours drawn are
+  // kept, plus the first (current) hour and those a cached redraw within the data age needs.
+  int hourlyNeeded = graph_hours_shown + 1 + (locationMaxDataAge() + 59) / 60;
+  if (hourlyNeeded > max_hourly_readings) hourlyNeeded = max_hourly_readings;
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.print(F("\nReceiving Hourly Forecast - "));
+  }
+#endif
+  if (!json.find("\"hourly\":[")) {
+    return false;
+  }
+  filter.clear();
+  filter["dt"]          = true;
+  filter["temp"]        = true;
+  filter["pressure"]    = true;
+  filter["humidity"]    = true;
+  filter["clouds"]      = true;
+  filter["pop"]         = true;
+  filter["wind_speed"]  = true;
+  filter["wind_deg"]    = true;
+  filter["rain"]["1h"]  = true;
+  filter["snow"]["1h"]  = true;
+  filter["weather"][0]["icon"] = true;
+  byte hourlyCount = 0;
+  do {
+    error = deserializeJson(doc, json, DeserializationOption::Filter(filter));
+    if (error) {
+#if DEBUG_LEVEL
+      if (Serial) {
+        Serial.print(F("hourly deserializeJson() failed: "));
+        Serial.println(error.c_str());
+      }
+#endif
+      return false;
+    }
+#if DEBUG_LEVEL
+    if (doc.memoryUsage() > peakDocUsage) peakDocUsage = doc.memoryUsage();
+#endif
+    JsonObject hour = doc.as<JsonObject>();
+    byte r = hourlyCount++;
+    memset(&WxHourlyForecast[r], 0, sizeof(Forecast_record_type));
+    WxHourlyForecast[r].Dt          = hour["dt"].as<int>();
+    WxHourlyForecast[r].Temperature = toTenths(hour["temp"].as<float>());
+    WxHourlyForecast[r].Low         = WxHourlyForecast[r].Temperature; // Hourly has single temperature value
+    WxHourlyForecast[r].High        = WxHourlyForecast[r].Temperature;
+    WxHourlyForecast[r].Pressure    = hour["pressure"].as<int>();
+    WxHourlyForecast[r].Humidity    = hour["humidity"].as<int>();
+    setRecordText(WxHourlyForecast[r].Icon, sizeof(WxHourlyForecast[r].Icon), hour["weather"][0]["icon"].as<const char*>());
+    WxHourlyForecast[r].Cloudcover  = hour["clouds"].as<int>();
+    WxHourlyForecast[r].Pop         = toPercent(hour["pop"].as<float>()); // API gives 0.0-1.0
+    WxHourlyForecast[r].Windspeed   = toTenths(hour["wind_speed"].as<float>());
+    WxHourlyForecast[r].Winddir     = hour["wind_deg"].as<int>();
+    
+    // Optional precipitation fields (hourly API uses "1h" key); missing keys read as 0
+    WxHourlyForecast[r].Rainfall    = toHundredths(hour["rain"]["1h"] | 0.0f);
+    WxHourlyForecast[r].Snowfall    = toHundredths(hour["snow"]["1h"] | 0.0f);
+    if (hourlyCount >= hourlyNeeded) break; // The rest is skipped by the search for "daily" below
+  } while (json.findUntil(",", "]"));
+  memset(&WxHourlyForecast[hourlyCount], 0, (max_hourly_readings - hourlyCount) * sizeof(Forecast_record_type));
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.println(String(hourlyCount) + " periods received");
+  }
+#endif
+  // The graph window starts at the API time, which the RTC was just set to
+  buildGraphView(WxHourlyForecast, hourlyCount, apiTime, timezoneOffset);
+  fetchProgress(FETCH_HOURLY_READY);
+  
+  // Parse daily forecasts (8 days) - used for 5-day forecast display. Reading stops after
+  // the days drawn; the caller closes the connection on the rest of the response.
+  const int dailyNeeded = forecast_days_shown;
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.print(F("\nReceiving Daily Forecast - "));
+  }
+#endif
+  if (!json.find("\"daily\":[")) {
+    return false;
+  }
+  filter.clear();
+  filter["dt"]           = true;
+  filter["sunrise"]      = true;
+  filter["sunset"]       = true;
+  filter["temp"]["day"]  = true;
+  filter["temp"]["min"]  = true;
+  filter["temp"]["max"]  = true;
+  filter["pressure"]     = true;
+  filter["humidity"]     = true;
+  filter["clouds"]       = true;
+  filter["pop"]          = true;
+  filter["wind_speed"]   = true;
+  filter["wind_deg"]     = true;
+  filter["rain"]         = true;
+  filter["snow"]         = true;
+  filter["weather"][0]["icon"] = true;
+  byte dailyCount = 0;
+  do {
+    error = deserializeJson(doc, json, DeserializationOption::Filter(filter));
+    if (error) {
+#if DEBUG_LEVEL
+      if (Serial) {
+        Serial.print(F("daily deserializeJson() failed: "));
+        Serial.println(error.c_str());
+      }
+#endif
+      return false;
+    }
+#if DEBUG_LEVEL
+    if (doc.memoryUsage() > peakDocUsage) peakDocUsage = doc.memoryUsage();
+#endif
+    JsonObject day = doc.as<JsonObject>();
+    JsonObject temp = day["temp"]; // Daily forecast has temp object with min/max/day/night
+    byte r = dailyCount++;
+    memset(&WxDailyForecast[r], 0, sizeof(Forecast_record_type));
+    WxDailyForecast[r].Dt          = day["dt"].as<int>();
+    WxDailyForecast[r].Temperature = toTenths(temp["day"].as<float>()); // Daytime average temperature
+    WxDailyForecast[r].Low         = toTenths(temp["min"].as<float>());
+    WxDailyForecast[r].High        = toTenths(temp["max"].as<float>());
+    WxDailyForecast[r].Pressure    = day["pressure"].as<int>();
+    WxDailyForecast[r].Humidity    = day["humidity"].as<int>();
+    setRecordText(WxDailyForecast[r].Icon, sizeof(WxDailyForecast[r].Icon), day["weather"][0]["icon"].as<const char*>());
+    WxDailyForecast[r].Cloudcover  = day["clouds"].as<int>();
+    WxDailyForecast[r].Pop         = toPercent(day["pop"].as<float>()); // API gives 0.0-1.0
+    WxDailyForecast[r].Windspeed   = toTenths(day["wind_speed"].as<float>());
+    WxDailyForecast[r].Winddir     = day["wind_deg"].as<int>();
+    WxDailyForecast[r].Sunrise     = day["sunrise"].as<int>();
+    WxDailyForecast[r].Sunset      = day["sunset"].as<int>();
+    
+    // Optional precipitation (daily API provides total for the day, not per-hour)
+    WxDailyForecast[r].Rainfall    = toHundredths(day["rain"] | 0.0f);
+    WxDailyForecast[r].Snowfall    = toHundredths(day["snow"] | 0.0f);
+  } while (dailyCount < dailyNeeded && json.findUntil(",", "]"));
+  memset(&WxDailyForecast[dailyCount], 0, (max_daily_readings - dailyCount) * sizeof(Forecast_record_type));
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.println(String(dailyCount) + " days received");
+  }
+#endif
+  
+  // Get today's high/low from first daily forecast entry
+  if (dailyCount > 0) {
+    WxConditions[0].High = WxDailyForecast[0].High;
+    WxConditions[0].Low  = WxDailyForecast[0].Low;
+  }
+  
+  // Calculate pressure trend: compare today's pressure with tomorrow's (whole hPa)
+  if (dailyCount >= 2) {
+    int pressure_trend = WxDailyForecast[0].Pressure - WxDailyForecast[1].Pressure;
+    WxConditions[0].Trend = TREND_STEADY;
+    if (pressure_trend > 0)  WxConditions[0].Trend = TREND_RISING;
+    if (pressure_trend < 0)  WxConditions[0].Trend = TREND_FALLING;
+  }
+  buildForecastView(WxDailyForecast, dailyCount, timezoneOffset);
+  fetchProgress(FETCH_DAILY_READY);
+  
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.printf("Decode took %lu ms, JSON scratch peak %u of %u bytes (whole-document decode reserved %u)\n",
+                  millis() - decodeStart, (unsigned)peakDocUsage, (unsigned)JSON_ELEMENT_DOC_SIZE, 64u * 1024u);
+    Serial.printf("Free heap before decode %u, after %u, minimum since boot %u\n",
+                  heapBefore, ESP.getFreeHeap(), ESP.getMinFreeHeap());
+  }
+#endif
+  return true;
+}
+
+bool DecodeNowcast(Stream &json, Nowcast_record_type &nowcast) {
+  memset(&nowcast, 0, sizeof(nowcast));
+  if (!json.find("\"minutely\":[")) {
+#if DEBUG_LEVEL
+    if (Serial) {
+      Serial.println(F("minutely section not found"));
+    }
+#endif
+    return false;
+  }
+  BasicJsonDocument<ArenaJsonAllocator> doc(JSON_ELEMENT_DOC_SIZE);  // Scratch document, reused for every minute
+  StaticJsonDocument<64> filter;
+  filter["dt"]            = true;
+  filter["precipitation"] = true;
+  do {
+    DeserializationError error = deserializeJson(doc, json, DeserializationOption::Filter(filter));
+    if (error) {
+#if DEBUG_LEVEL
+      if (Serial) {
+        Serial.print(F("minutely deserializeJson() failed: "));
+        Serial.println(error.c_str());
+      }
+#endif
+      return false;
+    }
+    int32_t dt = doc["dt"].as<int32_t>();
+    if (nowcast.Start == 0) {
+      nowcast.Start = dt;
+    }
+    // Placed by time, so a minute missing from the response leaves a dry gap, not a shift
+    long minute = (dt - nowcast.Start) / 60;
+    if (minute < 0 || minute >= max_nowcast_readings) break;
+    nowcast.Precipitation[minute] = toHundredths(doc["precipitation"] | 0.0f); // mm/h
+    if (minute >= nowcast.Count) nowcast.Count = minute + 1;
+  } while (json.findUntil(",", "]"));
+#if DEBUG_LEVEL
+  if (Serial) {
+    Serial.println(String(nowcast.Count) + " minutes of precipitation received");
+  }
+#endif
+  return nowcast.Count > 0;
+}
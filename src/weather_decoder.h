@@ -0,0 +1,56 @@
+#ifndef __WEATHER_DECODER_H__
+#define __WEATHER_DECODER_H__
+
+#include <Arduino.h>
+#include <time.h>
+#include "forecast_record.h"
+
+// Streaming JSON decoder sizing (one current/hourly/daily object is held at a time)
+#define JSON_ELEMENT_DOC_SIZE 1536  // Scratch document for a single filtered element
+#define JSON_FILTER_DOC_SIZE  512   // Filter describing the fields kept per element
+
+// Sections of the response, passed to fetchProgress() as each is stored
+#define FETCH_CURRENT_READY (1 << 0)
+#define FETCH_HOURLY_READY  (1 << 1)
+#define FETCH_DAILY_READY   (1 << 2)
+
+// Forecast arrays filled by DecodeWeather() (defined by the application)
+extern Forecast_record_type WxConditions[1];
+extern Forecast_record_type WxHourlyForecast[max_hourly_readings];
+extern Forecast_record_type WxDailyForecast[max_daily_readings];
+
+/**
+ * Parse an OpenWeatherMap One Call API 3.0 response into WxConditions, WxHourlyForecast
+ * and WxDailyForecast, and build the matching weatherView sections (weather_view.h).
+ *
+ * @param json Stream containing the JSON response body
+ * @return true if parsing successful, false on error
+ */
+bool DecodeWeather(Stream &json);
+
+/**
+ * Parse a One Call API 3.0 response requested with only "minutely" left in (the
+ * precipitation nowcast), one element at a time like DecodeWeather().
+ *
+ * @param json Stream containing the JSON response body
+ * @param nowcast Filled with the minutes received (Location is left to the caller)
+ * @return true if at least one minute was decoded, false on error
+ */
+bool DecodeNowcast(Stream &json, Nowcast_record_type &nowcast);
+
+// Provided by the application (main.ino, or the host benchmark in bench/)
+
+/**
+ * Set the clock from the API's time, called once "current" is decoded.
+ *
+ * @param apiTime Unix timestamp from API (UTC)
+ * @param timezoneOffset Timezone offset in seconds from UTC (positive = east of UTC)
+ */
+void SetRTCTimeFromAPI(time_t apiTime, int timezoneOffset);
+
+/**
+ * Announce FETCH_*_READY bits as the sections are stored.
+ */
+void fetchProgress(uint32_t bits);
+
+#endif // __WEATHER_DECODER_H__
@@ -0,0 +1,254 @@
+/**
+ * Weather View
+ *
+ * Derives what the weather screen shows from the forecast records: the 5-day summary,
+ * the graph series and the nowcast sparkline scaled to pixel coordinates, and the
+ * formatted labels. Each section is built once when its records are ready (as
+ * DecodeWeather() stores them, on the fetch core with PIPELINED_FETCH, or after restoring
+ * the RTC snapshot), the nowcast just before the status bar is drawn; the renderer only
+ * draws from it. Local times are the UTC timestamps shifted by the API's timezone offset.
+ */
+
+#include <Arduino.h>
+#include "weather_view.h"
+#include "settings.h"
+
+WeatherView weatherView;
+
+static bool metricUnits() {
+  return strcmp(settings.Units, "M") == 0;
+}
+
+/**
+ * Broken-down local time of a UTC timestamp.
+ */
+static void localTime(time_t utc, int timezoneOffset, struct tm *out) {
+  time_t local = utc + timezoneOffset;
+  gmtime_r(&local, out);
+}
+
+/**
+ * Time of day: "6:44" (metric) or "6:44AM", no leading zero on the hour.
+ */
+static void formatClock(char *out, size_t size, time_t utc, int timezoneOffset, bool metric) {
+  struct tm t;
+  localTime(utc, timezoneOffset, &t);
+  if (metric) {
+    snprintf(out, size, "%d:%02d", t.tm_hour, t.tm_min);
+  } else {
+    int hour12 = t.tm_hour % 12;
+    if (hour12 == 0) hour12 = 12;
+    snprintf(out, size, "%d:%02d%cM", hour12, t.tm_min, (t.tm_hour < 12) ? 'A' : 'P');
+  }
+}
+
+/**
+ * Determine appropriate weather icon based on daily conditions.
+ * Priority: snow > thunderstorm > rain > cloud cover.
+ *
+ * @param icon Output buffer for the icon code (at least 4 bytes)
+ * @param avgCloudCover Average cloud cover percentage (0-100)
+ * @param maxPop Maximum probability of precipitation (percent, 0-100)
+ * @param totalRainfall Total rainfall for the day (hundredths of mm or inches)
+ * @param totalSnowfall Total snowfall for the day (hundredths of mm or inches)
+ * @param isDay true for day icons, false for night icons
+ */
+static void getIconFromCloudCover(char *icon, int avgCloudCover, int maxPop, uint32_t totalRainfall,
+                                  uint32_t totalSnowfall, bool isDay) {
+  const char *code;
+
+  if (totalSnowfall > 50) {
+    code = "13";            // Priority 1: Snow
+  } else if (maxPop > 50 || totalRainfall > 200) {
+    code = "11";            // Priority 2: Thunderstorm - high probability or heavy rain
+  } else if (maxPop > 30 || totalRainfall > 50) {
+    code = "10";            // Priority 3: Rain - moderate probability or light rain
+  } else if (avgCloudCover <= 10) {
+    code = "01";            // Priority 4: Clear sky
+  } else if (avgCloudCover <= 25) {
+    code = "02";            // Few clouds
+  } else if (avgCloudCover <= 50) {
+    code = "03";            // Scattered clouds
+  } else {
+    code = "04";            // Broken clouds / overcast
+  }
+
+  icon[0] = code[0];
+  icon[1] = code[1];
+  icon[2] = isDay ? 'd' : 'n';
+  icon[3] = '\0';
+}
+
+void buildCurrentView(const Forecast_record_type &current) {
+  weatherView.metric = metricUnits();
+  formatClock(weatherView.sunrise, sizeof(weatherView.sunrise), current.Sunrise, current.FTimezone, weatherView.metric);
+  formatClock(weatherView.sunset, sizeof(weatherView.sunset), current.Sunset, current.FTimezone, weatherView.metric);
+}
+
+void buildGraphView(const Forecast_record_type *hourly, int count, time_t now, int timezoneOffset) {
+  const int SECONDS_PER_HOUR = 3600;
+  weatherView.metric = metricUnits();
+
+  // Include forecasts within the window (allow 1 hour in past for current period)
+  int indices[graph_hours_shown];
+  int points = 0;
+  for (int i = 0; i < count && points < graph_hours_shown; i++) {
+    time_t forecastTime = hourly[i].Dt;
+    if (hourly[i].Dt != 0 && forecastTime >= now - SECONDS_PER_HOUR &&
+        forecastTime <= now + graph_hours_shown * SECONDS_PER_HOUR) {
+      indices[points++] = i;
+    }
+  }
+  // Fallback if no valid forecasts found (e.g. the RTC is off)
+  if (points == 0 && count > 0) {
+    indices[points++] = 0;
+  }
+  weatherView.pointCount = points;
+  weatherView.timeLabelCount = 0;
+  if (points == 0) {
+    return;
+  }
+
+  // Temperature range for the left Y axis, with 10% padding above/below
+  float tempMin = fromTenths(hourly[indices[0]].Temperature);
+  float tempMax = tempMin;
+  for (int i = 1; i < points; i++) {
+    float temperature = fromTenths(hourly[indices[i]].Temperature);
+    if (temperature < tempMin) tempMin = temperature;
+    if (temperature > tempMax) tempMax = temperature;
+  }
+  float tempRange = tempMax - tempMin;
+  if (tempRange < 1.0) tempRange = 10.0; // Ensure minimum range
+  tempMin -= tempRange * 0.1;
+  tempMax += tempRange * 0.1;
+
+  for (int i = 0; i <= GRAPH_AXIS_TICKS; i++) {
+    float tempValue = tempMin + (tempMax - tempMin) * (float)i / GRAPH_AXIS_TICKS;
+    snprintf(weatherView.tempLabels[i], sizeof(weatherView.tempLabels[i]), weatherView.metric ? "%.0f°C" : "%.0f°F",
+             tempValue);
+  }
+
+  const int graphBottom = Layout::graphBottom;
+  const int graphHeight = Layout::graph.height;
+  for (int i = 0; i < points; i++) {
+    const Forecast_record_type &hour = hourly[indices[i]];
+    GraphPointView &point = weatherView.points[i];
+    // Bars start exactly where the previous one ends and fill the whole width; the edges
+    // of a full window are in the layout table
+    int x, nextX;
+    if (points == graph_hours_shown) {
+      x     = Layout::graphColumnX[i];
+      nextX = Layout::graphColumnX[i + 1];
+    } else {
+      x     = Layout::graph.x + (i * Layout::graph.width / points);
+      nextX = Layout::graph.x + ((i + 1) * Layout::graph.width / points);
+    }
+    int pop   = (hour.Pop > 100) ? 100 : hour.Pop;
+    float tempRatio = (fromTenths(hour.Temperature) - tempMin) / (tempMax - tempMin);
+    point.x     = x;
+    point.width = nextX - x;
+    point.barY  = graphBottom - (int)(pop / 100.0 * graphHeight);
+    point.tempY = graphBottom - (int)(tempRatio * graphHeight);
+    point.tempYFixed = graphBottom * 65536 - (int32_t)(tempRatio * graphHeight * 65536);
+  }
+
+  // X axis time labels (approximately 4-5 across the window)
+  int labelInterval = points / 4;
+  if (labelInterval < 1) labelInterval = 1;
+  for (int i = 0; i < points; i += labelInterval) {
+    GraphLabelView &label = weatherView.timeLabels[weatherView.timeLabelCount++];
+    struct tm t;
+    localTime(hourly[indices[i]].Dt, timezoneOffset, &t);
+    label.x = weatherView.points[i].x;
+    if (weatherView.metric) {
+      snprintf(label.text, sizeof(label.text), "%02d", t.tm_hour); // 24-hour format
+    } else {
+      // 12-hour format without leading zero (e.g., "7AM" not "07AM")
+      int hour12 = t.tm_hour % 12;
+      if (hour12 == 0) hour12 = 12;
+      snprintf(label.text, sizeof(label.text), "%d%cM", hour12, (t.tm_hour < 12) ? 'A' : 'P');
+    }
+  }
+}
+
+void buildForecastView(const Forecast_record_type *daily, int count, int timezoneOffset) {
+  // Aggregated daily statistics
+  struct {
+    int16_t  highTemp;        // Tenths
+    int16_t  lowTemp;         // Tenths
+    int      totalCloudCover; // Sum of cloud cover values (for averaging)
+    int      cloudCoverCount;
+    int      maxPop;          // Percent
+    uint32_t totalRainfall;   // Hundredths
+    uint32_t totalSnowfall;   // Hundredths
+    struct tm first;          // Local time of the day's first period
+  } days[forecast_days_shown];
+  int dayCount = 0;
+  int lastDayOfYear = -1; // Day of year handles month boundaries
+
+  for (int i = 0; i < count; i++) {
+    if (daily[i].Dt == 0) continue;
+    struct tm t;
+    localTime(daily[i].Dt, timezoneOffset, &t);
+    if (t.tm_yday != lastDayOfYear) {
+      if (dayCount == forecast_days_shown) break;
+      days[dayCount].highTemp        = daily[i].High;
+      days[dayCount].lowTemp         = daily[i].Low;
+      days[dayCount].totalCloudCover = daily[i].Cloudcover;
+      days[dayCount].cloudCoverCount = 1;
+      days[dayCount].maxPop          = daily[i].Pop;
+      days[dayCount].totalRainfall   = daily[i].Rainfall;
+      days[dayCount].totalSnowfall   = daily[i].Snowfall;
+      days[dayCount].first           = t;
+      dayCount++;
+      lastDayOfYear = t.tm_yday;
+    } else {
+      // Same day - aggregate statistics
+      int day = dayCount - 1;
+      if (daily[i].High > days[day].highTemp) days[day].highTemp = daily[i].High;
+      if (daily[i].Low < days[day].lowTemp)   days[day].lowTemp  = daily[i].Low;
+      days[day].totalCloudCover += daily[i].Cloudcover;
+      days[day].cloudCoverCount++;
+      if (daily[i].Pop > days[day].maxPop) days[day].maxPop = daily[i].Pop;
+      days[day].totalRainfall += daily[i].Rainfall;
+      days[day].totalSnowfall += daily[i].Snowfall;
+    }
+  }
+
+  weatherView.dayCount = dayCount;
+  for (int day = 0; day < dayCount; day++) {
+    DayView &view = weatherView.days[day];
+    strftime(view.name, sizeof(view.name), "%a", &days[day].first);
+    // Day/night icon from the first period's hour (6 AM - 6 PM = day)
+    bool isDay = days[day].first.tm_hour >= 6 && days[day].first.tm_hour < 18;
+    getIconFromCloudCover(view.icon, days[day].totalCloudCover / days[day].cloudCoverCount, days[day].maxPop,
+                          days[day].totalRainfall, days[day].totalSnowfall, isDay);
+    snprintf(view.temps, sizeof(view.temps), "%d°|%d°", roundTenths(days[day].highTemp), roundTenths(days[day].lowTemp));
+  }
+}
+
+void buildNowcastView(const Nowcast_record_type *nowcast, time_t now) {
+  weatherView.nowcastCount = 0;
+  if (nowcast == NULL || nowcast->Start == 0) {
+    return;
+  }
+  // A bar per minute inside the sparkline's frame, at least one pixel for any precipitation
+  const int bottom = Layout::nowcast.y + Layout::nowcast.height - 1;
+  const int fullHeight = Layout::nowcast.height - 2;
+  int first = (now > nowcast->Start) ? (now - nowcast->Start) / 60 : 0;
+  for (int i = first; i < nowcast->Count; i++) {
+    int rate = min((int)nowcast->Precipitation[i], NOWCAST_FULL_SCALE);
+    int height = 0;
+    if (rate > 0) {
+      height = max(1, (int)lroundf(fullHeight * sqrtf((float)rate / NOWCAST_FULL_SCALE)));
+    }
+    weatherView.nowcastBarY[weatherView.nowcastCount++] = bottom - height;
+  }
+}
+
+void buildWeatherView(const Forecast_record_type &current, const Forecast_record_type *hourly, int hourlyCount,
+                      const Forecast_record_type *daily, int dailyCount, time_t now, int timezoneOffset) {
+  buildCurrentView(current);
+  buildGraphView(hourly, hourlyCount, now, timezoneOffset);
+  buildForecastView(daily, dailyCount, timezoneOffset);
+}
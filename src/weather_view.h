@@ -0,0 +1,109 @@
+#ifndef __WEATHER_VIEW_H__
+#define __WEATHER_VIEW_H__
+
+#include <Arduino.h>
+#include <time.h>
+#include "forecast_record.h"
+#include "layout.h"
+
+// Nowcast sparkline: precipitation (hundredths of mm/h) drawn at full height; lower rates
+// are scaled by the square root, so drizzle still shows next to a downpour
+#define NOWCAST_FULL_SCALE 800
+
+/**
+ * One day of the forecast row, aggregated and formatted.
+ */
+typedef struct {
+  char name[8];    // Day of the week ("%a")
+  char icon[4];    // Icon code chosen from the day's cloud cover and precipitation
+  char temps[16];  // "high°|low°"
+} DayView;
+
+/**
+ * One hour of the graph, in screen coordinates.
+ */
+typedef struct {
+  int16_t x;      // Left edge of the bar and start of the temperature segment
+  int16_t width;  // Bar width (bars fill the graph width without gaps)
+  int16_t barY;   // Top of the precipitation bar, Layout::graphBottom for none
+  int16_t tempY;  // Temperature line
+  int32_t tempYFixed;  // Temperature line before rounding to a pixel, Q16 (fb_kernel.h)
+} GraphPointView;
+
+typedef struct {
+  int16_t x;
+  char    text[8];
+} GraphLabelView;
+
+/**
+ * Everything the weather screen draws that is derived from the forecast records:
+ * aggregates, the graph series already scaled to pixels and the formatted labels.
+ * Built once per section when its records are decoded or restored from the RTC snapshot,
+ * so drawing is only text and primitives.
+ */
+typedef struct {
+  bool metric;  // settings.Units is "M"
+
+  // Current conditions
+  char sunrise[12];
+  char sunset[12];
+
+  // Forecast row
+  int     dayCount;
+  DayView days[forecast_days_shown];
+
+  // Graph
+  int            pointCount;
+  GraphPointView points[graph_hours_shown];
+  char           tempLabels[GRAPH_AXIS_TICKS + 1][10];  // Left axis, bottom to top
+  int            timeLabelCount;
+  GraphLabelView timeLabels[graph_hours_shown];
+
+  // Nowcast sparkline, one column per minute from the current one
+  int     nowcastCount;                       // 0 = no nowcast to draw
+  int16_t nowcastBarY[max_nowcast_readings];  // Top of each minute's bar, the sparkline's bottom row for none
+} WeatherView;
+
+extern WeatherView weatherView;
+
+/**
+ * Format the current conditions (sunrise and sunset in the location's local time).
+ */
+void buildCurrentView(const Forecast_record_type &current);
+
+/**
+ * Select the hourly entries from an hour ago up to graph_hours_shown ahead of now and
+ * scale them to the graph: temperature range with 10% padding, precipitation 0-100%.
+ *
+ * @param hourly Hourly records (entries with Dt 0 are unused)
+ * @param count Number of records
+ * @param now Current UTC time
+ * @param timezoneOffset Seconds east of UTC, for the time labels
+ */
+void buildGraphView(const Forecast_record_type *hourly, int count, time_t now, int timezoneOffset);
+
+/**
+ * Aggregate the daily records by local day (high/low, average cloud cover, highest
+ * probability and total precipitation) into forecast_days_shown days.
+ *
+ * @param daily Daily records (entries with Dt 0 are unused)
+ * @param count Number of records
+ * @param timezoneOffset Seconds east of UTC
+ */
+void buildForecastView(const Forecast_record_type *daily, int count, int timezoneOffset);
+
+/**
+ * Scale a nowcast to the sparkline, from the current minute to the last one received.
+ *
+ * @param nowcast Minutely precipitation (nowcast.h), or NULL for none
+ * @param now Current UTC time
+ */
+void buildNowcastView(const Nowcast_record_type *nowcast, time_t now);
+
+/**
+ * Build every section of the view (e.g. after restoring the RTC snapshot).
+ */
+void buildWeatherView(const Forecast_record_type &current, const Forecast_record_type *hourly, int hourlyCount,
+                      const Forecast_record_type *daily, int dailyCount, time_t now, int timezoneOffset);
+
+#endif // __WEATHER_VIEW_H__
@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+"""
+Generate src/font_subsets.h - OpenSans fonts reduced to the characters the UI draws.
+
+The full src/OpenSans*.h headers carry every printable Latin-1 glyph, but the
+display only ever draws digits, units, English day/month names (newlib's C
+locale strftime) and fixed strings. Those are collected from the string literals
+of every source in src/ (lines writing to Serial are skipped): a label can be
+built in main.ino or weather_view.cpp and drawn by renderer.cpp, so scanning
+only the files that draw would miss it. This script copies the matching compressed glyphs
+out of the full headers (they stay in the tree as the source of truth) and
+writes one header with the same font names, so the FONT_SUBSET build flag only
+changes which header renderer.cpp includes.
+
+OpenSans18B also draws the city name, which is free text. It keeps all of
+printable ASCII, and the accented letters of each language in LANGUAGES are
+written as supplement fonts over one shared bitmap pool. The renderer picks the
+supplement for settings.Language (or the whole pool for any other language) and
+falls back to it for glyphs missing from the subset.
+
+Run from the repository root whenever a string on screen or the fonts change:
+
+    python3 tools/generate_font_subsets.py [--languages de,fr]
+
+With --check nothing is written; the script fails if src/font_subsets.h is out
+of date, e.g. because new text has characters the subset lacks.
+
+Limiting --languages to the ones a fleet actually uses drops the other letters.
+"""
+
+import argparse
+import io
+import os
+import re
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+SRC = os.path.join(ROOT, "src")
+OUTPUT = os.path.join(SRC, "font_subsets.h")
+
+FONT_NAMES = ["OpenSans8B", "OpenSans10B", "OpenSans12B", "OpenSans18B", "OpenSans24B"]
+
+# Fonts used for text entered by the user (drawLocationDate: city)
+FREE_TEXT_FONTS = ["OpenSans18B"]
+
+# Sources scanned for string literals: all of src/ except the fonts and generated data
+SOURCE_EXTENSIONS = (".h", ".cpp", ".ino")
+NOT_SCANNED = ["font_subsets.h", "icon_sprites.h", "setup_page.h", "owm_ca.h", "moon.h", "sunrise.h", "sunset.h"]
+
+# Characters produced at runtime by printf/strftime/String conversions
+RUNTIME_CHARS = (
+    "0123456789 +-.,:;/%|()"
+    "Monday Tuesday Wednesday Thursday Friday Saturday Sunday "
+    "January February March April May June July August September October November December "
+    "AM PM am pm"
+    # Every letter, for text that comes from the API (e.g. condition descriptions)
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz"
+)
+
+# Letters each language adds to the free text fonts (Latin-1 only - the fonts have no more)
+LANGUAGES = {
+    "ca": "ÀÇÈÉÍÏÒÓÚÜàçèéíïòóúü·",
+    "da": "ÆØÅæøåÉé",
+    "de": "ÄÖÜäöüß",
+    "es": "ÁÉÍÑÓÚÜáéíñóúü¡¿",
+    "fi": "ÄÖÅäöå",
+    "fr": "ÀÂÆÇÈÉÊËÎÏÔÙÛÜàâæçèéêëîïôùûüÿ",
+    "is": "ÁÐÉÍÓÚÝÞÆÖáðéíóúýþæö",
+    "it": "ÀÈÉÌÍÒÓÙÚàèéìíòóùú",
+    "nl": "ÁÉÍÓÚÄËÏÖÜáéíóúäëïöü",
+    "no": "ÆØÅæøåÉé",
+    "pt": "ÀÁÂÃÇÉÊÍÓÔÕÚàáâãçéêíóôõú",
+    "sv": "ÄÖÅäöåÉé",
+}
+
+
+class Font:
+    """GFXfont parsed from one of the src/OpenSans*.h headers."""
+
+    def __init__(self, name):
+        self.name = name
+        with open(os.path.join(SRC, name + ".h"), encoding="utf-8") as f:
+            text = f.read()
+        bitmap = re.search(r"Bitmaps\[\d+\]\s*=\s*\{(.*?)\};", text, re.S).group(1)
+        self.bitmap = bytes(int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]+", bitmap))
+        glyphs = re.search(r"Glyphs\[\]\s*=\s*\{(.*?)\n\};", text, re.S).group(1)
+        self.glyphs = [tuple(int(v) for v in g.split(","))
+                       for g in re.findall(r"\{\s*(-?\d+\s*(?:,\s*-?\d+\s*){6})\}", glyphs)]
+        intervals = re.search(r"Intervals\[\]\s*=\s*\{(.*?)\n\};", text, re.S).group(1)
+        self.intervals = [tuple(int(v, 16) for v in i)
+                          for i in re.findall(r"\{\s*(0x[0-9A-Fa-f]+),\s*(0x[0-9A-Fa-f]+),\s*(0x[0-9A-Fa-f]+)\s*\}", intervals)]
+        # Trailing fields of the GFXfont initializer: interval count, compressed, advance_y, ascender, descender
+        fields = re.search(r"GFXfont\s+\w+\s*=\s*\{(.*?)\};", text, re.S).group(1)
+        values = [v.strip() for v in fields.split(",") if v.strip()]
+        self.compressed, self.advance_y, self.ascender, self.descender = (int(v) for v in values[4:8])
+
+    def glyph(self, cp):
+        for first, last, offset in self.intervals:
+            if first <= cp <= last:
+                return self.glyphs[offset + cp - first]
+        return None
+
+
+def literal_sources():
+    """Source files whose string literals may be drawn."""
+    return sorted(name for name in os.listdir(SRC)
+                  if name.endswith(SOURCE_EXTENSIONS) and name not in NOT_SCANNED
+                  and not name.startswith("OpenSans"))
+
+
+def string_literals(path):
+    """Characters appearing in the C string literals of a source file, except debug output."""
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    chars = set()
+    for line in text.splitlines():
+        if line.lstrip().startswith("#include") or "Serial." in line:
+            continue
+        for literal in re.findall(r'"((?:[^"\\]|\\.)*)"', line):
+            literal = re.sub(r"\\(.)", r"\1", literal)
+            # Format specifiers are expanded at runtime (see RUNTIME_CHARS)
+            literal = re.sub(r"%[-+ 0#]*\d*(?:\.\d+)?[a-zA-Z]", "", literal)
+            chars.update(literal)
+    return chars
+
+
+def intervals_for(codepoints):
+    """Group sorted code points into (first, last, glyph offset) runs."""
+    intervals = []
+    for index, cp in enumerate(codepoints):
+        if intervals and intervals[-1][1] == cp - 1:
+            intervals[-1][1] = cp
+        else:
+            intervals.append([cp, cp, index])
+    return intervals
+
+
+def emit_bitmaps(out, source, name, codepoints):
+    """Write the compressed bitmaps of the given code points. Returns {code point: offset}, size."""
+    bitmap = bytearray()
+    offsets = {}
+    for cp in codepoints:
+        _, _, _, _, _, csize, offset = source.glyph(cp)
+        offsets[cp] = len(bitmap)
+        bitmap += source.bitmap[offset:offset + csize]
+
+    out.write("const uint8_t %sBitmaps[%d] = {\n" % (name, len(bitmap)))
+    for i in range(0, len(bitmap), 16):
+        out.write("    " + ", ".join("0x%02X" % b for b in bitmap[i:i + 16]) + ",\n")
+    out.write("};\n")
+    return offsets, len(bitmap)
+
+
+def emit_font(out, source, name, codepoints, bitmaps, offsets):
+    """Write the glyph table, intervals and GFXfont for code points stored in bitmaps."""
+    out.write("const GFXglyph %sGlyphs[] = {\n" % name)
+    for cp in codepoints:
+        width, height, advance, left, top, csize, _ = source.glyph(cp)
+        out.write("    { %d, %d, %d, %d, %d, %d, %d }, // %s\n"
+                  % (width, height, advance, left, top, csize, offsets[cp], "<backslash>" if cp == 0x5C else chr(cp)))
+    out.write("};\n")
+    intervals = intervals_for(codepoints)
+    out.write("const UnicodeInterval %sIntervals[] = {\n" % name)
+    for first, last, offset in intervals:
+        out.write("    { 0x%X, 0x%X, 0x%X },\n" % (first, last, offset))
+    out.write("};\n")
+    out.write("const GFXfont %s = {\n" % name)
+    out.write("    (uint8_t*)%sBitmaps,\n" % bitmaps)
+    out.write("    (GFXglyph*)%sGlyphs,\n" % name)
+    out.write("    (UnicodeInterval*)%sIntervals,\n" % name)
+    out.write("    %d,\n    %d,\n    %d,\n    %d,\n    %d,\n};\n\n"
+              % (len(intervals), source.compressed, source.advance_y, source.ascender, source.descender))
+
+
+def available(source, codepoints):
+    return sorted(cp for cp in set(codepoints) if source.glyph(cp) is not None)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0].strip())
+    parser.add_argument("--languages", default=",".join(sorted(LANGUAGES)),
+                        help="comma separated settings.Language codes to build supplements for")
+    parser.add_argument("--check", action="store_true",
+                        help="fail if %s is not up to date instead of writing it" % os.path.relpath(OUTPUT, ROOT))
+    args = parser.parse_args()
+    languages = [code for code in args.languages.split(",") if code]
+    for code in languages:
+        if code not in LANGUAGES:
+            parser.error("no letters defined for language '%s'" % code)
+
+    base = set(RUNTIME_CHARS)
+    for name in literal_sources():
+        base |= string_literals(os.path.join(SRC, name))
+    fonts = {name: Font(name) for name in FONT_NAMES}
+
+    out = io.StringIO()
+    total_full = sum(len(f.bitmap) for f in fonts.values())
+    total_subset = 0
+    supplements = []
+
+    for name in FONT_NAMES:
+        source = fonts[name]
+        wanted = {ord(c) for c in base}
+        if name in FREE_TEXT_FONTS:
+            wanted |= set(range(0x20, 0x7F))
+        wanted = available(source, wanted)
+        offsets, size = emit_bitmaps(out, source, name, wanted)
+        emit_font(out, source, name, wanted, name, offsets)
+        total_subset += size
+
+        if name in FREE_TEXT_FONTS:
+            # One bitmap pool shared by every language, so overlapping letters are stored once
+            extras = {language: available(source, {ord(c) for c in LANGUAGES[language]} - set(wanted))
+                      for language in languages}
+            pool = "%s_Latin" % name
+            letters = sorted(set().union(*extras.values()))
+            if letters:
+                offsets, size = emit_bitmaps(out, source, pool, letters)
+                total_subset += size
+            for language in languages:
+                if extras[language]:
+                    supplement = "%s_%s" % (name, language)
+                    emit_font(out, source, supplement, extras[language], pool, offsets)
+                    supplements.append((language, name, supplement))
+            if letters:
+                # Any other language (including the default "en") gets every letter in the pool
+                emit_font(out, source, pool, letters, pool, offsets)
+                supplements.append(("", name, pool))
+
+    text = io.StringIO()
+    text.write("#pragma once\n")
+    text.write("// Generated by tools/generate_font_subsets.py - do not edit by hand.\n")
+    text.write("// OpenSans subsets: %d bytes of glyph bitmaps (full fonts: %d bytes).\n"
+               % (total_subset, total_full))
+    text.write("#include \"epd_driver.h\"\n\n")
+    text.write("// Characters: %s\n\n" % "".join(sorted(base)).replace("\\", "\\\\"))
+    text.write(out.getvalue())
+    text.write("typedef struct {\n")
+    text.write("  const char *language;     // settings.Language code, \"\" for any other language\n")
+    text.write("  const GFXfont *base;      // Subset font the supplement extends\n")
+    text.write("  const GFXfont *supplement;\n")
+    text.write("} FontSupplement;\n\n")
+    text.write("const FontSupplement font_supplements[] = {\n")
+    for language, name, supplement in supplements:
+        text.write("  {\"%s\", &%s, &%s},\n" % (language, name, supplement))
+    if not supplements:
+        text.write("  {NULL, NULL, NULL},\n")
+    text.write("};\n")
+    text.write("const int font_supplement_count = %d;\n" % len(supplements))
+
+    header = text.getvalue()
+    if args.check:
+        with open(OUTPUT, encoding="utf-8") as current:
+            if current.read() != header:
+                raise SystemExit("%s is out of date: run tools/generate_font_subsets.py"
+                                 % os.path.relpath(OUTPUT, ROOT))
+        print("%s is up to date" % os.path.relpath(OUTPUT, ROOT))
+        return
+    with open(OUTPUT, "w", encoding="utf-8") as f:
+        f.write(header)
+    print("Wrote %s: %d bytes of glyph bitmaps (full fonts: %d bytes)"
+          % (os.path.relpath(OUTPUT, ROOT), total_subset, total_full))
+
+
+if __name__ == "__main__":
+    main()
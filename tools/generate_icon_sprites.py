@@ -0,0 +1,602 @@
+#!/usr/bin/env python3
+"""
+Generate src/icon_sprites.h - pre-rasterized 4-bit weather icon sprites.
+
+The weather icons in src/renderer.cpp are built from EPD driver primitives
+(filled circles, triangles, rectangles, lines and a few font glyphs). This
+script reproduces those primitives and the icon building blocks exactly, in
+the same integer arithmetic as the C++ code, rasterizes every
+(icon code x size x day/night) combination once and writes the results as
+packed 4bpp bitmaps in the same layout as moon_data in src/moon.h
+(2 pixels per byte, even pixel in the low nibble, rows padded to an even width).
+
+Run from the repository root whenever an icon function in renderer.cpp changes:
+
+    python3 tools/generate_icon_sprites.py
+
+The ICON_BENCHMARK build flag draws every icon both ways on the device and
+reports any pixel that differs, so a mismatch with the C++ primitives shows up
+immediately.
+"""
+
+import math
+import os
+import re
+import struct
+import zlib
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+SRC = os.path.join(ROOT, "src")
+OUTPUT = os.path.join(SRC, "icon_sprites.h")
+
+EPD_WIDTH = 960
+EPD_HEIGHT = 540
+
+BLACK = 0x00
+WHITE = 0xFF
+
+# Icon size constants (renderer.cpp)
+LARGE = 25
+SMALL = 15
+LARGE_ICON = True
+SMALL_ICON = False
+
+# Anchors used by the layout (src/layout.h): Layout::currentIcon and the first forecast column.
+# Icons are translation invariant in x; ScatteredClouds scales y, so sprites are only
+# valid for the row they were rasterized at (recorded as anchor_y in the table).
+ANCHORS = {LARGE_ICON: (122, 117), SMALL_ICON: (442, 160)}
+
+ICON_CODES = ["01", "02", "03", "04", "09", "10", "11", "13", "50"]
+
+
+def trunc(value):
+    """C conversion of a double to int (truncation toward zero)."""
+    return int(math.trunc(value))
+
+
+def f32(value):
+    """Round a value to IEEE single precision, like a C float."""
+    return struct.unpack("f", struct.pack("f", value))[0]
+
+
+class Font:
+    """GFXfont parsed from one of the src/OpenSans*.h headers."""
+
+    def __init__(self, name):
+        with open(os.path.join(SRC, name + ".h")) as f:
+            text = f.read()
+        bitmap = re.search(r"Bitmaps\[\d+\]\s*=\s*\{(.*?)\};", text, re.S).group(1)
+        self.bitmap = bytes(int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]+", bitmap))
+        glyphs = re.search(r"Glyphs\[\]\s*=\s*\{(.*?)\n\};", text, re.S).group(1)
+        self.glyphs = [tuple(int(v) for v in g.split(","))
+                       for g in re.findall(r"\{\s*(-?\d+\s*(?:,\s*-?\d+\s*){6})\}", glyphs)]
+        intervals = re.search(r"Intervals\[\]\s*=\s*\{(.*?)\n\};", text, re.S).group(1)
+        self.intervals = [tuple(int(v, 16) for v in i)
+                          for i in re.findall(r"\{\s*(0x[0-9A-Fa-f]+),\s*(0x[0-9A-Fa-f]+),\s*(0x[0-9A-Fa-f]+)\s*\}", intervals)]
+
+    def glyph(self, cp):
+        for first, last, offset in self.intervals:
+            if first <= cp <= last:
+                return self.glyphs[offset + cp - first]
+        return None
+
+    def glyph_bitmap(self, glyph):
+        width, height, _, _, _, csize, offset = glyph
+        byte_width = width // 2 + width % 2
+        data = zlib.decompress(self.bitmap[offset:offset + csize])
+        return data[:byte_width * height], byte_width
+
+
+FONTS = {}
+
+
+def font(name):
+    if name not in FONTS:
+        FONTS[name] = Font(name)
+    return FONTS[name]
+
+
+class Canvas:
+    """4bpp framebuffer with the LilyGo EPD47 driver's drawing semantics."""
+
+    def __init__(self):
+        self.pixels = bytearray([0x0F]) * (EPD_WIDTH * EPD_HEIGHT)
+
+    # epd_draw_pixel: the high nibble of color is stored for either pixel parity
+    def draw_pixel(self, x, y, color):
+        if 0 <= x < EPD_WIDTH and 0 <= y < EPD_HEIGHT:
+            self.pixels[y * EPD_WIDTH + x] = color >> 4
+
+    def draw_hline(self, x, y, length, color):
+        for i in range(length):
+            self.draw_pixel(x + i, y, color)
+
+    def draw_vline(self, x, y, length, color):
+        for i in range(length):
+            self.draw_pixel(x, y + i, color)
+
+    def fill_rect(self, x, y, w, h, color):
+        for yy in range(y, y + h):
+            self.draw_hline(x, yy, w, color)
+
+    def _fill_circle_helper(self, x0, y0, r, corners, delta, color):
+        f = 1 - r
+        ddF_x = 1
+        ddF_y = -2 * r
+        x = 0
+        y = r
+        px = x
+        py = y
+        delta += 1
+        while x < y:
+            if f >= 0:
+                y -= 1
+                ddF_y += 2
+                f += ddF_y
+            x += 1
+            ddF_x += 2
+            f += ddF_x
+            if x < y + 1:
+                if corners & 1:
+                    self.draw_vline(x0 + x, y0 - y, 2 * y + delta, color)
+                if corners & 2:
+                    self.draw_vline(x0 - x, y0 - y, 2 * y + delta, color)
+            if y != py:
+                if corners & 1:
+                    self.draw_vline(x0 + py, y0 - px, 2 * px + delta, color)
+                if corners & 2:
+                    self.draw_vline(x0 - py, y0 - px, 2 * px + delta, color)
+                py = y
+            px = x
+
+    def fill_circle(self, x0, y0, r, color):
+        self.draw_vline(x0, y0 - r, 2 * r + 1, color)
+        self._fill_circle_helper(x0, y0, r, 3, 0, color)
+
+    def write_line(self, x0, y0, x1, y1, color):
+        steep = abs(y1 - y0) > abs(x1 - x0)
+        if steep:
+            x0, y0 = y0, x0
+            x1, y1 = y1, x1
+        if x0 > x1:
+            x0, x1 = x1, x0
+            y0, y1 = y1, y0
+        dx = x1 - x0
+        dy = abs(y1 - y0)
+        err = dx // 2
+        ystep = 1 if y0 < y1 else -1
+        while x0 <= x1:
+            if steep:
+                self.draw_pixel(y0, x0, color)
+            else:
+                self.draw_pixel(x0, y0, color)
+            err -= dy
+            if err < 0:
+                y0 += ystep
+                err += dx
+            x0 += 1
+
+    def fill_triangle(self, x0, y0, x1, y1, x2, y2, color):
+        # Sort coordinates by y order (y2 >= y1 >= y0)
+        if y0 > y1:
+            y0, y1 = y1, y0
+            x0, x1 = x1, x0
+        if y1 > y2:
+            y2, y1 = y1, y2
+            x2, x1 = x1, x2
+        if y0 > y1:
+            y0, y1 = y1, y0
+            x0, x1 = x1, x0
+
+        if y0 == y2:  # All on same line
+            a = b = x0
+            if x1 < a:
+                a = x1
+            elif x1 > b:
+                b = x1
+            if x2 < a:
+                a = x2
+            elif x2 > b:
+                b = x2
+            self.draw_hline(a, y0, b - a + 1, color)
+            return
+
+        dx01 = x1 - x0
+        dy01 = y1 - y0
+        dx02 = x2 - x0
+        dy02 = y2 - y0
+        dx12 = x2 - x1
+        dy12 = y2 - y1
+        sa = 0
+        sb = 0
+
+        last = y1 if y1 == y2 else y1 - 1
+        y = y0
+        while y <= last:
+            a = x0 + cdiv(sa, dy01)
+            b = x0 + cdiv(sb, dy02)
+            sa += dx01
+            sb += dx02
+            if a > b:
+                a, b = b, a
+            self.draw_hline(a, y, b - a + 1, color)
+            y += 1
+
+        sa = dx12 * (y - y1)
+        sb = dx02 * (y - y0)
+        while y <= y2:
+            a = x1 + cdiv(sa, dy12)
+            b = x0 + cdiv(sb, dy02)
+            sa += dx12
+            sb += dx02
+            if a > b:
+                a, b = b, a
+            self.draw_hline(a, y, b - a + 1, color)
+            y += 1
+
+    # src/fb_kernel.cpp: blendPixel() and fbThickLineAA(), Q16 fixed point
+    def blend_pixel(self, x, y, level, coverage):
+        if not (0 <= x < EPD_WIDTH and 0 <= y < EPD_HEIGHT) or coverage <= 0:
+            return
+        gray = self.pixels[y * EPD_WIDTH + x]
+        if coverage >= 65536:
+            gray = level
+        elif level < gray:
+            gray -= ((gray - level) * coverage + 32768) >> 16
+        else:
+            gray += ((level - gray) * coverage + 32768) >> 16
+        self.pixels[y * EPD_WIDTH + x] = gray
+
+    def thick_line_aa(self, x0, y0, x1, y1, width, color):
+        dx = x1 - x0
+        dy = y1 - y0
+        length = math.isqrt(dx * dx + dy * dy)
+        if length == 0:
+            return
+        ux = cdiv(dx * 65536, length)
+        uy = cdiv(dy * 65536, length)
+        half = cdiv(width, 2)
+        reach = half + 65536
+
+        left = max((min(x0, x1) - reach) >> 16, 0)
+        right = min((max(x0, x1) + reach) >> 16, EPD_WIDTH - 1)
+        top = max((min(y0, y1) - reach) >> 16, 0)
+        bottom = min((max(y0, y1) + reach) >> 16, EPD_HEIGHT - 1)
+        level = color >> 4
+        clamp = lambda value: max(0, min(65536, value))
+
+        for py in range(top, bottom + 1):
+            rx = left * 65536 + 32768 - x0
+            ry = py * 65536 + 32768 - y0
+            along = (rx * ux + ry * uy) >> 16
+            across = (rx * uy - ry * ux) >> 16
+            for px in range(left, right + 1):
+                side = half + 32768 - abs(across)
+                end = min(along, length - along) + 32768
+                if side > 0 and end > 0:
+                    self.blend_pixel(px, py, level, (clamp(side) * clamp(end)) >> 16)
+                along += ux
+                across += uy
+
+    # get_text_bounds() + write_string() for a single line with the default font properties
+    def text_bounds(self, fnt, text, x, y):
+        minx, miny, maxx, maxy = 100000, 100000, -1, -1
+        original_x = x
+        for ch in text:
+            g = fnt.glyph(ord(ch))
+            if g is None:
+                continue
+            width, height, advance, left, top = g[:5]
+            x1 = x + left
+            y1 = y + (top - height)
+            x2 = x1 + width
+            y2 = y1 + height
+            minx = min(minx, x1)
+            miny = min(miny, y1)
+            maxx = max(maxx, x2)
+            maxy = max(maxy, y2)
+            x += advance
+        x1 = min(original_x, minx)
+        return x1, miny, maxx - x1, maxy - miny
+
+    def write_string(self, fnt, text, cursor_x, cursor_y):
+        # Default properties: fg_color 0, bg_color 15 -> bitmap value c maps to 15 - c
+        for ch in text:
+            g = fnt.glyph(ord(ch))
+            if g is None:
+                continue
+            width, height, advance, left, top = g[:5]
+            bitmap, byte_width = fnt.glyph_bitmap(g)
+            for y in range(height):
+                yy = cursor_y - top + y
+                if yy < 0 or yy >= EPD_HEIGHT:
+                    continue
+                start_pos = cursor_x + left
+                x = max(0, -start_pos)
+                max_x = min(start_pos + width, EPD_WIDTH)
+                for xx in range(start_pos, max_x):
+                    bm = bitmap[y * byte_width + x // 2]
+                    bm = (bm & 0xF) if (x & 1) == 0 else (bm >> 4)
+                    self.pixels[yy * EPD_WIDTH + xx] = 15 - bm
+                    x += 1
+            cursor_x += advance
+
+
+def cdiv(a, b):
+    """C integer division (truncation toward zero)."""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b > 0) else -q
+
+
+class IconPainter:
+    """The icon functions of src/renderer.cpp, with the same argument conversions."""
+
+    def __init__(self, canvas):
+        self.c = canvas
+        self.font = None
+
+    # Wrappers: int / int16_t parameters truncate double arguments
+    def fillCircle(self, x, y, r, color):
+        self.c.fill_circle(trunc(x), trunc(y), trunc(r), color)
+
+    def fillRect(self, x, y, w, h, color):
+        self.c.fill_rect(trunc(x), trunc(y), trunc(w), trunc(h), color)
+
+    def drawLine(self, x0, y0, x1, y1, color):
+        self.c.write_line(trunc(x0), trunc(y0), trunc(x1), trunc(y1), color)
+
+    def fillTriangle(self, x0, y0, x1, y1, x2, y2, color):
+        self.c.fill_triangle(trunc(x0), trunc(y0), trunc(x1), trunc(y1), trunc(x2), trunc(y2), color)
+
+    def setFont(self, name):
+        self.font = font(name)
+
+    def drawString(self, x, y, text, alignment):
+        x, y = trunc(x), trunc(y)
+        _, _, w, h = self.c.text_bounds(self.font, text, x, y)
+        if alignment == "RIGHT":
+            x = x - w
+        if alignment == "CENTER":
+            x = x - cdiv(w, 2)
+        self.c.write_string(self.font, text, x, y + h)
+
+    def DrawAngledLine(self, x, y, x1, y1, size, color):
+        x, y, x1, y1, size = trunc(x), trunc(y), trunc(x1), trunc(y1), trunc(size)
+        self.c.thick_line_aa(x * 65536, y * 65536, x1 * 65536, y1 * 65536, size * 65536, color)
+
+    # Icon building blocks
+    def addcloud(self, x, y, scale, linesize):
+        x, y, scale, linesize = trunc(x), trunc(y), trunc(scale), trunc(linesize)
+        self.fillCircle(x - scale * 3, y, scale, BLACK)
+        self.fillCircle(x + scale * 3, y, scale, BLACK)
+        self.fillCircle(x - scale, y - scale, scale * 1.4, BLACK)
+        self.fillCircle(x + scale * 1.5, y - scale * 1.3, scale * 1.75, BLACK)
+        self.fillRect(x - scale * 3 - 1, y - scale, scale * 6, scale * 2 + 1, BLACK)
+        self.fillCircle(x - scale * 3, y, scale - linesize, WHITE)
+        self.fillCircle(x + scale * 3, y, scale - linesize, WHITE)
+        self.fillCircle(x - scale, y - scale, scale * 1.4 - linesize, WHITE)
+        self.fillCircle(x + scale * 1.5, y - scale * 1.3, scale * 1.75 - linesize, WHITE)
+        self.fillRect(x - scale * 3 + 2, y - scale + linesize - 1, scale * 5.9, scale * 2 - linesize * 2 + 2, WHITE)
+
+    def addrain(self, x, y, scale, size):
+        if size == SMALL_ICON:
+            self.setFont("OpenSans8B")
+            self.drawString(x - 25, y + 12, "///////", "LEFT")
+        else:
+            self.setFont("OpenSans18B")
+            self.drawString(x - 60, y + 25, "///////", "LEFT")
+
+    def addsnow(self, x, y, scale, size):
+        if size == SMALL_ICON:
+            self.setFont("OpenSans8B")
+            self.drawString(x - 25, y + 15, "* * * *", "LEFT")
+        else:
+            self.setFont("OpenSans18B")
+            self.drawString(x - 60, y + 30, "* * * *", "LEFT")
+
+    def addtstorm(self, x, y, scale):
+        y = y + scale // 2  # Integer division in C: both operands are int
+        for i in range(1, 5):
+            for o in range(3):
+                self.drawLine(x - scale * 4 + scale * i * 1.5 + o, y + scale * 1.5, x - scale * 3.5 + scale * i * 1.5 + o, y + scale, BLACK)
+            for o in range(3):
+                self.drawLine(x - scale * 4 + scale * i * 1.5, y + scale * 1.5 + o, x - scale * 3 + scale * i * 1.5 + 0, y + scale * 1.5 + o, BLACK)
+            for o in range(3):
+                self.drawLine(x - scale * 3.5 + scale * i * 1.4 + o, y + scale * 2.5, x - scale * 3 + scale * i * 1.5 + o, y + scale * 1.5, BLACK)
+
+    def addsun(self, x, y, scale, size):
+        x, y, scale = trunc(x), trunc(y), trunc(scale)
+        linesize = 5
+        self.fillRect(x - scale * 2, y, scale * 4, linesize, BLACK)
+        self.fillRect(x, y - scale * 2, linesize, scale * 4, BLACK)
+        self.DrawAngledLine(x + scale * 1.4, y + scale * 1.4, (x - scale * 1.4), (y - scale * 1.4), linesize * 1.5, BLACK)
+        self.DrawAngledLine(x - scale * 1.4, y + scale * 1.4, (x + scale * 1.4), (y - scale * 1.4), linesize * 1.5, BLACK)
+        self.fillCircle(x, y, scale * 1.3, WHITE)
+        self.fillCircle(x, y, scale, BLACK)
+        self.fillCircle(x, y, scale - linesize, WHITE)
+
+    def addfog(self, x, y, scale, linesize, size):
+        if size == SMALL_ICON:
+            linesize = 3
+        for _ in range(6):
+            self.fillRect(x - scale * 3, y + scale * 1.5, scale * 6, linesize, BLACK)
+            self.fillRect(x - scale * 3, y + scale * 2.0, scale * 6, linesize, BLACK)
+            self.fillRect(x - scale * 3, y + scale * 2.5, scale * 6, linesize, BLACK)
+
+    def addmoon(self, x, y, size):
+        x_offset, y_offset = 65, 12
+        if size == LARGE_ICON:
+            x_offset, y_offset = 130, -40
+        self.fillCircle(x - 28 + x_offset, y - 37 + y_offset, trunc(SMALL * 1.0), BLACK)
+        self.fillCircle(x - 16 + x_offset, y - 37 + y_offset, trunc(SMALL * 1.6), WHITE)
+
+    # Main icon functions
+    def ClearSky(self, x, y, size, night):
+        scale = SMALL
+        if night:
+            self.addmoon(x, y, size)
+        if size == LARGE_ICON:
+            scale = LARGE
+        y += 0 if size else 10
+        self.addsun(x, y, scale * (1.7 if size else 1.2), size)
+
+    def BrokenClouds(self, x, y, size, night):
+        scale, linesize = SMALL, 5
+        if night:
+            self.addmoon(x, y, size)
+        y += 15
+        if size == LARGE_ICON:
+            scale = LARGE
+        self.addsun(x - scale * 1.8, y - scale * 1.8, scale, size)
+        self.addcloud(x, y, scale * (1 if size else 0.75), linesize)
+
+    def FewClouds(self, x, y, size, night):
+        scale, linesize = SMALL, 5
+        if night:
+            self.addmoon(x, y, size)
+        y += 15
+        if size == LARGE_ICON:
+            scale = LARGE
+        self.addcloud(x + (10 if size else 0), y, scale * (0.9 if size else 0.8), linesize)
+        self.addsun((x + (10 if size else 0)) - scale * 1.8, y - scale * 1.6, scale, size)
+
+    def ScatteredClouds(self, x, y, size, night):
+        scale, linesize = SMALL, 5
+        if night:
+            self.addmoon(x, y, size)
+        y += 15
+        if size == LARGE_ICON:
+            scale = LARGE
+        self.addcloud(x - (35 if size else 0), y * (0.75 if size else 0.93), scale // 2, linesize)
+        self.addcloud(x, y, scale * 0.9, linesize)
+
+    def Rain(self, x, y, size, night):
+        scale, linesize = SMALL, 5
+        if night:
+            self.addmoon(x, y, size)
+        y += 15
+        if size == LARGE_ICON:
+            scale = LARGE
+        self.addcloud(x, y, scale * (1 if size else 0.75), linesize)
+        self.addrain(x, y, scale, size)
+
+    def ChanceRain(self, x, y, size, night):
+        scale, linesize = SMALL, 5
+        if night:
+            self.addmoon(x, y, size)
+        if size == LARGE_ICON:
+            scale = LARGE
+        y += 15
+        self.addsun(x - scale * 1.8, y - scale * 1.8, scale, size)
+        self.addcloud(x, y, scale * (1 if size else 0.65), linesize)
+        self.addrain(x, y, scale, size)
+
+    def Thunderstorms(self, x, y, size, night):
+        scale, linesize = SMALL, 5
+        if night:
+            self.addmoon(x, y, size)
+        if size == LARGE_ICON:
+            scale = LARGE
+        y += 5
+        self.addcloud(x, y, scale * (1 if size else 0.75), linesize)
+        self.addtstorm(x, y, scale)
+
+    def Snow(self, x, y, size, night):
+        scale, linesize = SMALL, 5
+        if night:
+            self.addmoon(x, y, size)
+        if size == LARGE_ICON:
+            scale = LARGE
+        self.addcloud(x, y, scale * (1 if size else 0.75), linesize)
+        self.addsnow(x, y, scale, size)
+
+    def Mist(self, x, y, size, night):
+        scale, linesize = SMALL, 5
+        if night:
+            self.addmoon(x, y, size)
+        if size == LARGE_ICON:
+            scale = LARGE
+        self.addsun(x, y, scale * (1 if size else 0.75), linesize)
+        self.addfog(x, y, scale, linesize, size)
+
+    def draw(self, code, x, y, size, night):
+        {
+            "01": self.ClearSky,
+            "02": self.FewClouds,
+            "03": self.ScatteredClouds,
+            "04": self.BrokenClouds,
+            "09": self.ChanceRain,
+            "10": self.Rain,
+            "11": self.Thunderstorms,
+            "13": self.Snow,
+            "50": self.Mist,
+        }[code](x, y, size, night)
+
+
+def rasterize(code, size, night):
+    """Draw one icon on a white canvas and crop it to its non-white bounding box."""
+    canvas = Canvas()
+    ax, ay = ANCHORS[size]
+    IconPainter(canvas).draw(code, ax, ay, size, night)
+
+    rows = [y for y in range(EPD_HEIGHT)
+            if any(canvas.pixels[y * EPD_WIDTH + x] != 0x0F for x in range(EPD_WIDTH))]
+    cols = [x for x in range(EPD_WIDTH)
+            if any(canvas.pixels[y * EPD_WIDTH + x] != 0x0F for y in rows)]
+    top, bottom = rows[0], rows[-1] + 1
+    left, right = cols[0], cols[-1] + 1
+    # Keep the left edge on the anchor's parity so aligned anchors blit whole bytes
+    if (left - ax) % 2:
+        left -= 1
+    width = right - left
+    width += width % 2
+
+    data = bytearray()
+    for y in range(top, bottom):
+        for x in range(left, left + width, 2):
+            lo = canvas.pixels[y * EPD_WIDTH + x] if x < EPD_WIDTH else 0x0F
+            hi = canvas.pixels[y * EPD_WIDTH + x + 1] if x + 1 < EPD_WIDTH else 0x0F
+            data.append(lo | (hi << 4))
+    return left - ax, top - ay, width, bottom - top, ay, bytes(data)
+
+
+def main():
+    sprites = []
+    for size in (LARGE_ICON, SMALL_ICON):
+        for code in ICON_CODES:
+            for night in (False, True):
+                name = "icon_%s%s_%s" % (code, "n" if night else "d", "large" if size else "small")
+                dx, dy, w, h, anchor_y, data = rasterize(code, size, night)
+                sprites.append((name, code + ("n" if night else "d"), size, dx, dy, w, h, anchor_y, data))
+
+    total = sum(len(s[8]) for s in sprites)
+    with open(OUTPUT, "w") as out:
+        out.write("#pragma once\n")
+        out.write("// Generated by tools/generate_icon_sprites.py - do not edit by hand.\n")
+        out.write("// Pre-rasterized weather icons, packed 4bpp like moon_data (%d bytes of bitmaps).\n" % total)
+        out.write("#include <stdint.h>\n\n")
+        out.write("typedef struct {\n")
+        out.write("  char code[4];         // OpenWeatherMap icon code, e.g. \"10d\"\n")
+        out.write("  bool large;           // LargeIcon or SmallIcon\n")
+        out.write("  int16_t dx, dy;       // Top-left corner relative to the icon anchor\n")
+        out.write("  uint16_t width;       // Row width in pixels (even)\n")
+        out.write("  uint16_t height;\n")
+        out.write("  int16_t anchor_y;     // Anchor row the sprite was rasterized for\n")
+        out.write("  const uint8_t *data;\n")
+        out.write("} IconSprite;\n\n")
+        for name, _, _, _, _, w, h, _, data in sprites:
+            out.write("const uint8_t %s_data[(%d*%d)/2] = {\n" % (name, w, h))
+            for i in range(0, len(data), 24):
+                out.write("  " + ", ".join("0x%02X" % b for b in data[i:i + 24]) + ",\n")
+            out.write("};\n")
+        out.write("\nconst IconSprite icon_sprites[] = {\n")
+        for name, code, size, dx, dy, w, h, anchor_y, _ in sprites:
+            out.write("  {\"%s\", %s, %d, %d, %d, %d, %d, %s_data},\n"
+                      % (code, "true" if size else "false", dx, dy, w, h, anchor_y, name))
+        out.write("};\n")
+        out.write("const int icon_sprite_count = %d;\n" % len(sprites))
+    print("Wrote %s: %d sprites, %d bytes" % (os.path.relpath(OUTPUT, ROOT), len(sprites), total))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""
+Generate src/owm_ca.h - the root certificates api.openweathermap.org is pinned to.
+
+The weather API's server certificates are issued by Sectigo under the USERTrust
+roots. Only these roots are compiled in (rather than a full CA bundle), so a
+certificate from any other authority is rejected and the parsed chain stays
+small. Both the RSA and the ECC root are included so the device keeps working
+if the server switches key type.
+
+Run from the repository root when OpenWeatherMap changes certificate authority
+or a root nears its expiry date:
+
+    python3 tools/generate_owm_ca.py [root.pem ...]
+
+With no arguments the roots are read from the system certificate store.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+OUTPUT = os.path.join(ROOT, "src", "owm_ca.h")
+
+SYSTEM_CERTS = "/etc/ssl/certs"
+DEFAULT_ROOTS = [
+    "USERTrust_RSA_Certification_Authority.pem",
+    "USERTrust_ECC_Certification_Authority.pem",
+]
+
+
+def describe(path):
+    """Subject common name and expiry date of a PEM certificate (via openssl)."""
+    out = subprocess.run(["openssl", "x509", "-in", path, "-noout", "-subject", "-enddate"],
+                         check=True, capture_output=True, text=True).stdout
+    subject = re.search(r"CN\s*=\s*([^,\n]+)", out).group(1).strip()
+    expiry = re.search(r"notAfter=(.*)", out).group(1).strip()
+    return subject, expiry
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0].strip())
+    parser.add_argument("roots", nargs="*", help="PEM files to pin (default: USERTrust roots from %s)" % SYSTEM_CERTS)
+    args = parser.parse_args()
+    paths = args.roots or [os.path.join(SYSTEM_CERTS, name) for name in DEFAULT_ROOTS]
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("#pragma once\n")
+        f.write("// Generated by tools/generate_owm_ca.py - do not edit by hand.\n")
+        f.write("// CA certificates api.openweathermap.org is pinned to (PEM, parsed by mbedtls).\n\n")
+        f.write("static const char owm_ca_pem[] =\n")
+        for path in paths:
+            subject, expiry = describe(path)
+            with open(path, encoding="ascii") as pem:
+                block = re.search(r"-----BEGIN CERTIFICATE-----.*?-----END CERTIFICATE-----", pem.read(), re.S).group(0)
+            f.write("  // %s, expires %s\n" % (subject, expiry))
+            for line in block.splitlines():
+                f.write("  \"%s\\n\"\n" % line.strip())
+        f.write("  ;\n")
+
+    print("Wrote %s: %d certificates" % (os.path.relpath(OUTPUT, ROOT), len(paths)))
+
+
+if __name__ == "__main__":
+    main()
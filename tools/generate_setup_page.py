@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""
+Generate src/setup_page.h - the setup mode web page as one gzip blob in flash.
+
+web/setup.html holds the whole page (HTML, CSS and script). It is compressed
+once here so the device sends it as-is with "Content-Encoding: gzip" in a single
+response, instead of building it with many small writes. The ETag is the CRC of
+the compressed page, so browsers revalidate with a tiny 304 after a firmware update
+changes it.
+
+Run from the repository root after editing web/setup.html:
+
+    python3 tools/generate_setup_page.py
+"""
+
+import gzip
+import os
+import re
+import zlib
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+INPUT = os.path.join(ROOT, "web", "setup.html")
+OUTPUT = os.path.join(ROOT, "src", "setup_page.h")
+
+
+def minify(html):
+    """Drop HTML comments, indentation and blank lines (the page has no <pre> blocks)."""
+    html = re.sub(r"<!--.*?-->", "", html, flags=re.S)
+    lines = (line.strip() for line in html.splitlines())
+    return "\n".join(line for line in lines if line) + "\n"
+
+
+def main():
+    with open(INPUT, encoding="utf-8") as f:
+        page = minify(f.read()).encode("utf-8")
+    # mtime=0 keeps the output (and the ETag) identical for identical input
+    data = gzip.compress(page, compresslevel=9, mtime=0)
+    etag = "%08x" % (zlib.crc32(data) & 0xFFFFFFFF)
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as out:
+        out.write("#pragma once\n")
+        out.write("// Generated by tools/generate_setup_page.py from web/setup.html - do not edit by hand.\n")
+        out.write("// Setup mode page, gzip-compressed (%d bytes, %d uncompressed).\n" % (len(data), len(page)))
+        out.write("#include <Arduino.h>\n\n")
+        out.write("#define SETUP_PAGE_ETAG \"\\\"%s\\\"\"\n\n" % etag)
+        out.write("static const uint8_t setup_page_gz[] PROGMEM = {\n")
+        for i in range(0, len(data), 16):
+            out.write("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",\n")
+        out.write("};\n")
+
+    print("Wrote %s: %d bytes (%d uncompressed)" % (os.path.relpath(OUTPUT, ROOT), len(data), len(page)))
+
+
+if __name__ == "__main__":
+    main()
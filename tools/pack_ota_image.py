@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""
+Pack a firmware build for over-the-air updates (src/ota_update.h).
+
+The firmware is cut into 32 KB blocks and each block is deflated on its own, so
+a unit can stop a download after any block and resume it on a later wake with
+an HTTP Range request, without keeping inflate state across deep sleep. A block
+that does not get smaller is stored as it is. The output is:
+
+    firmware.ota   header "OTA1", firmware size, block size, 0 (little endian),
+                   then per block its length (bit 31 set = stored) and its bytes
+    manifest.json  {"version": N, "url": "...", "md5": "...", "size": ...}
+
+Put both on a web server, build the units with OTA_MANIFEST_URL pointing at the
+manifest and OTA_FIRMWARE_VERSION below N, and they update on their next check.
+firmware.bin itself (or the .ota file) can also be uploaded in setup mode.
+
+Run from the repository root after building, e.g.:
+
+    python3 tools/pack_ota_image.py .pio/build/esp32/firmware.bin \\
+        --version 12 --url http://example.com/weather/firmware.ota --out dist
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import struct
+import zlib
+
+BLOCK_SIZE = 32768          # OTA_BLOCK_SIZE: the inflater's dictionary size
+MAGIC = b"OTA1"             # OTA_PACK_MAGIC
+STORED = 0x80000000         # OTA_BLOCK_STORED
+ESP_IMAGE_MAGIC = 0xE9
+
+
+def pack(firmware):
+    """Return the packed image of a firmware binary."""
+    out = bytearray(MAGIC + struct.pack("<III", len(firmware), BLOCK_SIZE, 0))
+    for offset in range(0, len(firmware), BLOCK_SIZE):
+        block = firmware[offset:offset + BLOCK_SIZE]
+        compressor = zlib.compressobj(9, zlib.DEFLATED, -15)  # Raw deflate, as tinfl expects
+        deflated = compressor.compress(block) + compressor.flush()
+        if len(deflated) < len(block):
+            out += struct.pack("<I", len(deflated)) + deflated
+        else:
+            out += struct.pack("<I", len(block) | STORED) + block
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("firmware", help="firmware.bin from the build")
+    parser.add_argument("--version", type=int, required=True, help="version number, higher than the running one")
+    parser.add_argument("--url", required=True, help="where firmware.ota will be served")
+    parser.add_argument("--out", default=".", help="output directory")
+    args = parser.parse_args()
+
+    with open(args.firmware, "rb") as f:
+        firmware = f.read()
+    if not firmware or firmware[0] != ESP_IMAGE_MAGIC:
+        parser.error("%s is not an ESP32 application image" % args.firmware)
+    if len(args.url) >= 160:  # OTA_URL_LEN
+        parser.error("the URL must be shorter than 160 characters")
+
+    packed = pack(firmware)
+    os.makedirs(args.out, exist_ok=True)
+    with open(os.path.join(args.out, "firmware.ota"), "wb") as f:
+        f.write(packed)
+    manifest = {
+        "version": args.version,
+        "url": args.url,
+        "md5": hashlib.md5(firmware).hexdigest(),
+        "size": len(firmware),
+    }
+    with open(os.path.join(args.out, "manifest.json"), "w", encoding="utf-8", newline="\n") as f:
+        json.dump(manifest, f, indent=2)
+        f.write("\n")
+
+    print("Wrote %s: %d bytes (%d%% of %d), manifest version %d" %
+          (os.path.join(args.out, "firmware.ota"), len(packed), 100 * len(packed) // len(firmware),
+           len(firmware), args.version))
+
+
+if __name__ == "__main__":
+    main()